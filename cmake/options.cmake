@@ -373,7 +373,8 @@ set_if_at_least_one_set(RETDEC_ENABLE_UTILS
 		RETDEC_ENABLE_PATTERNGEN
 		RETDEC_ENABLE_RTTI_FINDER
 		RETDEC_ENABLE_STACOFIN
-		RETDEC_ENABLE_UNPACKERTOOL)
+		RETDEC_ENABLE_UNPACKERTOOL
+		RETDEC_ENABLE_YARACPP)
 
 set_if_at_least_one_set(RETDEC_ENABLE_YARACPP
 		RETDEC_ENABLE_ALL
@@ -391,6 +392,9 @@ set_if_all_set(RETDEC_ENABLE_CAPSTONE2LLVMIR_TESTS
 set_if_all_set(RETDEC_ENABLE_CONFIG_TESTS
 		RETDEC_TESTS
 		RETDEC_ENABLE_CONFIG)
+set_if_all_set(RETDEC_ENABLE_CPDETECT_TESTS
+		RETDEC_TESTS
+		RETDEC_ENABLE_CPDETECT)
 set_if_all_set(RETDEC_ENABLE_CTYPES_TESTS
 		RETDEC_TESTS
 		RETDEC_ENABLE_CTYPES)
@@ -412,6 +416,12 @@ set_if_all_set(RETDEC_ENABLE_LLVMIR2HLL_TESTS
 set_if_all_set(RETDEC_ENABLE_LOADER_TESTS
 		RETDEC_TESTS
 		RETDEC_ENABLE_LOADER)
+set_if_all_set(RETDEC_ENABLE_PELIB_TESTS
+		RETDEC_TESTS
+		RETDEC_ENABLE_PELIB)
+set_if_all_set(RETDEC_ENABLE_RETDEC_TESTS
+		RETDEC_TESTS
+		RETDEC_ENABLE_RETDEC)
 set_if_all_set(RETDEC_ENABLE_SERDES_TESTS
 		RETDEC_TESTS
 		RETDEC_ENABLE_SERDES)
@@ -424,6 +434,9 @@ set_if_all_set(RETDEC_ENABLE_COMMON_TESTS
 set_if_all_set(RETDEC_ENABLE_UTILS_TESTS
 		RETDEC_TESTS
 		RETDEC_ENABLE_UTILS)
+set_if_all_set(RETDEC_ENABLE_YARACPP_TESTS
+		RETDEC_TESTS
+		RETDEC_ENABLE_YARACPP)
 
 # src depending on tests
 set_if_at_least_one_set(RETDEC_ENABLE_LLVMIR_EMUL
@@ -432,6 +445,7 @@ set_if_at_least_one_set(RETDEC_ENABLE_LLVMIR_EMUL
 # deps
 set_if_at_least_one_set(RETDEC_ENABLE_CAPSTONE
 		RETDEC_ENABLE_CAPSTONE2LLVMIR
+		RETDEC_ENABLE_COMMON
 		RETDEC_ENABLE_STACOFIN)
 
 set_if_at_least_one_set(RETDEC_ENABLE_ELFIO
@@ -442,6 +456,7 @@ set_if_at_least_one_set(RETDEC_ENABLE_GOOGLETEST
 		RETDEC_ENABLE_CAPSTONE2LLVMIR_TESTS
 		RETDEC_ENABLE_COMMON_TESTS
 		RETDEC_ENABLE_CONFIG_TESTS
+		RETDEC_ENABLE_CPDETECT_TESTS
 		RETDEC_ENABLE_CTYPES_TESTS
 		RETDEC_ENABLE_CTYPESPARSER_TESTS
 		RETDEC_ENABLE_DEMANGLER_TESTS
@@ -449,9 +464,12 @@ set_if_at_least_one_set(RETDEC_ENABLE_GOOGLETEST
 		RETDEC_ENABLE_LLVMIR_EMUL_TESTS
 		RETDEC_ENABLE_LLVMIR2HLL_TESTS
 		RETDEC_ENABLE_LOADER_TESTS
+		RETDEC_ENABLE_PELIB_TESTS
+		RETDEC_ENABLE_RETDEC_TESTS
 		RETDEC_ENABLE_SERDES_TESTS
 		RETDEC_ENABLE_UNPACKER_TESTS
-		RETDEC_ENABLE_UTILS_TESTS)
+		RETDEC_ENABLE_UTILS_TESTS
+		RETDEC_ENABLE_YARACPP_TESTS)
 
 set_if_at_least_one_set(RETDEC_ENABLE_KEYSTONE
 		RETDEC_ENABLE_CAPSTONE2LLVMIRTOOL
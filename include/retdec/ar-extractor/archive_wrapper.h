@@ -7,6 +7,7 @@
 #ifndef RETDEC_AR_EXTRACTOR_ARCHIVE_WRAPPER_H
 #define RETDEC_AR_EXTRACTOR_ARCHIVE_WRAPPER_H
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,6 +28,8 @@ class ArchiveWrapper : private retdec::utils::NonCopyable
 	public:
 		ArchiveWrapper(const std::string &archivePath, bool &succes,
 			std::string &errorMessage);
+		ArchiveWrapper(const std::uint8_t *data, std::size_t size,
+			bool &succes, std::string &errorMessage);
 
 		/// @brief Getters.
 		/// @{
@@ -55,6 +58,10 @@ class ArchiveWrapper : private retdec::utils::NonCopyable
 			const std::string &outputPath = "") const;
 		bool extractByIndex(const std::size_t index, std::string &errorMessage,
 			const std::string &outputPath = "") const;
+		bool extractByName(const std::string &name,
+			std::vector<std::uint8_t> &result, std::string &errorMessage) const;
+		bool extractByIndex(const std::size_t index,
+			std::vector<std::uint8_t> &result, std::string &errorMessage) const;
 		/// @}
 
 	private:
@@ -65,6 +72,11 @@ class ArchiveWrapper : private retdec::utils::NonCopyable
 
 		/// @brief Auxiliary methods.
 		/// @{
+		bool init(std::string &errorMessage);
+		bool findByName(const std::string &name, llvm::StringRef &content,
+			std::string &errorMessage) const;
+		bool findByIndex(const std::size_t index, llvm::StringRef &content,
+			std::string &childName, std::string &errorMessage) const;
 		bool getNames(std::vector<std::string> &result,
 			std::string &errorMessage) const;
 		bool getCount(std::size_t &count, std::string &errorMessage) const;
@@ -3,9 +3,9 @@
 * @brief Reaching definitions analysis (RDA) builds UD and DU chains.
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 *
-* Right now, this works on an entire module. But we could insert an another layer
-* that represents functions. Then it would be possible to associate BBs with
-* functions that own them and recompute RDA only for the selected function.
+* Definitions of each function are densely numbered and the data-flow problem
+* is solved on bit vectors by a worklist algorithm. Functions are independent,
+* they are analysed in parallel when the whole module is processed.
 */
 
 #ifndef RETDEC_BIN2LLVMIR_ANALYSES_REACHING_DEFINITIONS_H
@@ -90,8 +90,6 @@ class BasicBlockEntry
 				std::ostream& out,
 				const BasicBlockEntry& bbe);
 
-		void initializeKillDefSets();
-		Changed initDefsOut();
 
 		const DefSet& defsFromUse(const llvm::Instruction* I) const;
 		const UseSet& usesFromDef(const llvm::Instruction* I) const;
@@ -106,13 +104,6 @@ class BasicBlockEntry
 
 		BBEntrySet prevBBs;
 
-		// defsIn is union of prevBBs' defsOuts
-		DefSet defsOut;
-		DefSet genDefs;
-		std::unordered_set<llvm::Value*> killDefs;
-
-		bool changed = false;
-
 	private:
 		unsigned id;
 };
@@ -152,18 +143,20 @@ class ReachingDefinitionsAnalysis
 				llvm::Instruction* I);
 
 	private:
+		using BasicBlockMap = std::map<const llvm::BasicBlock*, BasicBlockEntry>;
+
 		void run();
-		const BasicBlockEntry& getBasicBlockEntry(const llvm::Instruction* I) const;
-		void initializeBasicBlocks(llvm::Module& M);
-		void initializeBasicBlocks(llvm::Function& F);
-		void initializeBasicBlocksPrev();
-		void initializeKillGenSets();
-		void propagate();
-		void initializeDefsAndUses();
-		void clearInternal();
+		void run(llvm::Function& F, BasicBlockMap& bbs);
+		void initializeBasicBlocks(llvm::Function& F, BasicBlockMap& bbs);
+		void initializeBasicBlocksPrev(BasicBlockMap& bbs);
+		void initializeDefsAndUsesIndex();
 
 	private:
-		std::map<const llvm::Function*, std::map<const llvm::BasicBlock*, BasicBlockEntry>> bbMap;
+		std::map<const llvm::Function*, BasicBlockMap> bbMap;
+		/// Definitions and uses by their instructions (the first use of
+		/// instructions with more uses), for fast queries.
+		std::unordered_map<const llvm::Instruction*, const Definition*> _defs;
+		std::unordered_map<const llvm::Instruction*, const Use*> _uses;
 		bool _trackFlagRegs = false;
 		const llvm::GlobalVariable* _specialGlobal = nullptr;
 		bool _run = false;
@@ -30,6 +30,7 @@
 #include "retdec/bin2llvmir/optimizations/decoder/decoder_debug.h"
 #include "retdec/bin2llvmir/optimizations/decoder/decoder_ranges.h"
 #include "retdec/bin2llvmir/optimizations/decoder/jump_targets.h"
+#include "retdec/bin2llvmir/optimizations/decoder/speculative_disassembler.h"
 #include "retdec/bin2llvmir/utils/ir_modifier.h"
 #include "retdec/bin2llvmir/utils/symbolic_tree_match.h"
 #include "retdec/capstone2llvmir/capstone2llvmir.h"
@@ -65,6 +66,8 @@ class Decoder : public llvm::ModulePass
 	private:
 		void initTranslator();
 		void initDryRunCsInstruction();
+		void initDisassemblyStore();
+		void initSpeculativeDisassembler();
 		void initEnvironment();
 		void initEnvironmentAsm2LlvmMapping();
 		void initEnvironmentPseudoFunctions();
@@ -86,6 +89,7 @@ class Decoder : public llvm::ModulePass
 
 	private:
 		void decode();
+		void speculate();
 		bool getJumpTarget(JumpTarget& jt);
 		void decodeJumpTarget(const JumpTarget& jt);
 		std::size_t decodeJumpTargetDryRun(
@@ -98,6 +102,13 @@ class Decoder : public llvm::ModulePass
 						ByteData& bytes,
 						common::Address& addr,
 						llvm::IRBuilder<>& irb);
+		cs_mode getDisassemblyMode(cs_mode basicMode) const;
+		bool disasm(
+				cs_mode m,
+				ByteData& bytes,
+				uint64_t& addr,
+				cs_insn* insn);
+		bool disasmDryRun(ByteData& bytes, uint64_t& addr);
 
 		bool getJumpTargetsFromInstruction(
 				common::Address addr,
@@ -221,7 +232,6 @@ class Decoder : public llvm::ModulePass
 	//
 	private:
 		bool disasm_mips(
-				csh ce,
 				cs_mode m,
 				ByteData& bytes,
 				uint64_t& a,
@@ -294,11 +304,16 @@ class Decoder : public llvm::ModulePass
 		FileImage* _image = nullptr;
 		DebugFormat* _debug = nullptr;
 		NameContainer* _names = nullptr;
-		Llvm2CapstoneInsnMap* _llvm2capstone = nullptr;
 		Abi* _abi = nullptr;
 
 		std::unique_ptr<capstone2llvmir::Capstone2LlvmIrTranslator> _c2l;
 		cs_insn* _dryCsInsn = nullptr;
+		/// Instructions disassembled from the input, shared by decoding,
+		/// dry runs and static code detection.
+		std::unique_ptr<common::DisassemblyStore> _disassembly;
+		/// Disassembles queued jump targets ahead of decoding, @c nullptr
+		/// if there are no spare hardware threads.
+		std::unique_ptr<SpeculativeDisassembler> _speculation;
 
 		llvm::IRBuilder<>* _irb;
 
@@ -85,9 +85,6 @@ class JumpTarget
 		retdec::common::Address _fromAddress;
 		/// Disassembler mode that should be used for this jump target.
 		mutable cs_mode _mode = CS_MODE_BIG_ENDIAN;
-
-	public:
-		static Config* config;
 };
 
 /**
@@ -96,6 +93,8 @@ class JumpTarget
 class JumpTargets
 {
 	public:
+		void setConfig(Config* c);
+
 		auto begin();
 		auto end();
 
@@ -117,8 +116,9 @@ class JumpTargets
 	public:
 		std::set<JumpTarget> _data;
 
-	public:
-		static Config* config;
+	private:
+		/// Config of the module whose jump targets these are.
+		Config* _config = nullptr;
 };
 
 } // namespace bin2llvmir
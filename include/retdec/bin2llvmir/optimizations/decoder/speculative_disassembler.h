@@ -0,0 +1,96 @@
+/**
+* @file include/retdec/bin2llvmir/optimizations/decoder/speculative_disassembler.h
+* @brief Disassembly of jump targets ahead of their decoding.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_DECODER_SPECULATIVE_DISASSEMBLER_H
+#define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_DECODER_SPECULATIVE_DISASSEMBLER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <capstone/capstone.h>
+
+#include "retdec/common/address.h"
+#include "retdec/common/disassembly_store.h"
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Worker threads which disassemble queued code ranges into a shared
+ * disassembly store.
+ *
+ * Decoder queues ranges it is going to decode and then gets instructions
+ * from the store instead of disassembling them itself. Decoder never waits
+ * for workers, if an instruction is not in the store yet, it disassembles
+ * it on its own.
+ *
+ * Queued bytes must stay valid and unchanged until the object is destroyed.
+ */
+class SpeculativeDisassembler : private retdec::utils::NonCopyable
+{
+	public:
+		SpeculativeDisassembler(
+				common::DisassemblyStore& store,
+				cs_mode mode,
+				std::size_t threads);
+		~SpeculativeDisassembler();
+
+		void enqueue(
+				common::Address start,
+				cs_mode mode,
+				const std::uint8_t* bytes,
+				std::size_t size);
+
+	public:
+		/// Maximal number of instructions disassembled from one range.
+		static constexpr std::size_t maxRangeInstructions = 256;
+
+	private:
+		/**
+		 * Range queued for disassembly.
+		 */
+		struct Task
+		{
+			std::uint64_t start = 0;
+			cs_mode mode = CS_MODE_LITTLE_ENDIAN;
+			const std::uint8_t* bytes = nullptr;
+			std::size_t size = 0;
+		};
+		using Key = std::pair<std::uint64_t, cs_mode>;
+
+	private:
+		void work(csh handle, cs_mode handleMode);
+		void disassemble(
+				csh handle,
+				cs_mode& handleMode,
+				cs_insn* insn,
+				const Task& t);
+
+	private:
+		common::DisassemblyStore& _store;
+
+		/// guards @c _tasks, @c _enqueued and @c _stop
+		std::mutex _tasksMutex;
+		std::condition_variable _tasksCv;
+		std::deque<Task> _tasks;
+		std::set<Key> _enqueued;
+		bool _stop = false;
+
+		std::vector<csh> _handles;
+		std::vector<std::thread> _workers;
+};
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
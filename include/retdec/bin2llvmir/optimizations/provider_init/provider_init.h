@@ -7,6 +7,8 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_PROVIDER_INIT_PROVIDER_INIT_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_PROVIDER_INIT_PROVIDER_INIT_H
 
+#include <cstdint>
+
 #include <llvm/IR/Module.h>
 #include <llvm/Pass.h>
 
@@ -28,9 +30,13 @@ class ProviderInitialization : public llvm::ModulePass
 		virtual bool doFinalization(llvm::Module& m) override;
 
 		void setConfig(retdec::config::Config* c);
+		void setInputData(const std::uint8_t* data, std::size_t size);
 
 	private:
 		retdec::config::Config* _config = nullptr;
+		/// Input file content, if it was already loaded into memory.
+		const std::uint8_t* _inputData = nullptr;
+		std::size_t _inputSize = 0;
 };
 
 } // namespace bin2llvmir
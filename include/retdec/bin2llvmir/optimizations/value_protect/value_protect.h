@@ -41,6 +41,8 @@ class ValueProtect : public llvm::ModulePass
 		virtual bool runOnModule(llvm::Module& M) override;
 		bool runOnModuleCustom(llvm::Module& M, Config* c, Abi* abi);
 
+		static void clear();
+
 	private:
 		bool run();
 		bool protect();
@@ -61,7 +63,8 @@ class ValueProtect : public llvm::ModulePass
 		llvm::Module* _module = nullptr;
 		Config* _config = nullptr;
 		Abi* _abi = nullptr;
-		static std::map<llvm::Type*, llvm::Function*> _type2fnc;
+		/// Generated functions, stored in the module's provider context.
+		std::map<llvm::Type*, llvm::Function*>* _type2fnc = nullptr;
 };
 
 } // namespace bin2llvmir
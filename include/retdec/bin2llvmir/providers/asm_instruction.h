@@ -22,6 +22,8 @@
 namespace retdec {
 namespace bin2llvmir {
 
+struct AsmInstructionIndex;
+
 using Llvm2CapstoneInsnMap = typename std::map<llvm::StoreInst*, cs_insn*>;
 
 /**
@@ -29,6 +31,10 @@ using Llvm2CapstoneInsnMap = typename std::map<llvm::StoreInst*, cs_insn*>;
  *
  * This is a lightway class that contains only one llvm::StoreInst pointer.
  * I.e. this class can be passed by value instead of by reference or pointer.
+ *
+ * ASM instructions of LLVM instructions and addresses are found through
+ * a per-module index (see @c AsmInstructionIndex), which survives between
+ * passes. The IR is walked only for instructions not indexed yet.
  */
 class AsmInstruction
 {
@@ -159,6 +165,9 @@ class AsmInstruction
 		static void setLlvmToAsmGlobalVariable(
 				const llvm::Module* m,
 				llvm::GlobalVariable* gv);
+		static void addLlvmToAsmInstruction(
+				llvm::StoreInst* s,
+				cs_insn* insn);
 		static retdec::common::Address getInstructionAddress(
 				llvm::Instruction* inst);
 		static retdec::common::Address getInstructionEndAddress(
@@ -175,24 +184,16 @@ class AsmInstruction
 				llvm::Function* f);
 		static bool isLlvmToAsmInstruction(const llvm::Value* inst);
 		static void clear();
+		static void clear(const llvm::Module* m);
 
 	private:
 		const llvm::GlobalVariable* getLlvmToAsmGlobalVariablePrivate(
 				llvm::Module* m) const;
 		bool isLlvmToAsmInstructionPrivate(llvm::Value* inst) const;
-
-	private:
-		using ModuleGlobalPair = std::pair<
-				const llvm::Module*,
-				llvm::GlobalVariable*>;
-		using ModuleInstructionMap = std::pair<
-				const llvm::Module*,
-				std::map<llvm::StoreInst*, cs_insn*>>;
+		static void clearIndex(AsmInstructionIndex& index);
 
 	private:
 		llvm::StoreInst* _llvmToAsmInstr = nullptr;
-		static std::vector<ModuleGlobalPair> _module2global;
-		static std::vector<ModuleInstructionMap> _module2instMap;
 
 	public:
 		template<
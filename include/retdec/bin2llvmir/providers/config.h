@@ -206,9 +206,6 @@ class ConfigProvider
 		static bool getConfig(llvm::Module* m, Config*& c);
 		static void doFinalization(llvm::Module* m);
 		static void clear();
-
-	private:
-		static std::map<llvm::Module*, Config> _module2config;
 };
 
 } // namespace bin2llvmir
@@ -49,10 +49,6 @@ class DebugFormatProvider
 		static bool getDebugFormat(llvm::Module* m, DebugFormat*& df);
 
 		static void clear();
-
-	private:
-		/// Mapping of modules to debug info associated with them.
-		static std::map<llvm::Module*, DebugFormat> _module2debug;
 };
 
 } // namespace bin2llvmir
@@ -107,10 +107,6 @@ public:
 		Demangler *&d);
 
 	static void clear();
-
-private:
-	/// Mapping of modules to demanglers associated with them.
-	static std::map<llvm::Module *, std::unique_ptr<Demangler>> _module2demangler;
 };
 
 } // namespace bin2llvmir
@@ -32,6 +32,11 @@ class FileImage
 				llvm::Module* m,
 				const std::string& path,
 				Config* config);
+		FileImage(
+				llvm::Module* m,
+				const std::uint8_t* data,
+				std::size_t size,
+				Config* config);
 		FileImage(
 				llvm::Module* m,
 				const std::shared_ptr<retdec::fileformat::FileFormat>& ff,
@@ -122,6 +127,11 @@ class FileImageProvider
 				llvm::Module* m,
 				const std::string& path,
 				Config* config);
+		static FileImage* addFileImage(
+				llvm::Module* m,
+				const std::uint8_t* data,
+				std::size_t size,
+				Config* config);
 		static FileImage* addFileImage(
 				llvm::Module* m,
 				const std::shared_ptr<retdec::fileformat::FileFormat>& ff,
@@ -139,10 +149,6 @@ class FileImageProvider
 		static FileImage* addFileImage(
 				llvm::Module* m,
 				FileImage img);
-
-	private:
-		/// Mapping of modules to file images associated with them.
-		static std::map<llvm::Module*, FileImage> _module2image;
 };
 
 } // namespace bin2llvmir
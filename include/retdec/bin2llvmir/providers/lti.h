@@ -64,9 +64,6 @@ class LtiProvider
 		static Lti* getLti(llvm::Module* m);
 		static bool getLti(llvm::Module* m, Lti*& lti);
 		static void clear();
-
-	private:
-		static std::map<llvm::Module*, Lti> _module2lti;
 };
 
 } // namespace bin2llvmir
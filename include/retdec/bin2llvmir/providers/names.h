@@ -211,9 +211,6 @@ class NamesProvider
 		static NameContainer* getNames(llvm::Module* m);
 		static bool getNames(llvm::Module* m, NameContainer*& names);
 		static void clear();
-
-	private:
-		static std::map<llvm::Module*, NameContainer> _module2names;
 };
 
 } // namespace bin2llvmir
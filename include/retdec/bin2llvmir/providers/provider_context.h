@@ -0,0 +1,118 @@
+/**
+ * @file include/retdec/bin2llvmir/providers/provider_context.h
+ * @brief Per-module storage of all the data held by bin2llvmir providers.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_BIN2LLVMIR_PROVIDERS_PROVIDER_CONTEXT_H
+#define RETDEC_BIN2LLVMIR_PROVIDERS_PROVIDER_CONTEXT_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#include <capstone/capstone.h>
+
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/ValueHandle.h>
+#include <llvm/IR/ValueMap.h>
+
+namespace retdec {
+namespace bin2llvmir {
+
+class Abi;
+class Config;
+class DebugFormat;
+class Demangler;
+class FileImage;
+class Lti;
+class NameContainer;
+
+/**
+ * Index of ASM instructions (special LLVM to ASM mapping stores) kept alive
+ * across passes. It is maintained by @c AsmInstruction, which uses it instead
+ * of walking the IR. See @c AsmInstruction for its invalidation rules.
+ */
+struct AsmInstructionIndex
+{
+	/**
+	 * Owning ASM instruction of an LLVM instruction.
+	 */
+	struct Owner
+	{
+		/// Mapping store, becomes null when the store is erased.
+		llvm::WeakVH llvmToAsm;
+		/// Epoch of the index when the owner was found.
+		std::size_t epoch = 0;
+	};
+
+	/// Instructions are only dropped from the index when erased, RAUW does
+	/// not move the owner to the new value.
+	struct InstructionConfig
+			: llvm::ValueMapConfig<const llvm::Instruction*>
+	{
+		enum { FollowRAUW = false };
+	};
+
+	/// Mapping stores by ASM instruction addresses.
+	std::unordered_map<std::uint64_t, llvm::WeakVH> byAddress;
+	/// Owning ASM instructions of LLVM instructions.
+	llvm::ValueMap<const llvm::Instruction*, Owner, InstructionConfig>
+			byInstruction;
+	/// Owners found in older epochs are not valid anymore.
+	std::size_t epoch = 0;
+};
+
+/**
+ * Decompilation context -- everything providers know about one module.
+ *
+ * Providers (@c ConfigProvider, @c FileImageProvider, @c AbiProvider, ...)
+ * used to keep their data in process-wide maps. Now, all of it lives in one
+ * context object per @c llvm::Module. Passes still reach it through the
+ * module via the providers' static interface, but two decompilations of two
+ * different modules do not share (or clear) any state. Therefore, it is
+ * possible to run several decompilations in parallel threads.
+ *
+ * Access to the module to context mapping is synchronized. The objects
+ * inside the context are not -- a single module must be processed by
+ * a single thread at a time, as required by LLVM anyway.
+ */
+class ProviderContext
+{
+	public:
+		~ProviderContext();
+
+		static ProviderContext* get(const llvm::Module* m);
+		static ProviderContext& getOrCreate(const llvm::Module* m);
+		static void release(const llvm::Module* m);
+		static void forEach(const std::function<void(ProviderContext&)>& f);
+
+	// Members are destroyed in the reverse order -- objects that use other
+	// objects must be declared after them.
+	//
+	public:
+		std::unique_ptr<Config> config;
+		std::unique_ptr<FileImage> fileImage;
+		std::unique_ptr<Abi> abi;
+		std::unique_ptr<Demangler> demangler;
+		std::unique_ptr<DebugFormat> debugFormat;
+		std::unique_ptr<Lti> lti;
+		std::unique_ptr<NameContainer> names;
+
+		/// Special global variable used to map LLVM IR to ASM instructions.
+		llvm::GlobalVariable* llvmToAsmGlobal = nullptr;
+		/// Mapping of LLVM IR to ASM instructions to Capstone instructions.
+		std::map<llvm::StoreInst*, cs_insn*> llvmToCapstoneInsns;
+		/// Index of ASM instructions by addresses and LLVM instructions.
+		AsmInstructionIndex asmInstructionIndex;
+		/// Functions generated by @c ValueProtect, by their return types.
+		std::map<llvm::Type*, llvm::Function*> valueProtectFunctions;
+};
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
@@ -433,6 +433,20 @@ class Capstone2LlvmIrTranslator
 				std::size_t& size,
 				retdec::common::Address& a,
 				llvm::IRBuilder<>& irb) = 0;
+		/**
+		 * Translate one already disassembled assembly instruction.
+		 * @param insn  Capstone instruction disassembled by a Capstone engine
+		 *              with the same architecture, mode and options as the
+		 *              one used by this translator. Translator takes
+		 *              ownership of it, i.e. it ends up in the result.
+		 * @param irb   LLVM IR builder used to create LLVM IR translation.
+		 *              Translated LLVM IR instructions are created at its
+		 *              current position.
+		 * @return See @c TranslationResult structure.
+		 */
+		virtual TranslationResultOne translateOne(
+				cs_insn* insn,
+				llvm::IRBuilder<>& irb) = 0;
 //
 //==============================================================================
 // Capstone related getters and query methods.
@@ -0,0 +1,140 @@
+/**
+ * @file include/retdec/common/disassembly_store.h
+ * @brief Cache of disassembled instructions shared by several consumers.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_COMMON_DISASSEMBLY_STORE_H
+#define RETDEC_COMMON_DISASSEMBLY_STORE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <capstone/capstone.h>
+
+namespace retdec {
+namespace common {
+
+/**
+ * Capstone instructions of one image keyed by address and mode.
+ *
+ * Consumers which disassemble the same image (decoder, its dry runs,
+ * static code detection, ...) share one store, so that bytes are not
+ * disassembled again by each of them. Modes are complete Capstone modes
+ * (basic and extra mode), e.g. ARM and Thumb instructions on the same
+ * address are cached separately.
+ *
+ * An instruction is returned from the cache only if Capstone saw the same
+ * bytes when it was disassembled -- either both sizes were big enough for
+ * any instruction, or they were the same. Therefore, the result is always
+ * the same one as if the bytes were disassembled again.
+ *
+ * Instructions are stored in arena-allocated slots. When all the slots the
+ * memory budget allows are used, the whole cache is dropped and filled
+ * again. Instructions are always copied out, so this never invalidates
+ * instructions of consumers.
+ *
+ * All methods may be called from several threads at once.
+ */
+class DisassemblyStore
+{
+	public:
+		/// Default memory budget in bytes.
+		static constexpr std::size_t defaultBudget = 64 * 1024 * 1024;
+		/// Capstone never looks at more bytes to disassemble one instruction.
+		static constexpr std::size_t maxInstructionSize = 16;
+
+	public:
+		DisassemblyStore(
+				cs_arch arch,
+				cs_mode mode,
+				std::size_t budget = defaultBudget);
+		~DisassemblyStore();
+
+		DisassemblyStore(const DisassemblyStore&) = delete;
+		DisassemblyStore& operator=(const DisassemblyStore&) = delete;
+
+		/// @name Disassembling
+		/// @{
+		bool disassemble(
+				cs_mode mode,
+				const std::uint8_t** code,
+				std::size_t* size,
+				std::uint64_t* address,
+				cs_insn* insn);
+		bool find(
+				cs_mode mode,
+				std::uint64_t address,
+				std::size_t size,
+				cs_insn* insn) const;
+		bool contains(cs_mode mode, std::uint64_t address) const;
+		void insert(cs_mode mode, const cs_insn& insn, std::size_t available);
+		void clear();
+		/// @}
+
+		/// @name Getters
+		/// @{
+		bool isOk() const;
+		cs_arch getArchitecture() const;
+		std::size_t getBudget() const;
+		std::size_t getCapacity() const;
+		std::size_t getInstructionCount() const;
+		/// @}
+
+	private:
+		/**
+		 * One cached instruction with its details.
+		 */
+		struct Slot
+		{
+			cs_insn insn;
+			cs_detail detail;
+			/// number of bytes available when it was disassembled
+			std::size_t available;
+		};
+		using Key = std::pair<std::uint64_t, cs_mode>;
+		struct KeyHash
+		{
+			std::size_t operator()(const Key& k) const
+			{
+				return std::hash<std::uint64_t>()(k.first)
+						^ (std::hash<int>()(k.second) << 1);
+			}
+		};
+
+	private:
+		const Slot* findSlot(
+				cs_mode mode,
+				std::uint64_t address,
+				std::size_t size) const;
+		Slot* allocateSlot();
+
+	private:
+		cs_arch _arch;
+		std::size_t _budget = 0;
+		/// maximal number of slots allowed by the budget
+		std::size_t _capacity = 0;
+
+		/// guards @c _handle and @c _handleMode
+		std::mutex _handleMutex;
+		csh _handle = 0;
+		cs_mode _handleMode;
+		bool _handleOk = false;
+
+		/// guards the rest
+		mutable std::mutex _mutex;
+		std::unordered_map<Key, Slot*, KeyHash> _index;
+		std::vector<std::unique_ptr<Slot[]>> _chunks;
+		std::size_t _chunkSize = 0;
+		std::size_t _used = 0;
+};
+
+} // namespace common
+} // namespace retdec
+
+#endif
@@ -32,6 +32,8 @@ class Parameters
 		bool isSelectedDecodeOnly() const;
 		bool isDetectStaticCode() const;
 		bool isTimeout() const;
+		bool isFixedPointPipeline() const;
+		bool isPipelineBudget() const;
 		bool isMaxMemoryLimitHalfRam() const;
 		bool isBackendNoOpts() const;
 		bool isBackendEmitCfg() const;
@@ -59,12 +61,18 @@ class Parameters
 		void setOutputLlvmirFile(const std::string& file);
 		void setOutputConfigFile(const std::string& file);
 		void setOutputUnpackedFile(const std::string& file);
+		void setOutputProfileFile(const std::string& file);
 		void setOutputFormat(const std::string& format);
 		void setLogFile(const std::string& file);
 		void setErrFile(const std::string& file);
 		void setMaxMemoryLimit(uint64_t limit);
 		void setIsMaxMemoryLimitHalfRam(bool f);
 		void setTimeout(uint64_t seconds);
+		void setIsFixedPointPipeline(bool b);
+		void setPipelineBudget(uint64_t seconds);
+		void setDisassemblyCacheSize(uint64_t bytes);
+		void setDecoderThreads(uint64_t threads);
+		void setBackendThreads(uint64_t threads);
 		void setEntryPoint(const retdec::common::Address& a);
 		void setMainAddress(const retdec::common::Address& a);
 		void setSectionVMA(const retdec::common::Address& a);
@@ -96,11 +104,16 @@ class Parameters
 		const std::string& getOutputLlvmirFile() const;
 		const std::string& getOutputConfigFile() const;
 		const std::string& getOutputUnpackedFile() const;
+		const std::string& getOutputProfileFile() const;
 		const std::string& getOutputFormat() const;
 		const std::string& getLogFile() const;
 		const std::string& getErrFile() const;
 		uint64_t getMaxMemoryLimit() const;
 		uint64_t getTimeout() const;
+		uint64_t getPipelineBudget() const;
+		uint64_t getDisassemblyCacheSize() const;
+		uint64_t getDecoderThreads() const;
+		uint64_t getBackendThreads() const;
 		retdec::common::Address getEntryPoint() const;
 		retdec::common::Address getMainAddress() const;
 		retdec::common::Address getSectionVMA() const;
@@ -161,12 +174,25 @@ class Parameters
 		std::string _outputLlFile;
 		std::string _outputConfigFile;
 		std::string _outputUnpackedFile;
+		/// Per-pass profile is written into this file, if it is set.
+		std::string _outputProfileFile;
 		std::string _outputFormat;
 		std::string _logFile;
 		std::string _errFile;
 		uint64_t _maxMemoryLimit = 0;
 		bool _maxMemoryLimitHalfRam = true;
 		uint64_t _timeout = 0;
+		/// Split LLVM passes into groups and skip repetitions of groups
+		/// which do not change the module anymore.
+		bool _fixedPointPipeline = false;
+		/// Time (in seconds) after which repetitions of pass groups are
+		/// skipped even if they would change the module, zero means no limit.
+		uint64_t _pipelineBudget = 0;
+		/// Memory budget (in bytes) of cached disassembled instructions.
+		uint64_t _disassemblyCacheSize = 64 * 1024 * 1024;
+		/// Number of threads of the decoder including the decoding one,
+		/// zero means as many as the hardware supports.
+		uint64_t _decoderThreads = 0;
 
 		bool _detectStaticCode = true;
 		std::string _backendDisabledOpts;
@@ -183,6 +209,8 @@ class Parameters
 		bool _backendNoVarRenaming = false;
 		bool _backendNoCompoundOperators = false;
 		bool _backendNoSymbolicNames = false;
+		/// Maximal number of threads optimizing functions in the back-end.
+		uint64_t _backendThreads = 1;
 
 		retdec::common::Address _entryPoint;
 		retdec::common::Address _mainAddress;
@@ -15,6 +15,13 @@
 #include "retdec/cpdetect/search.h"
 
 namespace retdec {
+
+namespace yaracpp {
+
+class YaraScanCoordinator;
+
+} // namespace yaracpp
+
 namespace cpdetect {
 
 /**
@@ -26,6 +33,8 @@ class CompilerDetector : private retdec::utils::NonCopyable
 		retdec::fileformat::FileFormat &fileParser;
 		DetectParams &cpParams;
 		std::vector<std::string> externalDatabase;
+		/// scan shared with other YARA consumers (may be @c nullptr)
+		yaracpp::YaraScanCoordinator *signatureScan = nullptr;
 
 		/// @name External databases parsing
 		/// @{
@@ -34,6 +43,7 @@ class CompilerDetector : private retdec::utils::NonCopyable
 
 		/// @name Other methods
 		/// @{
+		void addSignatureRules(yaracpp::YaraScanCoordinator &scan);
 		void removeCompilersWithLessSimilarity(double ratio);
 		void removeUnusedCompilers();
 		/// @}
@@ -74,6 +84,7 @@ class CompilerDetector : private retdec::utils::NonCopyable
 
 		/// @name Detection methods
 		/// @{
+		void setSignatureScan(yaracpp::YaraScanCoordinator *scan);
 		ReturnCode getAllInformation();
 		/// @}
 };
@@ -7,6 +7,10 @@
 #ifndef RETDEC_CPDETECT_SEARCH_H
 #define RETDEC_CPDETECT_SEARCH_H
 
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
 #include "retdec/cpdetect/cptypes.h"
 #include "retdec/fileformat/file_format/file_format.h"
 
@@ -34,17 +38,64 @@ class Search
 
 				/// @name Jump getters
 				/// @{
-				std::string getSlash() const;
+				const std::string& getSlash() const;
 				std::size_t getSlashNibbleSize() const;
 				std::size_t getBytesAfter() const;
 				/// @}
 		};
 	private:
+		/**
+		 * One nibble of compiled signature pattern
+		 */
+		struct PatternNibble
+		{
+			enum class Type : std::uint8_t
+			{
+				VALUE, ///< nibble must have the given value
+				ANY,   ///< any nibble
+				SLASH  ///< relative jump
+			};
+
+			Type type;
+			/// value of nibble (out of nibble range for invalid characters)
+			std::uint8_t value;
+		};
+
+		/**
+		 * Signature pattern compiled for matching on bytes
+		 */
+		struct CompiledPattern
+		{
+			/// nibbles of pattern
+			std::vector<PatternNibble> nibbles;
+			/// number of significant nibbles of pattern
+			unsigned long long impNibbles = 0;
+		};
+
+		/**
+		 * Unslashed pattern aligned to bytes
+		 */
+		struct MaskedBytes
+		{
+			/// values of significant bits
+			std::vector<std::uint8_t> values;
+			/// masks of significant bits
+			std::vector<std::uint8_t> masks;
+			/// index of fully specified byte used to find candidates
+			std::size_t anchor = 0;
+			/// @c true if pattern can never match
+			bool invalid = false;
+		};
+
 		retdec::fileformat::FileFormat &parser;
-		/// content of file in hexadecimal string representation
-		std::string nibbles;
+		/// content of file used for signature search (in little endian)
+		const std::uint8_t *data;
+		/// number of bytes used for signature search
+		std::size_t dataSize;
+		/// content of big endian file converted to little endian
+		std::vector<std::uint8_t> swappedData;
 		/// content of file as plain string
-		std::string plain;
+		std::string_view plain;
 		/// representation of supported relative jumps
 		std::vector<RelativeJump> jumps;
 		/// average length of one slash representation
@@ -60,6 +111,26 @@ class Search
 		bool haveSlashes() const;
 		std::size_t nibblesFromBytes(std::size_t nBytes) const;
 		std::size_t bytesFromNibbles(std::size_t nNibbles) const;
+		std::size_t getNibbleCount() const;
+		std::uint8_t getNibble(std::size_t index) const;
+		bool hasNibbles(const std::string &hex, std::size_t index) const;
+		CompiledPattern compilePattern(
+				const std::string &signPattern,
+				bool unslashed) const;
+		MaskedBytes alignPattern(
+				const CompiledPattern &pattern,
+				std::size_t shift) const;
+		bool findMaskedBytes(
+				const MaskedBytes &pattern,
+				std::size_t first,
+				std::size_t last) const;
+		unsigned long long exactComparison(
+				const CompiledPattern &pattern,
+				std::size_t fileIndex) const;
+		bool countSimilarity(
+				const CompiledPattern &pattern,
+				Similarity &sim,
+				std::size_t fileIndex) const;
 		/// @}
 	public:
 		Search(retdec::fileformat::FileFormat &fileParser);
@@ -72,8 +143,7 @@ class Search
 
 		/// @name Getters
 		/// @{
-		const std::string& getNibbles() const;
-		const std::string& getPlainString() const;
+		std::string_view getPlainString() const;
 		/// @}
 
 		/// @name Jump methods
@@ -31,6 +31,11 @@ const std::set<std::string> EXTERNAL_DATABASE_SUFFIXES =
 const std::string YARA_RULES_PATH =
 		"../share/retdec/support/generic/yara_patterns/tools/";
 
+/*
+ * Name under which signatures are registered in a shared YARA scan.
+ */
+const std::string YARA_SCAN_CONSUMER = "cpdetect";
+
 } // namespace cpdetect
 } // namespace retdec
 
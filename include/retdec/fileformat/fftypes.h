@@ -70,7 +70,15 @@ enum LoadFlags
 	NONE              = 0,
 	NO_FILE_HASHES    = 1,
 	NO_VERBOSE_HASHES = 2,
-	DETECT_STRINGS    = 4
+	DETECT_STRINGS    = 4,
+	/// Do not copy the input into memory. An input file is memory-mapped,
+	/// input data passed to the constructor are used directly and must
+	/// outlive the file format object.
+	NO_INPUT_COPY     = 8,
+	/// Load parts which are not needed for code analysis (resources,
+	/// certificates, .NET and Visual Basic headers, anomalies, loader
+	/// error) only when they are first accessed.
+	LAZY_LOADING      = 16
 };
 
 } // namespace fileformat
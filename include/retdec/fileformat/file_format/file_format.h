@@ -7,15 +7,22 @@
 #ifndef RETDEC_FILEFORMAT_FILE_FORMAT_FILE_FORMAT_H
 #define RETDEC_FILEFORMAT_FILE_FORMAT_FILE_FORMAT_H
 
+#include <atomic>
 #include <fstream>
 #include <initializer_list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <utility>
 #include <vector>
 
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
 #include "retdec/utils/byte_value_storage.h"
+#include "retdec/utils/interval_index.h"
 #include "retdec/utils/non_copyable.h"
 #include "retdec/fileformat/fftypes.h"
 #include "retdec/fileformat/utils/byte_array_buffer.h"
@@ -44,11 +51,31 @@ struct LoaderErrorInfo
 class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils::NonCopyable
 {
 	private:
-		byte_array_buffer auxBuff;               ///< auxiliary input buffer
-		std::ifstream auxFStream;                ///< auxiliary input file stream
-		std::istream auxIStream;                 ///< auxiliary input stream
-		std::vector<unsigned char> *loadedBytes; ///< reference to serialized content of input file
-		LoadFlags loadFlags;                     ///< load flags for configurable file loading
+		std::unique_ptr<llvm::MemoryBuffer> mappedInput; ///< memory-mapped input file (if it is not copied)
+		byte_array_buffer auxBuff;                       ///< auxiliary input buffer
+		std::ifstream auxFStream;                        ///< auxiliary input file stream
+		std::istream auxIStream;                         ///< auxiliary input stream
+		llvm::ArrayRef<unsigned char> inputBytes;        ///< content of input file
+		llvm::ArrayRef<unsigned char> loadedBytes;       ///< serialized content of input file
+		LoadFlags loadFlags;                             ///< load flags for configurable file loading
+
+		/// @name Indexes of sections and segments
+		/// @{
+		mutable retdec::utils::IntervalIndex<const Section*> sectionAddressIndex; ///< sections by addresses
+		mutable retdec::utils::IntervalIndex<const Section*> sectionOffsetIndex;  ///< sections by offsets
+		mutable retdec::utils::IntervalIndex<const Segment*> segmentAddressIndex; ///< segments by addresses
+		mutable retdec::utils::IntervalIndex<const Segment*> segmentOffsetIndex;  ///< segments by offsets
+		mutable std::size_t indexedSections = 0;                                  ///< number of indexed sections
+		mutable std::size_t indexedSegments = 0;                                  ///< number of indexed segments
+		mutable std::atomic<bool> secSegIndexesValid{false};                     ///< @c true if indexes are up to date
+		mutable std::mutex secSegIndexesMutex;                                    ///< guards building of indexes
+		/// @}
+
+		/// @name Lazily loaded parts
+		/// @{
+		mutable std::atomic<std::uint32_t> loadedParts{0};                       ///< bit mask of loaded parts
+		mutable std::recursive_mutex loadedPartsMutex;                            ///< guards loading of parts
+		/// @}
 
 		/// @name Initialization methods
 		/// @{
@@ -56,11 +83,30 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		void initStream();
 		/// @}
 
+		/// @name Auxiliary methods
+		/// @{
+		void updateSecSegIndexes() const;
+		/// @}
+
 		/// @name Pure virtual initialization methods
 		/// @{
 		virtual std::size_t initSectionTableHashOffsets() = 0;
 		/// @}
 	protected:
+		/**
+		 * Parts of file format which are not needed for code analysis. With
+		 * @c LoadFlags::LAZY_LOADING, they are loaded on first use.
+		 */
+		enum LazyPart : std::uint32_t
+		{
+			LAZY_RESOURCES    = 1,
+			LAZY_CERTIFICATES = 2,
+			LAZY_DOTNET       = 4,
+			LAZY_VISUAL_BASIC = 8,
+			LAZY_ANOMALIES    = 16,
+			LAZY_LOADER_ERROR = 32
+		};
+
 		std::string crc32;                                                ///< CRC32 of file content
 		std::string md5;                                                  ///< MD5 of file content
 		std::string sha256;                                               ///< SHA256 of file content
@@ -74,7 +120,7 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		std::vector<SymbolTable*> symbolTables;                           ///< symbol tables
 		std::vector<RelocationTable*> relocationTables;                   ///< relocation tables
 		std::vector<DynamicTable*> dynamicTables;                         ///< tables with dynamic records
-		std::vector<unsigned char> bytes;                                 ///< content of file as bytes
+		std::vector<unsigned char> bytes;                                 ///< content of file as bytes (if it is copied)
 		std::vector<String> strings;                                      ///< detected strings
 		std::vector<ElfNoteSecSeg> noteSecSegs;                           ///< note sections or segemnts found in ELF file
 		std::set<std::uint64_t> unknownRelocs;                            ///< unknown relocations
@@ -98,6 +144,7 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		/// @name Clear methods
 		/// @{
 		void clear();
+		void invalidateSecSegIndexes();
 		/// @}
 
 		/// @name Protected detection methods
@@ -105,8 +152,16 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		void computeSectionTableHashes();
 		/// @}
 
+		/// @name Lazy loading methods
+		/// @{
+		void loadLazyParts();
+		void ensureLoaded(LazyPart part) const;
+		virtual void loadLazyPart(LazyPart part);
+		/// @}
+
 		/// @name Setters
 		/// @{
+		void setBytes(std::vector<unsigned char> *iBytes);
 		void setLoadedBytes(std::vector<unsigned char> *lBytes);
 		/// @}
 
@@ -124,9 +179,8 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 				std::size_t bytesPerWord = 4,
 				retdec::common::Address entryPoint = retdec::common::Address::Undefined,
 				retdec::common::Address sectionVMA = retdec::common::Address::Undefined);
-		void loadStrings();
-		void loadStrings(StringType type, std::size_t charSize);
-		void loadStrings(StringType type, std::size_t charSize, const SecSeg* secSeg);
+		void loadStrings(std::size_t threads = 1);
+		void loadStrings(const SecSeg* secSeg, std::vector<String>& result) const;
 		void loadImpHash();
 		void loadExpHash();
 		void loadResourceIconHash();
@@ -262,8 +316,8 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		const std::vector<SymbolTable*>& getSymbolTables() const;
 		const std::vector<RelocationTable*>& getRelocationTables() const;
 		const std::vector<DynamicTable*>& getDynamicTables() const;
-		const std::vector<unsigned char>& getBytes() const;
-		const std::vector<unsigned char>& getLoadedBytes() const;
+		llvm::ArrayRef<unsigned char> getBytes() const;
+		llvm::ArrayRef<unsigned char> getLoadedBytes() const;
 		const unsigned char* getBytesData() const;
 		const unsigned char* getLoadedBytesData() const;
 		const std::vector<String>& getStrings() const;
@@ -125,8 +125,14 @@ class RawDataFormat : public FileFormat
 			assert(pd && "Invalid data");
 			assert(section && "Section must be initialized in constructor");
 			std::vector<unsigned char> aBytes(pd, pd + sizeof(d));
+			if (getBytesData() != bytes.data())
+			{
+				// Input was not copied, it has to be copied before modification.
+				bytes.assign(getBytes().begin(), getBytes().end());
+			}
 			const auto pos = bytes.size();
 			bytes.insert(bytes.end(), aBytes.begin(), aBytes.end());
+			setBytes(&bytes);
 			section->setSizeInFile(bytes.size());
 			section->setSizeInMemory(bytes.size());
 			section->load(this);
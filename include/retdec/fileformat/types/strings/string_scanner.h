@@ -0,0 +1,37 @@
+/**
+ * @file include/retdec/fileformat/types/strings/string_scanner.h
+ * @brief Scanner of printable strings in binary data.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_FILEFORMAT_TYPES_STRINGS_STRING_SCANNER_H
+#define RETDEC_FILEFORMAT_TYPES_STRINGS_STRING_SCANNER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include "retdec/fileformat/types/strings/character_iterator.h"
+#include "retdec/fileformat/types/strings/string.h"
+
+namespace retdec {
+namespace fileformat {
+
+/**
+ * Callback for found strings.
+ * Gets type of the string, its offset in scanned data and its content.
+ */
+using StringCallback = std::function<void(StringType, std::size_t, std::string&&)>;
+
+std::size_t scanStrings(
+		const unsigned char *data,
+		std::size_t size,
+		CharacterEndianness endian,
+		std::size_t minLength,
+		std::size_t maxCount,
+		const StringCallback &callback);
+
+} // namespace fileformat
+} // namespace retdec
+
+#endif
@@ -7,11 +7,14 @@
 #ifndef RETDEC_LLVMIR2HLL_ANALYSIS_DEF_USE_ANALYSIS_H
 #define RETDEC_LLVMIR2HLL_ANALYSIS_DEF_USE_ANALYSIS_H
 
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <set>
 #include <vector>
 
+#include <llvm/ADT/BitVector.h>
+
 #include "retdec/llvmir2hll/graphs/cfg/cfg.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
 #include "retdec/utils/non_copyable.h"
@@ -38,7 +41,10 @@ public:
 	using StmtVarPair = std::pair<ShPtr<Statement>, ShPtr<Variable>>;
 
 	/// Set of (statement, variable) pairs.
-	using StmtVarPairSet = std::set<StmtVarPair>;
+	///
+	/// A pair is represented by its index in @c pairs, so that the sets can be
+	/// united and subtracted a machine word at a time.
+	using StmtVarPairSet = llvm::BitVector;
 
 	/// Mapping of a CFG node into a set of (statement, variable) pairs.
 	using NodePairMap = std::map<ShPtr<CFG::Node>, StmtVarPairSet>;
@@ -62,6 +68,13 @@ public:
 	/// in def-use chains.
 	std::function<bool (ShPtr<Variable>)> shouldBeIncluded;
 
+	/// All (statement, variable) pairs in @c kill, @c gen, @c in, and @c out.
+	/// The index of a pair is its ID in these sets.
+	std::vector<StmtVarPair> pairs;
+
+	/// Mapping of a (statement, variable) pair into its index in @c pairs.
+	std::map<StmtVarPair, std::size_t> pairIds;
+
 	/// Def-use chain for each statement @c s that defines a variable @c x (the
 	/// <tt>DU(s, x)</tt> set in [ItC]).
 	DefUseChain du;
@@ -126,6 +139,8 @@ private:
 		ShPtr<ValueAnalysis> va, ShPtr<VarUsesVisitor> vuv = nullptr);
 
 	void computeGenAndKill(ShPtr<DefUseChains> ducs);
+	static std::size_t getPairId(ShPtr<DefUseChains> ducs,
+		const DefUseChains::StmtVarPair &pair);
 	void computeGenAndKillForNode(ShPtr<DefUseChains> ducs,
 		ShPtr<CFG::Node> node);
 	void computeInAndOut(ShPtr<DefUseChains> ducs);
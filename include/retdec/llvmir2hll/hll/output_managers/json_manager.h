@@ -7,6 +7,7 @@
 #ifndef RETDEC_LLVMIR2HLL_HLL_OUTPUT_MANAGERS_JSON_MANAGER_H
 #define RETDEC_LLVMIR2HLL_HLL_OUTPUT_MANAGERS_JSON_MANAGER_H
 
+#include <cstdint>
 #include <stack>
 
 #include <rapidjson/writer.h>
@@ -27,7 +28,7 @@ template <typename Writer>
 class JsonOutputManager : public OutputManager
 {
 	public:
-		JsonOutputManager(llvm::raw_ostream& out);
+		JsonOutputManager(llvm::raw_ostream& out, bool compact = false);
 		virtual void finalize() override;
 
 	public:
@@ -59,15 +60,28 @@ class JsonOutputManager : public OutputManager
 		virtual void addressPop() override;
 
 	private:
-		void jsonToken(const std::string& k, const std::string& v);
+		void jsonToken(std::size_t k, const std::string& v);
 		void generateAddressEntry(Address a);
+		void flush();
 
 	private:
 		llvm::raw_ostream& _out;
 
+		/// Buffer for the JSON, periodically flushed into @c _out.
 		rapidjson::StringBuffer sb;
 		Writer writer;
 
+		/**
+		 * Emit the compact format: the object starts with a table of token
+		 * kinds and the tokens are stored as a flat array of
+		 * (kind index, value) pairs. An address entry is a pair of the
+		 * @c addr kind index and the difference from the previous defined
+		 * address (or null if the address is undefined).
+		 */
+		bool _compact = false;
+		/// The last emitted defined address (compact format only).
+		uint64_t _lastAddr = 0;
+
 		std::stack<std::pair<Address, bool>> _addrs;
 		std::pair<Address, bool> _addrToGenerate;
 		/**
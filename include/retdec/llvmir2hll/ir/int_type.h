@@ -8,6 +8,7 @@
 #define RETDEC_LLVMIR2HLL_IR_INT_TYPE_H
 
 #include <map>
+#include <mutex>
 
 #include "retdec/llvmir2hll/ir/type.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
@@ -57,6 +58,10 @@ private:
 	/// Set of already created unsigned integer types of the given size.
 	static SizeToIntTypeMap createdUnsignedTypes;
 
+	/// Guards the sets of already created types (modules may be converted
+	/// in parallel).
+	static std::mutex createdTypesMutex;
+
 private:
 	// Since instances are created by calling the static function create(), the
 	// constructor can be private.
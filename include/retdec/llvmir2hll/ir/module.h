@@ -30,6 +30,7 @@ class Config;
 class Expression;
 class Function;
 class GlobalVarDef;
+class NodeArena;
 class Semantics;
 class Variable;
 
@@ -59,6 +60,8 @@ public:
 	ShPtr<Semantics> getSemantics() const;
 	ShPtr<Config> getConfig() const;
 
+	void setNodeArena(ShPtr<NodeArena> arena);
+
 	/// @name Global Variables Accessors
 	/// @{
 	void addGlobalVar(ShPtr<Variable> var, ShPtr<Expression> init = nullptr);
@@ -184,6 +187,10 @@ private:
 	using FuncAddressRangeMap = std::map<ShPtr<Function>, AddressRange>;
 
 private:
+	/// Arena of nodes of the module. It is declared first, so it is released
+	/// after all the nodes owned by the module.
+	ShPtr<NodeArena> nodeArena;
+
 	/// Original module from which this module has been created.
 	const llvm::Module *llvmModule;
 
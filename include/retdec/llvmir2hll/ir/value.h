@@ -7,6 +7,7 @@
 #ifndef RETDEC_LLVMIR2HLL_IR_VALUE_H
 #define RETDEC_LLVMIR2HLL_IR_VALUE_H
 
+#include <cstddef>
 #include <iosfwd>
 #include <string>
 
@@ -25,7 +26,8 @@ namespace llvmir2hll {
 /**
 * @brief A base class of all objects a module can contain.
 *
-* Instances of this class have reference object semantics.
+* Instances of this class have reference object semantics. They are allocated
+* by NodeAllocator.
 */
 class Value: public Visitable, public Metadatable<std::string>,
 		public SharableFromThis<Value>, public Observer<Value>,
@@ -68,6 +70,12 @@ public:
 
 	std::string getTextRepr();
 
+	/// @name Allocation
+	/// @{
+	static void *operator new(std::size_t size);
+	static void operator delete(void *ptr, std::size_t size) noexcept;
+	/// @}
+
 protected:
 	Value() = default;
 };
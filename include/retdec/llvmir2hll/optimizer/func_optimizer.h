@@ -7,6 +7,9 @@
 #ifndef RETDEC_LLVMIR2HLL_OPTIMIZER_FUNC_OPTIMIZER_H
 #define RETDEC_LLVMIR2HLL_OPTIMIZER_FUNC_OPTIMIZER_H
 
+#include <cstddef>
+#include <functional>
+
 #include "retdec/llvmir2hll/optimizer/optimizer.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
 
@@ -39,9 +42,64 @@ class Module;
 * The functions are not optimized in any particular order. Optimizations for a
 * single function should not affect optimizations of other functions.
 *
+* Optimizers which change only the optimized function and keep no state between
+* functions may return @c true from isFunctionLocal(). Such optimizers can
+* optimize several functions at once (see optimizeInParallel()).
+*
 * Instances of this class have reference object semantics.
 */
 class FuncOptimizer: public Optimizer {
+public:
+	/**
+	* @brief Returns @c true if the optimizer may run on several functions at
+	*        once, each of them optimized by its own instance, @c false
+	*        otherwise.
+	*
+	* Only optimizers which change nothing but the optimized function (and
+	* its local variables), keep no state between functions, use no shared
+	* analyses, and do nothing in doInitialization() and doFinalization()
+	* should return @c true.
+	*/
+	virtual bool isFunctionLocal() const { return false; }
+
+	/**
+	* @brief Returns @c true if running the optimizer again on a function it
+	*        has left unchanged is useless, provided that neither the function
+	*        nor the module-level information (see
+	*        FuncFingerprinter::getModuleFingerprint()) has changed since,
+	*        @c false otherwise.
+	*/
+	virtual bool canSkipUnchangedFuncs() const { return false; }
+
+	void setFuncCallbacks(
+		std::function<bool (ShPtr<Function>)> shouldBeOptimized,
+		std::function<void (ShPtr<Function>)> funcOptimized);
+
+	static ShPtr<Module> optimizeInParallel(ShPtr<FuncOptimizer> optimizer,
+		std::size_t threads,
+		const std::function<ShPtr<FuncOptimizer>()> &createOptimizer);
+
+	/**
+	* @brief Creates instances of OptimizerType with the given arguments and
+	*        optimizes the given module by them, using @a threads threads.
+	*
+	* @param[in] threads Maximal number of threads.
+	* @param[in] module Module to be optimized.
+	* @param[in] args Arguments to be passed to the optimization.
+	*
+	* @tparam OptimizerType Type of the used optimizer.
+	*
+	* @return Optimized module.
+	*/
+	template<class OptimizerType, typename... Args>
+	static ShPtr<Module> optimizeInParallel(std::size_t threads,
+			ShPtr<Module> module, Args &&... args) {
+		auto createOptimizer = [&]() {
+			return std::make_shared<OptimizerType>(module, args...);
+		};
+		return optimizeInParallel(createOptimizer(), threads, createOptimizer);
+	}
+
 protected:
 	FuncOptimizer(ShPtr<Module> module);
 
@@ -70,6 +128,13 @@ protected:
 protected:
 	/// Function that is currently being optimized.
 	ShPtr<Function> currFunc;
+
+private:
+	/// Decides whether a function should be optimized by doOptimization().
+	std::function<bool (ShPtr<Function>)> shouldBeOptimized;
+
+	/// Called after doOptimization() has optimized a function.
+	std::function<void (ShPtr<Function>)> funcOptimized;
 };
 
 } // namespace llvmir2hll
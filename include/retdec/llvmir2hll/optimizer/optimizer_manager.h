@@ -7,6 +7,12 @@
 #ifndef RETDEC_LLVMIR2HLL_OPTIMIZER_OPTIMIZER_MANAGER_H
 #define RETDEC_LLVMIR2HLL_OPTIMIZER_OPTIMIZER_MANAGER_H
 
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+
 #include "retdec/llvmir2hll/optimizer/optimizer.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
 #include "retdec/llvmir2hll/support/types.h"
@@ -17,6 +23,8 @@ namespace llvmir2hll {
 
 class ArithmExprEvaluator;
 class CallInfoObtainer;
+class FuncOptimizer;
+class Function;
 class HLLWriter;
 class Module;
 class ValueAnalysis;
@@ -32,14 +40,17 @@ public:
 	OptimizerManager(const StringSet &enabledOpts, const StringSet &disabledOpts,
 		ShPtr<HLLWriter> hllWriter, ShPtr<ValueAnalysis> va,
 		ShPtr<CallInfoObtainer> cio, ShPtr<ArithmExprEvaluator> arithmExprEvaluator,
-		bool enableAggressiveOpts, bool enableDebug = false);
+		bool enableAggressiveOpts, bool enableDebug = false,
+		std::size_t threads = 1);
 
 	void optimize(ShPtr<Module> m);
 
 private:
 	void printOptimization(const std::string &optName) const;
 	bool optShouldBeRun(const std::string &optName) const;
-	void runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimizer);
+	void runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimizer,
+		const std::function<ShPtr<FuncOptimizer>()> &createOptimizer = nullptr);
+	void skipUnchangedFuncs(ShPtr<FuncOptimizer> optimizer, ShPtr<Module> m);
 	bool shouldSecondCopyPropagationBeRun() const;
 
 	template<typename Optimization, typename... Args>
@@ -70,11 +81,20 @@ private:
 	/// Enable emission of debug messages?
 	bool enableDebug;
 
+	/// Maximal number of threads used by function-local optimizations.
+	std::size_t threads;
+
 	/// Should we recover from out-of-memory errors during optimizations?
 	bool recoverFromOutOfMemory;
 
 	/// List of our optimizations that were run.
 	StringSet backendRunOpts;
+
+	/// For each optimization, functions it has left unchanged, with their
+	/// fingerprint and the module fingerprint at that time (see
+	/// skipUnchangedFuncs()).
+	std::map<std::string, std::map<ShPtr<Function>,
+		std::pair<std::size_t, std::size_t>>> unchangedFuncs;
 };
 
 } // namespace llvmir2hll
@@ -34,6 +34,7 @@ public:
 	AggressiveDerefOptimizer(ShPtr<Module> module);
 
 	virtual std::string getId() const override { return "AggressiveDeref"; }
+	virtual bool isFunctionLocal() const override { return true; }
 
 private:
 	void tryToOptimizeStmt(ShPtr<Statement> stmt, ShPtr<Expression> lhs,
@@ -47,6 +47,7 @@ public:
 	CArrayArgOptimizer(ShPtr<Module> module);
 
 	virtual std::string getId() const override { return "CArrayArg"; }
+	virtual bool isFunctionLocal() const override { return true; }
 
 	/// @name Visitor Interface
 	/// @{
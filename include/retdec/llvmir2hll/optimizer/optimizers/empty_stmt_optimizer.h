@@ -27,6 +27,7 @@ public:
 	EmptyStmtOptimizer(ShPtr<Module> module);
 
 	virtual std::string getId() const override { return "EmptyStmt"; }
+	virtual bool isFunctionLocal() const override { return true; }
 
 private:
 	/// @name Visitor Interface
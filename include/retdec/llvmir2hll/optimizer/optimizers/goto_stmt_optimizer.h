@@ -18,6 +18,7 @@ public:
 	GotoStmtOptimizer(ShPtr<Module> module);
 
 	virtual std::string getId() const override { return "GotoStmt"; }
+	virtual bool isFunctionLocal() const override { return true; }
 
 private:
 	/// @name Visitor Interface
@@ -25,6 +25,7 @@ public:
 	NoInitVarDefOptimizer(ShPtr<Module> module);
 
 	virtual std::string getId() const override { return "NoInitVarDef"; }
+	virtual bool isFunctionLocal() const override { return true; }
 
 private:
 	/// @name Visitor Interface
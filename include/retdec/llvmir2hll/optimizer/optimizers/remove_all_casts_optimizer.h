@@ -29,6 +29,7 @@ public:
 	RemoveAllCastsOptimizer(ShPtr<Module> module);
 
 	virtual std::string getId() const override { return "RemoveAllCasts"; }
+	virtual bool isFunctionLocal() const override { return true; }
 
 private:
 	/// @name Visitor Interface
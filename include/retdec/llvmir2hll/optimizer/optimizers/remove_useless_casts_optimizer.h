@@ -44,6 +44,7 @@ public:
 	RemoveUselessCastsOptimizer(ShPtr<Module> module);
 
 	virtual std::string getId() const override { return "RemoveUselessCasts"; }
+	virtual bool isFunctionLocal() const override { return true; }
 
 private:
 	/// @name Visitor Interface
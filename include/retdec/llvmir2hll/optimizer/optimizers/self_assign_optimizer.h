@@ -35,6 +35,7 @@ public:
 	SelfAssignOptimizer(ShPtr<Module> module);
 
 	virtual std::string getId() const override { return "SelfAssign"; }
+	virtual bool isFunctionLocal() const override { return true; }
 
 private:
 	/// @name Visitor Interface
@@ -69,6 +69,7 @@ public:
 		ShPtr<CallInfoObtainer> cio);
 
 	virtual std::string getId() const override { return "SimpleCopyPropagation"; }
+	virtual bool canSkipUnchangedFuncs() const override { return true; }
 
 private:
 	virtual void doOptimization() override;
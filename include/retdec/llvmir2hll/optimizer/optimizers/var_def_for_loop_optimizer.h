@@ -49,6 +49,7 @@ public:
 	VarDefForLoopOptimizer(ShPtr<Module> module);
 
 	virtual std::string getId() const override { return "VarDefForLoop"; }
+	virtual bool isFunctionLocal() const override { return true; }
 
 private:
 	virtual void runOnFunction(ShPtr<Function> func) override;
@@ -67,6 +67,7 @@ public:
 	WhileTrueToWhileCondOptimizer(ShPtr<Module> module);
 
 	virtual std::string getId() const override { return "WhileTrueToWhileCond"; }
+	virtual bool isFunctionLocal() const override { return true; }
 
 private:
 	/// @name Visitor Interface
@@ -0,0 +1,73 @@
+/**
+* @file include/retdec/llvmir2hll/support/func_fingerprinter.h
+* @brief Computation of fingerprints of functions.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_SUPPORT_FUNC_FINGERPRINTER_H
+#define RETDEC_LLVMIR2HLL_SUPPORT_FUNC_FINGERPRINTER_H
+
+#include <cstddef>
+#include <map>
+
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/llvmir2hll/support/types.h"
+#include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+class Function;
+class Module;
+
+/**
+* @brief Computation of fingerprints of functions.
+*
+* A fingerprint of a function is a hash of its signature, local variables,
+* and of every statement in its body: the statement itself, its successor,
+* and its textual representation. Therefore, if any statement is added,
+* removed, moved, or modified, the fingerprint changes (up to hash
+* collisions). It allows to find out cheaply whether a function has been
+* changed since some point.
+*
+* This class implements the "static helper" (or "library") design pattern (it
+* has just static functions and no instances can be created).
+*/
+class FuncFingerprinter: private OrderedAllVisitor,
+		private retdec::utils::NonCopyable {
+public:
+	/// Fingerprints of functions.
+	using FuncFingerprints = std::map<ShPtr<Function>, std::size_t>;
+
+public:
+	static std::size_t getFingerprint(ShPtr<Function> func,
+		VarSet *addressedVars = nullptr);
+	static std::size_t getModuleFingerprint(ShPtr<Module> module,
+		FuncFingerprints *funcFingerprints = nullptr);
+
+private:
+	FuncFingerprinter();
+
+	void add(std::size_t hash);
+
+	/// @name OrderedAllVisitor Interface
+	/// @{
+	using OrderedAllVisitor::visit;
+	virtual void visit(ShPtr<AddressOpExpr> expr) override;
+	virtual void visitStmt(ShPtr<Statement> stmt, bool visitSuccessors = true,
+		bool visitNestedStmts = true) override;
+	/// @}
+
+private:
+	/// Fingerprint computed so far.
+	std::size_t fingerprint;
+
+	/// Variables whose address is taken (if requested).
+	VarSet *addressedVars;
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
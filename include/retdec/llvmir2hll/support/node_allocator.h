@@ -0,0 +1,113 @@
+/**
+* @file include/retdec/llvmir2hll/support/node_allocator.h
+* @brief Pool allocator of nodes of the backend IR.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_SUPPORT_NODE_ALLOCATOR_H
+#define RETDEC_LLVMIR2HLL_SUPPORT_NODE_ALLOCATOR_H
+
+#include <cstddef>
+
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+/**
+* @brief Memory of nodes of one module.
+*
+* Nodes allocated by NodeAllocator while an arena is current in a thread (see
+* Scope) are carved from chunks of the arena. When the arena is destroyed,
+* its chunks are freed as soon as all their nodes have been freed. Chunks
+* whose nodes are still used (e.g. types cached in static variables) stay
+* until these nodes are freed. Therefore, nodes may outlive their arena.
+*
+* Nodes allocated when no arena is current come from a process-wide default
+* arena which is never destroyed.
+*
+* Instances of this class have reference object semantics.
+*/
+class NodeArena: private retdec::utils::NonCopyable {
+public:
+	struct State;
+
+	/**
+	* @brief Makes an arena current in the calling thread for the lifetime of
+	*        this object.
+	*
+	* The arena has to outlive the scope. Scopes may be nested.
+	*/
+	class Scope: private retdec::utils::NonCopyable {
+	public:
+		explicit Scope(NodeArena *arena);
+		~Scope();
+
+	private:
+		/// Arena which was current before this scope.
+		NodeArena *prevArena;
+	};
+
+public:
+	NodeArena();
+	~NodeArena();
+
+	std::size_t getReservedBytes() const;
+
+	static NodeArena *getCurrent();
+
+private:
+	static State *getCurrentState();
+
+private:
+	/// Chunks and free nodes of the arena.
+	State *state;
+
+	friend class NodeAllocator;
+};
+
+/**
+* @brief Pool allocator of nodes of the backend IR.
+*
+* Modules consist of millions of small values (expressions, statements,
+* variables, types). Allocating each of them separately by the general-purpose
+* allocator wastes memory on per-allocation headers and scatters nodes of the
+* same function over the whole heap. Therefore, nodes up to @c maxPooledSize
+* bytes are carved from big chunks of the current NodeArena, grouped by their
+* size rounded up to @c granularity. Freed nodes are kept for reuse by nodes
+* of the same size until the arena is destroyed.
+*
+* Each thread keeps its own lists of free nodes of its current arena, so that
+* threads optimizing different functions at once (see
+* FuncOptimizer::optimizeInParallel()) do not contend for a lock on every
+* allocation. Free nodes are moved between the threads and the arena in
+* batches.
+*
+* This class implements the "static helper" (or "library") design pattern (it
+* has just static functions and no instances can be created).
+*/
+class NodeAllocator: private retdec::utils::NonCopyable {
+public:
+	/// Nodes bigger than this are allocated by the global operator new.
+	static constexpr std::size_t maxPooledSize = 512;
+
+	/// Sizes of pooled nodes are rounded up to a multiple of this.
+	static constexpr std::size_t granularity = 16;
+
+	/// Size (and alignment) of chunks nodes are carved from.
+	static constexpr std::size_t chunkSize = 64 * 1024;
+
+public:
+	static void *allocate(std::size_t size);
+	static void deallocate(void *ptr, std::size_t size) noexcept;
+
+	static std::size_t getReservedBytes();
+
+private:
+	NodeAllocator();
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
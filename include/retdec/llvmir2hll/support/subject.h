@@ -8,6 +8,8 @@
 #define RETDEC_LLVMIR2HLL_SUPPORT_SUBJECT_H
 
 #include <algorithm>
+#include <cstdint>
+#include <mutex>
 #include <vector>
 
 #include "retdec/llvmir2hll/support/smart_ptr.h"
@@ -37,6 +39,10 @@ namespace llvmir2hll {
 * };
 * @endcode
 *
+* Observers of a subject may be added, removed, and notified from several
+* threads at once (e.g. when functions sharing a global variable are optimized
+* in parallel). Observers are notified without any lock held.
+*
 * @see Observer
 */
 template<typename SubjectType, typename ArgType = SubjectType>
@@ -89,6 +95,7 @@ public:
 	* @param[in] observer Observer to be added.
 	*/
 	void addObserver(ObserverPtr observer) {
+		std::lock_guard<std::recursive_mutex> lock(getObserversMutex());
 		observers.push_back(observer);
 	}
 
@@ -105,6 +112,7 @@ public:
 	* @brief Removes all observers.
 	*/
 	void removeObservers() {
+		std::lock_guard<std::recursive_mutex> lock(getObserversMutex());
 		observers.clear();
 	}
 
@@ -125,7 +133,12 @@ public:
 	void notifyObservers(ShPtr<ArgType> arg = nullptr) {
 		// We have to iterate over a copy of the container because it can be
 		// modified during the iteration (either by us or in an update() call).
-		for (const auto &observer : ObserverContainer(observers)) {
+		ObserverContainer observersCopy;
+		{
+			std::lock_guard<std::recursive_mutex> lock(getObserversMutex());
+			observersCopy = observers;
+		}
+		for (const auto &observer : observersCopy) {
 			notifyObserverOrRemoveItIfNotExists(observer, arg);
 		}
 	}
@@ -189,6 +202,7 @@ private:
 	* @brief Removes the given observer and all the non-existing observers.
 	*/
 	void removeObserverAndNonExistingObservers(ObserverPtr observer) {
+		std::lock_guard<std::recursive_mutex> lock(getObserversMutex());
 		observers.erase(std::remove_if(observers.begin(), observers.end(),
 			[&observer](const auto &other) {
 				return other.expired() || observer.lock() == other.lock();
@@ -196,6 +210,20 @@ private:
 		));
 	}
 
+	/**
+	* @brief Returns the mutex guarding the list of observers.
+	*
+	* There are too many subjects to give each of them its own mutex, so
+	* subjects share a fixed number of mutexes, selected by their addresses.
+	* The mutex is recursive because destroying an observer while the list is
+	* modified may remove the observer from the same subject.
+	*/
+	std::recursive_mutex &getObserversMutex() const {
+		static std::recursive_mutex mutexes[64];
+		auto address = reinterpret_cast<std::uintptr_t>(this);
+		return mutexes[(address / alignof(Subject)) % 64];
+	}
+
 private:
 	/// Container to store observers.
 	ObserverContainer observers;
@@ -17,7 +17,13 @@ namespace loader {
 
 std::unique_ptr<Image> createImage(
 		const std::string& filePath,
-		bool isRaw = false);
+		bool isRaw = false,
+		retdec::fileformat::LoadFlags loadFlags = retdec::fileformat::LoadFlags::NONE);
+std::unique_ptr<Image> createImage(
+		const std::uint8_t* data,
+		std::size_t size,
+		bool isRaw = false,
+		retdec::fileformat::LoadFlags loadFlags = retdec::fileformat::LoadFlags::NONE);
 std::unique_ptr<Image> createImage(
 		const std::shared_ptr<retdec::fileformat::FileFormat>& fileFormat);
 
@@ -7,9 +7,12 @@
 #ifndef RETDEC_LOADER_RETDEC_LOADER_IMAGE_H
 #define RETDEC_LOADER_RETDEC_LOADER_IMAGE_H
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 
 #include "retdec/utils/byte_value_storage.h"
+#include "retdec/utils/interval_index.h"
 #include "retdec/fileformat/fftypes.h"
 #include "retdec/fileformat/file_format/file_format.h"
 #include "retdec/loader/loader/segment.h"
@@ -44,6 +47,8 @@ public:
 	virtual bool setXByte(std::uint64_t address, std::uint64_t x, std::uint64_t val, retdec::utils::Endianness e = retdec::utils::Endianness::UNKNOWN) override;
 	virtual bool setXBytes(std::uint64_t address, const std::vector<std::uint8_t>& res) override;
 
+	template <typename T> bool read(std::uint64_t address, T& value, retdec::utils::Endianness e = retdec::utils::Endianness::UNKNOWN) const;
+
 	retdec::fileformat::FileFormat* getFileFormat();
 	const retdec::fileformat::FileFormat* getFileFormat() const;
 	std::weak_ptr<retdec::fileformat::FileFormat> getFileFormatWptr() const;
@@ -80,6 +85,7 @@ protected:
 	void removeSegment(Segment* segment);
 	void nameSegment(Segment* segment);
 	void sortSegments();
+	void invalidateSegmentIndex();
 
 	void setStatusMessage(const std::string& message);
 
@@ -88,14 +94,38 @@ private:
 	const Segment* _getSegment(const std::string& name) const;
 	const Segment* _getSegmentWithIndex(std::size_t index) const;
 	const Segment* _getSegmentFromAddress(std::uint64_t address) const;
+	void _updateSegmentIndex() const;
 
 	std::shared_ptr<retdec::fileformat::FileFormat> _fileFormat;
 	std::vector<std::unique_ptr<Segment>> _segments;
+	mutable retdec::utils::IntervalIndex<const Segment*> _segmentIndex;
+	mutable std::atomic<bool> _segmentIndexValid;
+	mutable std::mutex _segmentIndexMutex;
 	std::uint64_t _baseAddress;
 	NameGenerator _namelessSegNameGen;
 	std::string _statusMessage;
 };
 
+/**
+ * Reads integer or floating point value located at the provided address directly from
+ * the data of the segment, without any allocation.
+ *
+ * @param address Address to read the value from.
+ * @param value Read value.
+ * @param e Endianness - if specified it is forced, otherwise file's endianness is used.
+ *
+ * @return True if the whole value lies in a single segment, otherwise false.
+ */
+template <typename T>
+bool Image::read(std::uint64_t address, T& value, retdec::utils::Endianness e/* = UNKNOWN*/) const
+{
+	if (e == retdec::utils::Endianness::UNKNOWN)
+		e = getEndianness();
+
+	auto seg = getSegmentFromAddress(address);
+	return seg && seg->read(address - seg->getAddress(), value, e);
+}
+
 } // namespace loader
 } // namespace retdec
 
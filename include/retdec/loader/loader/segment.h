@@ -9,10 +9,13 @@
 
 #include <cstdint>
 #include <memory>
+#include <cstring>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "retdec/common/range.h"
+#include "retdec/utils/byte_value_storage.h"
 #include "retdec/fileformat/fftypes.h"
 #include "retdec/fileformat/types/sec_seg/sec_seg.h"
 #include "retdec/loader/loader/segment_data_source.h"
@@ -48,8 +51,11 @@ public:
 	bool getBytes(std::vector<unsigned char>& result, std::uint64_t addressOffset, std::uint64_t size) const;
 	bool getBits(std::string& result) const;
 	bool getBits(std::string& result, std::uint64_t addressOffset, std::uint64_t bytesCount) const;
+	bool readBytes(std::uint64_t addressOffset, std::uint64_t size, std::uint8_t* result) const;
+	template <typename T> bool read(std::uint64_t addressOffset, T& value, retdec::utils::Endianness e) const;
 
 	bool setBytes(const std::vector<unsigned char>& value, std::uint64_t addressOffset);
+	bool setBytes(const std::uint8_t* value, std::uint64_t size, std::uint64_t addressOffset);
 
 	void resize(std::uint64_t newSize);
 	void shrink(std::uint64_t shrinkOffset, std::uint64_t newSize);
@@ -65,6 +71,44 @@ private:
 	retdec::common::RangeContainer<std::uint64_t> _nonDecodableRanges;
 };
 
+/**
+ * Reads integer or floating point value directly from the data of the segment. No memory
+ * is allocated. Bytes beyond the physical data of the segment are read as zeroes.
+ *
+ * @param addressOffset Offset of the value from the start of the segment.
+ * @param value Read value.
+ * @param e Endianness of the value, must be either little or big endian.
+ *
+ * @return True if the whole value lies in the segment, otherwise false.
+ */
+template <typename T>
+bool Segment::read(std::uint64_t addressOffset, T& value, retdec::utils::Endianness e) const
+{
+	static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, "Segment::read() expects integer or floating point type");
+
+	if (e != retdec::utils::Endianness::LITTLE && e != retdec::utils::Endianness::BIG)
+		return false;
+
+	std::uint8_t bytes[sizeof(T)];
+	if (!readBytes(addressOffset, sizeof(T), bytes))
+		return false;
+
+	using Bits = typename std::conditional<sizeof(T) == 1, std::uint8_t,
+		typename std::conditional<sizeof(T) == 2, std::uint16_t,
+		typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type>::type>::type;
+	static_assert(sizeof(Bits) == sizeof(T), "Segment::read() expects type of size 1, 2, 4 or 8 bytes");
+
+	Bits bits = 0;
+	for (std::size_t i = 0; i < sizeof(T); ++i)
+	{
+		auto shift = 8 * (e == retdec::utils::Endianness::LITTLE ? i : sizeof(T) - i - 1);
+		bits |= static_cast<Bits>(static_cast<Bits>(bytes[i]) << shift);
+	}
+
+	std::memcpy(&value, &bits, sizeof(T));
+	return true;
+}
+
 } // namespace loader
 } // namespace retdec
 
@@ -33,6 +33,7 @@ public:
 
 	bool loadData(std::uint64_t loadOffset, std::uint64_t loadSize, std::vector<std::uint8_t>& data) const;
 	bool saveData(std::uint64_t saveOffset, std::uint64_t saveSize, const std::vector<std::uint8_t>& data);
+	bool saveData(std::uint64_t saveOffset, std::uint64_t saveSize, const std::uint8_t* data);
 
 private:
 	llvm::StringRef _data;
@@ -7,6 +7,9 @@
 #ifndef RETDEC_MACHO_EXTRACTOR_BREAK_FAT_H
 #define RETDEC_MACHO_EXTRACTOR_BREAK_FAT_H
 
+#include <cstdint>
+#include <vector>
+
 #include <llvm/Object/MachO.h>
 #include <llvm/Object/MachOUniversal.h>
 #include <llvm/Support/ErrorOr.h>
@@ -26,6 +29,7 @@ class BreakMachOUniversal
 
 		/// @brief Auxiliary methods
 		/// @{
+		void init();
 		bool isArchive();
 		const char* getFileBufferStart();
 		bool getByArchFamily(
@@ -34,6 +38,20 @@ class BreakMachOUniversal
 		bool extract(
 				llvm::object::MachOUniversalBinary::object_iterator &object,
 				const std::string &outPath);
+		bool extract(
+				llvm::object::MachOUniversalBinary::object_iterator &object,
+				std::vector<std::uint8_t> &result);
+		bool getBestArchive(
+				llvm::object::MachOUniversalBinary::object_iterator &res);
+		bool getArchiveWithIndex(
+				unsigned index,
+				llvm::object::MachOUniversalBinary::object_iterator &res);
+		bool getArchiveForFamily(
+				const std::string &familyName,
+				llvm::object::MachOUniversalBinary::object_iterator &res);
+		bool getArchiveForArchitecture(
+				const std::string &machoArchName,
+				llvm::object::MachOUniversalBinary::object_iterator &res);
 		bool getObjectNamesForArchive(
 				std::uintptr_t archOffset ,
 				std::size_t archSize,
@@ -42,6 +60,7 @@ class BreakMachOUniversal
 
 	public:
 		BreakMachOUniversal(const std::string &path);
+		BreakMachOUniversal(const std::uint8_t *data, std::size_t size);
 
 		/// @brief Information methods
 		/// @{
@@ -69,6 +88,17 @@ class BreakMachOUniversal
 		bool extractArchiveForArchitecture(
 				const std::string &machoArchName,
 				const std::string &outPath);
+		bool extractBestArchive(
+				std::vector<std::uint8_t> &result);
+		bool extractArchiveWithIndex(
+				unsigned index,
+				std::vector<std::uint8_t> &result);
+		bool extractArchiveForFamily(
+				const std::string &familyName,
+				std::vector<std::uint8_t> &result);
+		bool extractArchiveForArchitecture(
+				const std::string &machoArchName,
+				std::vector<std::uint8_t> &result);
 		/// @}
 };
 
@@ -13,6 +13,7 @@
 #ifndef RETDEC_PELIB_IMAGE_LOADER_H
 #define RETDEC_PELIB_IMAGE_LOADER_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -89,14 +90,13 @@ struct PELIB_FILE_PAGE
 		isZeroPage = false;
 	}
 
-	// Initializes the page with a valid data
+	// Initializes the page with a valid data. To save memory, the data are not copied.
+	// The page refers to them until it is written to, so they must outlive the page.
 	bool setValidPage(const void * data, size_t length)
 	{
-		// Write the valid data to the page
-		writeToPage(data, 0, length);
-
-		// Write zero data to the end of the page
-		memset(buffer.data() + length, 0, PELIB_PAGE_SIZE - length);
+		buffer.clear();
+		sharedData = static_cast<const std::uint8_t *>(data);
+		sharedLength = (length < PELIB_PAGE_SIZE) ? length : PELIB_PAGE_SIZE;
 
 		isInvalidPage = false;
 		isZeroPage = false;
@@ -107,17 +107,52 @@ struct PELIB_FILE_PAGE
 	void setZeroPage()
 	{
 		buffer.clear();
+		sharedData = nullptr;
+		sharedLength = 0;
 		isInvalidPage = false;
 		isZeroPage = true;
 	}
 
+	// Returns the page data or nullptr if the page has no data (zero or invalid page).
+	// Only the first getDataLength() bytes are valid, the rest of the page is zeros.
+	const std::uint8_t * getData() const
+	{
+		return buffer.size() ? buffer.data() : sharedData;
+	}
+
+	size_t getDataLength() const
+	{
+		return buffer.size() ? buffer.size() : sharedLength;
+	}
+
+	void readFromPage(void * data, size_t offset, size_t length) const
+	{
+		const std::uint8_t * pageData = getData();
+		size_t dataLength = getDataLength();
+		size_t bytesToCopy = 0;
+
+		// Copy the valid data, pad the rest with zeros
+		if(pageData != nullptr && offset < dataLength)
+		{
+			bytesToCopy = ((offset + length) > dataLength) ? (dataLength - offset) : length;
+			memcpy(data, pageData + offset, bytesToCopy);
+		}
+		memset(static_cast<std::uint8_t *>(data) + bytesToCopy, 0, length - bytesToCopy);
+	}
+
 	void writeToPage(const void * data, size_t offset, size_t length)
 	{
 		if(offset < PELIB_PAGE_SIZE)
 		{
-			// Make sure that there is buffer allocated
+			// Make a private copy of the page on the first write
 			if(buffer.size() != PELIB_PAGE_SIZE)
+			{
 				buffer.resize(PELIB_PAGE_SIZE);
+				if(sharedData != nullptr)
+					memcpy(buffer.data(), sharedData, sharedLength);
+				sharedData = nullptr;
+				sharedLength = 0;
+			}
 
 			// Copy the data, up to page size
 			if((offset + length) > PELIB_PAGE_SIZE)
@@ -126,7 +161,9 @@ struct PELIB_FILE_PAGE
 		}
 	}
 
-	ByteBuffer buffer;                    // A page-sized buffer, holding one image page. Empty if isInvalidPage
+	ByteBuffer buffer;                    // Private copy of the page. Empty until the page is written to
+	const std::uint8_t * sharedData = nullptr; // Page data within the loaded file. Null for zero, invalid and private pages
+	size_t sharedLength = 0;              // Number of valid bytes at sharedData
 	bool isInvalidPage;                   // For invalid pages within image (SectionAlignment > 0x1000)
 	bool isZeroPage;                      // For sections with VirtualSize != 0, RawSize = 0
 };
@@ -140,7 +177,7 @@ class ImageLoader
 
 	ImageLoader(std::uint32_t loaderFlags = 0);
 
-	int Load(ByteBuffer & fileData, bool loadHeadersOnly = false);
+	int Load(const ByteView & fileData, bool loadHeadersOnly = false);
 	int Load(std::istream & fs, std::streamoff fileOffset = 0, bool loadHeadersOnly = false);
 	int Load(const char * fileName, bool loadHeadersOnly = false);
 
@@ -154,7 +191,7 @@ class ImageLoader
 
 	std::uint32_t readString(std::string & str, std::uint32_t rva, std::uint32_t maxLength = 65535);
 	std::uint32_t readStringRc(std::string & str, std::uint32_t rva);
-	std::uint32_t readStringRaw(ByteBuffer & fileData,
+	std::uint32_t readStringRaw(const ByteView & fileData,
 		                        std::string & str,
 		                        std::size_t offset,
 		                        std::size_t maxLength = 65535,
@@ -372,23 +409,23 @@ class ImageLoader
 	bool processImageRelocations(std::uint64_t oldImageBase, std::uint64_t getImageBase, std::uint32_t VirtualAddress, std::uint32_t Size);
 	void writeNewImageBase(std::uint64_t newImageBase);
 
-	int captureDosHeader(ByteBuffer & fileData);
+	int captureDosHeader(const ByteView & fileData);
 	int saveDosHeader(std::ostream & fs, std::streamoff fileOffset);
-	int captureNtHeaders(ByteBuffer & fileData);
+	int captureNtHeaders(const ByteView & fileData);
 	int saveNtHeaders(std::ostream & fs, std::streamoff fileOffset);
-	int captureSectionName(ByteBuffer & fileData, std::string & sectionName, const std::uint8_t * name);
-	int captureSectionHeaders(ByteBuffer & fileData);
+	int captureSectionName(const ByteView & fileData, std::string & sectionName, const std::uint8_t * name);
+	int captureSectionHeaders(const ByteView & fileData);
 	int saveSectionHeaders(std::ostream & fs, std::streamoff fileOffset);
-	int captureImageSections(ByteBuffer & fileData);
-	int captureOptionalHeader32(std::uint8_t * fileData, std::uint8_t * filePtr, std::uint8_t * fileEnd);
-	int captureOptionalHeader64(std::uint8_t * fileData, std::uint8_t * filePtr, std::uint8_t * fileEnd);
+	int captureImageSections(const ByteView & fileData);
+	int captureOptionalHeader32(const std::uint8_t * fileData, const std::uint8_t * filePtr, const std::uint8_t * fileEnd);
+	int captureOptionalHeader64(const std::uint8_t * fileData, const std::uint8_t * filePtr, const std::uint8_t * fileEnd);
 
 	int verifyDosHeader(PELIB_IMAGE_DOS_HEADER & hdr, std::size_t fileSize);
 	int verifyDosHeader(std::istream & fs, std::streamoff fileOffset, std::size_t fileSize);
 
-	int loadImageAsIs(ByteBuffer & fileData);
+	int loadImageAsIs(const ByteView & fileData);
 
-	std::uint32_t captureImageSection(ByteBuffer & fileData,
+	std::uint32_t captureImageSection(const ByteView & fileData,
 									  std::uint32_t virtualAddress,
 									  std::uint32_t virtualSize,
 									  std::uint32_t pointerToRawData,
@@ -406,7 +443,7 @@ class ImageLoader
 	bool checkForValid32BitMachine();
 	bool isValidMachineForCodeIntegrifyCheck(std::uint32_t Bits);
 	bool checkForSectionTablesWithinHeader(std::uint32_t e_lfanew);
-	bool checkForBadCodeIntegrityImages(ByteBuffer & fileData);
+	bool checkForBadCodeIntegrityImages(const ByteView & fileData);
 	bool checkForBadArchitectureSpecific();
 	bool checkForImageAfterMapping();
 
@@ -450,6 +487,7 @@ class ImageLoader
 	PELIB_IMAGE_FILE_HEADER fileHeader;                 // Loaded NT file header
 	PELIB_IMAGE_OPTIONAL_HEADER optionalHeader;         // 32/64-bit optional header
 	ByteBuffer rawFileData;                             // Loaded content of the image in case it couldn't have been mapped
+	std::shared_ptr<ByteBuffer> streamFileData;         // File read by Load(std::istream), referenced by the pages
 	LoaderError ldrError;
 	std::uint64_t savedFileSize;                        // Size of the raw file
 	std::uint32_t windowsBuildNumber;
@@ -71,7 +71,7 @@ namespace PeLib
 		  /// Reads rich header of the current file.
 		  virtual int readRichHeader(std::size_t offset, std::size_t size, bool ignoreInvalidKey = false)  = 0; // EXPORT
 		  /// Reads the COFF symbol table of the current file.
-		  virtual int readCoffSymbolTable(ByteBuffer & fileData) = 0; // EXPORT
+		  virtual int readCoffSymbolTable(const ByteView & fileData) = 0; // EXPORT
 		  /// Reads delay import directory of the current file.
 		  virtual int readDelayImportDirectory() = 0; // EXPORT
 		  /// Reads security directory of the current file.
@@ -134,7 +134,7 @@ namespace PeLib
 		int loadPeHeaders(bool loadHeadersOnly = false);
 
 		/// Alternate load - can be used when the data are already loaded to memory to prevent duplicating large buffers
-		int loadPeHeaders(ByteBuffer & fileData, bool loadHeadersOnly = false);
+		int loadPeHeaders(const ByteView & fileData, bool loadHeadersOnly = false);
 
 		/// returns PEFILE64 or PEFILE32
 		int getFileType() const;
@@ -165,7 +165,7 @@ namespace PeLib
 		/// Reads rich header of the current file.
 		int readRichHeader(std::size_t offset, std::size_t size, bool ignoreInvalidKey = false) ;
 		/// Reads the COFF symbol table of the current file.
-		int readCoffSymbolTable(ByteBuffer & fileData);
+		int readCoffSymbolTable(const ByteView & fileData);
 		/// Reads delay import directory of the current file.
 		int readDelayImportDirectory() ;
 		/// Reads the security directory of the current file.
@@ -128,6 +128,27 @@ namespace PeLib
 
 	typedef std::vector<std::uint8_t> ByteBuffer;
 
+	/**
+	 * Read-only view of bytes of a file, e.g. of a buffer, of a memory-mapped
+	 * file or of data owned by the caller. The viewed bytes are not copied,
+	 * they must outlive the view.
+	 */
+	class ByteView
+	{
+		public:
+			ByteView(const std::uint8_t * data, std::size_t size) : m_data(data), m_size(size) {}
+			ByteView(const ByteBuffer & buffer) : m_data(buffer.data()), m_size(buffer.size()) {}
+
+			const std::uint8_t * data() const { return m_data; }
+			std::size_t size() const { return m_size; }
+			const std::uint8_t * begin() const { return m_data; }
+			const std::uint8_t * end() const { return m_data + m_size; }
+
+		private:
+			const std::uint8_t * m_data;
+			std::size_t m_size;
+	};
+
 	enum
 	{
 		PEFILE32 = 32,
@@ -0,0 +1,58 @@
+/**
+ * \file include/retdec/retdec/decompilation_cache.h
+ * \brief On-disk cache of decompilation results.
+ * \copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_RETDEC_DECOMPILATION_CACHE_H
+#define RETDEC_RETDEC_DECOMPILATION_CACHE_H
+
+#include <string>
+
+#include "retdec/config/config.h"
+
+namespace retdec {
+
+/**
+ * On-disk cache of decompilation outputs.
+ *
+ * Entries are keyed by the content of the input file. Each entry remembers
+ * a hash of the config the input was decompiled with and the whole
+ * decompilation output. The output is reused only when the same input is
+ * decompiled with the same config again. Parts of the output are never
+ * reused.
+ */
+class DecompilationCache
+{
+	public:
+		/**
+		 * Result of a decompilation of one input.
+		 */
+		struct Entry
+		{
+			/// hash of the config the input was decompiled with
+			std::string configHash;
+			/// decompilation output
+			std::string output;
+		};
+
+	public:
+		DecompilationCache(const std::string& directory);
+
+		bool load(const std::string& key, Entry& entry) const;
+		void save(const std::string& key, const Entry& entry) const;
+
+		static std::string computeKey(const std::string& inputFile);
+		static std::string computeConfigHash(const config::Config& config);
+
+	private:
+		std::string getCachePath(const std::string& key) const;
+
+	private:
+		/// directory with cached entries
+		std::string _directory;
+};
+
+} // namespace retdec
+
+#endif
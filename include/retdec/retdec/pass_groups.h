@@ -0,0 +1,58 @@
+/**
+ * \file include/retdec/retdec/pass_groups.h
+ * \brief Groups of repeated passes of the decompilation pipeline.
+ * \copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_RETDEC_PASS_GROUPS_H
+#define RETDEC_RETDEC_PASS_GROUPS_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace retdec {
+
+/**
+ * Group of passes from the pipeline: passes from \c begin to \c end (not
+ * included) are run \c repeats times in a row.
+ */
+struct PassGroup
+{
+	std::size_t begin = 0;
+	std::size_t end = 0;
+	std::size_t repeats = 1;
+};
+
+/**
+ * Split \p passes into groups. If \p fixedPoint is \c false, all the passes
+ * are in one group. Otherwise, sequences of passes which are repeated right
+ * after themselves are put into groups with the number of their repetitions,
+ * the longest sequence wins. The rest is put into groups run only once.
+ */
+std::vector<PassGroup> splitPasses(
+		const std::vector<std::string>& passes,
+		bool fixedPoint
+);
+
+/**
+ * Run \p groups by \p run. It gets the group and whether it is its last
+ * repetition and returns \c true if the run changed the module (the result
+ * of the last repetition is not used).
+ *
+ * A group is repeated until a run does not change the module -- the fixed
+ * point was reached -- or it was run \c repeats times. The first run of each
+ * group is always done. The next ones are skipped once \p isOverBudget
+ * returns \c true.
+ *
+ * \return \c true if some repetitions were skipped because of the budget.
+ */
+bool runPassGroups(
+		const std::vector<PassGroup>& groups,
+		const std::function<bool(const PassGroup&, bool)>& run,
+		const std::function<bool()>& isOverBudget
+);
+
+} // namespace retdec
+
+#endif
@@ -7,6 +7,10 @@
 #ifndef RETDEC_RETDEC_RETDEC_H
 #define RETDEC_RETDEC_RETDEC_H
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include <capstone/capstone.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
@@ -20,12 +24,8 @@ namespace retdec {
 struct LlvmModuleContextPair
 {
 	LlvmModuleContextPair(LlvmModuleContextPair&&) = default;
-	~LlvmModuleContextPair()
-	{
-		// Order matters: module destructor uses context.
-		module.reset();
-		context.reset();
-	}
+	~LlvmModuleContextPair();
+
 	std::unique_ptr<llvm::Module> module;
 	std::unique_ptr<llvm::LLVMContext> context;
 };
@@ -51,6 +51,67 @@ bool decompile(
 		std::string* outString = nullptr
 );
 
+/**
+ * Run a decompilation according to a \p config configuration of the input
+ * file whose content is already loaded in \p inputData (e.g. an object
+ * extracted from an archive or a fat Mach-O). The input file is not read
+ * from the path set in \p config, the path is used only to name things.
+ * If \p outString is set, decompilation output will be returned
+ * in this string. Otherwise, output file is expected to be set in \p config.
+ */
+bool decompile(
+		retdec::config::Config& config,
+		const std::vector<std::uint8_t>& inputData,
+		std::string* outString = nullptr
+);
+
+/**
+ * Run a decompilation according to a \p config configuration, reusing the
+ * output stored in the \p cacheDir directory by an earlier decompilation of
+ * an input with the same content and the same config. Otherwise, the input
+ * is decompiled and its output is stored in the cache.
+ *
+ * Only the whole output is cached. Any change of the config, including
+ * entries of single functions, leads to a full decompilation. When the
+ * cached output is used, no other outputs (e.g. the output config) are
+ * produced.
+ *
+ * If \p outString is set, decompilation output will be returned
+ * in this string. Otherwise, output file is expected to be set in \p config.
+ */
+bool decompileCached(
+		retdec::config::Config& config,
+		const std::string& cacheDir,
+		std::string* outString = nullptr
+);
+
+/**
+ * Run decompilations of all the given \p configs in one process, using at
+ * most \p threads worker threads (\c 0 means as many as the hardware
+ * supports). Each decompilation works on its own LLVM context and module,
+ * the expensive process-wide initialization is done only once.
+ *
+ * Logging is set up only once from the first config. Log files of the other
+ * configs are ignored.
+ *
+ * Configs with the automatic number of decoder threads (zero) get their
+ * share of the hardware threads, so that the decoders of concurrent
+ * decompilations do not start more workers than the hardware supports.
+ *
+ * If \p outStrings is set, it is resized to the number of configs and
+ * decompilation outputs are returned in it. Otherwise, output files are
+ * expected to be set in \p configs.
+ *
+ * \return Exit codes of individual decompilations (\c EXIT_SUCCESS or
+ *         \c EXIT_FAILURE if the decompilation threw an exception),
+ *         in the order of \p configs.
+ */
+std::vector<int> decompile(
+		std::vector<retdec::config::Config>& configs,
+		std::size_t threads = 0,
+		std::vector<std::string>* outStrings = nullptr
+);
+
 } // namespace retdec
 
 #endif
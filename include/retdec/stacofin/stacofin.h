@@ -8,6 +8,7 @@
 #define RETDEC_STACOFIN_STACOFIN_H
 
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -16,12 +17,17 @@
 
 #include "retdec/config/config.h"
 #include "retdec/common/address.h"
+#include "retdec/common/disassembly_store.h"
 
 namespace retdec {
 namespace loader {
 	class Image;
 } // namespace loader
 
+namespace yaracpp {
+	class YaraRule;
+} // namespace yaracpp
+
 namespace stacofin {
 
 struct DetectedFunction;
@@ -128,6 +134,11 @@ class Finder
 				const retdec::config::Config& config);
 		/// @}
 
+		/// @name Settings.
+		/// @{
+		void setDisassemblyStore(common::DisassemblyStore* store);
+		/// @}
+
 		/// @name Getters.
 		/// @{
 		CoveredCode getCoveredCode();
@@ -158,7 +169,12 @@ class Finder
 		using ByteData = typename std::pair<const std::uint8_t*, std::size_t>;
 
 	private:
+		void addDetections(
+				const retdec::loader::Image& image,
+				const std::string& yaraFile,
+				const std::vector<yaracpp::YaraRule>& detectedRules);
 		bool initDisassembler();
+		bool disasm(ByteData& bytes, std::uint64_t& addr);
 		void solveReferences();
 
 		common::Address getAddressFromRef(common::Address ref);
@@ -181,7 +197,14 @@ class Finder
 
 		csh _ce = 0;
 		cs_mode _ceMode = CS_MODE_LITTLE_ENDIAN;
+		cs_mode _ceCurrentMode = CS_MODE_LITTLE_ENDIAN;
 		cs_insn* _ceInsn = nullptr;
+		/// Instructions shared with other consumers (e.g. decoder).
+		common::DisassemblyStore* _sharedDisassembly = nullptr;
+		/// Own store, if the shared store cannot be used.
+		std::unique_ptr<common::DisassemblyStore> _ownDisassembly;
+		/// Store used by the current search.
+		common::DisassemblyStore* _disassembly = nullptr;
 
 		std::map<common::Address, std::string> _imports;
 		std::set<std::string> _sectionNames;
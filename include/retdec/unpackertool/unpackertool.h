@@ -7,11 +7,21 @@
 #ifndef RETDEC_UNPACKERTOOL_UNPACKERTOOL_H
 #define RETDEC_UNPACKERTOOL_UNPACKERTOOL_H
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
 namespace retdec {
 namespace unpackertool {
 
 int _main(int argc, char** argv);
 
+bool isUnpackable(const std::uint8_t* data, std::size_t size);
+int unpack(
+		const std::string& inputFile,
+		const std::string& outputFile,
+		bool brute = false);
+
 } // namespace unpackertool
 } // namespace retdec
 
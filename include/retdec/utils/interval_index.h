@@ -0,0 +1,196 @@
+/**
+* @file include/retdec/utils/interval_index.h
+* @brief Index of values assigned to possibly overlapping intervals.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_UTILS_INTERVAL_INDEX_H
+#define RETDEC_UTILS_INTERVAL_INDEX_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace retdec {
+namespace utils {
+
+/**
+* @brief Index of values assigned to possibly overlapping intervals.
+*
+* Intervals are added by @c add() in the order of their priority -- if more
+* intervals contain the same key, the value of the first added one is found.
+* @c build() then splits the key space into disjoint parts, each with its
+* final value, so that @c find() is a binary search. The part found by the
+* last query is remembered and checked first, because consecutive queries
+* usually hit the same interval.
+*
+* Intervals added after @c build() are not searched until the next
+* @c build(). Concurrent calls of @c find() are safe.
+*
+* @tparam T Type of values. Default-constructed value means "no value".
+*/
+template<typename T>
+class IntervalIndex {
+public:
+	using Key = std::uint64_t;
+
+public:
+	IntervalIndex() = default;
+
+	IntervalIndex(const IntervalIndex &other):
+		intervals(other.intervals),
+		starts(other.starts),
+		values(other.values),
+		built(other.built),
+		lastHit(other.lastHit.load(std::memory_order_relaxed)) {}
+
+	IntervalIndex &operator=(const IntervalIndex &other) {
+		intervals = other.intervals;
+		starts = other.starts;
+		values = other.values;
+		built = other.built;
+		lastHit.store(
+			other.lastHit.load(std::memory_order_relaxed),
+			std::memory_order_relaxed
+		);
+		return *this;
+	}
+
+	/**
+	* @brief Adds interval <tt>[first, last]</tt> with the given value.
+	*
+	* Intervals with @a last lower than @a first are ignored.
+	*/
+	void add(Key first, Key last, const T &value) {
+		if (first <= last) {
+			intervals.push_back({first, last, value});
+		}
+	}
+
+	/**
+	* @brief Builds the index from the added intervals.
+	*/
+	void build() {
+		starts.clear();
+		values.clear();
+		lastHit.store(0, std::memory_order_relaxed);
+		built = true;
+
+		// Boundaries of disjoint parts of the key space.
+		std::vector<Key> bounds;
+		bounds.reserve(2 * intervals.size());
+		for (const auto &i : intervals) {
+			bounds.push_back(i.first);
+			if (i.last != std::numeric_limits<Key>::max()) {
+				bounds.push_back(i.last + 1);
+			}
+		}
+		std::sort(bounds.begin(), bounds.end());
+		bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+		// Assign each part the value of the first interval covering it. Parts
+		// which already have a value are skipped (union-find with path
+		// halving), so every part is assigned only once.
+		std::vector<T> partValues(bounds.size(), T());
+		std::vector<std::size_t> nextFree(bounds.size() + 1);
+		std::iota(nextFree.begin(), nextFree.end(), 0);
+		auto findFree = [&nextFree](std::size_t i) {
+			while (nextFree[i] != i) {
+				nextFree[i] = nextFree[nextFree[i]];
+				i = nextFree[i];
+			}
+			return i;
+		};
+		for (const auto &i : intervals) {
+			const auto begin = lowerBound(bounds, i.first);
+			const auto end = i.last == std::numeric_limits<Key>::max()
+				? bounds.size()
+				: lowerBound(bounds, i.last + 1);
+			for (auto p = findFree(begin); p < end; p = findFree(p + 1)) {
+				partValues[p] = i.value;
+				nextFree[p] = p + 1;
+			}
+		}
+
+		// Merge neighbouring parts with the same value.
+		for (std::size_t p = 0; p < bounds.size(); ++p) {
+			if (values.empty() || !(partValues[p] == values.back())) {
+				starts.push_back(bounds[p]);
+				values.push_back(partValues[p]);
+			}
+		}
+	}
+
+	/**
+	* @brief Removes all intervals.
+	*/
+	void clear() {
+		intervals.clear();
+		starts.clear();
+		values.clear();
+		built = false;
+		lastHit.store(0, std::memory_order_relaxed);
+	}
+
+	/**
+	* @brief Returns @c true if @c build() was called since the last
+	*        @c clear().
+	*/
+	bool isBuilt() const {
+		return built;
+	}
+
+	/**
+	* @brief Returns the value of the first added interval containing @a key
+	*        or default-constructed value if there is no such interval.
+	*/
+	T find(Key key) const {
+		const auto hit = lastHit.load(std::memory_order_relaxed);
+		if (hit < starts.size() && starts[hit] <= key
+				&& (hit + 1 == starts.size() || key < starts[hit + 1])) {
+			return values[hit];
+		}
+
+		const auto it = std::upper_bound(starts.begin(), starts.end(), key);
+		if (it == starts.begin()) {
+			return T();
+		}
+
+		const auto part = static_cast<std::size_t>(it - starts.begin()) - 1;
+		lastHit.store(part, std::memory_order_relaxed);
+		return values[part];
+	}
+
+private:
+	/// Added interval.
+	struct Interval {
+		Key first;
+		Key last;
+		T value;
+	};
+
+	static std::size_t lowerBound(const std::vector<Key> &bounds, Key key) {
+		return std::lower_bound(bounds.begin(), bounds.end(), key)
+			- bounds.begin();
+	}
+
+private:
+	/// Added intervals in the order of their priority.
+	std::vector<Interval> intervals;
+	/// Sorted starts of disjoint parts of the key space.
+	std::vector<Key> starts;
+	/// Values of the parts (the last part goes up to the maximal key).
+	std::vector<T> values;
+	/// Has the index been built?
+	bool built = false;
+	/// Part found by the last query.
+	mutable std::atomic<std::size_t> lastHit{0};
+};
+
+} // namespace utils
+} // namespace retdec
+
+#endif
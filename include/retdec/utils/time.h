@@ -21,6 +21,7 @@ std::string timestampToDate(std::tm *tm);
 std::string timestampToDate(std::time_t timestamp);
 
 double getElapsedTime();
+double getThreadCpuTime();
 
 } // namespace utils
 } // namespace retdec
@@ -7,11 +7,13 @@
 #ifndef RETDEC_YARACPP_YARA_DETECTOR_H
 #define RETDEC_YARACPP_YARA_DETECTOR_H
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "retdec/yaracpp/yara_rule.h"
+#include "retdec/yaracpp/yara_rules_cache.h"
 
 typedef struct _YR_COMPILER YR_COMPILER;
 typedef struct YR_RULES YR_RULES;
@@ -38,6 +40,8 @@ class YaraDetector
 				std::vector<YaraRule> &storedDetected;
 				/// link to undetected rules
 				std::vector<YaraRule> &storedUndetected;
+				/// namespace forced to all rules, if set
+				const std::string *forcedNamespace = nullptr;
 			public:
 				CallbackSettings(
 						bool cStoreAll,
@@ -50,6 +54,8 @@ class YaraDetector
 				void addDetected(YaraRule &rule);
 				void addUndetected(YaraRule &rule);
 				bool storeAllRules() const;
+				const std::string* getForcedNamespace() const;
+				void setForcedNamespace(const std::string *nameSpace);
 				/// @}
 		};
 
@@ -70,22 +76,23 @@ class YaraDetector
 		};
 
 	private:
-		/// compiler or text rules
-		YR_COMPILER *compiler = nullptr;
-		/// representation of files with rules
-		std::vector<FILE*> files;
+		/// sources of text rules
+		std::vector<YaraRulesCache::Source> textSources;
 		/// representation of detected rules
 		std::vector<YaraRule> detectedRules;
 		/// representation of undetected rules
 		std::vector<YaraRule> undetectedRules;
-		/// rules from input text files
-		YR_RULES* textFilesRules = nullptr;
-		/// rules from precompiled files
-		std::vector<YR_RULES*> precompiledRules;
+		/// rules from input text files (compiled before the first analysis)
+		std::shared_ptr<YR_RULES> textFilesRules;
+		/// rules from precompiled files (or shared compiled rules)
+		std::vector<std::shared_ptr<YR_RULES>> precompiledRules;
+		/// namespaces requested for precompiled files (their own namespaces
+		/// were fixed when they were compiled)
+		std::vector<std::string> precompiledNamespaces;
 		/// internal state of instance
 		bool stateIsValid = true;
-		/// indicates whether text files need recompilation
-		bool needsRecompilation = true;
+		/// number of threads scanning with independent rule sets
+		std::size_t scanThreads = 1;
 
 		/// @name Static auxiliary methods
 		/// @{
@@ -103,7 +110,8 @@ class YaraDetector
 				T&& value,
 				bool storeAllRules = false
 		);
-		YR_RULES* getCompiledRules();
+		bool addTextSource(YaraRulesCache::Source &&source);
+		bool compileTextRules();
 		/// @}
 	public:
 		YaraDetector();
@@ -116,6 +124,11 @@ class YaraDetector
 				const std::string &pathToFile,
 				const std::string &nameSpace = std::string()
 		);
+		bool addCompiledRules(
+				const std::shared_ptr<YR_RULES> &rules,
+				const std::string &nameSpace = std::string()
+		);
+		std::shared_ptr<YR_RULES> shareCompiledRules();
 		bool isInValidState() const;
 		/// @}
 
@@ -126,9 +139,15 @@ class YaraDetector
 				bool storeAllRules = false
 		);
 		bool analyze(
-				std::vector<std::uint8_t> &bytes,
+				const std::vector<std::uint8_t> &bytes,
+				bool storeAllRules = false
+		);
+		bool analyze(
+				const std::uint8_t *bytes,
+				std::size_t size,
 				bool storeAllRules = false
 		);
+		void setScanThreads(std::size_t threads);
 		const std::vector<YaraRule>& getDetectedRules() const;
 		const std::vector<YaraRule>& getUndetectedRules() const;
 		/// @}
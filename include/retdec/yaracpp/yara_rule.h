@@ -23,12 +23,14 @@ class YaraRule
 {
 	private:
 		std::string name;
+		std::string nameSpace;
 		std::vector<YaraMeta> metas;
 		std::vector<YaraMatch> matches;
 	public:
 		/// @name Const getters
 		/// @{
 		const std::string &getName() const;
+		const std::string &getNamespace() const;
 		const YaraMeta* getMeta(const std::string &id) const;
 		const YaraMatch* getMatch(std::size_t index) const;
 		const YaraMatch* getFirstMatch() const;
@@ -48,6 +50,7 @@ class YaraRule
 		/// @name Setters
 		/// @{
 		void setName(const std::string &ruleName);
+		void setNamespace(const std::string &ruleNamespace);
 		/// @}
 
 		/// @name Other methods
@@ -0,0 +1,94 @@
+/**
+ * @file include/retdec/yaracpp/yara_rules_cache.h
+ * @brief Cache of compiled YARA rules.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_YARACPP_YARA_RULES_CACHE_H
+#define RETDEC_YARACPP_YARA_RULES_CACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "retdec/utils/non_copyable.h"
+
+typedef struct YR_RULES YR_RULES;
+
+namespace retdec {
+namespace yaracpp {
+
+/**
+ * Process-wide cache of compiled YARA rules
+ *
+ * Text rules are compiled only if the same sources (contents and namespaces)
+ * were not compiled before. Compiled rules are kept in memory for the whole
+ * process. If a cache directory is set, they are also saved there, from where
+ * they are loaded by other processes. Entries are keyed by SHA-256 of the
+ * sources and YARA version. Precompiled rule files are loaded only once per
+ * process.
+ *
+ * Returned rules are shared -- they can be used by many detectors at the same
+ * time, even from different threads (scanning does not modify them).
+ */
+class YaraRulesCache : private retdec::utils::NonCopyable
+{
+	public:
+		/**
+		 * Text source of rules
+		 */
+		struct Source
+		{
+			/// namespace of rules (empty for the default namespace)
+			std::string nameSpace;
+			/// text of rules
+			std::string content;
+		};
+
+		static YaraRulesCache& get();
+
+		/// @name Settings
+		/// @{
+		void setDirectory(const std::string &dir);
+		std::string getDirectory() const;
+		/// @}
+
+		/// @name Rules
+		/// @{
+		std::shared_ptr<YR_RULES> getCompiledRules(
+				const std::vector<Source> &sources
+		);
+		std::shared_ptr<YR_RULES> getPrecompiledRules(
+				const std::string &pathToFile
+		);
+		void clear();
+		/// @}
+
+	private:
+		YaraRulesCache();
+		~YaraRulesCache();
+
+		/// @name Auxiliary methods
+		/// @{
+		std::shared_ptr<YR_RULES> compile(
+				const std::vector<Source> &sources
+		) const;
+		std::shared_ptr<YR_RULES> load(const std::string &pathToFile) const;
+		void save(YR_RULES *compiled, const std::string &key) const;
+		std::string getCachePath(const std::string &key) const;
+		/// @}
+
+		/// guards all members
+		mutable std::mutex mutex;
+		/// directory with compiled rules (empty if disk cache is disabled)
+		std::string directory;
+		/// rules already used in this process
+		std::map<std::string, std::shared_ptr<YR_RULES>> rules;
+};
+
+} // namespace yaracpp
+} // namespace retdec
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file include/retdec/yaracpp/yara_scan_coordinator.h
+ * @brief Shared YARA scanning of one input for several consumers.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_YARACPP_YARA_SCAN_COORDINATOR_H
+#define RETDEC_YARACPP_YARA_SCAN_COORDINATOR_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "retdec/yaracpp/yara_rule.h"
+
+namespace retdec {
+namespace yaracpp {
+
+class YaraDetector;
+
+/**
+ * Scans one input with rule files of several consumers (e.g. compiler
+ * detection, crypto patterns, static code detection) at once.
+ *
+ * Consumers register their rule files under their names. Each file gets its
+ * own YARA namespace, all pending text files are compiled together and the
+ * input is scanned only once. Matches are then split back by consumers.
+ * Each file is checked when it is registered, so a broken rule file is
+ * rejected and does not affect the other files.
+ *
+ * Files registered after a scan are scanned by the next call of @c scan().
+ * Results of already scanned consumers are kept.
+ */
+class YaraScanCoordinator
+{
+	public:
+		YaraScanCoordinator();
+		~YaraScanCoordinator();
+
+		/// @name Rules registration
+		/// @{
+		bool addRuleFile(
+				const std::string &consumer,
+				const std::string &pathToFile,
+				bool storeAllRules = false
+		);
+		/// @}
+
+		/// @name Scanning
+		/// @{
+		bool scan(const std::vector<std::uint8_t> &bytes);
+		bool scan(const std::uint8_t *bytes, std::size_t size);
+		void setScanThreads(std::size_t threads);
+		bool isScanned(const std::string &consumer) const;
+		/// @}
+
+		/// @name Results
+		/// @{
+		const std::vector<YaraRule>& getDetectedRules(
+				const std::string &consumer) const;
+		const std::vector<YaraRule>& getUndetectedRules(
+				const std::string &consumer) const;
+		/// @}
+
+	private:
+		/**
+		 * Rules and results of one consumer
+		 */
+		struct Consumer
+		{
+			bool storeAllRules = false;
+			bool pending = false;
+			bool scanned = false;
+			std::vector<YaraRule> detected;
+			std::vector<YaraRule> undetected;
+		};
+
+		/// detector with files not scanned yet
+		std::unique_ptr<YaraDetector> pendingDetector;
+		/// consumers by names
+		std::map<std::string, Consumer> consumers;
+		/// YARA namespaces of rule files to names of their consumers
+		std::map<std::string, std::string> namespaces;
+		/// number of threads scanning with independent rule sets
+		std::size_t scanThreads = 1;
+};
+
+} // namespace yaracpp
+} // namespace retdec
+
+#endif
@@ -110,21 +110,55 @@ ArchiveWrapper::ArchiveWrapper(
 	std::string &errorMessage)
 	: buffer(MemoryBuffer::getFile(llvm::Twine(archivePath)))
 {
-	succes = false;
+	succes = init(errorMessage);
+}
+
+/**
+ * Constructor.
+ *
+ * Archive content is not copied, memory pointed to by @p data must outlive
+ * the created object.
+ *
+ * @param data archive content in memory
+ * @param size size of @p data
+ * @param succes result of object construction
+ * @param errorMessage possible error message if @p success is set to false
+ */
+ArchiveWrapper::ArchiveWrapper(
+	const std::uint8_t *data,
+	std::size_t size,
+	bool &succes,
+	std::string &errorMessage)
+	: buffer(MemoryBuffer::getMemBuffer(
+		StringRef(reinterpret_cast<const char*>(data), size), "", false))
+{
+	succes = init(errorMessage);
+}
+
+/**
+ * Create archive parser over loaded buffer.
+ *
+ * @param errorMessage possible error message if @c false is returned
+ *
+ * @return @c true if no errors occurred, @c false otherwise
+ */
+bool ArchiveWrapper::init(
+	std::string &errorMessage)
+{
 	if (!buffer) {
 		errorMessage = "Could not create file buffer";
-		return;
+		return false;
 	}
 
 	Error error = Error::success();
 	archive = std::make_unique<Archive>(buffer.get()->getMemBufferRef(), error);
 	if (error) {
 		errorMessage = llvm::toString(std::move(error));
-		return;
+		return false;
 	}
 
 	// Get object count - this iterates over all objects.
-	succes = getCount(objectCount, errorMessage);
+	return getCount(objectCount, errorMessage);
 }
 
 /**
@@ -312,6 +346,107 @@ bool ArchiveWrapper::extractByName(
 	const std::string &name,
 	std::string &errorMessage,
 	const std::string &outputPath) const
+{
+	StringRef content;
+	if (!findByName(name, content, errorMessage)) {
+		return false;
+	}
+
+	auto path = outputPath.empty() ? name : outputPath;
+	return writeFile(path, content, errorMessage);
+}
+
+/**
+ * Extract object file by its index.
+ *
+ * If output path is not given, object name and current directory is used. If
+ * name cannot be retrieved, name 'invalid_name' is used.
+ *
+ * @param index target index
+ * @param errorMessage possible error message if @c false is returned
+ * @param outputPath optional output path
+ *
+ * @return @c true if no errors occurred, @c false otherwise
+ */
+bool ArchiveWrapper::extractByIndex(
+	const std::size_t index,
+	std::string &errorMessage,
+	const std::string &outputPath) const
+{
+	StringRef content;
+	std::string childName;
+	if (!findByIndex(index, content, childName, errorMessage)) {
+		return false;
+	}
+
+	// No path given - use object name.
+	auto path = outputPath.empty() ? childName : outputPath;
+	return writeFile(path, content, errorMessage);
+}
+
+/**
+ * Extract object file by its name into memory.
+ *
+ * If multiple files with the same name are present, only first one is
+ * extracted.
+ *
+ * @param name target name
+ * @param result extracted object file content
+ * @param errorMessage possible error message if @c false is returned
+ *
+ * @return @c true if no errors occurred, @c false otherwise
+ */
+bool ArchiveWrapper::extractByName(
+	const std::string &name,
+	std::vector<std::uint8_t> &result,
+	std::string &errorMessage) const
+{
+	StringRef content;
+	if (!findByName(name, content, errorMessage)) {
+		return false;
+	}
+
+	result.assign(content.bytes_begin(), content.bytes_end());
+	return true;
+}
+
+/**
+ * Extract object file by its index into memory.
+ *
+ * @param index target index
+ * @param result extracted object file content
+ * @param errorMessage possible error message if @c false is returned
+ *
+ * @return @c true if no errors occurred, @c false otherwise
+ */
+bool ArchiveWrapper::extractByIndex(
+	const std::size_t index,
+	std::vector<std::uint8_t> &result,
+	std::string &errorMessage) const
+{
+	StringRef content;
+	std::string childName;
+	if (!findByIndex(index, content, childName, errorMessage)) {
+		return false;
+	}
+
+	result.assign(content.bytes_begin(), content.bytes_end());
+	return true;
+}
+
+/**
+ * Find content of the first object file with the given name.
+ *
+ * @param name target name
+ * @param content content of the found object file
+ * @param errorMessage possible error message if @c false is returned
+ *
+ * @return @c true if object was found, @c false otherwise
+ */
+bool ArchiveWrapper::findByName(
+	const std::string &name,
+	llvm::StringRef &content,
+	std::string &errorMessage) const
 {
 	Error error = Error::success();
 	for (const auto &child : archive->children(error)) {
@@ -330,16 +465,14 @@ bool ArchiveWrapper::extractByName(
 			continue;
 		}
 
-		// Get buffer and try to write to a file.
 		auto bufferOrErr = child.getBuffer();
 		if (!bufferOrErr) {
 			errorMessage = "Could not get file buffer";
 			return false;
 		}
-		else {
-			auto path = outputPath.empty() ? name : outputPath;
-			return writeFile(path, *bufferOrErr, errorMessage);
-		}
+
+		content = *bufferOrErr;
+		return true;
 	}
 
 	if (checkError(error, errorMessage)) {
@@ -351,21 +484,22 @@ bool ArchiveWrapper::extractByName(
 }
 
 /**
- * Extract object file by its index.
+ * Find content of the object file with the given index.
  *
- * If output path is not given, object name and current directory is used. If
- * name cannot be retrieved, name 'invalid_name' is used.
+ * If name cannot be retrieved, name 'invalid_name' is used.
  *
  * @param index target index
+ * @param content content of the found object file
+ * @param childName fixed name of the found object file
  * @param errorMessage possible error message if @c false is returned
- * @param outputPath optional output path
  *
- * @return @c true if no errors occurred, @c false otherwise
+ * @return @c true if object was found, @c false otherwise
  */
-bool ArchiveWrapper::extractByIndex(
+bool ArchiveWrapper::findByIndex(
 	const std::size_t index,
-	std::string &errorMessage,
-	const std::string &outputPath) const
+	llvm::StringRef &content,
+	std::string &childName,
+	std::string &errorMessage) const
 {
 	Error error = Error::success();
 	std::size_t counter = 0;
@@ -379,24 +513,16 @@ bool ArchiveWrapper::extractByIndex(
 			continue;
 		}
 
-		// Get buffer and try to write to a file.
 		auto bufferOrErr = child.getBuffer();
 		if (!bufferOrErr) {
 			errorMessage = "Could not get file buffer";
 			return false;
 		}
-		else {
-			std::string path;
-			if (outputPath.empty()) {
-				// No path given - use object name.
-				auto nameOrErr = child.getName();
-				path = nameOrErr ? fixName(nameOrErr->str()) : "invalid_name";
-			}
-			else {
-				path = outputPath;
-			}
-			return writeFile(path, *bufferOrErr, errorMessage);
-		}
+
+		auto nameOrErr = child.getName();
+		childName = nameOrErr ? fixName(nameOrErr->str()) : "invalid_name";
+		content = *bufferOrErr;
+		return true;
 	}
 
 	if (checkError(error, errorMessage)) {
@@ -4,12 +4,17 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/PostOrderIterator.h>
 #include <llvm/IR/CFG.h>
 #include <llvm/IR/Instruction.h>
@@ -29,6 +34,257 @@ using namespace llvm;
 namespace retdec {
 namespace bin2llvmir {
 
+namespace {
+
+/**
+ * Solves reaching definitions of one function on bit vectors.
+ *
+ * Definitions are numbered densely (in the order of basic blocks in the
+ * function map) and sets of definitions are bit vectors over these numbers.
+ * Only basic blocks reachable from the entry propagate definitions, they are
+ * numbered in reverse post-order, which is also the order of the worklist.
+ */
+class ReachingDefinitionsSolver
+{
+	public:
+		ReachingDefinitionsSolver(
+				const Function& F,
+				std::map<const BasicBlock*, BasicBlockEntry>& bbs);
+
+		void solve();
+		void linkDefsAndUses();
+
+	private:
+		unsigned getSourceId(const Value* src);
+		void linkDefsAndUses(BasicBlockEntry& bbe);
+
+	private:
+		std::map<const BasicBlock*, BasicBlockEntry>& _bbs;
+
+		/// All definitions by their numbers.
+		std::vector<Definition*> _defs;
+		/// Source ids of all definitions by their numbers.
+		std::vector<unsigned> _defSources;
+		/// Defined values (sources) to their ids.
+		DenseMap<const Value*, unsigned> _sourceIds;
+		/// Numbers of definitions of each source.
+		std::vector<BitVector> _sourceDefs;
+
+		/// Reachable basic blocks in reverse post-order.
+		std::vector<const BasicBlock*> _blocks;
+		/// Reachable basic blocks to their positions in @c _blocks.
+		DenseMap<const BasicBlock*, unsigned> _blockIds;
+		/// Predecessors and successors of reachable basic blocks.
+		std::vector<std::vector<unsigned>> _preds;
+		std::vector<std::vector<unsigned>> _succs;
+		/// GEN sets of reachable basic blocks.
+		std::vector<BitVector> _gen;
+		/// Ids of sources defined (killed) in reachable basic blocks.
+		std::vector<std::vector<unsigned>> _kill;
+		/// OUT sets of reachable basic blocks.
+		std::vector<BitVector> _out;
+};
+
+ReachingDefinitionsSolver::ReachingDefinitionsSolver(
+		const Function& F,
+		std::map<const BasicBlock*, BasicBlockEntry>& bbs)
+		: _bbs(bbs)
+{
+	for (auto& p : _bbs)
+	{
+		for (Definition& d : p.second.defs)
+		{
+			_defs.push_back(&d);
+			_defSources.push_back(getSourceId(d.src));
+		}
+	}
+
+	_sourceDefs.assign(_sourceIds.size(), BitVector(_defs.size()));
+	for (unsigned i = 0; i < _defs.size(); ++i)
+	{
+		_sourceDefs[_defSources[i]].set(i);
+	}
+
+	if (F.empty())
+	{
+		return;
+	}
+
+	for (auto* bb : post_order(&F))
+	{
+		_blocks.push_back(bb);
+	}
+	std::reverse(_blocks.begin(), _blocks.end());
+	for (unsigned i = 0; i < _blocks.size(); ++i)
+	{
+		_blockIds[_blocks[i]] = i;
+	}
+
+	_preds.resize(_blocks.size());
+	_succs.resize(_blocks.size());
+	_gen.assign(_blocks.size(), BitVector(_defs.size()));
+	_kill.resize(_blocks.size());
+	_out.assign(_blocks.size(), BitVector(_defs.size()));
+
+	// Definitions are numbered in the order of the function map. Find the
+	// number of the first definition of each basic block.
+	//
+	std::unordered_map<const BasicBlock*, unsigned> firstDefs;
+	unsigned defNum = 0;
+	for (auto& p : _bbs)
+	{
+		firstDefs[p.first] = defNum;
+		defNum += p.second.defs.size();
+	}
+
+	for (unsigned i = 0; i < _blocks.size(); ++i)
+	{
+		auto* bb = _blocks[i];
+		for (auto* pred : predecessors(bb))
+		{
+			auto it = _blockIds.find(pred);
+			if (it != _blockIds.end())
+			{
+				_preds[i].push_back(it->second);
+				_succs[it->second].push_back(i);
+			}
+		}
+
+		// The last definition of each source is generated, the source is
+		// killed.
+		//
+		auto& defs = _bbs.find(bb)->second.defs;
+		auto first = firstDefs[bb];
+		BitVector killed(_sourceIds.size());
+		for (unsigned j = defs.size(); j > 0; --j)
+		{
+			auto num = first + j - 1;
+			auto src = _defSources[num];
+			if (!killed.test(src))
+			{
+				killed.set(src);
+				_kill[i].push_back(src);
+				_gen[i].set(num);
+			}
+		}
+	}
+}
+
+unsigned ReachingDefinitionsSolver::getSourceId(const Value* src)
+{
+	return _sourceIds.insert({src, _sourceIds.size()}).first->second;
+}
+
+/**
+ * REACH_in[B] = Sum (p in pred[B]) (REACH_out[p])
+ * REACH_out[B] = GEN[B] + ( REACH_in[B] - KILL[B] )
+ *
+ * Basic blocks are processed in reverse post-order. When OUT of a basic block
+ * changes, its successors are processed again -- those after it in the same
+ * sweep, those before it (back edges) in the next one.
+ */
+void ReachingDefinitionsSolver::solve()
+{
+	BitVector dirty(_blocks.size(), true);
+	BitVector out(_defs.size());
+
+	while (dirty.any())
+	{
+		for (int i = dirty.find_first(); i != -1; i = dirty.find_next(i))
+		{
+			dirty.reset(i);
+
+			out.reset();
+			for (auto p : _preds[i])
+			{
+				out |= _out[p];
+			}
+			for (auto src : _kill[i])
+			{
+				out.reset(_sourceDefs[src]);
+			}
+			out |= _gen[i];
+
+			if (out != _out[i])
+			{
+				std::swap(out, _out[i]);
+				for (auto s : _succs[i])
+				{
+					dirty.set(s);
+				}
+			}
+		}
+	}
+}
+
+void ReachingDefinitionsSolver::linkDefsAndUses()
+{
+	for (auto& p : _bbs)
+	{
+		linkDefsAndUses(p.second);
+	}
+}
+
+/**
+ * Link uses in basic block @a bbe with their definitions. A use is defined by
+ * the last preceding definition of its source in the same basic block. If
+ * there is no such definition, it is defined by all definitions of its source
+ * reaching the basic block.
+ */
+void ReachingDefinitionsSolver::linkDefsAndUses(BasicBlockEntry& bbe)
+{
+	DenseMap<const Value*, Definition*> lastDefs;
+	BitVector in;
+	bool inComputed = false;
+
+	auto dIt = bbe.defs.begin();
+	for (Use& u : bbe.uses)
+	{
+		for (; dIt != bbe.defs.end() && dIt->posInBb < u.posInBb; ++dIt)
+		{
+			lastDefs[dIt->src] = &(*dIt);
+		}
+
+		auto ld = lastDefs.find(u.src);
+		if (ld != lastDefs.end())
+		{
+			ld->second->uses.insert(&u);
+			u.defs.insert(ld->second);
+			continue;
+		}
+
+		auto src = _sourceIds.find(u.src);
+		if (src == _sourceIds.end())
+		{
+			continue;
+		}
+
+		if (!inComputed)
+		{
+			in.resize(_defs.size());
+			auto b = _blockIds.find(bbe.bb);
+			if (b != _blockIds.end())
+			{
+				for (auto p : _preds[b->second])
+				{
+					in |= _out[p];
+				}
+			}
+			inComputed = true;
+		}
+
+		BitVector reaching = in;
+		reaching &= _sourceDefs[src->second];
+		for (int i = reaching.find_first(); i != -1; i = reaching.find_next(i))
+		{
+			_defs[i]->uses.insert(&u);
+			u.defs.insert(_defs[i]);
+		}
+	}
+}
+
+} // anonymous namespace
+
 //
 //=============================================================================
 //  ReachingDefinitionsAnalysis
@@ -45,7 +301,10 @@ bool ReachingDefinitionsAnalysis::runOnModule(
 	_specialGlobal = AsmInstruction::getLlvmToAsmGlobalVariable(&M);
 
 	clear();
-	initializeBasicBlocks(M);
+	for (Function& F : M)
+	{
+		bbMap[&F];
+	}
 	run();
 
 	_run = true;
@@ -62,38 +321,77 @@ bool ReachingDefinitionsAnalysis::runOnFunction(
 	_specialGlobal = AsmInstruction::getLlvmToAsmGlobalVariable(F.getParent());
 
 	clear();
-	initializeBasicBlocks(F);
+	bbMap[&F];
 	run();
 
 	_run = true;
 	return false;
 }
 
+/**
+ * Analyse all the functions in @c bbMap. Functions are independent -- each
+ * one only reads its own IR and writes its own entry in @c bbMap, which was
+ * already created. Therefore, they are analysed in parallel.
+ */
 void ReachingDefinitionsAnalysis::run()
 {
-	initializeBasicBlocksPrev();
-	initializeKillGenSets();
-	propagate();
-	initializeDefsAndUses();
+	std::vector<std::pair<Function*, BasicBlockMap*>> fncs;
+	fncs.reserve(bbMap.size());
+	for (auto& p : bbMap)
+	{
+		if (!p.first->empty())
+		{
+			fncs.emplace_back(const_cast<Function*>(p.first), &p.second);
+		}
+	}
 
-	LOG << *this << "\n";
+	std::atomic<std::size_t> next(0);
+	auto worker = [this, &fncs, &next]()
+	{
+		for (auto i = next++; i < fncs.size(); i = next++)
+		{
+			run(*fncs[i].first, *fncs[i].second);
+		}
+	};
+
+	std::size_t threads = fncs.size() > 1
+			? std::min<std::size_t>(
+					fncs.size(),
+					std::max(1u, std::thread::hardware_concurrency()))
+			: 1;
+	std::vector<std::thread> pool;
+	for (std::size_t i = 1; i < threads; ++i)
+	{
+		pool.emplace_back(worker);
+	}
+	worker();
+	for (auto& t : pool)
+	{
+		t.join();
+	}
+
+	initializeDefsAndUsesIndex();
 
-	clearInternal();
+	LOG << *this << "\n";
 }
 
-void ReachingDefinitionsAnalysis::initializeBasicBlocks(llvm::Module& M)
+void ReachingDefinitionsAnalysis::run(llvm::Function& F, BasicBlockMap& bbs)
 {
-	for (Function& F : M)
-	{
-		initializeBasicBlocks(F);
-	}
+	initializeBasicBlocks(F, bbs);
+	initializeBasicBlocksPrev(bbs);
+
+	ReachingDefinitionsSolver solver(F, bbs);
+	solver.solve();
+	solver.linkDefsAndUses();
 }
 
-void ReachingDefinitionsAnalysis::initializeBasicBlocks(llvm::Function& F)
+void ReachingDefinitionsAnalysis::initializeBasicBlocks(
+		llvm::Function& F,
+		BasicBlockMap& bbs)
 {
 	for (BasicBlock& B : F)
 	{
-		BasicBlockEntry bbe(&B, bbMap.size());
+		BasicBlockEntry bbe(&B, bbs.size());
 
 		int insnPos = -1;
 		for (Instruction& I : B)
@@ -200,13 +498,15 @@ void ReachingDefinitionsAnalysis::initializeBasicBlocks(llvm::Function& F)
 			}
 		}
 
-		bbMap[&F][&B] = bbe;
+		bbs[&B] = std::move(bbe);
 	}
 }
 
 void ReachingDefinitionsAnalysis::clear()
 {
 	bbMap.clear();
+	_defs.clear();
+	_uses.clear();
 	_run = false;
 }
 
@@ -215,26 +515,9 @@ bool ReachingDefinitionsAnalysis::wasRun() const
 	return _run;
 }
 
-/**
- * Clear internal structures used to compute RDA, but not needed to use it once
- * it is computed.
- */
-void ReachingDefinitionsAnalysis::clearInternal()
+void ReachingDefinitionsAnalysis::initializeBasicBlocksPrev(BasicBlockMap& bbs)
 {
-	for (auto& pair1 : bbMap)
-	for (auto& pair : pair1.second)
-	{
-		BasicBlockEntry& bb = pair.second;
-		bb.defsOut.clear();
-		bb.genDefs.clear();
-		bb.killDefs.clear();
-	}
-}
-
-void ReachingDefinitionsAnalysis::initializeBasicBlocksPrev()
-{
-	for (auto &pair1 : bbMap)
-	for (auto& pair : pair1.second)
+	for (auto& pair : bbs)
 	{
 		auto B = pair.first;
 		auto &entry = pair.second;
@@ -242,130 +525,55 @@ void ReachingDefinitionsAnalysis::initializeBasicBlocksPrev()
 		for (auto PI = pred_begin(B), E = pred_end(B); PI != E; ++PI)
 		{
 			auto* pred = *PI;
-			auto p = pair1.second.find(pred);
+			auto p = bbs.find(pred);
 
-			assert(p != pair1.second.end() && "we should have all BBs stored in bbMap");
+			assert(p != bbs.end() && "we should have all BBs stored in bbMap");
 
 			entry.prevBBs.insert( &p->second );
 		}
 	}
 }
 
-void ReachingDefinitionsAnalysis::initializeKillGenSets()
+void ReachingDefinitionsAnalysis::initializeDefsAndUsesIndex()
 {
 	for (auto &pair1 : bbMap)
 	for (auto& pair : pair1.second)
 	{
-		pair.second.initializeKillDefSets();
-	}
-}
-
-void ReachingDefinitionsAnalysis::propagate()
-{
-	for (auto &pair1 : bbMap)
-	{
-		const Function* fnc = pair1.first;
-
-		std::vector<BasicBlockEntry*> workList;
-		workList.reserve(pair1.second.size());
-		ReversePostOrderTraversal<const Function*> RPOT(fnc); // Expensive to create
-		for (auto I = RPOT.begin(); I != RPOT.end(); ++I)
+		for (auto& d : pair.second.defs)
 		{
-			const BasicBlock* bb = *I;
-			auto fIt = pair1.second.find(bb);
-			assert(fIt != pair1.second.end());
-			workList.push_back(&(fIt->second));
-
-			fIt->second.changed = true;
+			_defs.emplace(d.def, &d);
 		}
-
-		bool changed = true;
-		while (changed)
+		for (auto& u : pair.second.uses)
 		{
-			changed = false;
-
-			for (auto* bbe : workList)
-			{
-				changed |= bbe->initDefsOut();
-			}
-		}
-	}
-}
-
-void ReachingDefinitionsAnalysis::initializeDefsAndUses()
-{
-	for (auto &pair1 : bbMap)
-	for (auto& pair : pair1.second)
-	{
-		BasicBlockEntry &bb = pair.second;
-
-		for (Use &u : bb.uses)
-		{
-			for (auto dIt = bb.defs.rbegin(); dIt != bb.defs.rend(); ++dIt)
-			{
-				Definition &d = *dIt;
-
-				if (d.getSource() != u.src)
-				{
-					continue;
-				}
-
-				if (d.dominates(&u))
-				{
-					d.uses.insert(&u);
-					u.defs.insert(&d);
-					break;
-				}
-			}
-
-			if (u.defs.empty())
-			{
-				for (auto p : bb.prevBBs)
-				for (auto d : p->defsOut)
-				{
-					if (d->getSource() == u.src)
-					{
-						d->uses.insert(&u);
-						u.defs.insert(d);
-					}
-				}
-			}
+			_uses.emplace(u.use, &u);
 		}
 	}
 }
 
-const BasicBlockEntry& ReachingDefinitionsAnalysis::getBasicBlockEntry(
-		const Instruction* I) const
-{
-	auto* F = I->getFunction();
-	auto pair1 = bbMap.find(F);
-	assert(pair1 != bbMap.end() && "we do not have this function in bbMap");
-
-	auto* BB = I->getParent();
-	auto pair = pair1->second.find(BB);
-	assert(pair != pair1->second.end() && "we do not have this basic block in bbMap");
-
-	return pair->second;
-}
-
 const DefSet& ReachingDefinitionsAnalysis::defsFromUse(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).defsFromUse(I);
+	static const DefSet emptyDefSet;
+	auto* u = getUse(I);
+	return u ? u->defs : emptyDefSet;
 }
 
 const UseSet& ReachingDefinitionsAnalysis::usesFromDef(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).usesFromDef(I);
+	static const UseSet emptyUseSet;
+	auto* d = getDef(I);
+	return d ? d->uses : emptyUseSet;
 }
 
 const Definition* ReachingDefinitionsAnalysis::getDef(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).getDef(I);
+	auto it = _defs.find(I);
+	return it != _defs.end() ? it->second : nullptr;
 }
 
 const Use* ReachingDefinitionsAnalysis::getUse(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).getUse(I);
+	auto it = _uses.find(I);
+	return it != _uses.end() ? it->second : nullptr;
 }
 
 std::ostream& operator<<(std::ostream& out, const ReachingDefinitionsAnalysis& rda)
@@ -391,54 +599,6 @@ BasicBlockEntry::BasicBlockEntry(const llvm::BasicBlock* b, std::size_t _id) :
 
 }
 
-void BasicBlockEntry::initializeKillDefSets()
-{
-	killDefs.clear();
-	genDefs.clear();
-
-	for (auto dIt = defs.rbegin(); dIt != defs.rend(); ++dIt)
-	{
-		Definition& d = *dIt;
-
-		bool added = (killDefs.insert(d.getSource())).second;
-		if (added)
-		{
-			genDefs.insert(&d);
-		}
-	}
-}
-
-/**
- * REACH_in[B] = Sum (p in pred[B]) (REACH_out[p])
- * REACH_out[B] = GEN[B] + ( REACH_in[B] - KILL[B] )
- */
-Changed BasicBlockEntry::initDefsOut()
-{
-	auto oldSz = defsOut.size();
-
-	if (defsOut.empty() && !genDefs.empty())
-	{
-		defsOut = std::move(genDefs);
-	}
-
-	for (auto* p : prevBBs)
-	{
-		if (p->changed)
-		{
-			for (auto* d : p->defsOut)
-			{
-				if (killDefs.find(d->getSource()) == killDefs.end())
-				{
-					defsOut.insert(d);
-				}
-			}
-		}
-	}
-
-	changed = oldSz != defsOut.size();
-	return changed;
-}
-
 std::string BasicBlockEntry::getName() const
 {
 	std::stringstream out;
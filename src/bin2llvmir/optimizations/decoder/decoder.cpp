@@ -54,7 +54,6 @@ bool Decoder::runOnModule(llvm::Module& m)
 	_debug = DebugFormatProvider::getDebugFormat(_module);
 	_names = NamesProvider::getNames(_module);
 	_abi = AbiProvider::getAbi(_module);
-	_llvm2capstone = &AsmInstruction::getLlvmToCapstoneInsnMap(_module);
 	return runCatcher();
 }
 
@@ -72,7 +71,6 @@ bool Decoder::runOnModuleCustom(
 	_debug = d;
 	_names = n;
 	_abi = a;
-	_llvm2capstone = &AsmInstruction::getLlvmToCapstoneInsnMap(_module);
 	return runCatcher();
 }
 
@@ -105,6 +103,8 @@ bool Decoder::run()
 
 	initTranslator();
 	initDryRunCsInstruction();
+	initDisassemblyStore();
+	initSpeculativeDisassembler();
 	initEnvironment();
 	initRanges();
 	initJumpTargets();
@@ -148,9 +148,16 @@ void Decoder::decode()
 	JumpTarget jt;
 	while (getJumpTarget(jt))
 	{
-		LOG << "\t" << "processing : " << jt << std::endl;
+		speculate();
+		LOG << "\t" << "processing : " << jt << " ("
+				<< capstone_utils::mode2string(
+						_config->getConfig().architecture,
+						jt.getMode())
+				<< ")" << std::endl;
 		decodeJumpTarget(jt);
 	}
+	_speculation.reset();
+	_disassembly.reset();
 
 	if (!_somethingDecoded)
 	{
@@ -158,6 +165,51 @@ void Decoder::decode()
 	}
 }
 
+/**
+ * Queue the next jump targets to be decoded for speculative disassembly.
+ * Jump targets are disassembled up to the end of their ranges, decoding
+ * then uses only those instructions which fit into the decoded chunk.
+ */
+void Decoder::speculate()
+{
+	if (_speculation == nullptr)
+	{
+		return;
+	}
+
+	// Jump targets found meanwhile may get ahead of these, but they are
+	// likely to be decoded soon anyway.
+	//
+	const std::size_t lookAhead = 8;
+	std::size_t cntr = 0;
+	for (auto& jt : _jumpTargets._data)
+	{
+		if (cntr++ == lookAhead)
+		{
+			break;
+		}
+
+		auto* range = _ranges.get(jt.getAddress());
+		if (range == nullptr)
+		{
+			continue;
+		}
+		ByteData bytes = _image->getImage()->getRawSegmentData(jt.getAddress());
+		if (bytes.first == nullptr)
+		{
+			continue;
+		}
+		auto toRangeEnd = range->getEnd() - jt.getAddress();
+		bytes.second = toRangeEnd < bytes.second ? toRangeEnd : bytes.second;
+
+		_speculation->enqueue(
+				jt.getAddress(),
+				getDisassemblyMode(jt.getMode()),
+				bytes.first,
+				bytes.second);
+	}
+}
+
 bool Decoder::getJumpTarget(JumpTarget& jt)
 {
 	if (!_jumpTargets.empty())
@@ -168,11 +220,14 @@ bool Decoder::getJumpTarget(JumpTarget& jt)
 	}
 	else if (!_ranges.primaryEmpty())
 	{
-		jt = JumpTarget(
-				_ranges.primaryFront().getStart(),
-				JumpTarget::eType::LEFTOVER,
-				_c2l->getBasicMode(),
-				Address());
+		Address a = _ranges.primaryFront().getStart();
+		cs_mode m = _c2l->getBasicMode();
+		if (_config->getConfig().architecture.isArm32OrThumb() && a % 2)
+		{
+			m = CS_MODE_THUMB;
+			a -= 1;
+		}
+		jt = JumpTarget(a, JumpTarget::eType::LEFTOVER, m, Address());
 		return true;
 	}
 	return false;
@@ -319,7 +374,7 @@ void Decoder::decodeJumpTarget(const JumpTarget& jt)
 		}
 		_somethingDecoded = true;
 
-		_llvm2capstone->emplace(res.llvmInsn, res.capstoneInsn);
+		AsmInstruction::addLlvmToAsmInstruction(res.llvmInsn, res.capstoneInsn);
 
 		bbEnd |= getJumpTargetsFromInstruction(oldAddr, res, bytes.second);
 		bbEnd |= instructionBreaksBasicBlock(oldAddr, res);
@@ -337,7 +392,11 @@ void Decoder::decodeJumpTarget(const JumpTarget& jt)
 capstone2llvmir::Capstone2LlvmIrTranslator::TranslationResultOne
 Decoder::translate(ByteData& bytes, common::Address& addr, llvm::IRBuilder<>& irb)
 {
-	auto res = _c2l->translateOne(bytes.first, bytes.second, addr, irb);
+	// Translator keeps the instruction -> alloc a new one each time.
+	cs_insn* insn = cs_malloc(_c2l->getCapstoneEngine());
+
+	uint64_t a = addr;
+	bool ok = disasm(_c2l->getBasicMode(), bytes, a, insn);
 
 	// MIPS 64-bit mode can decompile more instructions than the 32-bit mode.
 	// When 32-bit mode is used, some 32-bit instructions that IDA handles fail
@@ -346,16 +405,72 @@ Decoder::translate(ByteData& bytes, common::Address& addr, llvm::IRBuilder<>& ir
 	// instructions are disassembled differently. Try to swtich modes only if
 	// translations fails.
 	//
-	if (_config->getConfig().architecture.isMipsOrPic32()
-			&& (_c2l->getBasicMode() & CS_MODE_MIPS32)
-			&& res.failed())
+	if (!ok
+			&& _config->getConfig().architecture.isMipsOrPic32()
+			&& (_c2l->getBasicMode() & CS_MODE_MIPS32))
+	{
+		ok = disasm(CS_MODE_MIPS64, bytes, a, insn);
+	}
+
+	if (!ok)
 	{
-		_c2l->modifyBasicMode(CS_MODE_MIPS64);
-		res = _c2l->translateOne(bytes.first, bytes.second, addr, irb);
-		_c2l->modifyBasicMode(CS_MODE_MIPS32);
+		cs_free(insn, 1);
+		return capstone2llvmir::Capstone2LlvmIrTranslator::TranslationResultOne();
 	}
 
-	return res;
+	addr = a;
+	return _c2l->translateOne(insn, irb);
+}
+
+/**
+ * @return Complete Capstone mode, i.e. the given basic mode with the extra
+ *         mode of the translator.
+ */
+cs_mode Decoder::getDisassemblyMode(cs_mode basicMode) const
+{
+	return static_cast<cs_mode>(basicMode + _c2l->getExtraMode());
+}
+
+/**
+ * Disassemble one instruction from @a bytes on @a addr into @a insn in the
+ * given basic mode, the same way as @c cs_disasm_iter().
+ * The instruction is shared via the disassembly store.
+ */
+bool Decoder::disasm(
+		cs_mode m,
+		ByteData& bytes,
+		uint64_t& addr,
+		cs_insn* insn)
+{
+	if (_disassembly == nullptr)
+	{
+		auto basicMode = _c2l->getBasicMode();
+		if (m != basicMode) _c2l->modifyBasicMode(m);
+		bool ok = cs_disasm_iter(
+				_c2l->getCapstoneEngine(),
+				&bytes.first,
+				&bytes.second,
+				&addr,
+				insn);
+		if (m != basicMode) _c2l->modifyBasicMode(basicMode);
+		return ok;
+	}
+
+	return _disassembly->disassemble(
+			getDisassemblyMode(m),
+			&bytes.first,
+			&bytes.second,
+			&addr,
+			insn);
+}
+
+/**
+ * Disassemble one instruction from @a bytes on @a addr into @c _dryCsInsn
+ * in the current mode.
+ */
+bool Decoder::disasmDryRun(ByteData& bytes, uint64_t& addr)
+{
+	return disasm(_c2l->getBasicMode(), bytes, addr, _dryCsInsn);
 }
 
 /**
@@ -1192,15 +1307,14 @@ if (brToSwitch)
 	}
 	while (true)
 	{
-		auto* ci = _image->getImage()->isPointer(tableItemAddr)
-				? _image->getConstantDefault(tableItemAddr)
-				: nullptr;
-		if (ci == nullptr)
+		// isPointer() already reads the item, do not read it again.
+		std::uint64_t ptr = 0;
+		if (!_image->getImage()->isPointer(tableItemAddr, &ptr))
 		{
 			break;
 		}
 
-		Address item = ci->getZExtValue();
+		Address item = ptr;
 		LOG << "\t\t\t\t" << item << " @ " << tableItemAddr << std::endl;
 
 		tableItemAddr += archByteSz;
@@ -1355,7 +1469,7 @@ void Decoder::handleDelaySlotTypical(
 		{
 			break;
 		}
-		_llvm2capstone->emplace(r.llvmInsn, r.capstoneInsn);
+		AsmInstruction::addLlvmToAsmInstruction(r.llvmInsn, r.capstoneInsn);
 	}
 
 	irb.SetInsertPoint(oldIp);
@@ -1412,7 +1526,7 @@ void Decoder::handleDelaySlotLikely(
 			{
 				break;
 			}
-			_llvm2capstone->emplace(res.llvmInsn, res.capstoneInsn);
+			AsmInstruction::addLlvmToAsmInstruction(res.llvmInsn, res.capstoneInsn);
 		}
 
 		_likelyBb2Target.emplace(newBb, target);
@@ -4,6 +4,8 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <thread>
+
 #include "retdec/bin2llvmir/optimizations/decoder/decoder.h"
 #include "retdec/utils/string.h"
 
@@ -96,6 +98,41 @@ void Decoder::initDryRunCsInstruction()
 	_dryCsInsn = cs_malloc(ce);
 }
 
+/**
+ * Initialize store of disassembled instructions with memory budget from
+ * the config.
+ */
+void Decoder::initDisassemblyStore()
+{
+	_disassembly = std::make_unique<common::DisassemblyStore>(
+			_c2l->getArchitecture(),
+			getDisassemblyMode(_c2l->getBasicMode()),
+			_config->getConfig().parameters.getDisassemblyCacheSize());
+}
+
+/**
+ * Initialize worker threads disassembling jump targets ahead of decoding.
+ * One of the decoder threads from the config is left for decoding itself,
+ * there is no speculation if it is the only one.
+ */
+void Decoder::initSpeculativeDisassembler()
+{
+	auto threads = _config->getConfig().parameters.getDecoderThreads();
+	if (threads == 0)
+	{
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads <= 1)
+	{
+		return;
+	}
+
+	_speculation = std::make_unique<SpeculativeDisassembler>(
+			*_disassembly,
+			getDisassemblyMode(_c2l->getBasicMode()),
+			threads - 1);
+}
+
 /**
  * Synchronize metadata between capstone2llvmir and bin2llvmir.
  */
@@ -183,8 +220,7 @@ void Decoder::initEnvironmentRegisters()
  */
 void Decoder::initRanges()
 {
-	JumpTarget::config = _config;
-	JumpTargets::config = _config;
+	_jumpTargets.setConfig(_config);
 
 	auto& arch = _config->getConfig().architecture;
 	unsigned a = 0;
@@ -936,6 +972,7 @@ void Decoder::initStaticCode()
 	LOG << "\n" << "initStaticCode():" << std::endl;
 
 	stacofin::Finder SCA;
+	SCA.setDisassemblyStore(_disassembly.get());
 	SCA.searchAndConfirm(*_image->getImage(), _config->getConfig());
 
 	for (auto& p : SCA.getConfirmedDetections())
@@ -18,8 +18,6 @@ namespace bin2llvmir {
 //==============================================================================
 //
 
-Config* JumpTarget::config = nullptr;
-
 JumpTarget::JumpTarget()
 {
 
@@ -38,11 +36,7 @@ JumpTarget::JumpTarget(
 		_fromAddress(f),
 		_mode(m)
 {
-	if (config->getConfig().architecture.isArm32OrThumb() && _address % 2)
-	{
-		_mode = CS_MODE_THUMB;
-		_address -= 1;
-	}
+
 }
 
 bool JumpTarget::operator<(const JumpTarget& o) const
@@ -157,9 +151,6 @@ std::ostream& operator<<(std::ostream &out, const JumpTarget& jt)
 
 	out << jt.getAddress() << " (" << t << ")";
 
-	auto& arch = jt.config->getConfig().architecture;
-	out << " (" << capstone_utils::mode2string(arch, jt.getMode()) << ")";
-
 	if (jt.getFromAddress().isDefined())
 	{
 		out << ", from = " << jt.getFromAddress();
@@ -178,7 +169,14 @@ std::ostream& operator<<(std::ostream &out, const JumpTarget& jt)
 //==============================================================================
 //
 
-Config* JumpTargets::config = nullptr;
+/**
+ * Set config of the module whose jump targets are pushed. It must be set
+ * before any jump target is pushed.
+ */
+void JumpTargets::setConfig(Config* c)
+{
+	_config = c;
+}
 
 const JumpTarget* JumpTargets::push(
 		retdec::common::Address a,
@@ -187,7 +185,7 @@ const JumpTarget* JumpTargets::push(
 		retdec::common::Address f,
 		std::optional<std::size_t> sz)
 {
-	auto& arch = config->getConfig().architecture;
+	auto& arch = _config->getConfig().architecture;
 
 	if (arch.isArm64() && m == CS_MODE_THUMB)
 	{
@@ -257,10 +255,14 @@ auto JumpTargets::end()
 
 std::ostream& operator<<(std::ostream &out, const JumpTargets& jts)
 {
+	auto& arch = jts._config->getConfig().architecture;
+
 	out << "Jump targets:" << std::endl;
 	for (auto& jt : jts._data)
 	{
-		out << "\t" << jt << std::endl;
+		out << "\t" << jt << " ("
+				<< capstone_utils::mode2string(arch, jt.getMode()) << ")"
+				<< std::endl;
 	}
 	return out;
 }
@@ -47,19 +47,16 @@ bool isBadBranch(FileImage* img, cs_insn* br)
 }
 
 bool Decoder::disasm_mips(
-		csh ce,
 		cs_mode m,
 		ByteData& bytes,
 		uint64_t& a,
 		cs_insn* i)
 {
-	bool ret = cs_disasm_iter(ce, &bytes.first, &bytes.second, &a, i);
+	bool ret = disasm(m, bytes, a, i);
 
 	if (ret == false && (m & CS_MODE_MIPS32))
 	{
-		_c2l->modifyBasicMode(CS_MODE_MIPS64);
-		ret = cs_disasm_iter(ce, &bytes.first, &bytes.second, &a, i);
-		_c2l->modifyBasicMode(CS_MODE_MIPS32);
+		ret = disasm(CS_MODE_MIPS64, bytes, a, i);
 	}
 
 	return ret;
@@ -75,14 +72,12 @@ std::size_t Decoder::decodeJumpTargetDryRun_mips(
 		return true;
 	}
 
-	csh ce = _c2l->getCapstoneEngine();
-
 	uint64_t addr = jt.getAddress();
 	std::size_t nops = 0;
 	bool first = true;
 	unsigned counter = 0;
 	unsigned cfChangePos = 0;
-	while (disasm_mips(ce, _c2l->getBasicMode(), bytes, addr, _dryCsInsn))
+	while (disasm_mips(_c2l->getBasicMode(), bytes, addr, _dryCsInsn))
 	{
 		++counter;
 
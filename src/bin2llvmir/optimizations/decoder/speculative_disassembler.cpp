@@ -0,0 +1,186 @@
+/**
+* @file src/bin2llvmir/optimizations/decoder/speculative_disassembler.cpp
+* @brief Disassembly of jump targets ahead of their decoding.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include "retdec/bin2llvmir/optimizations/decoder/speculative_disassembler.h"
+
+using namespace retdec::common;
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Open Capstone engines and start worker threads.
+ * @param store   Store the instructions are disassembled into.
+ * @param mode    Capstone mode (basic and extra mode) engines are opened
+ *                with, each range then gives its own mode.
+ * @param threads Number of worker threads.
+ *
+ * Engines are opened here, on the calling thread, because Capstone
+ * initializes its global tables in @c cs_open() without any locking.
+ * If an engine cannot be opened, there are fewer workers (possibly none,
+ * then nothing is ever disassembled).
+ */
+SpeculativeDisassembler::SpeculativeDisassembler(
+		common::DisassemblyStore& store,
+		cs_mode mode,
+		std::size_t threads)
+		: _store(store)
+{
+	if (_store.getCapacity() == 0)
+	{
+		return;
+	}
+
+	for (std::size_t i = 0; i < threads; ++i)
+	{
+		csh handle = 0;
+		if (cs_open(_store.getArchitecture(), mode, &handle) != CS_ERR_OK)
+		{
+			break;
+		}
+		if (cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON) != CS_ERR_OK)
+		{
+			cs_close(&handle);
+			break;
+		}
+		_handles.push_back(handle);
+	}
+
+	for (auto handle : _handles)
+	{
+		_workers.emplace_back(
+				&SpeculativeDisassembler::work,
+				this,
+				handle,
+				mode);
+	}
+}
+
+/**
+ * Stop worker threads, queued ranges are dropped.
+ */
+SpeculativeDisassembler::~SpeculativeDisassembler()
+{
+	{
+		std::lock_guard<std::mutex> lock(_tasksMutex);
+		_stop = true;
+		_tasks.clear();
+	}
+	_tasksCv.notify_all();
+	for (auto& w : _workers)
+	{
+		w.join();
+	}
+	for (auto& handle : _handles)
+	{
+		cs_close(&handle);
+	}
+}
+
+/**
+ * Queue range for disassembly. Ranges already queued with the same start
+ * and mode are ignored.
+ * @param start Address of the first instruction.
+ * @param mode  Capstone mode (basic and extra mode) used for disassembly.
+ * @param bytes Bytes on @a start.
+ * @param size  Number of bytes which may be disassembled.
+ */
+void SpeculativeDisassembler::enqueue(
+		common::Address start,
+		cs_mode mode,
+		const std::uint8_t* bytes,
+		std::size_t size)
+{
+	if (_workers.empty() || start.isUndefined() || bytes == nullptr
+			|| size == 0)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_tasksMutex);
+		if (!_enqueued.emplace(start.getValue(), mode).second)
+		{
+			return;
+		}
+
+		Task t;
+		t.start = start;
+		t.mode = mode;
+		t.bytes = bytes;
+		t.size = size;
+		_tasks.push_back(t);
+	}
+	_tasksCv.notify_one();
+}
+
+/**
+ * Worker thread -- disassemble queued ranges until stopped.
+ */
+void SpeculativeDisassembler::work(csh handle, cs_mode handleMode)
+{
+	cs_insn* insn = cs_malloc(handle);
+	while (true)
+	{
+		Task t;
+		{
+			std::unique_lock<std::mutex> lock(_tasksMutex);
+			_tasksCv.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+			if (_stop)
+			{
+				break;
+			}
+			t = _tasks.front();
+			_tasks.pop_front();
+		}
+
+		disassemble(handle, handleMode, insn, t);
+	}
+	cs_free(insn, 1);
+}
+
+/**
+ * Disassemble the given range until an instruction fails to disassemble,
+ * an already stored instruction is reached, or @c maxRangeInstructions
+ * instructions are disassembled.
+ */
+void SpeculativeDisassembler::disassemble(
+		csh handle,
+		cs_mode& handleMode,
+		cs_insn* insn,
+		const Task& t)
+{
+	if (handleMode != t.mode)
+	{
+		if (cs_option(handle, CS_OPT_MODE, t.mode) != CS_ERR_OK)
+		{
+			return;
+		}
+		handleMode = t.mode;
+	}
+
+	const std::uint8_t* bytes = t.bytes;
+	std::size_t size = t.size;
+	std::uint64_t addr = t.start;
+
+	for (std::size_t i = 0; i < maxRangeInstructions; ++i)
+	{
+		if (_store.contains(t.mode, addr))
+		{
+			break;
+		}
+
+		std::size_t available = size;
+		if (!cs_disasm_iter(handle, &bytes, &size, &addr, insn))
+		{
+			break;
+		}
+		_store.insert(t.mode, *insn, available);
+	}
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
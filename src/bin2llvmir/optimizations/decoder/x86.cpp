@@ -25,15 +25,13 @@ std::size_t Decoder::decodeJumpTargetDryRun_x86(
 		return true;
 	}
 
-	csh ce = _c2l->getCapstoneEngine();
-
 	uint64_t addr = jt.getAddress();
 	std::size_t nops = 0;
 	bool first = true;
 	bool storeOneToEax = false;
 	bool lastSyscall = false;
 	std::size_t decodedSz = 0;
-	while (cs_disasm_iter(ce, &bytes.first, &bytes.second, &addr, _dryCsInsn))
+	while (disasmDryRun(bytes, addr))
 	{
 		decodedSz += _dryCsInsn->size;
 		auto& detail = _dryCsInsn->detail->x86;
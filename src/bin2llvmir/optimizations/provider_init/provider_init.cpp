@@ -20,9 +20,10 @@
 #include "retdec/bin2llvmir/providers/fileimage.h"
 #include "retdec/bin2llvmir/providers/lti.h"
 #include "retdec/bin2llvmir/providers/names.h"
+#include "retdec/bin2llvmir/providers/provider_context.h"
 #include "retdec/cpdetect/cpdetect.h"
 #include "retdec/utils/string.h"
-#include "retdec/yaracpp/yara_detector.h"
+#include "retdec/yaracpp/yara_scan_coordinator.h"
 
 using namespace llvm;
 using namespace retdec::utils::io;
@@ -30,6 +31,13 @@ using namespace retdec::utils::io;
 namespace retdec {
 namespace bin2llvmir {
 
+namespace {
+
+/// Name under which crypto patterns are registered in a shared YARA scan.
+const std::string CRYPTO_SCAN_CONSUMER = "crypto";
+
+} // anonymous namespace
+
 common::Pattern saveCryptoRule(
 		const yaracpp::YaraRule &rule,
 		retdec::fileformat::FileFormat* file)
@@ -168,21 +176,27 @@ void ProviderInitialization::setConfig(retdec::config::Config* c)
 	_config = c;
 }
 
+/**
+ * Use the given input file content instead of reading the input file from
+ * the path in config. The memory is not copied, it must outlive the module.
+ */
+void ProviderInitialization::setInputData(
+		const std::uint8_t* data,
+		std::size_t size)
+{
+	_inputData = data;
+	_inputSize = size;
+}
+
 /**
  * @return Always @c false -- this pass does not modify module.
  */
 bool ProviderInitialization::runOnModule(Module& m)
 {
-	AbiProvider::clear();
-	AsmInstruction::clear();
-	ConfigProvider::clear();
-	DebugFormatProvider::clear();
-	DemanglerProvider::clear();
-	FileImageProvider::clear();
-	LtiProvider::clear();
-	NamesProvider::clear();
+	// Drop only data of this module -- other modules may be decompiled
+	// at the same time in other threads.
+	ProviderContext::release(&m);
 	SymbolicTree::clear();
-	CallingConventionProvider::clear();
 
 	// Config.
 	//
@@ -199,10 +213,12 @@ bool ProviderInitialization::runOnModule(Module& m)
 
 	// Fileimage.
 	//
-	auto* f = FileImageProvider::addFileImage(
-			&m,
-			c->getConfig().parameters.getInputFile(),
-			c);
+	auto* f = _inputData
+			? FileImageProvider::addFileImage(&m, _inputData, _inputSize, c)
+			: FileImageProvider::addFileImage(
+					&m,
+					c->getConfig().parameters.getInputFile(),
+					c);
 	if (f == nullptr)
 	{
 		throw std::runtime_error("ProviderInitialization: f == nullptr");
@@ -266,6 +282,11 @@ bool ProviderInitialization::runOnModule(Module& m)
 		throw std::runtime_error("Unsupported target format and architecture combination");
 	}
 
+	// Compiler signatures and crypto patterns are matched by a single YARA
+	// scan of the already loaded input.
+	//
+	yaracpp::YaraScanCoordinator yaraScan;
+
 	// Run cpdetect and set info to config.
 	// TODO: we could probably be using cpdetect results.
 	//
@@ -281,6 +302,15 @@ bool ProviderInitialization::runOnModule(Module& m)
 			searchParams,
 			tools
 	);
+	cd.setSignatureScan(&yaraScan);
+	for (auto& crypto : c->getConfig().parameters.cryptoPatternPaths)
+	{
+		yaraScan.addRuleFile(CRYPTO_SCAN_CONSUMER, crypto);
+	}
+	yaraScan.scan(
+			f->getFileFormat()->getBytesData(),
+			f->getFileFormat()->getFileLength());
+
 	if (cd.getAllInformation() == cpdetect::ReturnCode::OK)
 	{
 		for (auto& t : tools.detectedTools)
@@ -354,15 +384,9 @@ bool ProviderInitialization::runOnModule(Module& m)
 		c->getConfig().architecture.setIsPic32();
 	}
 
-	// YARA crypto patterns scanning.
+	// YARA crypto patterns (scanned together with cpdetect signatures).
 	//
-	yaracpp::YaraDetector yara;
-	for (auto& crypto : c->getConfig().parameters.cryptoPatternPaths)
-	{
-		yara.addRuleFile(crypto);
-	}
-	yara.analyze(c->getConfig().parameters.getInputFile());
-	for(const auto &rule : yara.getDetectedRules())
+	for(const auto &rule : yaraScan.getDetectedRules(CRYPTO_SCAN_CONSUMER))
 	{
 		common::Pattern p = saveCryptoRule(
 				rule,
@@ -403,7 +427,7 @@ bool ProviderInitialization::runOnModule(Module& m)
 
 	NamesProvider::addNames(&m, c, debug, f, d, lti);
 
-	AsmInstruction::clear();
+	AsmInstruction::clear(&m);
 
 	return false;
 }
@@ -82,7 +82,8 @@ bool SimpleTypesAnalysis::runOnModule(Module& M)
 	module = &M;
 	_specialGlobal = AsmInstruction::getLlvmToAsmGlobalVariable(module);
 
-	static bool first = true;
+	// Thread-local, so that parallel decompilations do not share it.
+	static thread_local bool first = true;
 
 	if (first)
 	{
@@ -12,6 +12,7 @@
 
 #include "retdec/bin2llvmir/optimizations/value_protect/value_protect.h"
 #include "retdec/bin2llvmir/providers/names.h"
+#include "retdec/bin2llvmir/providers/provider_context.h"
 #include "retdec/bin2llvmir/utils/ir_modifier.h"
 #include "retdec/bin2llvmir/utils/llvm.h"
 
@@ -259,8 +260,6 @@ llvm::Function* getWriteUndefQword(llvm::Module* m)
 
 char ValueProtect::ID = 0;
 
-std::map<llvm::Type*, llvm::Function*> ValueProtect::_type2fnc;
-
 static RegisterPass<ValueProtect> X(
 		"retdec-value-protect",
 		"Value protection optimization",
@@ -303,16 +302,23 @@ bool ValueProtect::run()
 
 	bool changed = false;
 
-	if (!_type2fnc.empty() && _type2fnc.begin()->second->getParent() != _module)
-	{
-		_type2fnc.clear();
-	}
-
-	changed = _type2fnc.empty() ? protect() : unprotect();
+	_type2fnc = &ProviderContext::getOrCreate(_module).valueProtectFunctions;
+	changed = _type2fnc->empty() ? protect() : unprotect();
 
 	return changed;
 }
 
+/**
+ * Forget functions generated for all modules.
+ */
+void ValueProtect::clear()
+{
+	ProviderContext::forEach([](ProviderContext& ctx)
+	{
+		ctx.valueProtectFunctions.clear();
+	});
+}
+
 bool ValueProtect::protect()
 {
 	// TODO: this is a random place for this. solve better.
@@ -621,8 +627,8 @@ bool ValueProtect::protectLoadStores()
 
 llvm::Function* ValueProtect::getOrCreateFunction(llvm::Type* t)
 {
-	auto fIt = _type2fnc.find(t);
-	return fIt != _type2fnc.end() ? fIt->second : createFunction(t);
+	auto fIt = _type2fnc->find(t);
+	return fIt != _type2fnc->end() ? fIt->second : createFunction(t);
 }
 
 llvm::Function* ValueProtect::createFunction(llvm::Type* t)
@@ -636,9 +642,9 @@ llvm::Function* ValueProtect::createFunction(llvm::Type* t)
 	auto* fnc = Function::Create(
 			ft,
 			GlobalValue::ExternalLinkage,
-			names::generateFunctionNameUndef(_type2fnc.size()),
+			names::generateFunctionNameUndef(_type2fnc->size()),
 			_module);
-	_type2fnc[t] = fnc;
+	(*_type2fnc)[t] = fnc;
 
 	return fnc;
 }
@@ -649,7 +655,7 @@ bool ValueProtect::unprotect()
 
 	std::map<std::pair<Function*, Type*>, Value*> ft2v;
 
-	for (auto& p : _type2fnc)
+	for (auto& p : *_type2fnc)
 	{
 		auto* fnc = p.second;
 
@@ -705,7 +711,7 @@ bool ValueProtect::unprotect()
 		}
 	}
 
-	_type2fnc.clear();
+	_type2fnc->clear();
 	return changed;
 }
 
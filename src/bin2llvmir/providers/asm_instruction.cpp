@@ -11,6 +11,7 @@
 #include "retdec/utils/string.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/providers/names.h"
+#include "retdec/bin2llvmir/providers/provider_context.h"
 #include "retdec/bin2llvmir/utils/debug.h"
 #include "retdec/bin2llvmir/utils/ir_modifier.h"
 #include "retdec/bin2llvmir/utils/llvm.h"
@@ -20,9 +21,6 @@ using namespace llvm;
 namespace retdec {
 namespace bin2llvmir {
 
-std::vector<AsmInstruction::ModuleGlobalPair> AsmInstruction::_module2global;
-std::vector<AsmInstruction::ModuleInstructionMap> AsmInstruction::_module2instMap;
-
 AsmInstruction::AsmInstruction()
 {
 
@@ -35,9 +33,44 @@ AsmInstruction::AsmInstruction(llvm::Instruction* inst)
 		return;
 	}
 
+	// Only owners in the same basic block as the instruction are indexed.
+	// Such an owner is valid if it was found in the current epoch, it was not
+	// erased, and the instruction was not moved to another basic block.
+	// Owners in preceding basic blocks depend on the block layout, they are
+	// always searched for. Instructions are never moved to another ASM
+	// instruction of the same basic block, such a move would not be noticed.
+	//
+	auto* ctx = inst->getParent()
+			? ProviderContext::get(inst->getModule())
+			: nullptr;
+	auto* index = ctx ? &ctx->asmInstructionIndex : nullptr;
+	if (index)
+	{
+		auto it = index->byInstruction.find(inst);
+		if (it != index->byInstruction.end()
+				&& it->second.epoch == index->epoch)
+		{
+			Value* v = it->second.llvmToAsm;
+			auto* s = dyn_cast_or_null<StoreInst>(v);
+			if (s
+					&& s->getParent() == inst->getParent()
+					&& isLlvmToAsmInstructionPrivate(s))
+			{
+				_llvmToAsmInstr = s;
+				return;
+			}
+		}
+	}
+
+	std::vector<Instruction*> visited;
 	auto* bb = inst->getParent();
 	while (inst && !isLlvmToAsmInstructionPrivate(inst))
 	{
+		if (index)
+		{
+			visited.push_back(inst);
+		}
+
 		if (&bb->front() == inst)
 		{
 			if (&bb->getParent()->front() == bb)
@@ -58,6 +91,21 @@ AsmInstruction::AsmInstruction(llvm::Instruction* inst)
 
 	auto* s = dyn_cast_or_null<StoreInst>(inst);
 	_llvmToAsmInstr = isLlvmToAsmInstructionPrivate(s) ? s : nullptr;
+
+	// All the visited instructions have the same owner, index them at once.
+	//
+	if (index && _llvmToAsmInstr)
+	{
+		for (auto* i : visited)
+		{
+			if (i->getParent() == _llvmToAsmInstr->getParent())
+			{
+				auto& owner = index->byInstruction[i];
+				owner.llvmToAsm = _llvmToAsmInstr;
+				owner.epoch = index->epoch;
+			}
+		}
+	}
 }
 
 AsmInstruction::AsmInstruction(llvm::BasicBlock* bb)
@@ -95,6 +143,26 @@ AsmInstruction::AsmInstruction(llvm::Module* m, retdec::common::Address addr)
 		return;
 	}
 
+	auto* ctx = ProviderContext::get(m);
+	if (ctx)
+	{
+		auto& byAddress = ctx->asmInstructionIndex.byAddress;
+		auto it = byAddress.find(addr.getValue());
+		if (it != byAddress.end())
+		{
+			Value* v = it->second;
+			auto* s = dyn_cast_or_null<StoreInst>(v);
+			if (s && isLlvmToAsmInstructionPrivate(s)
+					&& cast<ConstantInt>(s->getValueOperand())->getZExtValue()
+							== addr.getValue())
+			{
+				_llvmToAsmInstr = s;
+				return;
+			}
+			byAddress.erase(it);
+		}
+	}
+
 	ConstantInt* ci = ConstantInt::get(
 			Type::getInt64Ty(m->getContext()),
 			addr,
@@ -109,6 +177,11 @@ AsmInstruction::AsmInstruction(llvm::Module* m, retdec::common::Address addr)
 		if (isLlvmToAsmInstructionPrivate(u))
 		{
 			_llvmToAsmInstr = dyn_cast_or_null<StoreInst>(u);
+			if (ctx)
+			{
+				ctx->asmInstructionIndex.byAddress[addr.getValue()]
+						= _llvmToAsmInstr;
+			}
 			return;
 		}
 	}
@@ -186,38 +259,53 @@ const llvm::GlobalVariable* AsmInstruction::getLlvmToAsmGlobalVariablePrivate(
 Llvm2CapstoneInsnMap& AsmInstruction::getLlvmToCapstoneInsnMap(
 		const llvm::Module* m)
 {
-	for (auto& p : _module2instMap)
-	{
-		if (p.first == m)
-		{
-			return p.second;
-		}
-	}
-
-	auto it = _module2instMap.emplace(_module2instMap.end(), std::make_pair(
-			m,
-			std::map<llvm::StoreInst*, cs_insn*>()));
-	return it->second;
+	return ProviderContext::getOrCreate(m).llvmToCapstoneInsns;
 }
 
 llvm::GlobalVariable* AsmInstruction::getLlvmToAsmGlobalVariable(
 		const llvm::Module* m)
 {
-	for (auto& p : _module2global)
-	{
-		if (p.first == m)
-		{
-			return p.second;
-		}
-	}
-	return nullptr;
+	auto* ctx = ProviderContext::get(m);
+	return ctx ? ctx->llvmToAsmGlobal : nullptr;
 }
 
 void AsmInstruction::setLlvmToAsmGlobalVariable(
 		const llvm::Module* m,
 		llvm::GlobalVariable* gv)
 {
-	_module2global.emplace_back(m, gv);
+	auto& ctx = ProviderContext::getOrCreate(m);
+	ctx.llvmToAsmGlobal = gv;
+	clearIndex(ctx.asmInstructionIndex);
+}
+
+/**
+ * Register a new special LLVM to ASM mapping store @a s created for Capstone
+ * instruction @a insn. The store is indexed by its address.
+ *
+ * Owners of LLVM instructions found so far are invalidated, because @a s may
+ * have been inserted in the middle of another ASM instruction (e.g. delay
+ * slots).
+ */
+void AsmInstruction::addLlvmToAsmInstruction(
+		llvm::StoreInst* s,
+		cs_insn* insn)
+{
+	auto& ctx = ProviderContext::getOrCreate(s->getModule());
+	ctx.llvmToCapstoneInsns.emplace(s, insn);
+
+	auto& index = ctx.asmInstructionIndex;
+	if (auto* ci = dyn_cast<ConstantInt>(s->getValueOperand()))
+	{
+		index.byAddress[ci->getZExtValue()] = s;
+	}
+	++index.epoch;
+}
+
+void AsmInstruction::clearIndex(AsmInstructionIndex& index)
+{
+	index.byAddress.clear();
+	index.byInstruction.clear();
+	++index.epoch;
 }
 
 retdec::common::Address AsmInstruction::getInstructionAddress(
@@ -328,8 +416,25 @@ bool AsmInstruction::isLlvmToAsmInstruction(const llvm::Value* inst)
 
 void AsmInstruction::clear()
 {
-	_module2global.clear();
-	_module2instMap.clear();
+	ProviderContext::forEach([](ProviderContext& ctx)
+	{
+		ctx.llvmToAsmGlobal = nullptr;
+		ctx.llvmToCapstoneInsns.clear();
+		clearIndex(ctx.asmInstructionIndex);
+	});
+}
+
+/**
+ * Clear data only for the given module @a m.
+ */
+void AsmInstruction::clear(const llvm::Module* m)
+{
+	if (auto* ctx = ProviderContext::get(m))
+	{
+		ctx->llvmToAsmGlobal = nullptr;
+		ctx->llvmToCapstoneInsns.clear();
+		clearIndex(ctx->asmInstructionIndex);
+	}
 }
 
 bool AsmInstruction::isValid() const
@@ -344,16 +449,14 @@ bool AsmInstruction::isInvalid() const
 
 cs_insn* AsmInstruction::getCapstoneInsn() const
 {
-	for (auto& p : _module2instMap)
+	auto* ctx = ProviderContext::get(_llvmToAsmInstr->getModule());
+	if (ctx == nullptr)
 	{
-		if (p.first == _llvmToAsmInstr->getModule())
-		{
-			auto it =  p.second.find(_llvmToAsmInstr);
-			return it != p.second.end() ? it->second : nullptr;
-		}
+		return nullptr;
 	}
 
-	return nullptr;
+	auto it = ctx->llvmToCapstoneInsns.find(_llvmToAsmInstr);
+	return it != ctx->llvmToCapstoneInsns.end() ? it->second : nullptr;
 }
 
 std::string AsmInstruction::getDsm() const
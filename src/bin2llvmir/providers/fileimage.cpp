@@ -6,6 +6,7 @@
 
 #include "retdec/utils/string.h"
 #include "retdec/bin2llvmir/providers/fileimage.h"
+#include "retdec/bin2llvmir/providers/provider_context.h"
 #include "retdec/bin2llvmir/utils/ir_modifier.h"
 #include "retdec/loader/image_factory.h"
 #include "retdec/loader/loader/raw_data/raw_data_image.h"
@@ -30,7 +31,26 @@ FileImage::FileImage(
 				m,
 				retdec::loader::createImage(
 						path,
-						config->getConfig().fileFormat.isRaw()),
+						config->getConfig().fileFormat.isRaw(),
+						retdec::fileformat::LoadFlags::LAZY_LOADING),
+				config)
+{
+
+}
+
+FileImage::FileImage(
+		llvm::Module* m,
+		const std::uint8_t* data,
+		std::size_t size,
+		Config* config)
+		:
+		FileImage(
+				m,
+				retdec::loader::createImage(
+						data,
+						size,
+						config->getConfig().fileFormat.isRaw(),
+						retdec::fileformat::LoadFlags::LAZY_LOADING),
 				config)
 {
 
@@ -625,8 +645,6 @@ bool FileImage::isImportTerminating(
 //=============================================================================
 //
 
-std::map<llvm::Module*, FileImage> FileImageProvider::_module2image;
-
 /**
  * Create and add to provider a file image created from file at @a path for
  * the given module @a m and architecture @a a.
@@ -641,6 +659,22 @@ FileImage* FileImageProvider::addFileImage(
 	return addFileImage(m, FileImage(m, path, config));
 }
 
+/**
+ * Create and add to provider a file image created from file content @a data
+ * already loaded in memory for the given module @a m. The content is not
+ * copied, it must outlive the module.
+ * @return Created and added file image or @c nullptr if something went wrong
+ *         and it was not successfully created.
+ */
+FileImage* FileImageProvider::addFileImage(
+		llvm::Module* m,
+		const std::uint8_t* data,
+		std::size_t size,
+		Config *config)
+{
+	return addFileImage(m, FileImage(m, data, size, config));
+}
+
 /**
  * Create and add to provider a file image @a ff for the given module @a m
  * and architecture @a a.
@@ -659,8 +693,12 @@ FileImage* FileImageProvider::addFileImage(
 		llvm::Module* m,
 		FileImage img)
 {
-	auto p = _module2image.emplace(m, std::move(img));
-	return &p.first->second;
+	auto& ctx = ProviderContext::getOrCreate(m);
+	if (ctx.fileImage == nullptr)
+	{
+		ctx.fileImage = std::make_unique<FileImage>(std::move(img));
+	}
+	return ctx.fileImage.get();
 }
 
 /**
@@ -670,8 +708,8 @@ FileImage* FileImageProvider::addFileImage(
 FileImage* FileImageProvider::getFileImage(
 		llvm::Module* m)
 {
-	auto f = _module2image.find(m);
-	return f != _module2image.end() ? &f->second : nullptr;
+	auto* ctx = ProviderContext::get(m);
+	return ctx ? ctx->fileImage.get() : nullptr;
 }
 
 /**
@@ -695,7 +733,10 @@ bool FileImageProvider::getFileImage(
  */
 void FileImageProvider::clear()
 {
-	_module2image.clear();
+	ProviderContext::forEach([](ProviderContext& ctx)
+	{
+		ctx.fileImage.reset();
+	});
 }
 
 } // namespace bin2llvmir
@@ -18,6 +18,7 @@
 #include "retdec/ctypes/void_type.h"
 #include "retdec/utils/string.h"
 #include "retdec/bin2llvmir/providers/lti.h"
+#include "retdec/bin2llvmir/providers/provider_context.h"
 #include "retdec/bin2llvmir/utils/ctypes2llvm.h"
 
 using namespace llvm;
@@ -234,8 +235,6 @@ llvm::Type* Lti::getLlvmType(std::shared_ptr<retdec::ctypes::Type> type)
 //=============================================================================
 //
 
-std::map<llvm::Module*, Lti> LtiProvider::_module2lti;
-
 Lti* LtiProvider::addLti(
 	llvm::Module *m,
 	Config *c,
@@ -247,14 +246,18 @@ Lti* LtiProvider::addLti(
 		return nullptr;
 	}
 
-	auto p = _module2lti.emplace(m, Lti(m, c, typeConfig, objf));
-	return &p.first->second;
+	auto& ctx = ProviderContext::getOrCreate(m);
+	if (ctx.lti == nullptr)
+	{
+		ctx.lti = std::make_unique<Lti>(m, c, typeConfig, objf);
+	}
+	return ctx.lti.get();
 }
 
 Lti* LtiProvider::getLti(llvm::Module* m)
 {
-	auto f = _module2lti.find(m);
-	return f != _module2lti.end() ? &f->second : nullptr;
+	auto* ctx = ProviderContext::get(m);
+	return ctx ? ctx->lti.get() : nullptr;
 }
 
 bool LtiProvider::getLti(llvm::Module* m, Lti*& lti)
@@ -265,7 +268,10 @@ bool LtiProvider::getLti(llvm::Module* m, Lti*& lti)
 
 void LtiProvider::clear()
 {
-	_module2lti.clear();
+	ProviderContext::forEach([](ProviderContext& ctx)
+	{
+		ctx.lti.reset();
+	});
 }
 
 } // namespace bin2llvmir
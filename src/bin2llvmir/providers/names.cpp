@@ -5,6 +5,7 @@
 */
 
 #include "retdec/bin2llvmir/providers/names.h"
+#include "retdec/bin2llvmir/providers/provider_context.h"
 #include "retdec/utils/string.h"
 
 using namespace retdec::common;
@@ -544,8 +545,6 @@ bool NameContainer::loadImportOrds(const std::string& libName)
 //==============================================================================
 //
 
-std::map<llvm::Module*, NameContainer> NamesProvider::_module2names;
-
 NameContainer* NamesProvider::addNames(
 		llvm::Module* m,
 		Config* c,
@@ -563,14 +562,18 @@ NameContainer* NamesProvider::addNames(
 		return nullptr;
 	}
 
-	auto p = _module2names.emplace(m, NameContainer(m, c, d, i, dm, lti));
-	return &p.first->second;
+	auto& ctx = ProviderContext::getOrCreate(m);
+	if (ctx.names == nullptr)
+	{
+		ctx.names = std::make_unique<NameContainer>(m, c, d, i, dm, lti);
+	}
+	return ctx.names.get();
 }
 
 NameContainer* NamesProvider::getNames(llvm::Module* m)
 {
-	auto f = _module2names.find(m);
-	return f != _module2names.end() ? &f->second : nullptr;
+	auto* ctx = ProviderContext::get(m);
+	return ctx ? ctx->names.get() : nullptr;
 }
 
 bool NamesProvider::getNames(llvm::Module* m, NameContainer*& names)
@@ -581,7 +584,10 @@ bool NamesProvider::getNames(llvm::Module* m, NameContainer*& names)
 
 void NamesProvider::clear()
 {
-	_module2names.clear();
+	ProviderContext::forEach([](ProviderContext& ctx)
+	{
+		ctx.names.reset();
+	});
 }
 
 } // namespace bin2llvmir
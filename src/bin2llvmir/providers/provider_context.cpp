@@ -0,0 +1,129 @@
+/**
+ * @file src/bin2llvmir/providers/provider_context.cpp
+ * @brief Per-module storage of all the data held by bin2llvmir providers.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "retdec/bin2llvmir/providers/abi/abi.h"
+#include "retdec/bin2llvmir/providers/config.h"
+#include "retdec/bin2llvmir/providers/debugformat.h"
+#include "retdec/bin2llvmir/providers/demangler.h"
+#include "retdec/bin2llvmir/providers/fileimage.h"
+#include "retdec/bin2llvmir/providers/lti.h"
+#include "retdec/bin2llvmir/providers/names.h"
+#include "retdec/bin2llvmir/providers/provider_context.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+namespace {
+
+std::shared_mutex contextsMutex;
+std::unordered_map<
+		const llvm::Module*,
+		std::unique_ptr<ProviderContext>> contexts;
+
+/// Incremented each time a context is created or released. Thread-local
+/// caches below are valid only if their generation matches this one.
+std::atomic<std::size_t> contextsGeneration = 0;
+
+// Providers are queried all the time (e.g. each AsmInstruction construction),
+// almost always for the same module. Remember the last hit in each thread to
+// avoid taking the lock.
+thread_local const llvm::Module* lastModule = nullptr;
+thread_local ProviderContext* lastContext = nullptr;
+thread_local std::size_t lastGeneration = 0;
+
+} // anonymous namespace
+
+ProviderContext::~ProviderContext()
+{
+
+}
+
+/**
+ * @return Context associated with the given module @a m or @c nullptr
+ *         if there is no associated context.
+ */
+ProviderContext* ProviderContext::get(const llvm::Module* m)
+{
+	auto generation = contextsGeneration.load(std::memory_order_acquire);
+	if (m == lastModule && generation == lastGeneration)
+	{
+		return lastContext;
+	}
+
+	std::shared_lock<std::shared_mutex> lock(contextsMutex);
+	auto f = contexts.find(m);
+	auto* ctx = f != contexts.end() ? f->second.get() : nullptr;
+
+	lastModule = m;
+	lastContext = ctx;
+	lastGeneration = contextsGeneration.load(std::memory_order_relaxed);
+
+	return ctx;
+}
+
+/**
+ * @return Context associated with the given module @a m. If there is no such
+ *         context, a new empty one is created.
+ */
+ProviderContext& ProviderContext::getOrCreate(const llvm::Module* m)
+{
+	if (auto* ctx = get(m))
+	{
+		return *ctx;
+	}
+
+	std::unique_lock<std::shared_mutex> lock(contextsMutex);
+	auto& ctx = contexts[m];
+	if (ctx == nullptr)
+	{
+		ctx = std::make_unique<ProviderContext>();
+		++contextsGeneration;
+	}
+	return *ctx;
+}
+
+/**
+ * Destroy context associated with the given module @a m (if any).
+ * This must be done before the module itself is destroyed.
+ */
+void ProviderContext::release(const llvm::Module* m)
+{
+	std::unique_ptr<ProviderContext> ctx;
+	{
+		std::unique_lock<std::shared_mutex> lock(contextsMutex);
+		auto f = contexts.find(m);
+		if (f == contexts.end())
+		{
+			return;
+		}
+		ctx = std::move(f->second);
+		contexts.erase(f);
+		++contextsGeneration;
+	}
+	// ctx is destroyed here, outside of the lock.
+}
+
+/**
+ * Call @a f for all existing contexts.
+ * Used by providers' @c clear() methods that clear data for all modules.
+ */
+void ProviderContext::forEach(
+		const std::function<void(ProviderContext&)>& f)
+{
+	std::unique_lock<std::shared_mutex> lock(contextsMutex);
+	for (auto& p : contexts)
+	{
+		f(*p.second);
+	}
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
@@ -4,6 +4,7 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <atomic>
 #include <fstream>
 
 #include <llvm/IR/CFG.h>
@@ -57,7 +58,7 @@ void dumpModuleToFile(
 		fs::path dirName,
 		const std::string& fileName)
 {
-	static unsigned cntr = 0;
+	static std::atomic<unsigned> cntr = 0;
 	std::string n = fileName.empty()
 			? "dump_" + std::to_string(cntr++) + ".ll"
 			: fileName;
@@ -256,15 +256,7 @@ Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translateOne(
 
 	if (disasmRes)
 	{
-		auto* a2l = generateSpecialAsm2LlvmInstr(irb, insn);
-		translateInstruction(insn, irb);
-
-		res.llvmInsn = a2l;
-		res.capstoneInsn = insn;
-		res.size = insn->size;
-		res.branchCall = _branchGenerated;
-		res.inCondition = _inCondition;
-
+		res = translateOne(insn, irb);
 		a = address;
 	}
 	else
@@ -275,6 +267,29 @@ Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translateOne(
 	return res;
 }
 
+template <typename CInsn, typename CInsnOp>
+typename Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::TranslationResultOne
+Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translateOne(
+		cs_insn* insn,
+		llvm::IRBuilder<>& irb)
+{
+	TranslationResultOne res;
+
+	_branchGenerated = nullptr;
+	_inCondition = false;
+
+	auto* a2l = generateSpecialAsm2LlvmInstr(irb, insn);
+	translateInstruction(insn, irb);
+
+	res.llvmInsn = a2l;
+	res.capstoneInsn = insn;
+	res.size = insn->size;
+	res.branchCall = _branchGenerated;
+	res.inCondition = _inCondition;
+
+	return res;
+}
+
 //
 //==============================================================================
 // Capstone related getters - from Capstone2LlvmIrTranslator.
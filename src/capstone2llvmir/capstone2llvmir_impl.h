@@ -77,6 +77,9 @@ class Capstone2LlvmIrTranslator_impl : virtual public Capstone2LlvmIrTranslator
 				std::size_t& size,
 				retdec::common::Address& a,
 				llvm::IRBuilder<>& irb) override;
+		virtual TranslationResultOne translateOne(
+				cs_insn* insn,
+				llvm::IRBuilder<>& irb) override;
 //
 //==============================================================================
 // Capstone related getters - from Capstone2LlvmIrTranslator.
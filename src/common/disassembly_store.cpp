@@ -0,0 +1,274 @@
+/**
+ * @file src/common/disassembly_store.cpp
+ * @brief Cache of disassembled instructions shared by several consumers.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+
+#include "retdec/common/disassembly_store.h"
+
+namespace retdec {
+namespace common {
+
+namespace {
+
+/// Maximal number of slots allocated at once.
+const std::size_t maxChunkSize = 1024;
+
+} // anonymous namespace
+
+/**
+ * Constructor
+ * @param arch   Capstone architecture of all cached instructions.
+ * @param mode   Capstone mode the store's own engine is opened with.
+ * @param budget Memory budget in bytes. If it is too small for even one
+ *               instruction, nothing is cached.
+ */
+DisassemblyStore::DisassemblyStore(
+		cs_arch arch,
+		cs_mode mode,
+		std::size_t budget) :
+		_arch(arch),
+		_budget(budget),
+		_handleMode(mode)
+{
+	// Index entry and its hash table node are included in the slot cost.
+	const std::size_t slotCost = sizeof(Slot)
+			+ sizeof(Key) + sizeof(Slot*) + 4 * sizeof(void*);
+	_capacity = _budget / slotCost;
+	_chunkSize = std::min(_capacity, maxChunkSize);
+
+	_handleOk = cs_open(_arch, _handleMode, &_handle) == CS_ERR_OK
+			&& cs_option(_handle, CS_OPT_DETAIL, CS_OPT_ON) == CS_ERR_OK;
+}
+
+/**
+ * Destructor
+ */
+DisassemblyStore::~DisassemblyStore()
+{
+	if (_handle != 0)
+	{
+		cs_close(&_handle);
+	}
+}
+
+/**
+ * Disassemble one instruction, the same way as @c cs_disasm_iter().
+ * @param mode    Capstone mode (basic and extra mode).
+ * @param code    Bytes to disassemble, moved after the instruction.
+ * @param size    Number of bytes, decreased by the instruction size.
+ * @param address Address of the bytes, moved after the instruction.
+ * @param insn    Instruction allocated by @c cs_malloc() of an engine with
+ *                instruction details on, it is overwritten.
+ * @return @c True if an instruction was disassembled, @c false otherwise.
+ *
+ * The instruction is taken from the cache, or disassembled and cached.
+ */
+bool DisassemblyStore::disassemble(
+		cs_mode mode,
+		const std::uint8_t** code,
+		std::size_t* size,
+		std::uint64_t* address,
+		cs_insn* insn)
+{
+	if (find(mode, *address, *size, insn))
+	{
+		*code += insn->size;
+		*size -= insn->size;
+		*address += insn->size;
+		return true;
+	}
+
+	const std::size_t available = *size;
+	{
+		std::lock_guard<std::mutex> lock(_handleMutex);
+		if (!_handleOk)
+		{
+			return false;
+		}
+		if (_handleMode != mode)
+		{
+			if (cs_option(_handle, CS_OPT_MODE, mode) != CS_ERR_OK)
+			{
+				return false;
+			}
+			_handleMode = mode;
+		}
+		if (!cs_disasm_iter(_handle, code, size, address, insn))
+		{
+			return false;
+		}
+	}
+
+	insert(mode, *insn, available);
+	return true;
+}
+
+/**
+ * Copy cached instruction.
+ * @param mode    Capstone mode (basic and extra mode).
+ * @param address Address of the instruction.
+ * @param size    Number of bytes on @a address which may be disassembled.
+ * @param insn    Instruction allocated by @c cs_malloc() of an engine with
+ *                instruction details on, it is overwritten.
+ * @return @c True if the instruction was found and copied, @c false if it
+ *         is not cached or it was disassembled from different bytes.
+ */
+bool DisassemblyStore::find(
+		cs_mode mode,
+		std::uint64_t address,
+		std::size_t size,
+		cs_insn* insn) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto* s = findSlot(mode, address, size);
+	if (s == nullptr)
+	{
+		return false;
+	}
+
+	auto* detail = insn->detail;
+	*insn = s->insn;
+	insn->detail = detail;
+	if (detail)
+	{
+		*detail = s->detail;
+	}
+	return true;
+}
+
+/**
+ * Is there any instruction cached on the given address in the given mode?
+ */
+bool DisassemblyStore::contains(cs_mode mode, std::uint64_t address) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _index.count(Key(address, mode));
+}
+
+/**
+ * Cache instruction disassembled elsewhere.
+ * @param mode      Capstone mode (basic and extra mode) of the instruction.
+ * @param insn      Instruction with details.
+ * @param available Number of bytes which Capstone got when the instruction
+ *                  was disassembled.
+ *
+ * Already cached instruction on the same address is kept.
+ */
+void DisassemblyStore::insert(
+		cs_mode mode,
+		const cs_insn& insn,
+		std::size_t available)
+{
+	if (insn.detail == nullptr)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_capacity == 0 || _index.count(Key(insn.address, mode)))
+	{
+		return;
+	}
+
+	auto* s = allocateSlot();
+	s->insn = insn;
+	s->detail = *insn.detail;
+	s->insn.detail = &s->detail;
+	s->available = available;
+	_index.emplace(Key(insn.address, mode), s);
+}
+
+/**
+ * Drop all cached instructions. Allocated slots are kept for reuse.
+ */
+void DisassemblyStore::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_index.clear();
+	_used = 0;
+}
+
+/**
+ * @return @c True if the store's own engine was opened, i.e. it is able
+ *         to disassemble, @c false otherwise.
+ */
+bool DisassemblyStore::isOk() const
+{
+	return _handleOk;
+}
+
+cs_arch DisassemblyStore::getArchitecture() const
+{
+	return _arch;
+}
+
+std::size_t DisassemblyStore::getBudget() const
+{
+	return _budget;
+}
+
+/**
+ * @return Maximal number of instructions which can be cached at once.
+ */
+std::size_t DisassemblyStore::getCapacity() const
+{
+	return _capacity;
+}
+
+std::size_t DisassemblyStore::getInstructionCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _index.size();
+}
+
+/**
+ * Find slot of cached instruction, @c _mutex must be locked.
+ */
+const DisassemblyStore::Slot* DisassemblyStore::findSlot(
+		cs_mode mode,
+		std::uint64_t address,
+		std::size_t size) const
+{
+	auto it = _index.find(Key(address, mode));
+	if (it == _index.end())
+	{
+		return nullptr;
+	}
+
+	auto* s = it->second;
+	if (s->insn.size > size
+			|| std::min(s->available, maxInstructionSize)
+					!= std::min(size, maxInstructionSize))
+	{
+		return nullptr;
+	}
+	return s;
+}
+
+/**
+ * Get unused slot, @c _mutex must be locked and @c _capacity must not be
+ * zero. If the whole capacity is used, all instructions are dropped.
+ */
+DisassemblyStore::Slot* DisassemblyStore::allocateSlot()
+{
+	if (_used == _capacity)
+	{
+		_index.clear();
+		_used = 0;
+	}
+
+	if (_used == _chunks.size() * _chunkSize)
+	{
+		auto size = std::min(_chunkSize, _capacity - _used);
+		_chunks.emplace_back(new Slot[size]);
+	}
+
+	auto& chunk = _chunks[_used / _chunkSize];
+	return &chunk[_used++ % _chunkSize];
+}
+
+} // namespace common
+} // namespace retdec
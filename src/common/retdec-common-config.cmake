@@ -3,6 +3,7 @@ if(NOT TARGET retdec::common)
     find_package(retdec @PROJECT_VERSION@ REQUIRED
         COMPONENTS
             utils
+            capstone
     )
 
     include(${CMAKE_CURRENT_LIST_DIR}/retdec-common-targets.cmake)
@@ -39,6 +39,7 @@ const std::string JSON_outputAsmFile            = "outputAsmFile";
 const std::string JSON_outputLlFile             = "outputLlFile";
 const std::string JSON_outputConfigFile         = "outputConfigFile";
 const std::string JSON_outputUnpackedFile       = "outputUnpackedFile";
+const std::string JSON_outputProfileFile        = "outputProfileFile";
 const std::string JSON_outputFormat             = "outputFormat";
 const std::string JSON_logFile                  = "logFile";
 const std::string JSON_errFile                  = "errFile";
@@ -58,10 +59,15 @@ const std::string JSON_backendNoTimeVaryingInfo = "backendNoTimeVaryingInfo";
 const std::string JSON_backendNoVarRenaming     = "backendNoVarRenaming";
 const std::string JSON_backendNoCompoundOperators = "backendNoCompoundOperators";
 const std::string JSON_backendNoSymbolicNames   = "backendNoSymbolicNames";
+const std::string JSON_backendThreads           = "backendThreads";
 
 const std::string JSON_timeout                  = "timeout";
+const std::string JSON_fixedPointPipeline       = "fixedPointPipeline";
+const std::string JSON_pipelineBudget           = "pipelineBudget";
 const std::string JSON_maxMemoryLimit           = "maxMemoryLimit";
 const std::string JSON_maxMemoryLimitHalfRam    = "maxMemoryLimitHalfRam";
+const std::string JSON_disassemblyCacheSize     = "disassemblyCacheSize";
+const std::string JSON_decoderThreads           = "decoderThreads";
 
 } // anonymous namespace
 
@@ -168,6 +174,20 @@ bool Parameters::isTimeout() const
 	return _timeout != 0;
 }
 
+/**
+ * @return Repetitions of LLVM pass groups are skipped once they stop
+ *         changing the module.
+ */
+bool Parameters::isFixedPointPipeline() const
+{
+	return _fixedPointPipeline;
+}
+
+bool Parameters::isPipelineBudget() const
+{
+	return _pipelineBudget != 0;
+}
+
 void Parameters::setIsVerboseOutput(bool b)
 {
 	_verboseOutput = b;
@@ -212,6 +232,11 @@ void Parameters::setOutputUnpackedFile(const std::string& file)
 	_outputUnpackedFile = file;
 }
 
+void Parameters::setOutputProfileFile(const std::string& file)
+{
+	_outputProfileFile = file;
+}
+
 void Parameters::setOutputFormat(const std::string& format)
 {
 	_outputFormat = format;
@@ -257,6 +282,46 @@ void Parameters::setTimeout(uint64_t seconds)
 	_timeout = seconds;
 }
 
+void Parameters::setIsFixedPointPipeline(bool b)
+{
+	_fixedPointPipeline = b;
+}
+
+/**
+ * Set time (in seconds) after which repetitions of LLVM pass groups are
+ * skipped even if they would change the module. It has effect only in the
+ * fixed-point pipeline mode. Zero means no limit.
+ */
+void Parameters::setPipelineBudget(uint64_t seconds)
+{
+	_pipelineBudget = seconds;
+}
+
+void Parameters::setDisassemblyCacheSize(uint64_t bytes)
+{
+	_disassemblyCacheSize = bytes;
+}
+
+/**
+ * Set number of threads used by the decoder. One of them decodes, the others
+ * disassemble jump targets ahead of it. One disables the speculative
+ * disassembly, zero means as many threads as the hardware supports.
+ */
+void Parameters::setDecoderThreads(uint64_t threads)
+{
+	_decoderThreads = threads;
+}
+
+/**
+ * Set maximal number of threads used by back-end optimizations which
+ * optimize each function separately. Values lower than two disable
+ * parallel optimizations.
+ */
+void Parameters::setBackendThreads(uint64_t threads)
+{
+	_backendThreads = threads;
+}
+
 void Parameters::setEntryPoint(const retdec::common::Address& a)
 {
 	_entryPoint = a;
@@ -391,6 +456,11 @@ const std::string& Parameters::getOutputUnpackedFile() const
 	return _outputUnpackedFile;
 }
 
+const std::string& Parameters::getOutputProfileFile() const
+{
+	return _outputProfileFile;
+}
+
 const std::string& Parameters::getOutputFormat() const
 {
 	return _outputFormat;
@@ -416,6 +486,30 @@ uint64_t Parameters::getTimeout() const
 	return _timeout;
 }
 
+uint64_t Parameters::getPipelineBudget() const
+{
+	return _pipelineBudget;
+}
+
+/**
+ * @return Memory budget (in bytes) of instructions disassembled from the
+ * input and shared by all their consumers. Zero disables caching.
+ */
+uint64_t Parameters::getDisassemblyCacheSize() const
+{
+	return _disassemblyCacheSize;
+}
+
+uint64_t Parameters::getDecoderThreads() const
+{
+	return _decoderThreads;
+}
+
+uint64_t Parameters::getBackendThreads() const
+{
+	return _backendThreads;
+}
+
 retdec::common::Address Parameters::getEntryPoint() const
 {
 	return _entryPoint;
@@ -507,6 +601,7 @@ void Parameters::serialize(Writer& writer) const
 	serdes::serializeString(writer, JSON_outputLlFile, getOutputLlvmirFile());
 	serdes::serializeString(writer, JSON_outputConfigFile, getOutputConfigFile());
 	serdes::serializeString(writer, JSON_outputUnpackedFile, getOutputUnpackedFile());
+	serdes::serializeString(writer, JSON_outputProfileFile, getOutputProfileFile());
 	serdes::serializeString(writer, JSON_outputFormat, getOutputFormat());
 	serdes::serializeString(writer, JSON_logFile, getLogFile());
 	serdes::serializeString(writer, JSON_errFile, getErrFile());
@@ -526,10 +621,15 @@ void Parameters::serialize(Writer& writer) const
 	serdes::serializeBool(writer, JSON_backendNoVarRenaming, isBackendNoVarRenaming());
 	serdes::serializeBool(writer, JSON_backendNoCompoundOperators, isBackendNoCompoundOperators());
 	serdes::serializeBool(writer, JSON_backendNoSymbolicNames, isBackendNoSymbolicNames());
+	serdes::serializeUint64(writer, JSON_backendThreads, getBackendThreads());
 
 	serdes::serializeUint64(writer, JSON_timeout, getTimeout());
+	serdes::serializeBool(writer, JSON_fixedPointPipeline, isFixedPointPipeline());
+	serdes::serializeUint64(writer, JSON_pipelineBudget, getPipelineBudget());
 	serdes::serializeUint64(writer, JSON_maxMemoryLimit, getMaxMemoryLimit());
 	serdes::serializeBool(writer, JSON_maxMemoryLimitHalfRam, isMaxMemoryLimitHalfRam());
+	serdes::serializeUint64(writer, JSON_disassemblyCacheSize, getDisassemblyCacheSize());
+	serdes::serializeUint64(writer, JSON_decoderThreads, getDecoderThreads());
 
 	serdes::serializeContainer(writer, JSON_selectedRanges, selectedRanges);
 	serdes::serializeContainer(writer, JSON_userStaticSigPaths, userStaticSignaturePaths);
@@ -576,6 +676,7 @@ void Parameters::deserialize(const rapidjson::Value& val)
 	setOutputLlvmirFile( serdes::deserializeString(val, JSON_outputLlFile) );
 	setOutputConfigFile( serdes::deserializeString(val, JSON_outputConfigFile) );
 	setOutputUnpackedFile( serdes::deserializeString(val, JSON_outputUnpackedFile) );
+	setOutputProfileFile( serdes::deserializeString(val, JSON_outputProfileFile) );
 	setOutputFormat( serdes::deserializeString(val, JSON_outputFormat) );
 	setLogFile( serdes::deserializeString(val, JSON_logFile) );
 	setErrFile( serdes::deserializeString(val, JSON_errFile) );
@@ -595,10 +696,15 @@ void Parameters::deserialize(const rapidjson::Value& val)
 	setIsBackendNoVarRenaming( serdes::deserializeBool(val, JSON_backendNoVarRenaming, false) );
 	setIsBackendNoCompoundOperators( serdes::deserializeBool(val, JSON_backendNoCompoundOperators, false) );
 	setIsBackendNoSymbolicNames( serdes::deserializeBool(val, JSON_backendNoSymbolicNames, false) );
+	setBackendThreads( serdes::deserializeUint64(val, JSON_backendThreads, 1) );
 
 	setTimeout( serdes::deserializeUint64(val, JSON_timeout, 0) );
+	setIsFixedPointPipeline( serdes::deserializeBool(val, JSON_fixedPointPipeline, false) );
+	setPipelineBudget( serdes::deserializeUint64(val, JSON_pipelineBudget, 0) );
 	setMaxMemoryLimit( serdes::deserializeUint64(val, JSON_maxMemoryLimit, 0) );
 	setIsMaxMemoryLimitHalfRam( serdes::deserializeBool(val, JSON_maxMemoryLimitHalfRam, true) );
+	setDisassemblyCacheSize( serdes::deserializeUint64(val, JSON_disassemblyCacheSize, 64 * 1024 * 1024) );
+	setDecoderThreads( serdes::deserializeUint64(val, JSON_decoderThreads, 0) );
 
 	serdes::deserialize(val, JSON_entryPoint, _entryPoint);
 	serdes::deserialize(val, JSON_mainAddress, _mainAddress);
@@ -15,7 +15,7 @@
 #include "retdec/cpdetect/heuristics/macho_heuristics.h"
 #include "retdec/cpdetect/heuristics/pe_heuristics.h"
 #include "retdec/cpdetect/settings.h"
-#include "retdec/yaracpp/yara_detector.h"
+#include "retdec/yaracpp/yara_scan_coordinator.h"
 
 using namespace retdec::fileformat;
 using namespace retdec::utils;
@@ -493,37 +493,64 @@ void CompilerDetector::getAllHeuristics()
 }
 
 /**
- * Try detect used compiler (or packer) based on signatures
- * @return Status of detection (ReturnCode::OK if all is OK)
+ * Register internal and external signature files in the given scan
+ * @param scan Scan of the input file
  */
-ReturnCode CompilerDetector::getAllSignatures()
+void CompilerDetector::addSignatureRules(yaracpp::YaraScanCoordinator &scan)
 {
-	YaraDetector yara;
+	const auto storeAllRules = cpParams.searchType != SearchType::EXACT_MATCH;
 
-	// Add internal paths.
-	unsigned iCntr = 0;
 	for (const auto &ruleFile : internalPaths)
 	{
-		std::string nameSpace = "internal_" + std::to_string(iCntr++);
-		yara.addRuleFile(ruleFile, nameSpace);
+		scan.addRuleFile(YARA_SCAN_CONSUMER, ruleFile, storeAllRules);
 	}
 
-	unsigned eCntr = 0;
 	if (cpParams.external && getExternalDatabases())
 	{
 		for (const auto &item : externalDatabase)
 		{
-			std::string nameSpace = "external_" + std::to_string(eCntr++);
-			yara.addRuleFile(item, nameSpace);
+			scan.addRuleFile(YARA_SCAN_CONSUMER, item, storeAllRules);
 		}
 	}
+}
+
+/**
+ * Use YARA scan shared with other consumers of the same input file
+ * @param scan Shared scan or @c nullptr to scan the input on its own
+ *
+ * Signature files are registered in @a scan immediately. If the scan was not
+ * run before the detection, it is run by the detection.
+ */
+void CompilerDetector::setSignatureScan(yaracpp::YaraScanCoordinator *scan)
+{
+	signatureScan = scan;
+	if (signatureScan)
+	{
+		addSignatureRules(*signatureScan);
+	}
+}
 
-	yara.analyze(
-			fileParser.getPathToFile(),
-			cpParams.searchType != SearchType::EXACT_MATCH
-	);
-	const auto &detected = yara.getDetectedRules();
-	const auto &undetected = yara.getUndetectedRules();
+/**
+ * Try detect used compiler (or packer) based on signatures
+ * @return Status of detection (ReturnCode::OK if all is OK)
+ */
+ReturnCode CompilerDetector::getAllSignatures()
+{
+	YaraScanCoordinator ownScan;
+	auto *scan = signatureScan;
+	if (!scan)
+	{
+		addSignatureRules(ownScan);
+		scan = &ownScan;
+	}
+
+	// Scan already loaded bytes -- there is no need to read the file again.
+	if (!scan->isScanned(YARA_SCAN_CONSUMER))
+	{
+		scan->scan(fileParser.getBytesData(), fileParser.getFileLength());
+	}
+	const auto &detected = scan->getDetectedRules(YARA_SCAN_CONSUMER);
+	const auto &undetected = scan->getUndetectedRules(YARA_SCAN_CONSUMER);
 	auto result = false;
 	if (cpParams.searchType == SearchType::EXACT_MATCH
 			|| (cpParams.searchType == SearchType::MOST_SIMILAR
@@ -690,16 +690,15 @@ void Heuristics::getDwarfInfo()
 	std::vector<std::string> languages;
 	std::vector<std::size_t> modulesCounter;
 
-	// Open input file as buffer.
+	// Use already loaded input file content as buffer -- there is no need
+	// to read the file again (and input created from memory has no file).
 	//
-	llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffOrErr =
-			llvm::MemoryBuffer::getFileOrSTDIN(fileParser.getPathToFile());
-	if (buffOrErr.getError())
-	{
-		return;
-	}
-	std::unique_ptr<llvm::MemoryBuffer> bufferPtr = std::move(buffOrErr.get());
-	llvm::MemoryBufferRef buffer = *bufferPtr;
+	const auto& bytes = fileParser.getBytes();
+	llvm::MemoryBufferRef buffer(
+			llvm::StringRef(
+					reinterpret_cast<const char*>(bytes.data()),
+					bytes.size()),
+			fileParser.getPathToFile());
 
 	// Open buffer as a binary file.
 	//
@@ -955,7 +954,8 @@ std::string Heuristics::getUpxVersion()
 		const std::size_t versionLen = 4;
 		if (pos <= content.length() - pattern.length() - versionLen)
 		{
-			return content.substr(pos + pattern.length(), versionLen);
+			return std::string(
+					content.substr(pos + pattern.length(), versionLen));
 		}
 	}
 
@@ -5,16 +5,14 @@
  */
 
 #include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <map>
 
 #include "retdec/utils/container.h"
-#include "retdec/utils/conversion.h"
 #include "retdec/utils/equality.h"
-#include "retdec/utils/string.h"
 #include "retdec/cpdetect/search.h"
 #include "retdec/cpdetect/signature.h"
-#include "retdec/fileformat/utils/conversions.h"
-#include "retdec/fileformat/utils/file_io.h"
 
 using namespace retdec::utils;
 using namespace retdec::fileformat;
@@ -37,22 +35,73 @@ const std::map<Architecture, std::vector<Search::RelativeJump>> jumpMap =
 	},
 };
 
+/// value of nibble which never matches content of file
+const std::uint8_t INVALID_NIBBLE = 0x10;
+
+/// hexadecimal digits of nibbles
+const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+/**
+ * Get value of nibble written as hexadecimal digit in signature
+ * @param c Hexadecimal digit (uppercase)
+ * @return Value of nibble or @c INVALID_NIBBLE if @a c is not a digit
+ */
+std::uint8_t hexDigitToNibble(char c)
+{
+	if (c >= '0' && c <= '9')
+	{
+		return c - '0';
+	}
+	else if (c >= 'A' && c <= 'F')
+	{
+		return c - 'A' + 10;
+	}
+
+	return INVALID_NIBBLE;
+}
+
 } // anonymous namespace
 
 /**
  * Constructor
  * @param fileParser Parser of input file
+ *
+ * Content of file is not copied. Only content of big endian files is
+ * converted to little endian in which the signatures are written.
  */
 Search::Search(retdec::fileformat::FileFormat &fileParser)
 		: parser(fileParser)
 		, averageSlashLen(0)
 {
 	const auto &bytes = parser.getLoadedBytes();
-	bytesToHexString(bytes, nibbles);
-	bytesToString(bytes, plain);
+	data = bytes.data();
+	dataSize = bytes.size();
+	plain = std::string_view(reinterpret_cast<const char*>(data), dataSize);
 	fileLoaded = !bytes.empty();
-	fileSupported = parser.hexToLittle(nibbles)
-			&& parser.getNumberOfNibblesInByte();
+	fileSupported = !parser.isUnknownEndian()
+			&& parser.getNumberOfNibblesInByte() == 2;
+
+	if (fileSupported && !parser.isLittleEndian())
+	{
+		// Swap bytes in each word, incomplete word at the end is ignored.
+		const auto wordSize = parser.getBytesPerWord();
+		fileSupported = wordSize && dataSize >= wordSize;
+		if (fileSupported && wordSize > 1)
+		{
+			dataSize -= dataSize % wordSize;
+			swappedData.resize(dataSize);
+			for (std::size_t i = 0; i < dataSize; i += wordSize)
+			{
+				std::reverse_copy(
+						data + i,
+						data + i + wordSize,
+						swappedData.begin() + i
+				);
+			}
+			data = swappedData.data();
+		}
+	}
+
 	jumps = mapGetValueOrDefault(
 			jumpMap,
 			parser.getTargetArchitecture(),
@@ -93,7 +142,7 @@ Search::RelativeJump::RelativeJump(
  * Get slash pattern
  * @return Slash pattern
  */
-std::string Search::RelativeJump::getSlash() const
+const std::string& Search::RelativeJump::getSlash() const
 {
 	return slash;
 }
@@ -145,6 +194,212 @@ std::size_t Search::bytesFromNibbles(std::size_t nNibbles) const
 	return parser.bytesFromNibbles(nNibbles);
 }
 
+/**
+ * Get number of nibbles in content of file used for signature search
+ * @return Number of nibbles
+ */
+std::size_t Search::getNibbleCount() const
+{
+	return 2 * dataSize;
+}
+
+/**
+ * Get nibble of content of file used for signature search
+ * @param index Index of nibble (must be less than @c getNibbleCount())
+ * @return Value of nibble, higher nibble of byte precedes the lower one
+ */
+std::uint8_t Search::getNibble(std::size_t index) const
+{
+	const auto byte = data[index / 2];
+	return index % 2 ? byte & 0x0F : byte >> 4;
+}
+
+/**
+ * Check if file has nibbles written as hexadecimal string on specified index
+ * @param hex Hexadecimal string (uppercase)
+ * @param index Index of first nibble
+ * @return @c true if nibbles are present, @c false otherwise
+ */
+bool Search::hasNibbles(const std::string &hex, std::size_t index) const
+{
+	const auto nibbleCount = getNibbleCount();
+	if (index >= nibbleCount || nibbleCount - index < hex.length())
+	{
+		return false;
+	}
+
+	for (std::size_t i = 0, e = hex.length(); i < e; ++i)
+	{
+		if (hexDigitToNibble(hex[i]) != getNibble(index + i))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Compile signature pattern for matching
+ * @param signPattern Signature pattern
+ * @param unslashed If @c true, whole pattern is compiled and semicolons are
+ *    wildcards. Otherwise, pattern ends with the first semicolon and slashes
+ *    are relative jumps.
+ * @return Compiled pattern
+ */
+Search::CompiledPattern Search::compilePattern(
+		const std::string &signPattern,
+		bool unslashed) const
+{
+	CompiledPattern result;
+	result.nibbles.reserve(signPattern.length());
+	result.impNibbles = countImpNibbles(signPattern);
+
+	for (const auto c : signPattern)
+	{
+		if (c == ';' && !unslashed)
+		{
+			break;
+		}
+		else if (c == '-' || c == '?' || c == ';')
+		{
+			result.nibbles.push_back({PatternNibble::Type::ANY, 0});
+		}
+		else if (c == '/' && !unslashed)
+		{
+			result.nibbles.push_back({PatternNibble::Type::SLASH, 0});
+		}
+		else
+		{
+			result.nibbles.push_back(
+					{PatternNibble::Type::VALUE, hexDigitToNibble(c)});
+		}
+	}
+
+	return result;
+}
+
+/**
+ * Convert unslashed pattern into bytes with masks of significant nibbles
+ * @param pattern Compiled unslashed pattern
+ * @param shift Number of nibbles (0 or 1) before pattern in its first byte
+ * @return Pattern aligned to bytes
+ */
+Search::MaskedBytes Search::alignPattern(
+		const CompiledPattern &pattern,
+		std::size_t shift) const
+{
+	MaskedBytes result;
+	const auto size = (pattern.nibbles.size() + shift + 1) / 2;
+	result.values.assign(size, 0);
+	result.masks.assign(size, 0);
+
+	for (std::size_t i = 0, e = pattern.nibbles.size(); i < e; ++i)
+	{
+		const auto &nibble = pattern.nibbles[i];
+		if (nibble.type != PatternNibble::Type::VALUE)
+		{
+			continue;
+		}
+		else if (nibble.value == INVALID_NIBBLE)
+		{
+			result.invalid = true;
+			return result;
+		}
+
+		const auto index = (i + shift) / 2;
+		const auto bits = (i + shift) % 2 ? 0 : 4;
+		result.values[index] |= nibble.value << bits;
+		result.masks[index] |= 0x0F << bits;
+	}
+
+	// Candidates are found by memchr() on the anchor byte. Zero and 0xFF
+	// bytes are too common in files to be good anchors.
+	result.anchor = size;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		if (result.masks[i] != 0xFF)
+		{
+			continue;
+		}
+		else if (result.anchor == size)
+		{
+			result.anchor = i;
+		}
+		if (result.values[i] != 0x00 && result.values[i] != 0xFF)
+		{
+			result.anchor = i;
+			break;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * Find pattern aligned to bytes in content of file
+ * @param pattern Pattern aligned to bytes
+ * @param first First byte index where pattern may start
+ * @param last Last byte index where pattern may start (whole pattern must
+ *    be in content of file when it starts here)
+ * @return @c true if pattern was found, @c false otherwise
+ */
+bool Search::findMaskedBytes(
+		const MaskedBytes &pattern,
+		std::size_t first,
+		std::size_t last) const
+{
+	if (pattern.invalid || first > last)
+	{
+		return false;
+	}
+
+	const auto size = pattern.values.size();
+	const auto matches = [&](std::size_t index)
+	{
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			if ((data[index + i] & pattern.masks[i]) != pattern.values[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	if (pattern.anchor == size)
+	{
+		for (auto index = first; index <= last; ++index)
+		{
+			if (matches(index))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const auto anchorValue = pattern.values[pattern.anchor];
+	const auto *act = data + first + pattern.anchor;
+	const auto *end = data + last + pattern.anchor + 1;
+	while (act < end)
+	{
+		act = static_cast<const std::uint8_t*>(
+				std::memchr(act, anchorValue, end - act));
+		if (!act)
+		{
+			return false;
+		}
+		else if (matches(act - data - pattern.anchor))
+		{
+			return true;
+		}
+		++act;
+	}
+
+	return false;
+}
+
 /**
  * Check if input file was successfully loaded
  * @return @c true if file was successfully loaded, @c false otherwise
@@ -163,20 +418,11 @@ bool Search::isFileSupported() const
 	return fileSupported;
 }
 
-/**
- * Get content of file in hexadecimal string representation
- * @return Content of file in hexadecimal string representation
- */
-const std::string& Search::getNibbles() const
-{
-	return nibbles;
-}
-
 /**
  * Get content of file as plain string
- * @return Content of file as plain string
+ * @return Content of file as plain string (view of loaded bytes of file)
  */
-const std::string& Search::getPlainString() const
+std::string_view Search::getPlainString() const
 {
 	return plain;
 }
@@ -201,9 +447,9 @@ const Search::RelativeJump* Search::getRelativeJump(
 	for (const auto &jump : jumps)
 	{
 		const auto nibblesAfter = nibblesFromBytes(jump.getBytesAfter());
-		if (!hasSubstringOnPosition(nibbles, jump.getSlash(), nibbleOffset)
+		if (!hasNibbles(jump.getSlash(), nibbleOffset)
 				|| (nibbleOffset + jump.getSlashNibbleSize() + nibblesAfter - 1
-						>= nibbles.length()))
+						>= getNibbleCount()))
 		{
 			continue;
 		}
@@ -287,26 +533,39 @@ unsigned long long Search::findUnslashedSignature(
 		return 0;
 	}
 
-	const auto startIterator = nibbles.begin() + nibblesFromBytes(startOffset);
-	const auto stopIndex = nibblesFromBytes(stopOffset) + 1;
-	const auto stopIterator = stopIndex < nibbles.size()
-			? nibbles.begin() + stopIndex
-			: nibbles.end();
-	const auto it = std::search(
-			startIterator,
-			stopIterator,
-			signPattern.begin(),
-			signPattern.end(),
-			[] (const char fileNibble, const char signatureNibble)
-			{
-				return fileNibble == signatureNibble
-						|| signatureNibble == '-'
-						|| signatureNibble == '?'
-						|| signatureNibble == ';';
-			}
+	const auto pattern = compilePattern(signPattern, true);
+	const auto len = pattern.nibbles.size();
+	const auto first = nibblesFromBytes(startOffset);
+	const auto stop = std::min(
+			nibblesFromBytes(stopOffset) + 1,
+			getNibbleCount()
 	);
+	if (!len || first > stop || stop - first < len)
+	{
+		return 0;
+	}
+
+	// Pattern may start on any nibble. Patterns starting on higher and lower
+	// nibbles of bytes are searched separately, both aligned to bytes.
+	const auto lastPos = stop - len;
+	for (std::size_t shift = 0; shift < 2; ++shift)
+	{
+		const auto firstAligned = first + (first + shift) % 2;
+		if (firstAligned > lastPos)
+		{
+			continue;
+		}
+		const auto lastAligned = lastPos - (lastPos + shift) % 2;
+		if (findMaskedBytes(
+				alignPattern(pattern, shift),
+				firstAligned / 2,
+				lastAligned / 2))
+		{
+			return pattern.impNibbles;
+		}
+	}
 
-	return (it != stopIterator) ? countImpNibbles(signPattern) : 0;
+	return 0;
 }
 
 /**
@@ -335,10 +594,12 @@ unsigned long long Search::findSlashedSignature(
 		return false;
 	}
 	const auto iters = startOffset == stopOffset ? 1 : areaSize - signSize + 1;
+	const auto pattern = compilePattern(signPattern, false);
+	const auto first = nibblesFromBytes(startOffset);
 
 	for (std::size_t i = 0; i < iters; ++i)
 	{
-		const auto result = exactComparison(signPattern, startOffset, i);
+		const auto result = exactComparison(pattern, first + i);
 		if (result)
 		{
 			return result;
@@ -361,19 +622,34 @@ unsigned long long Search::exactComparison(
 		std::size_t fileOffset,
 		std::size_t shift) const
 {
-	for (std::size_t sigIndex = 0,
-			fileIndex = nibblesFromBytes(fileOffset) + shift,
-			fileLen = nibbles.length()
-			;
-			fileIndex < fileLen
-			;
+	return exactComparison(
+			compilePattern(signPattern, false),
+			nibblesFromBytes(fileOffset) + shift
+	);
+}
+
+/**
+ * Try find compiled signature at specified nibble of file
+ * @param pattern Compiled signature pattern
+ * @param fileIndex Index of nibble in file
+ * @return Number of significant nibbles of signature or 0 if content of file
+ *         and signature are different
+ */
+unsigned long long Search::exactComparison(
+		const CompiledPattern &pattern,
+		std::size_t fileIndex) const
+{
+	for (std::size_t sigIndex = 0, fileLen = getNibbleCount();
+			fileIndex < fileLen;
 			++sigIndex, ++fileIndex)
 	{
-		if (sigIndex == signPattern.length() || signPattern[sigIndex] == ';')
+		if (sigIndex == pattern.nibbles.size())
 		{
-			return countImpNibbles(signPattern);
+			return pattern.impNibbles;
 		}
-		else if (signPattern[sigIndex] == '/')
+
+		const auto &nibble = pattern.nibbles[sigIndex];
+		if (nibble.type == PatternNibble::Type::SLASH)
 		{
 			std::int64_t moveSize = 0;
 			const auto actShift = parser.getNumberOfNibblesInByte()
@@ -398,9 +674,8 @@ unsigned long long Search::exactComparison(
 					+ moveSize
 					- 1;
 		}
-		else if (signPattern[sigIndex] != nibbles[fileIndex]
-				&& signPattern[sigIndex] != '-'
-				&& signPattern[sigIndex] != '?')
+		else if (nibble.type == PatternNibble::Type::VALUE
+				&& nibble.value != getNibble(fileIndex))
 		{
 			return 0;
 		}
@@ -425,29 +700,48 @@ bool Search::countSimilarity(
 		Similarity &sim,
 		std::size_t fileOffset,
 		std::size_t shift) const
+{
+	return countSimilarity(
+			compilePattern(signPattern, false),
+			sim,
+			nibblesFromBytes(fileOffset) + shift
+	);
+}
+
+/**
+ * Count similarity of compiled signature at specified nibble of file
+ * @param pattern Compiled signature pattern
+ * @param sim Structure for save similarity
+ * @param fileIndex Index of nibble in file
+ * @return @c true if function went OK, @c false otherwise
+ *
+ * If function return @c false, @a sim is left unchanged
+ */
+bool Search::countSimilarity(
+		const CompiledPattern &pattern,
+		Similarity &sim,
+		std::size_t fileIndex) const
 {
 	Similarity result;
 
-	for (std::size_t sigIndex = 0,
-			fileIndex = nibblesFromBytes(fileOffset) + shift,
-			fileLen = nibbles.length()
-			;
-			fileIndex < fileLen
-			;
+	for (std::size_t sigIndex = 0, fileLen = getNibbleCount();
+			fileIndex < fileLen;
 			++sigIndex, ++fileIndex)
 	{
-		if (sigIndex == signPattern.length() || signPattern[sigIndex] == ';')
+		if (sigIndex == pattern.nibbles.size())
 		{
 			sim.same = result.same;
 			sim.total = result.total;
 			sim.ratio = static_cast<double>(result.same) / result.total;
-			return countImpNibbles(signPattern);
+			return pattern.impNibbles;
 		}
-		else if (signPattern[sigIndex] == '-' || signPattern[sigIndex] == '?')
+
+		const auto &nibble = pattern.nibbles[sigIndex];
+		if (nibble.type == PatternNibble::Type::ANY)
 		{
 			continue;
 		}
-		else if (signPattern[sigIndex] == '/')
+		else if (nibble.type == PatternNibble::Type::SLASH)
 		{
 			std::int64_t moveSize = 0;
 			const auto actShift = parser.getNumberOfNibblesInByte()
@@ -475,7 +769,7 @@ bool Search::countSimilarity(
 			}
 			continue;
 		}
-		else if (signPattern[sigIndex] == nibbles[fileIndex])
+		else if (nibble.value == getNibble(fileIndex))
 		{
 			++result.same;
 		}
@@ -517,12 +811,14 @@ bool Search::areaSimilarity(
 	const auto iters = startOffset == stopOffset
 			? 1
 			: areaSize - signSize + 1;
+	const auto pattern = compilePattern(signPattern, false);
+	const auto first = nibblesFromBytes(startOffset);
 	auto result = false;
 	Similarity act, max;
 
 	for (std::size_t i = 0; i < iters; ++i)
 	{
-		if (countSimilarity(signPattern, act, startOffset, i)
+		if (countSimilarity(pattern, act, first + i)
 				&& (act.ratio > max.ratio
 						|| (areEqual(act.ratio, max.ratio)
 								&& act.total > max.total)))
@@ -551,7 +847,7 @@ bool Search::areaSimilarity(
  */
 bool Search::hasString(const std::string &str) const
 {
-	return contains(plain, str);
+	return plain.find(str) != std::string_view::npos;
 }
 
 /**
@@ -563,7 +859,9 @@ bool Search::hasString(const std::string &str) const
  */
 bool Search::hasString(const std::string &str, std::size_t fileOffset) const
 {
-	return hasSubstringOnPosition(plain, str, fileOffset);
+	return fileOffset < plain.length()
+			&& plain.length() - fileOffset >= str.length()
+			&& plain.compare(fileOffset, str.length(), str) == 0;
 }
 
 /**
@@ -579,7 +877,15 @@ bool Search::hasString(
 		std::size_t startOffset,
 		std::size_t stopOffset) const
 {
-	return hasSubstringInArea(plain, str, startOffset, stopOffset);
+	if (startOffset > stopOffset)
+	{
+		return false;
+	}
+
+	const auto stopIndex = std::min(stopOffset + 1, plain.length());
+	return startOffset < stopIndex
+			&& plain.substr(startOffset, stopIndex - startOffset).find(str)
+					!= std::string_view::npos;
 }
 
 /**
@@ -641,7 +947,7 @@ bool Search::createSignature(
 
 	for (std::size_t i = 0,
 			fileIndex = nibblesFromBytes(fileOffset),
-			fileLen = nibbles.length(),
+			fileLen = getNibbleCount(),
 			nibbleSize = nibblesFromBytes(size)
 			;
 			fileIndex < fileLen && i < nibbleSize
@@ -664,7 +970,7 @@ bool Search::createSignature(
 		}
 		else
 		{
-			pattern += nibbles[fileIndex];
+			pattern += HEX_DIGITS[getNibble(fileIndex)];
 		}
 	}
 
@@ -27,17 +27,15 @@ namespace debugformat {
 
 void DebugFormat::loadDwarf()
 {
-	// Open input file as buffer.
+	// Use already loaded input file content as buffer -- there is no need
+	// to read the file again (and input created from memory has no file).
 	//
-	llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffOrErr =
-			llvm::MemoryBuffer::getFileOrSTDIN(
-				_inFile->getFileFormat()->getPathToFile());
-	if (buffOrErr.getError())
-	{
-		return;
-	}
-	std::unique_ptr<llvm::MemoryBuffer> bufferPtr = std::move(buffOrErr.get());
-	llvm::MemoryBufferRef buffer = *bufferPtr;
+	auto* fileFormat = _inFile->getFileFormat();
+	llvm::MemoryBufferRef buffer(
+			llvm::StringRef(
+					reinterpret_cast<const char*>(fileFormat->getBytesData()),
+					fileFormat->getFileLength()),
+			fileFormat->getPathToFile());
 
 	// Open buffer as a binary file.
 	//
@@ -231,8 +231,8 @@ CoffFormat::CoffFormat(std::istream &inputStream, LoadFlags loadFlags) :
 		FileFormat(inputStream, loadFlags),
 		fileBuffer(MemoryBuffer::getMemBuffer(
 				StringRef(
-						reinterpret_cast<const char*>(bytes.data()),
-						bytes.size()),
+						reinterpret_cast<const char*>(getBytesData()),
+						getFileLength()),
 				"",
 				false))
 {
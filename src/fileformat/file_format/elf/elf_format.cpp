@@ -1511,7 +1511,7 @@ ELFIO::section* ElfFormat::addGlobalOffsetTable(ELFIO::section *dynamicSection,
 			{
 				const auto w = std::min<std::size_t>(gotTable->get_size(), seg->get_data_size() - (gotAddr - gotSeg->getAddress()));
 				const auto gotSegOffset = gotAddr - gotSeg->getAddress();
-				if (seg->get_offset() + gotSegOffset + w > bytes.size())
+				if (seg->get_offset() + gotSegOffset + w > getFileLength())
 				{
 					return nullptr;
 				}
@@ -8,8 +8,11 @@
 #include <cassert>
 #include <climits>
 #include <cstring>
+#include <exception>
 #include <functional>
+#include <limits>
 #include <sstream>
+#include <thread>
 
 #include "retdec/utils/conversion.h"
 #include "retdec/utils/file_io.h"
@@ -20,7 +23,7 @@
 #include "retdec/fileformat/utils/byte_array_buffer.h"
 #include "retdec/fileformat/file_format/intel_hex/intel_hex_format.h"
 #include "retdec/fileformat/file_format/raw_data/raw_data_format.h"
-#include "retdec/fileformat/types/strings/character_iterator.h"
+#include "retdec/fileformat/types/strings/string_scanner.h"
 #include "retdec/fileformat/utils/conversions.h"
 #include "retdec/fileformat/utils/crypto.h"
 #include "retdec/fileformat/utils/file_io.h"
@@ -38,76 +41,101 @@ namespace
 {
 
 const std::size_t DefaultMinStringLength = 4;
+/// Strings beyond this number (ordered by offsets) are dropped.
+const std::size_t DefaultMaxStrings = 1000000;
+/// Strings of less data than this are scanned in a single thread.
+const std::size_t MinParallelStringsData = 4 * 1024 * 1024;
 
 /**
- * Decide whether @a offset is part of region (section or segment) @a newRegion
- * @param actualRegion Region to which is offset currently assigned (may be @c nullptr)
- * @param newRegion Currently examined region
- * @param offset Offset in file
- * @return @c true if @a offset is in range of @a newRegion and @a actualRegion is
- *    @c nullptr or @a newRegion is subset of @a actualRegion, @c false otherwise
+ * Build index of regions (sections or segments)
+ * @param index Index to build
+ * @param regions Regions to index
+ * @param byAddress If @c true, regions are indexed by addresses in memory,
+ *    otherwise by offsets in file
+ *
+ * If more regions contain the same offset (address), the region with the
+ * highest start wins. From regions with the same start, the smallest one
+ * wins. From regions with the same start and size, the first one wins.
  */
-bool isOffsetFromRegion(const SecSeg *actualRegion, const SecSeg *newRegion, std::size_t offset)
+template<typename T>
+void buildRegionIndex(
+		retdec::utils::IntervalIndex<const T*> &index,
+		const std::vector<T*> &regions,
+		bool byAddress)
 {
-	if(!newRegion)
+	struct Region
 	{
-		return false;
-	}
+		const T *region;
+		unsigned long long start;
+		unsigned long long size;
+	};
 
-	const auto newRegionSize = newRegion->getSizeInFile();
-	const auto actualRegionSize = (actualRegion ? actualRegion->getSizeInFile() : 0);
-	if(offset >= newRegion->getOffset() && offset - newRegion->getOffset() < newRegionSize)
+	std::vector<Region> items;
+	items.reserve(regions.size());
+	for(const auto *item : regions)
 	{
-		if(!actualRegion || (newRegion->getOffset() > actualRegion->getOffset() ||
-			(newRegion->getOffset() == actualRegion->getOffset() && newRegionSize < actualRegionSize)))
+		if(!item || (byAddress && !item->getMemory()))
+		{
+			continue;
+		}
+
+		unsigned long long size = item->getSizeInFile();
+		if(byAddress)
+		{
+			unsigned long long memSize;
+			if(item->getSizeInMemory(memSize))
+			{
+				size = memSize;
+			}
+		}
+		if(size)
 		{
-			return true;
+			items.push_back({item, byAddress ? item->getAddress() : item->getOffset(), size});
 		}
 	}
 
-	return false;
+	std::stable_sort(items.begin(), items.end(),
+		[] (const auto &a, const auto &b)
+		{
+			return a.start > b.start || (a.start == b.start && a.size < b.size);
+		}
+	);
+
+	index.clear();
+	for(const auto &item : items)
+	{
+		const auto maxSize = std::numeric_limits<unsigned long long>::max() - item.start;
+		index.add(item.start, item.start + std::min(item.size - 1, maxSize), item.region);
+	}
+	index.build();
 }
 
 /**
- * Decide whether @a address is part of region (section or segment) @a newRegion
- * @param actualRegion Region to which is address currently assigned (may be @c nullptr)
- * @param newRegion Currently examined region
- * @param address Address in memory
- * @return @c true if @a address is in range of @a newRegion and @a actualRegion is
- *    @c nullptr or @a newRegion is subset of @a actualRegion, @c false otherwise
+ * Memory-map the input file if it should not be copied
+ * @param pathToFile Path to input file
+ * @param loadFlags Load flags
+ * @return Mapped file or @c nullptr if the file should be copied or it could
+ *    not be mapped
  */
-bool isAddressFromRegion(const SecSeg *actualRegion, const SecSeg *newRegion, std::size_t address)
+std::unique_ptr<llvm::MemoryBuffer> mapFile(const std::string & pathToFile, LoadFlags loadFlags)
 {
-	if(!newRegion)
+	if (!(loadFlags & LoadFlags::NO_INPUT_COPY))
 	{
-		return false;
-	}
-
-	unsigned long long newRegionSize;
-	if(!newRegion->getSizeInMemory(newRegionSize))
-	{
-		newRegionSize = newRegion->getSizeInFile();
+		return nullptr;
 	}
 
-	unsigned long long actualRegionSize = 0;
-	if(actualRegion)
-	{
-		if(!actualRegion->getSizeInMemory(actualRegionSize))
-		{
-			actualRegionSize = actualRegion->getSizeInFile();
-		}
-	}
+	auto buffer = llvm::MemoryBuffer::getFile(pathToFile, -1, false);
+	return buffer ? std::move(buffer.get()) : nullptr;
+}
 
-	if(newRegion->getMemory() && address >= newRegion->getAddress() && address - newRegion->getAddress() < newRegionSize)
-	{
-		if(!actualRegion || (newRegion->getAddress() > actualRegion->getAddress() ||
-			(newRegion->getAddress() == actualRegion->getAddress() && newRegionSize < actualRegionSize)))
-		{
-			return true;
-		}
-	}
+const unsigned char* getBufferBegin(const std::unique_ptr<llvm::MemoryBuffer> &buffer)
+{
+	return buffer ? reinterpret_cast<const unsigned char*>(buffer->getBufferStart()) : nullptr;
+}
 
-	return false;
+const unsigned char* getBufferEnd(const std::unique_ptr<llvm::MemoryBuffer> &buffer)
+{
+	return buffer ? reinterpret_cast<const unsigned char*>(buffer->getBufferEnd()) : nullptr;
 }
 
 } // anonymous namespace
@@ -118,16 +146,26 @@ bool isAddressFromRegion(const SecSeg *actualRegion, const SecSeg *newRegion, st
  * @param loadFlags Load flags
  */
 FileFormat::FileFormat(const std::string & pathToFile, LoadFlags loadFlags) :
-		auxBuff(nullptr, nullptr),
+		mappedInput(mapFile(pathToFile, loadFlags)),
+		auxBuff(getBufferBegin(mappedInput), getBufferEnd(mappedInput)),
 		auxIStream(&auxBuff),
-		loadedBytes(&bytes),
 		loadFlags(loadFlags),
 		filePath(pathToFile),
-		fileStream(auxFStream),
+		fileStream(mappedInput ? auxIStream : auxFStream),
 		_ldrErrInfo()
 {
-	auxFStream.open(filePath, std::ifstream::binary);
-	stateIsValid = auxFStream.is_open();
+	if (mappedInput)
+	{
+		stateIsValid = true;
+		inputBytes = llvm::ArrayRef<unsigned char>(
+				getBufferBegin(mappedInput),
+				getBufferEnd(mappedInput));
+	}
+	else
+	{
+		auxFStream.open(filePath, std::ifstream::binary);
+		stateIsValid = auxFStream.is_open();
+	}
 	init();
 }
 
@@ -139,7 +177,6 @@ FileFormat::FileFormat(const std::string & pathToFile, LoadFlags loadFlags) :
 FileFormat::FileFormat(std::istream &inputStream, LoadFlags loadFlags) :
 		auxBuff(nullptr, nullptr),
 		auxIStream(&auxBuff),
-		loadedBytes(&bytes),
 		loadFlags(loadFlags),
 		fileStream(inputStream),
 		_ldrErrInfo()
@@ -157,12 +194,15 @@ FileFormat::FileFormat(std::istream &inputStream, LoadFlags loadFlags) :
 FileFormat::FileFormat(const std::uint8_t *data, std::size_t size, LoadFlags loadFlags) :
 		auxBuff(data, size),
 		auxIStream(&auxBuff),
-		loadedBytes(&bytes),
 		loadFlags(loadFlags),
 		fileStream(auxIStream),
 		_ldrErrInfo()
 {
 	stateIsValid = true;
+	if (loadFlags & LoadFlags::NO_INPUT_COPY)
+	{
+		inputBytes = llvm::ArrayRef<unsigned char>(data, size);
+	}
 	init();
 }
 
@@ -189,7 +229,13 @@ void FileFormat::init()
 	tlsInfo = nullptr;
 	elfCoreInfo = nullptr;
 	fileFormat = Format::UNDETECTABLE;
-	stateIsValid = readFile(fileStream, bytes) && stateIsValid;
+	// Content which is not copied was already set by the constructor.
+	if (!(getLoadFlags() & LoadFlags::NO_INPUT_COPY) || !inputBytes.data())
+	{
+		stateIsValid = readFile(fileStream, bytes) && stateIsValid;
+		inputBytes = bytes;
+	}
+	loadedBytes = inputBytes;
 	if (getLoadFlags() & LoadFlags::NO_FILE_HASHES)
 	{
 		crc32.clear();
@@ -198,9 +244,8 @@ void FileFormat::init()
 	}
 	else
 	{
-		crc32 = retdec::fileformat::getCrc32(bytes.data(), bytes.size());
-		md5 = retdec::fileformat::getMd5(bytes.data(), bytes.size());
-		sha256 = retdec::fileformat::getSha256(bytes.data(), bytes.size());
+		retdec::fileformat::computeHashes(inputBytes.data(), inputBytes.size(),
+				crc32, md5, sha256);
 	}
 	initStream();
 }
@@ -262,11 +307,110 @@ void FileFormat::clear()
 
 	sections.clear();
 	segments.clear();
+	invalidateSecSegIndexes();
 	symbolTables.clear();
 	relocationTables.clear();
 	dynamicTables.clear();
 }
 
+/**
+ * Mark indexes of sections and segments as outdated
+ *
+ * Must be called whenever sections or segments are changed without changing
+ * their number (e.g. address of section is changed or sections are sorted).
+ * Added or removed sections and segments are detected automatically.
+ */
+void FileFormat::invalidateSecSegIndexes()
+{
+	secSegIndexesValid = false;
+}
+
+/**
+ * Build indexes of sections and segments if they are outdated
+ */
+void FileFormat::updateSecSegIndexes() const
+{
+	const auto isValid = [this]()
+	{
+		return secSegIndexesValid
+				&& indexedSections == sections.size()
+				&& indexedSegments == segments.size();
+	};
+	if(isValid())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(secSegIndexesMutex);
+	if(isValid())
+	{
+		return;
+	}
+
+	buildRegionIndex(sectionAddressIndex, sections, true);
+	buildRegionIndex(sectionOffsetIndex, sections, false);
+	buildRegionIndex(segmentAddressIndex, segments, true);
+	buildRegionIndex(segmentOffsetIndex, segments, false);
+	indexedSections = sections.size();
+	indexedSegments = segments.size();
+	secSegIndexesValid = true;
+}
+
+/**
+ * Load all lazily loaded parts which are not loaded yet, unless lazy loading
+ * was requested by load flags
+ */
+void FileFormat::loadLazyParts()
+{
+	if(getLoadFlags() & LoadFlags::LAZY_LOADING)
+	{
+		return;
+	}
+
+	for(auto part : {LAZY_RESOURCES, LAZY_CERTIFICATES, LAZY_DOTNET,
+			LAZY_VISUAL_BASIC, LAZY_ANOMALIES, LAZY_LOADER_ERROR})
+	{
+		ensureLoaded(part);
+	}
+}
+
+/**
+ * Load given part of file format if it is not loaded yet
+ * @param part Part to load
+ *
+ * Loaders of parts may ensure that other parts are loaded as well.
+ */
+void FileFormat::ensureLoaded(LazyPart part) const
+{
+	if(loadedParts & part)
+	{
+		return;
+	}
+
+	std::lock_guard<std::recursive_mutex> lock(loadedPartsMutex);
+	if(loadedParts & part)
+	{
+		return;
+	}
+
+	// Parts are loaded into members which are logically a part of the
+	// already constructed instance.
+	const_cast<FileFormat*>(this)->loadLazyPart(part);
+	loadedParts |= part;
+}
+
+/**
+ * Load given part of file format
+ * @param part Part to load
+ *
+ * The default implementation does nothing. Formats which load some parts
+ * lazily override this method.
+ */
+void FileFormat::loadLazyPart(LazyPart)
+{
+
+}
+
 /**
  * Compute hashes of section table. This method must be called after
  * sections are loaded.
@@ -315,12 +459,25 @@ void FileFormat::computeSectionTableHashes()
 
 	if(!data.empty())
 	{
-		sectionCrc32 = retdec::fileformat::getCrc32(data.data(), data.size());
-		sectionMd5 = retdec::fileformat::getMd5(data.data(), data.size());
-		sectionSha256 = retdec::fileformat::getSha256(data.data(), data.size());
+		retdec::fileformat::computeHashes(data.data(), data.size(),
+				sectionCrc32, sectionMd5, sectionSha256);
 	}
 }
 
+/**
+ * Set content of input file. Both content of input file and loaded serialized
+ * content are set to @a iBytes.
+ * @param iBytes Pointer to content of input file
+ *
+ * Call this method again each time the vector is modified, because views of
+ * the content refer directly to the vector's storage.
+ */
+void FileFormat::setBytes(std::vector<unsigned char> *iBytes)
+{
+	inputBytes = *iBytes;
+	loadedBytes = *iBytes;
+}
+
 /**
  * Set pointer to loaded serialized bytes of input file. In binary file formats
  * (e.g. ELF, PE, COFF) it is not necessary to call this method. In text file
@@ -329,7 +486,7 @@ void FileFormat::computeSectionTableHashes()
  */
 void FileFormat::setLoadedBytes(std::vector<unsigned char> *lBytes)
 {
-	loadedBytes = lBytes;
+	loadedBytes = *lBytes;
 }
 
 /**
@@ -370,72 +527,106 @@ void FileFormat::initArchitecture(
 
 /**
  * Load strings from data sections
+ * @param threads Maximal number of threads scanning sections (or segments)
+ *    at once
+ *
+ * Sections are scanned in a single thread if there is not enough data to
+ * make the start of more threads worth it.
  */
-void FileFormat::loadStrings()
+void FileFormat::loadStrings(std::size_t threads)
 {
 	if (!(getLoadFlags() & LoadFlags::DETECT_STRINGS))
 		return;
 
-	loadStrings(StringType::Ascii, 1);
-	loadStrings(StringType::Wide, 2);
-
-	// Sort and remove duplicates
-	std::sort(strings.begin(), strings.end());
-	auto endItr = std::unique(strings.begin(), strings.end());
-	strings.erase(endItr, strings.end());
-}
-
-/**
- * Load strings of specified type and with specified character size.
- * @param type Type of the strings.
- * @param charSize Character size.
- */
-void FileFormat::loadStrings(StringType type, std::size_t charSize)
-{
+	std::vector<const SecSeg*> secSegs;
+	std::size_t dataSize = 0;
 	if (!sections.empty())
 	{
 		for (const auto* sec : sections)
 		{
-			if (!sec->isSomeData() && !sec->isDebug())
-				continue;
-
-			loadStrings(type, charSize, sec);
+			if (sec->isSomeData() || sec->isDebug())
+			{
+				secSegs.push_back(sec);
+				dataSize += sec->getLoadedSize();
+			}
 		}
 	}
 	else
 	{
 		for (const auto* seg : segments)
 		{
-			if (!seg->isSomeData() && !seg->isDebug())
-				continue;
-
-			loadStrings(type, charSize, seg);
+			if (seg->isSomeData() || seg->isDebug())
+			{
+				secSegs.push_back(seg);
+				dataSize += seg->getLoadedSize();
+			}
 		}
 	}
-}
 
-void FileFormat::loadStrings(StringType type, std::size_t charSize, const SecSeg* secSeg)
-{
-	CharacterEndianness endian = isLittleEndian() ? CharacterEndianness::Little : CharacterEndianness::Big;
-
-	for (auto begin = secSeg->getBytes().begin(), end = secSeg->getBytes().end(), itr = begin; itr != end;)
+	// Sections or segments are scanned in parallel, each into its own vector.
+	std::vector<std::vector<String>> results(secSegs.size());
+	std::atomic<std::size_t> nextSecSeg(0);
+	if (dataSize < MinParallelStringsData)
+		threads = 1;
+	threads = std::max<std::size_t>(std::min(threads, secSegs.size()), 1);
+	std::vector<std::exception_ptr> errors(threads);
+	auto work = [&](std::size_t t)
 	{
-		if (makeCharacterIterator(itr, begin, end, charSize).pointsToValidCharacter(endian))
+		try
 		{
-			auto stringBeginItr = makeCharacterIterator(itr, begin, end, charSize);
-			auto stringDataEndItr = makeCharacterIterator(end, begin, end, charSize);
-			auto stringEndItr = stringBeginItr + 1;
-			while (stringEndItr != stringDataEndItr && stringEndItr.pointsToValidCharacter(endian))
-				++stringEndItr;
-
-			if (static_cast<std::size_t>(stringEndItr - stringBeginItr) >= DefaultMinStringLength)
-				strings.emplace_back(type, secSeg->getOffset() + (itr - begin), secSeg->getName(), std::string{stringBeginItr, stringEndItr});
-
-			itr = stringEndItr.getUnderlyingIterator();
+			for (auto i = nextSecSeg++; i < secSegs.size(); i = nextSecSeg++)
+				loadStrings(secSegs[i], results[i]);
+		}
+		catch (...)
+		{
+			errors[t] = std::current_exception();
+			nextSecSeg = secSegs.size();
 		}
-		else
-			++itr;
+	};
+
+	std::vector<std::thread> workers;
+	for (std::size_t t = 1; t < threads; ++t)
+		workers.emplace_back(work, t);
+	work(0);
+	for (auto& worker : workers)
+		worker.join();
+	for (const auto& error : errors)
+	{
+		if (error)
+			std::rethrow_exception(error);
 	}
+
+	for (auto& result : results)
+		std::move(result.begin(), result.end(), std::back_inserter(strings));
+
+	// Sort and remove duplicates
+	std::sort(strings.begin(), strings.end());
+	auto endItr = std::unique(strings.begin(), strings.end());
+	strings.erase(endItr, strings.end());
+	if (strings.size() > DefaultMaxStrings)
+		strings.erase(strings.begin() + DefaultMaxStrings, strings.end());
+}
+
+/**
+ * Load ASCII and wide strings from the given section or segment.
+ * @param secSeg Section or segment to scan.
+ * @param result Into this parameter the found strings are appended.
+ */
+void FileFormat::loadStrings(const SecSeg* secSeg, std::vector<String>& result) const
+{
+	CharacterEndianness endian = isLittleEndian() ? CharacterEndianness::Little : CharacterEndianness::Big;
+	const auto bytes = secSeg->getBytes();
+
+	scanStrings(
+			reinterpret_cast<const unsigned char*>(bytes.data()),
+			bytes.size(),
+			endian,
+			DefaultMinStringLength,
+			DefaultMaxStrings,
+			[&](StringType type, std::size_t offset, std::string&& content)
+			{
+				result.emplace_back(type, secSeg->getOffset() + offset, secSeg->getName(), std::move(content));
+			});
 }
 
 /**
@@ -503,17 +694,8 @@ LoadFlags FileFormat::getLoadFlags() const
  */
 const Section* FileFormat::getSectionFromOffset(unsigned long long offset) const
 {
-	const Section *actSec = nullptr;
-
-	for(const auto *item : sections)
-	{
-		if(isOffsetFromRegion(actSec, item, offset))
-		{
-			actSec = item;
-		}
-	}
-
-	return actSec;
+	updateSecSegIndexes();
+	return sectionOffsetIndex.find(offset);
 }
 
 /**
@@ -524,17 +706,8 @@ const Section* FileFormat::getSectionFromOffset(unsigned long long offset) const
  */
 const Segment* FileFormat::getSegmentFromOffset(unsigned long long offset) const
 {
-	const Segment *actSeg = nullptr;
-
-	for(const auto *item : segments)
-	{
-		if(isOffsetFromRegion(actSeg, item, offset))
-		{
-			actSeg = item;
-		}
-	}
-
-	return actSeg;
+	updateSecSegIndexes();
+	return segmentOffsetIndex.find(offset);
 }
 
 /**
@@ -585,17 +758,8 @@ bool FileFormat::haveDataOnOffset(unsigned long long offset) const
  */
 const Section* FileFormat::getSectionFromAddress(unsigned long long address) const
 {
-	const Section *actSec = nullptr;
-
-	for(const auto *item : sections)
-	{
-		if(isAddressFromRegion(actSec, item, address))
-		{
-			actSec = item;
-		}
-	}
-
-	return actSec;
+	updateSecSegIndexes();
+	return sectionAddressIndex.find(address);
 }
 
 /**
@@ -606,17 +770,8 @@ const Section* FileFormat::getSectionFromAddress(unsigned long long address) con
  */
 const Segment* FileFormat::getSegmentFromAddress(unsigned long long address) const
 {
-	const Segment *actSeg = nullptr;
-
-	for(const auto *item : segments)
-	{
-		if(isAddressFromRegion(actSeg, item, address))
-		{
-			actSeg = item;
-		}
-	}
-
-	return actSeg;
+	updateSecSegIndexes();
+	return segmentAddressIndex.find(address);
 }
 
 /**
@@ -726,6 +881,7 @@ std::size_t FileFormat::getNumberOfNibblesInByte() const
 */
 const LoaderErrorInfo & FileFormat::getLoaderErrorInfo() const
 {
+	ensureLoaded(LAZY_LOADER_ERROR);
 	return _ldrErrInfo;
 }
 
@@ -1050,7 +1206,7 @@ std::size_t FileFormat::getNumberOfDynamicTables() const
  */
 std::size_t FileFormat::getFileLength() const
 {
-	return bytes.size();
+	return inputBytes.size();
 }
 
 /**
@@ -1059,7 +1215,7 @@ std::size_t FileFormat::getFileLength() const
  */
 std::size_t FileFormat::getLoadedFileLength() const
 {
-	return loadedBytes->size();
+	return loadedBytes.size();
 }
 
 /**
@@ -1193,7 +1349,7 @@ bool FileFormat::getBytes(std::vector<std::uint8_t> &result, unsigned long long
 	numberOfBytes = offset + numberOfBytes > getLoadedFileLength() ? getLoadedFileLength() - offset : numberOfBytes;
 	result.clear();
 	result.reserve(numberOfBytes);
-	std::copy(loadedBytes->begin() + offset, loadedBytes->begin() + offset + numberOfBytes, std::back_inserter(result));
+	std::copy(loadedBytes.begin() + offset, loadedBytes.begin() + offset + numberOfBytes, std::back_inserter(result));
 	return true;
 }
 
@@ -1229,7 +1385,7 @@ bool FileFormat::getEpBytes(std::vector<std::uint8_t> &result, unsigned long lon
  */
 bool FileFormat::getHexBytes(std::string &result, unsigned long long offset, unsigned long long numberOfBytes) const
 {
-	bytesToHexString(*loadedBytes, result, offset, numberOfBytes);
+	bytesToHexString(loadedBytes.data(), loadedBytes.size(), result, offset, numberOfBytes);
 	return offset < getLoadedFileLength();
 }
 
@@ -1280,7 +1436,7 @@ bool FileFormat::getHexBytesFromEnd(std::string &result, unsigned long long numb
  */
 bool FileFormat::getString(std::string &result, unsigned long long offset, unsigned long long numberOfBytes) const
 {
-	bytesToString(*loadedBytes, result, offset, numberOfBytes);
+	bytesToString(loadedBytes.data(), loadedBytes.size(), result, offset, numberOfBytes);
 	return offset < getLoadedFileLength();
 }
 
@@ -1547,6 +1703,7 @@ const ExportTable* FileFormat::getExportTable() const
  */
 const ResourceTable* FileFormat::getResourceTable() const
 {
+	ensureLoaded(LAZY_RESOURCES);
 	return resourceTable;
 }
 
@@ -1556,6 +1713,7 @@ const ResourceTable* FileFormat::getResourceTable() const
  */
 const ResourceTree* FileFormat::getResourceTree() const
 {
+	ensureLoaded(LAZY_RESOURCES);
 	return resourceTree;
 }
 
@@ -1583,6 +1741,7 @@ const PdbInfo* FileFormat::getPdbInfo() const
  */
 const CertificateTable* FileFormat::getCertificateTable() const
 {
+	ensureLoaded(LAZY_CERTIFICATES);
 	return certificateTable;
 }
 
@@ -1738,6 +1897,7 @@ const Export* FileFormat::getExport(unsigned long long address) const
  */
 const Resource* FileFormat::getManifestResource() const
 {
+	ensureLoaded(LAZY_RESOURCES);
 	return resourceTable ? resourceTable->getResourceWithType(PELIB_RT_MANIFEST) : nullptr;
 }
 
@@ -1747,6 +1907,7 @@ const Resource* FileFormat::getManifestResource() const
  */
 const Resource* FileFormat::getVersionResource() const
 {
+	ensureLoaded(LAZY_RESOURCES);
 	return resourceTable ? resourceTable->getResourceWithType(PELIB_RT_VERSION) : nullptr;
 }
 
@@ -1756,6 +1917,7 @@ const Resource* FileFormat::getVersionResource() const
  */
 bool FileFormat::isSignaturePresent() const
 {
+	ensureLoaded(LAZY_CERTIFICATES);
 	return signatureVerified.has_value();
 }
 
@@ -1765,6 +1927,7 @@ bool FileFormat::isSignaturePresent() const
  */
 bool FileFormat::isSignatureVerified() const
 {
+	ensureLoaded(LAZY_CERTIFICATES);
 	return signatureVerified.has_value() && signatureVerified.value();
 }
 
@@ -1774,6 +1937,7 @@ bool FileFormat::isSignatureVerified() const
  */
 const retdec::common::RangeContainer<std::uint64_t>& FileFormat::getNonDecodableAddressRanges() const
 {
+	ensureLoaded(LAZY_RESOURCES);
 	return nonDecodableRanges;
 }
 
@@ -1876,18 +2040,18 @@ const std::vector<DynamicTable*>& FileFormat::getDynamicTables() const
  * Get content of input file as bytes
  * @return Content of input file as bytes
  */
-const std::vector<unsigned char>& FileFormat::getBytes() const
+llvm::ArrayRef<unsigned char> FileFormat::getBytes() const
 {
-	return bytes;
+	return inputBytes;
 }
 
 /**
  * Get serialized loaded content of input file as bytes
  * @return Serialized content of input file as bytes
  */
-const std::vector<unsigned char>& FileFormat::getLoadedBytes() const
+llvm::ArrayRef<unsigned char> FileFormat::getLoadedBytes() const
 {
-	return *loadedBytes;
+	return loadedBytes;
 }
 
 /**
@@ -1896,7 +2060,7 @@ const std::vector<unsigned char>& FileFormat::getLoadedBytes() const
  */
 const unsigned char* FileFormat::getBytesData() const
 {
-	return bytes.data();
+	return inputBytes.data();
 }
 
 /**
@@ -1905,7 +2069,7 @@ const unsigned char* FileFormat::getBytesData() const
  */
 const unsigned char* FileFormat::getLoadedBytesData() const
 {
-	return loadedBytes->data();
+	return loadedBytes.data();
 }
 
 /**
@@ -1937,6 +2101,7 @@ const std::set<std::uint64_t> &FileFormat::getUnknownRelocations() const
  */
 const std::vector<std::pair<std::string,std::string>> &FileFormat::getAnomalies() const
 {
+	ensureLoaded(LAZY_ANOMALIES);
 	return anomalies;
 }
 
@@ -1964,7 +2129,7 @@ bool FileFormat::getXByte(std::uint64_t address, std::uint64_t x, std::uint64_t
 	const auto secOffset = address - secSeg->getAddress();
 	const auto offset = secSeg->getOffset() + secOffset;
 	return (secOffset + x > secSeg->getLoadedSize() || offset + x > getLoadedFileLength()) ?
-		false : createValueFromBytes(*loadedBytes, res, e, offset, x);
+		false : createValueFromBytes(loadedBytes.data(), loadedBytes.size(), res, e, offset, x);
 }
 
 /**
@@ -2104,7 +2269,7 @@ bool FileFormat::getXByteOffset(std::uint64_t offset, std::uint64_t x, std::uint
 		return true;
 	}
 
-	return createValueFromBytes(*loadedBytes, res, e, offset, x);
+	return createValueFromBytes(loadedBytes.data(), loadedBytes.size(), res, e, offset, x);
 }
 
 /**
@@ -2119,7 +2284,7 @@ bool FileFormat::getXBytesOffset(std::uint64_t offset, std::uint64_t x, std::vec
 	res.clear();
 	if(offset + x <= getLoadedFileLength())
 	{
-		res.assign(loadedBytes->begin() + offset, loadedBytes->begin() + offset + x);
+		res.assign(loadedBytes.begin() + offset, loadedBytes.begin() + offset + x);
 		return res.size() == x;
 	}
 
@@ -2609,6 +2774,7 @@ void FileFormat::dumpResourceTree()
 
 void FileFormat::dumpResourceTree(std::string &dumpStr)
 {
+	ensureLoaded(LAZY_RESOURCES);
 	if(!resourceTree)
 	{
 		dumpStr.clear();
@@ -83,8 +83,8 @@ MachOFormat::MachOFormat(std::string pathToFile, LoadFlags loadFlags) :
 MachOFormat::MachOFormat(std::istream &inputStream, LoadFlags loadFlags) :
 		FileFormat(inputStream, loadFlags),
 		fileBuffer(MemoryBuffer::getMemBuffer(StringRef(
-				reinterpret_cast<const char*>(bytes.data()),
-				bytes.size()))),
+				reinterpret_cast<const char*>(getBytesData()),
+				getFileLength()))),
 		file(nullptr),
 		fatFile(nullptr)
 {
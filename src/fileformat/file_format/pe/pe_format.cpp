@@ -593,10 +593,10 @@ void PeFormat::initStructures(const std::string & dllListFile)
 	{
 		try
 		{
-			if(file->loadPeHeaders(bytes) == ERROR_NONE)
+			if(file->loadPeHeaders(PeLib::ByteView(getBytesData(), getFileLength())) == ERROR_NONE)
 				stateIsValid = true;
 
-			file->readCoffSymbolTable(bytes);
+			file->readCoffSymbolTable(PeLib::ByteView(getBytesData(), getFileLength()));
 			file->readImportDirectory();
 			file->readIatDirectory();
 			file->readBoundImportDirectory();
@@ -604,14 +604,8 @@ void PeFormat::initStructures(const std::string & dllListFile)
 			file->readExportDirectory();
 			file->readDebugDirectory();
 			file->readTlsDirectory();
-			file->readResourceDirectory();
-			file->readSecurityDirectory();
-			file->readComHeaderDirectory();
 			file->readRelocationsDirectory();
 
-			// Fill-in the loader error info from PE file
-			initLoaderErrorInfo();
-
 			// Create an instance of PeFormatParser32/PeFormatParser64
 			formatParser = new PeFormatParser(this, file);
 		}
@@ -628,14 +622,75 @@ void PeFormat::initStructures(const std::string & dllListFile)
 		loadImports();
 		loadExports();
 		loadPdbInfo();
-		loadResources();
-		loadCertificates();
 		loadTlsInformation();
-		loadDotnetHeaders();
-		loadVisualBasicHeader();
 		computeSectionTableHashes();
 		loadStrings();
-		scanForAnomalies();
+	}
+
+	loadLazyParts();
+}
+
+/**
+ * Load part of PE file which is not needed for code analysis
+ * @param part Part to load
+ *
+ * Resource, security and COM header directories are read by PeLib here,
+ * so that they are not parsed at all if they are never used.
+ */
+void PeFormat::loadLazyPart(LazyPart part)
+{
+	const auto readDirectory = [this](int (PeLib::PeFileT::*read)())
+	{
+		try
+		{
+			(file->*read)();
+		}
+		catch(...)
+		{}
+	};
+
+	switch(part)
+	{
+		case LAZY_RESOURCES:
+			readDirectory(&PeLib::PeFileT::readResourceDirectory);
+			if(stateIsValid)
+			{
+				loadResources();
+			}
+			break;
+		case LAZY_CERTIFICATES:
+			readDirectory(&PeLib::PeFileT::readSecurityDirectory);
+			if(stateIsValid)
+			{
+				loadCertificates();
+			}
+			break;
+		case LAZY_DOTNET:
+			readDirectory(&PeLib::PeFileT::readComHeaderDirectory);
+			if(stateIsValid)
+			{
+				loadDotnetHeaders();
+			}
+			break;
+		case LAZY_VISUAL_BASIC:
+			if(stateIsValid)
+			{
+				loadVisualBasicHeader();
+			}
+			break;
+		case LAZY_ANOMALIES:
+			ensureLoaded(LAZY_RESOURCES);
+			if(stateIsValid)
+			{
+				scanForAnomalies();
+			}
+			break;
+		case LAZY_LOADER_ERROR:
+			// Fill-in the loader error info from PE file
+			ensureLoaded(LAZY_RESOURCES);
+			ensureLoaded(LAZY_CERTIFICATES);
+			initLoaderErrorInfo();
+			break;
 	}
 }
 
@@ -746,7 +801,7 @@ void PeFormat::loadRichHeader()
 	}
 
 	std::string plainText;
-	bytesToString(bytes, plainText, getMzHeaderSize(), getPeHeaderOffset() - getMzHeaderSize());
+	bytesToString(getBytesData(), getFileLength(), plainText, getMzHeaderSize(), getPeHeaderOffset() - getMzHeaderSize());
 	auto offset = getRichHeaderOffset(plainText);
 	auto standardOffset = (offset == STANDARD_RICH_HEADER_OFFSET);
 	if(offset >= getPeHeaderOffset())
@@ -1960,12 +2015,12 @@ std::vector<std::tuple<const std::uint8_t*, std::size_t>> PeFormat::getDigestRan
 	for (auto& offsetSize : offsets)
 	{
 		// If the length of the range is bigger than the amount of data we have available, then sanitize the length
-		if (offsetSize.second > bytes.size())
-			offsetSize.second = bytes.size();
+		if (offsetSize.second > getFileLength())
+			offsetSize.second = getFileLength();
 
 		// If the range overlaps the end of the file, then sanitize the length
-		if (offsetSize.first + offsetSize.second > bytes.size())
-			offsetSize.second = bytes.size() - offsetSize.first;
+		if (offsetSize.first + offsetSize.second > getFileLength())
+			offsetSize.second = getFileLength() - offsetSize.first;
 
 		// This offsetSize is completely covered by the last offset so ignore it
 		if (offsetSize.first + offsetSize.second <= lastOffset)
@@ -1979,13 +2034,13 @@ std::vector<std::tuple<const std::uint8_t*, std::size_t>> PeFormat::getDigestRan
 			offsetSize.first = lastOffset;
 		}
 
-		result.emplace_back(bytes.data() + lastOffset, offsetSize.first - lastOffset);
+		result.emplace_back(getBytesData() + lastOffset, offsetSize.first - lastOffset);
 		lastOffset = offsetSize.first + offsetSize.second;
 	}
 
 	// Finish off the data if the last offset didn't end at the end of all data
-	if (lastOffset != bytes.size())
-		result.emplace_back(bytes.data() + lastOffset, bytes.size() - lastOffset);
+	if (lastOffset != getFileLength())
+		result.emplace_back(getBytesData() + lastOffset, getFileLength() - lastOffset);
 
 	return result;
 }
@@ -3185,6 +3240,7 @@ bool PeFormat::initDllList(const std::string & dllListFile)
  */
 bool PeFormat::isDotNet() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return clrHeader != nullptr || metadataHeader != nullptr;
 }
 
@@ -3332,76 +3388,91 @@ const PeCoffSection* PeFormat::getPeSection(unsigned long long secIndex) const
 
 const CLRHeader* PeFormat::getCLRHeader() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return clrHeader.get();
 }
 
 const MetadataHeader* PeFormat::getMetadataHeader() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return metadataHeader.get();
 }
 
 const MetadataStream* PeFormat::getMetadataStream() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return metadataStream.get();
 }
 
 const StringStream* PeFormat::getStringStream() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return stringStream.get();
 }
 
 const BlobStream* PeFormat::getBlobStream() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return blobStream.get();
 }
 
 const GuidStream* PeFormat::getGuidStream() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return guidStream.get();
 }
 
 const UserStringStream* PeFormat::getUserStringStream() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return userStringStream.get();
 }
 
 const std::string& PeFormat::getModuleVersionId() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return moduleVersionId;
 }
 
 const std::string& PeFormat::getTypeLibId() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return typeLibId;
 }
 
 const std::vector<std::shared_ptr<DotnetClass>>& PeFormat::getDefinedDotnetClasses() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return definedClasses;
 }
 
 const std::vector<std::shared_ptr<DotnetClass>>& PeFormat::getImportedDotnetClasses() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return importedClasses;
 }
 
 const std::string& PeFormat::getTypeRefhashCrc32() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return typeRefHashCrc32;
 }
 
 const std::string& PeFormat::getTypeRefhashMd5() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return typeRefHashMd5;
 }
 
 const std::string& PeFormat::getTypeRefhashSha256() const
 {
+	ensureLoaded(LAZY_DOTNET);
 	return typeRefHashSha256;
 }
 
 const VisualBasicInfo* PeFormat::getVisualBasicInfo() const
 {
+	ensureLoaded(LAZY_VISUAL_BASIC);
 	return &visualBasicInfo;
 }
 
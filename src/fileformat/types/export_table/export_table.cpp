@@ -163,9 +163,8 @@ void ExportTable::computeHashes()
 		}
 	}
 
-	expHashCrc32 = getCrc32(expHashBytes.data(), expHashBytes.size());
-	expHashMd5 = getMd5(expHashBytes.data(), expHashBytes.size());
-	expHashSha256 = getSha256(expHashBytes.data(), expHashBytes.size());
+	retdec::fileformat::computeHashes(expHashBytes.data(), expHashBytes.size(),
+			expHashCrc32, expHashMd5, expHashSha256);
 }
 
 /**
@@ -51,9 +51,8 @@ void ElfImportTable::computeHashes()
 		const int show_version = 1;
 		impHashTlsh = toLower(tlsh.getHash(show_version));
 
-		impHashCrc32 = getCrc32(data, impHashString.size());
-		impHashMd5 = getMd5(data, impHashString.size());
-		impHashSha256 = getSha256(data, impHashString.size());
+		retdec::fileformat::computeHashes(data, impHashString.size(),
+				impHashCrc32, impHashMd5, impHashSha256);
 	}
 }
 
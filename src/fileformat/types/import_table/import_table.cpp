@@ -835,9 +835,8 @@ void ImportTable::computeHashes()
 		const int show_version = 1;
 		impHashTlsh = toLower(tlsh.getHash(show_version));
 
-		impHashCrc32 = getCrc32(data, impHashBytes.size());
-		impHashMd5 = getMd5(data, impHashBytes.size());
-		impHashSha256 = getSha256(data, impHashBytes.size());
+		retdec::fileformat::computeHashes(data, impHashBytes.size(),
+				impHashCrc32, impHashMd5, impHashSha256);
 	}
 }
 
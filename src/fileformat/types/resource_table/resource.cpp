@@ -428,9 +428,7 @@ void Resource::load(const FileFormat *rOwner)
 
 	if (!(rOwner->getLoadFlags() & LoadFlags::NO_VERBOSE_HASHES))
 	{
-		crc32 = retdec::fileformat::getCrc32(origBytes, bytes.size());
-		md5 = retdec::fileformat::getMd5(origBytes, bytes.size());
-		sha256 = retdec::fileformat::getSha256(origBytes, bytes.size());
+		retdec::fileformat::computeHashes(origBytes, bytes.size(), crc32, md5, sha256);
 	}
 }
 
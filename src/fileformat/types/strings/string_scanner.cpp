@@ -0,0 +1,234 @@
+/**
+ * @file src/fileformat/types/strings/string_scanner.cpp
+ * @brief Scanner of printable strings in binary data.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include "retdec/fileformat/types/strings/string_scanner.h"
+
+namespace retdec {
+namespace fileformat {
+
+namespace
+{
+
+const std::uint64_t OnesMask = 0x0101010101010101ULL;
+const std::uint64_t HighBitsMask = 0x8080808080808080ULL;
+
+bool isPrintable(unsigned char c)
+{
+	return c >= 0x20 && c < 0x7f;
+}
+
+/**
+ * Get mask with the highest bit of each byte of @a word set iff the byte is
+ * printable. All bytes are checked at once.
+ */
+std::uint64_t getPrintableMask(std::uint64_t word)
+{
+	const auto low = word & ~HighBitsMask;
+	// Bytes are at most 0x7f here, so the additions never carry into the
+	// next byte.
+	const auto atLeastSpace = low + (0x80 - 0x20) * OnesMask;
+	const auto atLeastDel = low + (0x80 - 0x7f) * OnesMask;
+	return atLeastSpace & ~atLeastDel & ~word & HighBitsMask;
+}
+
+/**
+ * Scanner of strings in one block of data.
+ *
+ * ASCII strings are maximal runs of printable bytes. Wide strings are
+ * maximal runs of 2-byte characters with a printable lower byte and a zero
+ * upper byte. They may start at both even and odd offsets, so a run is
+ * tracked for each parity.
+ */
+class StringScanner
+{
+	public:
+		StringScanner(
+				const unsigned char *data,
+				std::size_t size,
+				CharacterEndianness endian,
+				std::size_t minLength,
+				std::size_t maxCount,
+				const StringCallback &callback)
+			: data(data), size(size), littleEndian(endian == CharacterEndianness::Little),
+			minLength(minLength), maxCount(maxCount), callback(callback)
+		{
+		}
+
+		std::size_t scan()
+		{
+			std::size_t i = 0;
+			while (i < size && found < maxCount)
+			{
+				// Process 8 bytes at once if all or none of them are
+				// printable. Then, no wide character can start in the first
+				// 7 of them. The last one depends on the next byte, so it is
+				// processed separately.
+				if (i + sizeof(std::uint64_t) <= size)
+				{
+					std::uint64_t word;
+					std::memcpy(&word, data + i, sizeof(word));
+					const auto printable = getPrintableMask(word);
+					if (printable == HighBitsMask)
+					{
+						flushWide(0);
+						flushWide(1);
+						if (asciiLength == 0)
+						{
+							asciiStart = i;
+						}
+						asciiLength += sizeof(std::uint64_t) - 1;
+						i += sizeof(std::uint64_t) - 1;
+						continue;
+					}
+					else if (printable == 0)
+					{
+						flushAscii();
+						flushWide(0);
+						flushWide(1);
+						i += sizeof(std::uint64_t) - 1;
+						continue;
+					}
+
+					for (auto end = i + sizeof(std::uint64_t); i < end; ++i)
+					{
+						scanByte(i);
+					}
+					continue;
+				}
+
+				scanByte(i);
+				++i;
+			}
+
+			flushAscii();
+			flushWide(0);
+			flushWide(1);
+			return found;
+		}
+
+	private:
+		void scanByte(std::size_t i)
+		{
+			if (isPrintable(data[i]))
+			{
+				if (asciiLength == 0)
+				{
+					asciiStart = i;
+				}
+				++asciiLength;
+			}
+			else
+			{
+				flushAscii();
+			}
+
+			const auto parity = i % 2;
+			if (isWideCharacter(i))
+			{
+				if (wideLength[parity] == 0)
+				{
+					wideStart[parity] = i;
+				}
+				++wideLength[parity];
+			}
+			else
+			{
+				flushWide(parity);
+			}
+		}
+
+		bool isWideCharacter(std::size_t i) const
+		{
+			if (i + 1 >= size)
+			{
+				return false;
+			}
+
+			return littleEndian
+				? isPrintable(data[i]) && data[i + 1] == 0
+				: data[i] == 0 && isPrintable(data[i + 1]);
+		}
+
+		void flushAscii()
+		{
+			if (asciiLength >= minLength && found < maxCount)
+			{
+				callback(StringType::Ascii, asciiStart,
+						std::string(reinterpret_cast<const char*>(data + asciiStart), asciiLength));
+				++found;
+			}
+			asciiLength = 0;
+		}
+
+		void flushWide(std::size_t parity)
+		{
+			const auto length = wideLength[parity];
+			if (length >= minLength && found < maxCount)
+			{
+				const auto *character = data + wideStart[parity] + (littleEndian ? 0 : 1);
+				std::string content(length, '\0');
+				for (std::size_t i = 0; i < length; ++i, character += 2)
+				{
+					content[i] = static_cast<char>(*character);
+				}
+				callback(StringType::Wide, wideStart[parity], std::move(content));
+				++found;
+			}
+			wideLength[parity] = 0;
+		}
+
+	private:
+		const unsigned char *data;
+		std::size_t size;
+		bool littleEndian;
+		std::size_t minLength;
+		std::size_t maxCount;
+		const StringCallback &callback;
+
+		std::size_t found = 0;
+		std::size_t asciiStart = 0;
+		std::size_t asciiLength = 0;
+		std::size_t wideStart[2] = {0, 0};
+		std::size_t wideLength[2] = {0, 0};
+};
+
+} // anonymous namespace
+
+/**
+ * Find ASCII and wide strings in the given data in one pass.
+ * @param data Data to scan.
+ * @param size Size of @a data.
+ * @param endian Endianness of wide characters.
+ * @param minLength Minimal number of characters of reported strings.
+ * @param maxCount Maximal number of reported strings. Scanning stops when it
+ *    is reached.
+ * @param callback Called for each found string.
+ * @return Number of found strings.
+ *
+ * A character is a printable ASCII character. A wide character consists of
+ * two bytes, one of them is printable and the other one is zero.
+ */
+std::size_t scanStrings(
+		const unsigned char *data,
+		std::size_t size,
+		CharacterEndianness endian,
+		std::size_t minLength,
+		std::size_t maxCount,
+		const StringCallback &callback)
+{
+	if (!data)
+	{
+		return 0;
+	}
+
+	return StringScanner(data, size, endian, minLength, maxCount, callback).scan();
+}
+
+} // namespace fileformat
+} // namespace retdec
@@ -684,9 +684,8 @@ void VisualBasicInfo::computeExternTableHashes()
 		}
 	}
 
-	externTableHashCrc32 = getCrc32(hashBytes.data(), hashBytes.size());
-	externTableHashMd5 = getMd5(hashBytes.data(), hashBytes.size());
-	externTableHashSha256 = getSha256(hashBytes.data(), hashBytes.size());
+	retdec::fileformat::computeHashes(hashBytes.data(), hashBytes.size(),
+			externTableHashCrc32, externTableHashMd5, externTableHashSha256);
 }
 
 /**
@@ -726,9 +725,8 @@ void VisualBasicInfo::computeObjectTableHashes()
 		}
 	}
 
-	objectTableHashCrc32 = getCrc32(hashBytes.data(), hashBytes.size());
-	objectTableHashMd5 = getMd5(hashBytes.data(), hashBytes.size());
-	objectTableHashSha256 = getSha256(hashBytes.data(), hashBytes.size());
+	retdec::fileformat::computeHashes(hashBytes.data(), hashBytes.size(),
+			objectTableHashCrc32, objectTableHashMd5, objectTableHashSha256);
 }
 
 /**
@@ -4,10 +4,13 @@
  * @copyright (c) 2020 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <climits>
 #include <cmath>
+#include <memory>
 #include <vector>
 
+#include <openssl/evp.h>
 #include <openssl/md5.h>
 #include <openssl/sha.h>
 
@@ -18,6 +21,57 @@
 namespace retdec {
 namespace fileformat {
 
+namespace
+{
+
+/// Size of chunks fed into all digests at once. Each chunk stays in cache
+/// while it is being hashed by all of them.
+const std::uint64_t HASH_CHUNK_SIZE = 32 * 1024;
+
+using DigestContext = std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)>;
+
+std::string digestToString(const unsigned char *digest, std::size_t length)
+{
+	std::string result;
+	retdec::utils::bytesToHexString(digest, length, result, 0, 0, false);
+	return result;
+}
+
+/**
+ * @brief Create a context of a digest of the given type.
+ * @return Context or null pointer if it could not be initialized.
+ */
+DigestContext createDigestContext(const EVP_MD *type)
+{
+	DigestContext ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+	if(ctx && EVP_DigestInit_ex(ctx.get(), type, nullptr) != 1)
+	{
+		ctx.reset();
+	}
+	return ctx;
+}
+
+/**
+ * @brief Finish the digest in @a ctx.
+ * @param[in] ctx Digest context.
+ * @param[out] result Digest as a hexadecimal string.
+ * @return @c true if the digest was computed, @c false otherwise.
+ */
+bool finishDigest(EVP_MD_CTX *ctx, std::string &result)
+{
+	unsigned char digest[EVP_MAX_MD_SIZE];
+	unsigned int digestSize = 0;
+	if(EVP_DigestFinal_ex(ctx, digest, &digestSize) != 1)
+	{
+		return false;
+	}
+
+	result = digestToString(digest, digestSize);
+	return true;
+}
+
+} // anonymous namespace
+
 /**
  * @brief Count CRC32 of @a data.
  * @param[in] data Input data.
@@ -78,5 +132,47 @@ std::string getSha256(const unsigned char *data, std::uint64_t length)
 	return sha;
 }
 
+/**
+ * @brief Count CRC32, MD5 and SHA256 of @a data in one pass.
+ * @param[in] data Input data.
+ * @param[in] length Length of input data.
+ * @param[out] crc32 CRC32 of input data.
+ * @param[out] md5 MD5 of input data.
+ * @param[out] sha256 SHA256 of input data.
+ *
+ * The data are fed into all digests by chunks, so they are read from memory
+ * just once.
+ */
+void computeHashes(const unsigned char *data, std::uint64_t length,
+		std::string &crc32, std::string &md5, std::string &sha256)
+{
+	retdec::utils::CRC32 crc;
+	auto md5Context = createDigestContext(EVP_md5());
+	auto sha256Context = createDigestContext(EVP_sha256());
+	bool ok = md5Context && sha256Context;
+
+	for(std::uint64_t offset = 0; ok && offset < length; offset += HASH_CHUNK_SIZE)
+	{
+		const auto chunkSize = std::min(HASH_CHUNK_SIZE, length - offset);
+		crc.add(data + offset, chunkSize);
+		ok = EVP_DigestUpdate(md5Context.get(), data + offset, chunkSize) == 1
+				&& EVP_DigestUpdate(sha256Context.get(), data + offset, chunkSize) == 1;
+	}
+
+	ok = ok
+			&& finishDigest(md5Context.get(), md5)
+			&& finishDigest(sha256Context.get(), sha256);
+	if(!ok)
+	{
+		// The one-shot functions do not need contexts.
+		crc32 = getCrc32(data, length);
+		md5 = getMd5(data, length);
+		sha256 = getSha256(data, length);
+		return;
+	}
+
+	crc32 = crc.getHash();
+}
+
 } // namespace fileformat
 } // namespace retdec
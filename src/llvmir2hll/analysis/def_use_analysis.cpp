@@ -15,7 +15,6 @@
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/utils/container.h"
 
-using retdec::utils::addToSet;
 using retdec::utils::hasItem;
 
 namespace retdec {
@@ -41,28 +40,22 @@ void DefUseChains::debugPrint() {
 	llvm::errs() << "\n";
 	llvm::errs() << "Out, in, gen, and kill sets:\n";
 	llvm::errs() << "----------------------------\n";
+	auto printPairs = [this](const StmtVarPairSet &set) {
+		for (auto j = set.find_first(); j != -1; j = set.find_next(j)) {
+			llvm::errs() << "      (" << pairs[j].first << ", "
+				<< pairs[j].second->getName() << ")\n";
+		}
+	};
 	for (auto i = cfg->node_begin(), e = cfg->node_end(); i != e; ++i) {
 		llvm::errs() << "  " << (*i)->getLabel() << ":\n";
 		llvm::errs() << "    kill: \n";
-		for (auto j = kill[*i].begin(), f = kill[*i].end(); j != f; ++j) {
-			llvm::errs() << "      (" << j->first << ", "
-				<< j->second->getName() << ")\n";
-		}
+		printPairs(kill[*i]);
 		llvm::errs() << "\n    gen: \n";
-		for (auto j = gen[*i].begin(), f = gen[*i].end(); j != f; ++j) {
-			llvm::errs() << "      (" << j->first << ", "
-				<< j->second->getName() << ")\n";
-		}
+		printPairs(gen[*i]);
 		llvm::errs() << "\n    in: \n";
-		for (auto j = in[*i].begin(), f = in[*i].end(); j != f; ++j) {
-			llvm::errs() << "      (" << j->first << ", "
-				<< j->second->getName() << ")\n";
-		}
+		printPairs(in[*i]);
 		llvm::errs() << "\n    out: \n";
-		for (auto j = out[*i].begin(), f = out[*i].end(); j != f; ++j) {
-			llvm::errs() << "      (" << j->first << ", "
-				<< j->second->getName() << ")\n";
-		}
+		printPairs(out[*i]);
 		llvm::errs() << "\n\n";
 	}
 	llvm::errs() << "Def-use chains:\n";
@@ -152,6 +145,9 @@ ShPtr<DefUseAnalysis> DefUseAnalysis::create(ShPtr<Module> module,
 * This function modifies @a ducs.
 */
 void DefUseAnalysis::computeGenAndKill(ShPtr<DefUseChains> ducs) {
+	ducs->pairs.clear();
+	ducs->pairIds.clear();
+
 	// For each node B...
 	for (auto i = ducs->cfg->node_begin(), e = ducs->cfg->node_end();
 			i != e; ++i) {
@@ -159,6 +155,21 @@ void DefUseAnalysis::computeGenAndKill(ShPtr<DefUseChains> ducs) {
 	}
 }
 
+/**
+* @brief Returns the ID of the given (statement, variable) pair in the sets of
+*        @a ducs.
+*
+* If the pair has no ID yet, a new one is assigned to it.
+*/
+std::size_t DefUseAnalysis::getPairId(ShPtr<DefUseChains> ducs,
+		const DefUseChains::StmtVarPair &pair) {
+	auto inserted = ducs->pairIds.emplace(pair, ducs->pairs.size());
+	if (inserted.second) {
+		ducs->pairs.push_back(pair);
+	}
+	return inserted.first->second;
+}
+
 /**
 * @brief Computes the @c GEN[B] and @c KILL[B] sets for the given CFG node @a
 *        node @c B.
@@ -175,6 +186,14 @@ void DefUseAnalysis::computeGenAndKillForNode(ShPtr<DefUseChains> ducs,
 	// Initialization.
 	gen.clear();
 	kill.clear();
+	auto add = [&ducs](DefUseChains::StmtVarPairSet &set,
+			const DefUseChains::StmtVarPair &pair) {
+		auto id = getPairId(ducs, pair);
+		if (set.size() <= id) {
+			set.resize(id + 1);
+		}
+		set.set(id);
+	};
 
 	// Defined variables in the node (regularly updated).
 	VarSet defVars;
@@ -192,7 +211,7 @@ void DefUseAnalysis::computeGenAndKillForNode(ShPtr<DefUseChains> ducs,
 		for (auto j = stmtData->dir_read_begin(), f = stmtData->dir_read_end();
 				j != f; ++j) {
 			if (!hasItem(defVars, *j) && ducs->shouldBeIncluded(*j)) {
-				gen.emplace(*i, *j);
+				add(gen, std::make_pair(*i, *j));
 			}
 		}
 
@@ -224,7 +243,7 @@ void DefUseAnalysis::computeGenAndKillForNode(ShPtr<DefUseChains> ducs,
 				continue;
 			}
 
-			kill.emplace(varUse, defVar);
+			add(kill, std::make_pair(varUse, defVar));
 		}
 	}
 }
@@ -284,11 +303,17 @@ void DefUseAnalysis::computeInAndOut(ShPtr<DefUseChains> ducs) {
 	//
 	// Initialize the analysis.
 	//
+	// IN[B] = \emptyset for each node B. Sets of all nodes are created
+	// here, so that they all have the same size.
 	ducs->in.clear();
 	ducs->out.clear();
-	// Normally, we would have to set IN[B] = \emptyset for each node B.
-	// However, since ducs->in[B] gets initialized to an empty set
-	// automatically upon first access, we don't have to do it.
+	for (auto i = ducs->cfg->node_begin(), e = ducs->cfg->node_end();
+			i != e; ++i) {
+		ducs->in[*i].resize(ducs->pairs.size());
+		ducs->out[*i].resize(ducs->pairs.size());
+		ducs->gen[*i].resize(ducs->pairs.size());
+		ducs->kill[*i].resize(ducs->pairs.size());
+	}
 
 	//
 	// Perform the iterative algorithm to obtain IN and OUT for each node.
@@ -322,18 +347,18 @@ bool DefUseAnalysis::computeInAndOutForNode(ShPtr<DefUseChains> ducs,
 	// following algorithm.
 
 	// OUT[B] = \bigcup_{S \in succ(B)} IN[S]
-	DefUseChains::StmtVarPairSet newOut;
+	DefUseChains::StmtVarPairSet newOut(ducs->pairs.size());
 	for (auto i = node->succ_begin(), e = node->succ_end(); i != e; ++i) {
-		addToSet(ducs->in[(*i)->getDst()], newOut);
+		newOut |= ducs->in[(*i)->getDst()];
 	}
 
 	// Check whether OUT[B] has been changed.
 	auto &out = ducs->out[node];
 	auto &in = ducs->in[node];
-	if (out.size() != newOut.size()) {
+	if (out != newOut) {
 		// We no longer need newOut, so we can make a move instead of a copy.
 		out = std::move(newOut);
-	} else if (!in.empty()) {
+	} else if (in.any()) {
 		// OUT[B] hasn't been changed and IN[B] has already been
 		// computed, so we don't have to recompute IN[B] because it
 		// would remain unchanged.
@@ -341,20 +366,14 @@ bool DefUseAnalysis::computeInAndOutForNode(ShPtr<DefUseChains> ducs,
 	}
 
 	// IN[B] = GEN[B] \cup (OUT[B] - KILL[B])
-	// The following code is faster than
-	// in = setUnion(ducs->gen[node], setDifference(out, ducs->kill[node]));
-	in = ducs->gen[node];
-	auto &kill = ducs->kill[node];
-	for (auto &item : out) {
-		if (!hasItem(kill, item)) {
-			in.insert(item);
-		}
-	}
+	in = out;
+	in.reset(ducs->kill[node]);
+	in |= ducs->gen[node];
 
 	// At this moment, OUT may be unchanged, but IN has been computed for the
 	// first time. Therefore, we have to check that at least one item has been
 	// added to IN.
-	return !in.empty();
+	return in.any();
 }
 
 /**
@@ -440,7 +459,9 @@ void DefUseAnalysis::computeDefUseChainForStmt(ShPtr<DefUseChains> ducs,
 	// We have traversed all statements in the node without stopping the
 	// computation, so add also the relevant contents of OUT[node] to the
 	// def-use chain.
-	for (auto &item : ducs->out[node]) {
+	const auto &out = ducs->out[node];
+	for (auto i = out.find_first(); i != -1; i = out.find_next(i)) {
+		const auto &item = ducs->pairs[i];
 		if (item.second == defVar) {
 			du.insert(item.first);
 		}
@@ -152,6 +152,8 @@ HLLWriter::HLLWriter(llvm::raw_ostream &o, const std::string& outputFormat):
 		out = UPtr<OutputManager>(new JsonOutputManagerPlain(o));
 	} else if (outputFormat == "json-human") {
 		out = UPtr<OutputManager>(new JsonOutputManagerPretty(o));
+	} else if (outputFormat == "json-compact") {
+		out = UPtr<OutputManager>(new JsonOutputManagerPlain(o, true));
 	} else {
 		out = UPtr<OutputManager>(new PlainOutputManager(o));
 	}
@@ -18,27 +18,71 @@ const std::string JSON_KEY_TOKENS          = "tokens";
 const std::string JSON_KEY_KIND            = "kind";
 const std::string JSON_KEY_VALUE           = "val";
 
-const std::string JSON_TOKEN_NEWLINE       = "nl";
-const std::string JSON_TOKEN_SPACE         = "ws";
-const std::string JSON_TOKEN_PUNCTUATION   = "punc";
-const std::string JSON_TOKEN_OPERATOR      = "op";
-const std::string JSON_TOKEN_ID_GVAR       = "i_gvar";
-const std::string JSON_TOKEN_ID_LVAR       = "i_lvar";
-const std::string JSON_TOKEN_ID_MEMBER     = "i_mem";
-const std::string JSON_TOKEN_ID_LABEL      = "i_lab";
-const std::string JSON_TOKEN_ID_FUNCTION   = "i_fnc";
-const std::string JSON_TOKEN_ID_PARAMETER  = "i_arg";
-const std::string JSON_TOKEN_KEYWORD       = "keyw";
-const std::string JSON_TOKEN_DATA_TYPE     = "type";
-const std::string JSON_TOKEN_PREPROCESSOR  = "preproc";
-const std::string JSON_TOKEN_INCLUDE       = "inc";
-const std::string JSON_TOKEN_CONST_BOOL    = "l_bool";
-const std::string JSON_TOKEN_CONST_INT     = "l_int";
-const std::string JSON_TOKEN_CONST_FLOAT   = "l_fp";
-const std::string JSON_TOKEN_CONST_STRING  = "l_str";
-const std::string JSON_TOKEN_CONST_SYMBOL  = "l_sym";
-const std::string JSON_TOKEN_CONST_POINTER = "l_ptr";
-const std::string JSON_TOKEN_COMMENT       = "cmnt";
+const std::string JSON_KEY_FORMAT          = "format";
+const std::string JSON_KEY_KINDS           = "kinds";
+
+const std::string JSON_FORMAT_COMPACT      = "compact";
+
+/// Token kinds, indexes into @c JSON_TOKEN_KINDS.
+enum : std::size_t
+{
+	JSON_TOKEN_NEWLINE,
+	JSON_TOKEN_SPACE,
+	JSON_TOKEN_PUNCTUATION,
+	JSON_TOKEN_OPERATOR,
+	JSON_TOKEN_ID_GVAR,
+	JSON_TOKEN_ID_LVAR,
+	JSON_TOKEN_ID_MEMBER,
+	JSON_TOKEN_ID_LABEL,
+	JSON_TOKEN_ID_FUNCTION,
+	JSON_TOKEN_ID_PARAMETER,
+	JSON_TOKEN_KEYWORD,
+	JSON_TOKEN_DATA_TYPE,
+	JSON_TOKEN_PREPROCESSOR,
+	JSON_TOKEN_INCLUDE,
+	JSON_TOKEN_CONST_BOOL,
+	JSON_TOKEN_CONST_INT,
+	JSON_TOKEN_CONST_FLOAT,
+	JSON_TOKEN_CONST_STRING,
+	JSON_TOKEN_CONST_SYMBOL,
+	JSON_TOKEN_CONST_POINTER,
+	JSON_TOKEN_COMMENT,
+	/// Address entry, used only in the compact format.
+	JSON_TOKEN_ADDRESS
+};
+
+/// Names of token kinds. The order matches the enumeration above.
+const std::string JSON_TOKEN_KINDS[] =
+{
+	"nl",
+	"ws",
+	"punc",
+	"op",
+	"i_gvar",
+	"i_lvar",
+	"i_mem",
+	"i_lab",
+	"i_fnc",
+	"i_arg",
+	"keyw",
+	"type",
+	"preproc",
+	"inc",
+	"l_bool",
+	"l_int",
+	"l_fp",
+	"l_str",
+	"l_sym",
+	"l_ptr",
+	"cmnt",
+	"addr"
+};
+
+/**
+ * The buffered JSON is written to the output stream once it reaches this size,
+ * so the whole token stream is never held in memory at once.
+ */
+const std::size_t FLUSH_THRESHOLD = 64 * 1024;
 
 /**
  * We don't like macros, but we potentially need to return from methods calling
@@ -57,12 +101,29 @@ const std::string JSON_TOKEN_COMMENT       = "cmnt";
 } // anonymous namespace
 
 template <typename Writer>
-JsonOutputManager<Writer>::JsonOutputManager(llvm::raw_ostream& out) :
+JsonOutputManager<Writer>::JsonOutputManager(
+		llvm::raw_ostream& out,
+		bool compact) :
 		_out(out),
-		writer(sb)
+		writer(sb),
+		_compact(compact)
 {
 	writer.StartObject();
 
+	if (_compact)
+	{
+		writer.String(JSON_KEY_FORMAT);
+		writer.String(JSON_FORMAT_COMPACT);
+
+		writer.String(JSON_KEY_KINDS);
+		writer.StartArray();
+		for (auto& k : JSON_TOKEN_KINDS)
+		{
+			writer.String(k);
+		}
+		writer.EndArray();
+	}
+
 	writer.String(JSON_KEY_TOKENS);
 	writer.StartArray();
 
@@ -79,7 +140,18 @@ void JsonOutputManager<Writer>::finalize()
 
 	writer.EndObject();
 
-	_out << sb.GetString();
+	flush();
+}
+
+/**
+ * Writes the JSON buffered so far to the output stream and clears the buffer.
+ * The writer keeps its own state, so it continues where the buffer ended.
+ */
+template <typename Writer>
+void JsonOutputManager<Writer>::flush()
+{
+	_out.write(sb.GetString(), sb.GetSize());
+	sb.Clear();
 }
 
 template <typename Writer>
@@ -98,6 +170,12 @@ void JsonOutputManager<Writer>::newLine()
 	}
 
 	jsonToken(JSON_TOKEN_NEWLINE, "\n");
+
+	// Lines are the natural units of the output, so stream it out by them.
+	if (sb.GetSize() >= FLUSH_THRESHOLD)
+	{
+		flush();
+	}
 }
 
 template <typename Writer>
@@ -314,6 +392,23 @@ void JsonOutputManager<Writer>::addressPop()
 template <typename Writer>
 void JsonOutputManager<Writer>::generateAddressEntry(Address a)
 {
+	if (_compact)
+	{
+		// Addresses of neighbouring tokens are close to each other, so they
+		// are emitted as differences from the last defined address.
+		writer.Uint(JSON_TOKEN_ADDRESS);
+		if (a.isDefined())
+		{
+			writer.Int64(static_cast<int64_t>(a.getValue() - _lastAddr));
+			_lastAddr = a.getValue();
+		}
+		else
+		{
+			writer.Null();
+		}
+		return;
+	}
+
 	writer.StartObject();
 
 	writer.String(JSON_KEY_ADDRESS);
@@ -324,7 +419,7 @@ void JsonOutputManager<Writer>::generateAddressEntry(Address a)
 
 template <typename Writer>
 void JsonOutputManager<Writer>::jsonToken(
-		const std::string& k,
+		std::size_t k,
 		const std::string& v)
 {
 	if (_addrToGenerate.second)
@@ -333,10 +428,17 @@ void JsonOutputManager<Writer>::jsonToken(
 		_addrToGenerate = std::make_pair(Address::Undefined, false);
 	}
 
+	if (_compact)
+	{
+		writer.Uint(k);
+		writer.String(v);
+		return;
+	}
+
 	writer.StartObject();
 
 	writer.String(JSON_KEY_KIND);
-	writer.String(k);
+	writer.String(JSON_TOKEN_KINDS[k]);
 
 	writer.String(JSON_KEY_VALUE);
 	writer.String(v);
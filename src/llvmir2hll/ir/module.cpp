@@ -17,6 +17,7 @@
 #include "retdec/llvmir2hll/ir/variable.h"
 #include "retdec/llvmir2hll/semantics/semantics.h"
 #include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/node_allocator.h"
 #include "retdec/utils/container.h"
 #include "retdec/utils/string.h"
 
@@ -224,6 +225,16 @@ ShPtr<Config> Module::getConfig() const {
 	return config;
 }
 
+/**
+* @brief Sets the arena nodes of the module have been allocated from.
+*
+* The module keeps the arena until it is destroyed, so the memory of its nodes
+* is released together with the module.
+*/
+void Module::setNodeArena(ShPtr<NodeArena> arena) {
+	nodeArena = arena;
+}
+
 /**
 * @brief Returns @c true if the module contains at least one global variable,
 *        @c false otherwise.
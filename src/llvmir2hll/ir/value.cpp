@@ -7,6 +7,7 @@
 #include "retdec/llvmir2hll/ir/statement.h"
 #include "retdec/llvmir2hll/ir/value.h"
 #include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/node_allocator.h"
 #include "retdec/llvmir2hll/support/value_text_repr_visitor.h"
 
 namespace retdec {
@@ -32,6 +33,23 @@ ShPtr<Value> Value::getSelf() {
 	return shared_from_this();
 }
 
+/**
+* @brief Allocates memory for a value of the given size by NodeAllocator.
+*/
+void *Value::operator new(std::size_t size) {
+	return NodeAllocator::allocate(size);
+}
+
+/**
+* @brief Frees memory of a value of the given size by NodeAllocator.
+*
+* Since the destructor is virtual, @a size is the size of the most derived
+* class, i.e. the same size the value has been allocated with.
+*/
+void Value::operator delete(void *ptr, std::size_t size) noexcept {
+	NodeAllocator::deallocate(ptr, size);
+}
+
 /**
 * @brief Returns a textual representation of the value.
 *
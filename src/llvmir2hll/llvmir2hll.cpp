@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "retdec/llvmir2hll/llvmir2hll.h"
+#include "retdec/llvmir2hll/support/node_allocator.h"
 #include "retdec/utils/io/log.h"
 
 using namespace llvm;
@@ -149,6 +150,11 @@ void LlvmIr2Hll::getAnalysisUsage(llvm::AnalysisUsage &au) const
 
 bool LlvmIr2Hll::runOnModule(llvm::Module &m)
 {
+	// Nodes of the resulting module are allocated from its own arena, which
+	// is released together with the module.
+	auto nodeArena = std::make_shared<llvmir2hll::NodeArena>();
+	llvmir2hll::NodeArena::Scope nodeArenaScope(nodeArena.get());
+
 	Log::phase("initialization");
 
 	bool decompilationShouldContinue = initialize(m);
@@ -163,6 +169,7 @@ bool LlvmIr2Hll::runOnModule(llvm::Module &m)
 	{
 		return false;
 	}
+	resModule->setNodeArena(nodeArena);
 
 	if (!globalConfig->parameters.isBackendKeepLibraryFuncs())
 	{
@@ -604,7 +611,8 @@ void LlvmIr2Hll::runOptimizations()
 					cio,
 					arithmExprEvaluator,
 					globalConfig->parameters.isBackendAggressiveOpts(),
-					Debug
+					Debug,
+					globalConfig->parameters.getBackendThreads()
 			)
 	);
 	optManager->optimize(resModule);
@@ -4,10 +4,17 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
 #include "retdec/llvmir2hll/ir/function.h"
 #include "retdec/llvmir2hll/ir/module.h"
 #include "retdec/llvmir2hll/optimizer/func_optimizer.h"
 #include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/node_allocator.h"
 
 namespace retdec {
 namespace llvmir2hll {
@@ -25,6 +32,103 @@ FuncOptimizer::FuncOptimizer(ShPtr<Module> module):
 		PRECONDITION_NON_NULL(module);
 	}
 
+/**
+* @brief Optimizes the module of @a optimizer by several instances of the
+*        optimizer running in parallel.
+*
+* @param[in] optimizer Optimizer to be run.
+* @param[in] threads Maximal number of threads.
+* @param[in] createOptimizer Creates another instance of the same optimizer for
+*                            the same module.
+*
+* @return Optimized module.
+*
+* If the optimizer is not function-local (see isFunctionLocal()) or @a threads
+* is less than two, the module is just optimized by @a optimizer. Otherwise,
+* functions are distributed among threads, each of them having its own
+* instance of the optimizer. Since optimizations of different functions are
+* independent, the result does not depend on the distribution. The first
+* exception thrown by any of the threads is rethrown after all of them have
+* finished.
+*
+* @par Preconditions
+*  - @a optimizer and @a createOptimizer are non-null
+*/
+ShPtr<Module> FuncOptimizer::optimizeInParallel(
+		ShPtr<FuncOptimizer> optimizer, std::size_t threads,
+		const std::function<ShPtr<FuncOptimizer>()> &createOptimizer) {
+	PRECONDITION_NON_NULL(optimizer);
+	PRECONDITION_NON_NULL(createOptimizer);
+
+	FuncVector funcs(optimizer->module->func_begin(),
+		optimizer->module->func_end());
+	threads = std::min(threads, funcs.size());
+	if (threads < 2 || !optimizer->isFunctionLocal()) {
+		return optimizer->optimize();
+	}
+
+	// Instances are created here, not in the threads, because constructors
+	// of optimizers may access the module.
+	std::vector<ShPtr<FuncOptimizer>> optimizers{optimizer};
+	for (std::size_t i = 1; i < threads; ++i) {
+		optimizers.push_back(createOptimizer());
+	}
+
+	std::atomic<std::size_t> nextFunc(0);
+	std::vector<std::exception_ptr> errors(threads);
+	NodeArena *nodeArena = NodeArena::getCurrent();
+	auto work = [&](std::size_t t) {
+		// New nodes belong to the module, so they come from its arena.
+		NodeArena::Scope nodeArenaScope(nodeArena);
+		try {
+			for (auto i = nextFunc++; i < funcs.size(); i = nextFunc++) {
+				optimizers[t]->runOnFunction(funcs[i]);
+			}
+		} catch (...) {
+			errors[t] = std::current_exception();
+			nextFunc = funcs.size();
+		}
+	};
+
+	optimizer->doInitialization();
+	std::vector<std::thread> workers;
+	for (std::size_t t = 1; t < threads; ++t) {
+		workers.emplace_back(work, t);
+	}
+	work(0);
+	for (auto &w : workers) {
+		w.join();
+	}
+	optimizer->doFinalization();
+
+	for (const auto &error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+	return optimizer->module;
+}
+
+/**
+* @brief Sets functions called by doOptimization() for each function.
+*
+* @param[in] shouldBeOptimized If non-null, it is called before a function is
+*                              optimized. The function is skipped if it
+*                              returns @c false.
+* @param[in] funcOptimized If non-null, it is called after a function has been
+*                          optimized.
+*
+* Since subclasses which override doOptimization() call the default
+* implementation to optimize functions, the callbacks work for them as well.
+* They are not called by the other instances in optimizeInParallel().
+*/
+void FuncOptimizer::setFuncCallbacks(
+		std::function<bool (ShPtr<Function>)> shouldBeOptimized,
+		std::function<void (ShPtr<Function>)> funcOptimized) {
+	this->shouldBeOptimized = shouldBeOptimized;
+	this->funcOptimized = funcOptimized;
+}
+
 /**
 * @brief Performs the optimization on all functions in the module.
 *
@@ -36,7 +140,13 @@ FuncOptimizer::FuncOptimizer(ShPtr<Module> module):
 void FuncOptimizer::doOptimization() {
 	// For each function in the module...
 	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
+		if (shouldBeOptimized && !shouldBeOptimized(*i)) {
+			continue;
+		}
 		runOnFunction(*i);
+		if (funcOptimized) {
+			funcOptimized(*i);
+		}
 	}
 }
 
@@ -6,11 +6,13 @@
 
 #include <chrono>
 #include <thread>
+#include <type_traits>
 
 #include "retdec/llvmir2hll/analysis/value_analysis.h"
 #include "retdec/llvmir2hll/graphs/cg/cg_builder.h"
 #include "retdec/llvmir2hll/hll/hll_writer.h"
 #include "retdec/llvmir2hll/obtainer/call_info_obtainer.h"
+#include "retdec/llvmir2hll/optimizer/func_optimizer.h"
 #include "retdec/llvmir2hll/optimizer/optimizer_manager.h"
 #include "retdec/llvmir2hll/optimizer/optimizers/aggressive_deref_optimizer.h"
 #include "retdec/llvmir2hll/optimizer/optimizers/aggressive_global_to_local_optimizer.h"
@@ -47,6 +49,7 @@
 #include "retdec/llvmir2hll/optimizer/optimizers/while_true_to_ufor_loop_optimizer.h"
 #include "retdec/llvmir2hll/optimizer/optimizers/while_true_to_while_cond_optimizer.h"
 #include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/func_fingerprinter.h"
 #include "retdec/utils/container.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/system.h"
@@ -103,6 +106,9 @@ StringSet trimOptimizerSuffix(const StringSet &opts) {
 * @param[in] arithmExprEvaluator Used evaluator of arithmetical expressions.
 * @param[in] enableAggressiveOpts Enables aggressive optimizations.
 * @param[in] enableDebug Enables emission of debug messages.
+* @param[in] threads Maximal number of threads used by optimizations which
+*                    optimize each function separately (see
+*                    FuncOptimizer::isFunctionLocal()).
 *
 * To perform the actual optimizations, call optimize(). To get a list of
 * available optimizations and their names, see our wiki.
@@ -126,13 +132,14 @@ OptimizerManager::OptimizerManager(const StringSet &enabledOpts,
 	const StringSet &disabledOpts, ShPtr<HLLWriter> hllWriter,
 	ShPtr<ValueAnalysis> va, ShPtr<CallInfoObtainer> cio,
 	ShPtr<ArithmExprEvaluator> arithmExprEvaluator,
-	bool enableAggressiveOpts, bool enableDebug):
+	bool enableAggressiveOpts, bool enableDebug, std::size_t threads):
 		enabledOpts(trimOptimizerSuffix(enabledOpts)),
 		disabledOpts(trimOptimizerSuffix(disabledOpts)),
 		hllWriter(hllWriter), va(va), cio(cio),
 		arithmExprEvaluator(arithmExprEvaluator),
 		enableAggressiveOpts(enableAggressiveOpts), enableDebug(enableDebug),
-		recoverFromOutOfMemory(true), backendRunOpts() {
+		threads(threads), recoverFromOutOfMemory(true), backendRunOpts(),
+		unchangedFuncs() {
 			PRECONDITION_NON_NULL(hllWriter);
 			PRECONDITION_NON_NULL(va);
 			PRECONDITION_NON_NULL(cio);
@@ -291,8 +298,17 @@ bool OptimizerManager::optShouldBeRun(const std::string &optId) const {
 
 /**
 * @brief Runs the given optimizer provided that it should be run.
+*
+* @param[in] optimizer Optimizer to be run.
+* @param[in] createOptimizer If non-null, @a optimizer is a function optimizer
+*                            and this creates its other instances, so that
+*                            functions can be optimized in parallel.
+*
+* Optimizers are run one by one, so an optimizer never starts before all
+* functions have been optimized by the previous one.
 */
-void OptimizerManager::runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimizer) {
+void OptimizerManager::runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimizer,
+		const std::function<ShPtr<FuncOptimizer>()> &createOptimizer) {
 	const std::string OPT_ID = optimizer->getId();
 	if (!optShouldBeRun(OPT_ID)) {
 		return;
@@ -300,6 +316,16 @@ void OptimizerManager::runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimi
 
 	printOptimization(OPT_ID);
 
+	auto optimize = [&]() {
+		if (createOptimizer) {
+			FuncOptimizer::optimizeInParallel(
+				std::static_pointer_cast<FuncOptimizer>(optimizer), threads,
+				createOptimizer);
+		} else {
+			optimizer->optimize();
+		}
+	};
+
 	if (recoverFromOutOfMemory) {
 		// Some optimizations, most notable CopyPropagation, may run out of
 		// memory on huge inputs. We try to recover from such situations by
@@ -308,19 +334,62 @@ void OptimizerManager::runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimi
 		// memory requirements of the optimizations, or to generate smaller
 		// code in the first place.
 		try {
-			optimizer->optimize();
+			optimize();
 		} catch (const std::bad_alloc &) {
 			Log::error() << Log::Warning << "out of memory; trying to recover" << std::endl;
 			std::this_thread::sleep_for(std::chrono::seconds(1));
 		}
 	} else {
 		// Just run the optimizer and let std::bad_alloc propagate.
-		optimizer->optimize();
+		optimize();
 	}
 
 	backendRunOpts.insert(OPT_ID);
 }
 
+/**
+* @brief Makes @a optimizer skip functions that it has left unchanged the last
+*        time it was run and that have not been changed since.
+*
+* Such functions would be left unchanged again, provided that the module-level
+* information the optimizer depends on has not been changed either. Data-flow
+* optimizations are run several times, so this saves building CFGs and def-use
+* chains of functions that other optimizations have not touched.
+*/
+void OptimizerManager::skipUnchangedFuncs(ShPtr<FuncOptimizer> optimizer,
+		ShPtr<Module> m) {
+	auto &unchanged = unchangedFuncs[optimizer->getId()];
+	// Fingerprints of functions before the optimization are computed together
+	// with the module fingerprint. Optimizations of single functions do not
+	// change other functions, so they are valid until the function is
+	// optimized.
+	auto funcFingerprints =
+		std::make_shared<FuncFingerprinter::FuncFingerprints>();
+	const auto moduleFingerprint = FuncFingerprinter::getModuleFingerprint(m,
+		funcFingerprints.get());
+	// Fingerprint of the currently optimized function before its optimization.
+	auto lastFingerprint = std::make_shared<std::size_t>(0);
+	optimizer->setFuncCallbacks(
+		[&unchanged, moduleFingerprint, funcFingerprints,
+				lastFingerprint](auto func) {
+			auto f = funcFingerprints->find(func);
+			*lastFingerprint = f != funcFingerprints->end()
+				? f->second
+				: FuncFingerprinter::getFingerprint(func);
+			auto i = unchanged.find(func);
+			return i == unchanged.end() ||
+				i->second != std::make_pair(*lastFingerprint, moduleFingerprint);
+		},
+		[&unchanged, moduleFingerprint, lastFingerprint](auto func) {
+			if (FuncFingerprinter::getFingerprint(func) == *lastFingerprint) {
+				unchanged[func] = std::make_pair(*lastFingerprint, moduleFingerprint);
+			} else {
+				unchanged.erase(func);
+			}
+		}
+	);
+}
+
 /**
 * @brief Prints debug information about the currently run optimization with @a
 *        optId.
@@ -369,12 +438,27 @@ bool OptimizerManager::shouldSecondCopyPropagationBeRun() const {
 * is non-empty and it doesn't contain the optimization, it is also not run.
 *
 * If @c enableDebug is @c true, debug messages are emitted.
+*
+* Function optimizations may be run with more instances in parallel, so they
+* get copies of @a args.
 */
 template<typename Optimization, typename... Args>
 void OptimizerManager::run(ShPtr<Module> m, Args &&... args) {
-	auto optimizer = std::make_shared<Optimization>(m,
-		std::forward<Args>(args)...);
-	runOptimizerProvidedItShouldBeRun(optimizer);
+	if constexpr (std::is_base_of<FuncOptimizer, Optimization>::value) {
+		auto createOptimizer = [&]() -> ShPtr<FuncOptimizer> {
+			return std::make_shared<Optimization>(m, args...);
+		};
+		auto optimizer = createOptimizer();
+		if (optimizer->canSkipUnchangedFuncs() &&
+				optShouldBeRun(optimizer->getId())) {
+			skipUnchangedFuncs(optimizer, m);
+		}
+		runOptimizerProvidedItShouldBeRun(optimizer, createOptimizer);
+	} else {
+		auto optimizer = std::make_shared<Optimization>(m,
+			std::forward<Args>(args)...);
+		runOptimizerProvidedItShouldBeRun(optimizer);
+	}
 }
 
 } // namespace llvmir2hll
@@ -0,0 +1,130 @@
+/**
+* @file src/llvmir2hll/support/func_fingerprinter.cpp
+* @brief Implementation of FuncFingerprinter.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <functional>
+#include <string>
+
+#include "retdec/llvmir2hll/ir/address_op_expr.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/global_var_def.h"
+#include "retdec/llvmir2hll/ir/module.h"
+#include "retdec/llvmir2hll/ir/statement.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/func_fingerprinter.h"
+#include "retdec/utils/container.h"
+
+using retdec::utils::hasItem;
+
+namespace retdec {
+namespace llvmir2hll {
+
+/**
+* @brief Constructs a new fingerprinter.
+*/
+FuncFingerprinter::FuncFingerprinter():
+	OrderedAllVisitor(), fingerprint(0), addressedVars(nullptr) {}
+
+/**
+* @brief Returns a fingerprint of the given function.
+*
+* @param[in] func Function whose fingerprint is computed.
+* @param[out] addressedVars If non-null, variables whose address is taken in
+*                           @a func are added to it.
+*
+* Two calls for the same function return the same fingerprint if and only if
+* the function has not been changed in between (up to hash collisions).
+*
+* @par Preconditions
+*  - @a func is non-null
+*/
+std::size_t FuncFingerprinter::getFingerprint(ShPtr<Function> func,
+		VarSet *addressedVars) {
+	PRECONDITION_NON_NULL(func);
+
+	FuncFingerprinter fingerprinter;
+	fingerprinter.addressedVars = addressedVars;
+	fingerprinter.add(std::hash<std::string>()(func->getTextRepr()));
+	for (const auto &var : func->getLocalVars(true)) {
+		fingerprinter.add(std::hash<ShPtr<Variable>>()(var));
+	}
+	func->accept(&fingerprinter);
+	return fingerprinter.fingerprint;
+}
+
+/**
+* @brief Returns a fingerprint of module-level information that optimizations
+*        of single functions may depend on.
+*
+* It covers definitions of global variables, the set of functions with
+* information whether they are defined or only declared, and all variables
+* whose address is taken anywhere in the module (i.e. variables that may be
+* pointed to).
+*
+* @param[in] module Module whose fingerprint is computed.
+* @param[out] funcFingerprints If non-null, fingerprints of all the defined
+*                              functions (see getFingerprint()) are stored
+*                              into it.
+*
+* @par Preconditions
+*  - @a module is non-null
+*/
+std::size_t FuncFingerprinter::getModuleFingerprint(ShPtr<Module> module,
+		FuncFingerprints *funcFingerprints) {
+	PRECONDITION_NON_NULL(module);
+
+	FuncFingerprinter fingerprinter;
+	VarSet addressedVars;
+	fingerprinter.addressedVars = &addressedVars;
+	for (auto i = module->global_var_begin(), e = module->global_var_end();
+			i != e; ++i) {
+		fingerprinter.add(std::hash<std::string>()((*i)->getTextRepr()));
+		(*i)->accept(&fingerprinter);
+	}
+	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
+		fingerprinter.add(std::hash<ShPtr<Function>>()(*i));
+		fingerprinter.add((*i)->isDefinition());
+		if ((*i)->isDefinition()) {
+			auto fingerprint = getFingerprint(*i, &addressedVars);
+			if (funcFingerprints) {
+				(*funcFingerprints)[*i] = fingerprint;
+			}
+		}
+	}
+	for (const auto &var : addressedVars) {
+		fingerprinter.add(std::hash<ShPtr<Variable>>()(var));
+	}
+	return fingerprinter.fingerprint;
+}
+
+/**
+* @brief Adds the given hash to the fingerprint.
+*/
+void FuncFingerprinter::add(std::size_t hash) {
+	fingerprint ^= hash + 0x9e3779b9 + (fingerprint << 6) + (fingerprint >> 2);
+}
+
+void FuncFingerprinter::visit(ShPtr<AddressOpExpr> expr) {
+	if (addressedVars) {
+		if (ShPtr<Variable> var = cast<Variable>(expr->getOperand())) {
+			addressedVars->insert(var);
+		}
+	}
+	OrderedAllVisitor::visit(expr);
+}
+
+void FuncFingerprinter::visitStmt(ShPtr<Statement> stmt,
+		bool visitSuccessors, bool visitNestedStmts) {
+	if (stmt && !hasItem(accessedStmts, stmt)) {
+		add(std::hash<ShPtr<Statement>>()(stmt));
+		add(std::hash<ShPtr<Statement>>()(stmt->getSuccessor()));
+		add(std::hash<std::string>()(stmt->getTextRepr()));
+	}
+	OrderedAllVisitor::visitStmt(stmt, visitSuccessors, visitNestedStmts);
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
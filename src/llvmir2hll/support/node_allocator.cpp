@@ -0,0 +1,413 @@
+/**
+* @file src/llvmir2hll/support/node_allocator.cpp
+* @brief Implementation of NodeAllocator and NodeArena.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "retdec/llvmir2hll/support/node_allocator.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+namespace {
+
+/// Number of size classes of pooled nodes.
+constexpr std::size_t SIZE_CLASS_COUNT =
+	NodeAllocator::maxPooledSize / NodeAllocator::granularity;
+
+/// Number of free nodes moved between a thread and an arena at once.
+constexpr std::size_t BATCH_SIZE = 64;
+
+/**
+* @brief A free node, linked to the next free node of the same size.
+*/
+struct FreeNode {
+	FreeNode *next;
+};
+
+/**
+* @brief A list of free nodes of the same size.
+*/
+struct FreeList {
+	void push(FreeNode *node) {
+		node->next = head;
+		head = node;
+		++length;
+	}
+
+	FreeNode *pop() {
+		FreeNode *node = head;
+		head = node->next;
+		--length;
+		return node;
+	}
+
+	FreeNode *head = nullptr;
+	std::size_t length = 0;
+};
+
+/**
+* @brief The beginning of a chunk, followed by its nodes.
+*
+* Chunks are aligned to their size, so the chunk of a node is found by
+* clearing the lower bits of its address.
+*/
+struct alignas(std::max_align_t) ChunkHeader {
+	/// Arena the chunk belongs to.
+	NodeArena::State *arena;
+	/// Number of nodes of the chunk which are not in free lists of the
+	/// arena (they are used or in free lists of threads).
+	std::size_t takenNodes;
+};
+
+/**
+* @brief Returns the chunk the given node has been carved from.
+*/
+ChunkHeader *getChunk(void *node) {
+	return reinterpret_cast<ChunkHeader *>(
+		reinterpret_cast<std::uintptr_t>(node) &
+			~std::uintptr_t(NodeAllocator::chunkSize - 1));
+}
+
+/**
+* @brief Returns the size class of nodes of the given size.
+*/
+std::size_t getSizeClass(std::size_t size) {
+	return size == 0 ? 0 : (size - 1) / NodeAllocator::granularity;
+}
+
+} // anonymous namespace
+
+/**
+* @brief Chunks and free nodes of an arena.
+*
+* Unless stated otherwise, @c mutex must be locked when calling its functions.
+*/
+struct NodeArena::State {
+	/// Takes a free node of the given size class, carves a new one if there
+	/// is none.
+	FreeNode *take(std::size_t sizeClass) {
+		FreeList &list = freeLists[sizeClass];
+		FreeNode *node = list.head ? list.pop() : carve(sizeClass);
+		++getChunk(node)->takenNodes;
+		return node;
+	}
+
+	/// Returns a node of the given size class to the arena.
+	/// @return @c true if the arena has been destroyed and this was its last
+	///         node, so the state has to be deleted (with unlocked @c mutex).
+	bool put(FreeNode *node, std::size_t sizeClass) {
+		ChunkHeader *chunk = getChunk(node);
+		--chunk->takenNodes;
+		if (!destroyed) {
+			freeLists[sizeClass].push(node);
+			return false;
+		}
+
+		if (chunk->takenNodes == 0) {
+			freeChunk(chunk);
+			--remainingChunks;
+		}
+		return remainingChunks == 0;
+	}
+
+	/// Moves @c BATCH_SIZE free nodes of the given size class to @a list,
+	/// @c mutex must not be locked.
+	void refill(std::size_t sizeClass, FreeList &list) {
+		std::lock_guard<std::mutex> lock(mutex);
+		while (list.length < BATCH_SIZE) {
+			list.push(take(sizeClass));
+		}
+	}
+
+	/// Frees chunks with no taken nodes when the arena is destroyed, @c mutex
+	/// must not be locked.
+	/// @return @c true if no chunk remains, so the state has to be deleted.
+	bool destroy() {
+		std::lock_guard<std::mutex> lock(mutex);
+		destroyed = true;
+		for (auto chunk : chunks) {
+			if (chunk->takenNodes == 0) {
+				freeChunk(chunk);
+			} else {
+				++remainingChunks;
+			}
+		}
+		// Nodes from the free lists are in the freed chunks or they will be
+		// freed together with the remaining chunks.
+		chunks.clear();
+		return remainingChunks == 0;
+	}
+
+	FreeNode *carve(std::size_t sizeClass) {
+		const std::size_t size = (sizeClass + 1) * NodeAllocator::granularity;
+		if (chunkLeft < size) {
+			auto chunk = new (::operator new(NodeAllocator::chunkSize,
+				std::align_val_t(NodeAllocator::chunkSize))) ChunkHeader{this, 0};
+			chunks.push_back(chunk);
+			chunkPos = reinterpret_cast<char *>(chunk) + sizeof(ChunkHeader);
+			chunkLeft = NodeAllocator::chunkSize - sizeof(ChunkHeader);
+		}
+		auto node = reinterpret_cast<FreeNode *>(chunkPos);
+		chunkPos += size;
+		chunkLeft -= size;
+		return node;
+	}
+
+	static void freeChunk(ChunkHeader *chunk) {
+		::operator delete(chunk, std::align_val_t(NodeAllocator::chunkSize));
+	}
+
+	std::mutex mutex;
+	std::vector<ChunkHeader *> chunks;
+	char *chunkPos = nullptr;
+	std::size_t chunkLeft = 0;
+	FreeList freeLists[SIZE_CLASS_COUNT];
+	/// The arena has been destroyed, its nodes are not reused.
+	bool destroyed = false;
+	/// Number of chunks with taken nodes after the arena has been destroyed.
+	std::size_t remainingChunks = 0;
+};
+
+namespace {
+
+/**
+* @brief Returns the state of the default arena.
+*
+* It is never destroyed because nodes held by static variables (e.g. cached
+* types) may be freed after all static variables of this module have been
+* destroyed.
+*/
+NodeArena::State *getDefaultState() {
+	static auto state = new NodeArena::State();
+	return state;
+}
+
+/// Arena of the current thread, the default arena if it is null.
+thread_local NodeArena *currentArena = nullptr;
+
+/**
+* @brief Free nodes of one thread.
+*
+* They belong to the current arena of the thread. It is trivially
+* destructible, so it can be used even after the thread's LocalCacheFlusher
+* has been destroyed.
+*/
+struct LocalCache {
+	/// Arena of the nodes, null if there are no nodes.
+	NodeArena::State *arena;
+	FreeList freeLists[SIZE_CLASS_COUNT];
+	/// The thread is exiting, so arenas have to be used directly.
+	bool flushed;
+};
+
+thread_local LocalCache localCache;
+
+/**
+* @brief Returns free nodes of @a cache to their arena.
+*/
+void flush(LocalCache &cache) {
+	if (!cache.arena) {
+		return;
+	}
+
+	// The arena of the cache is current, so it has not been destroyed and
+	// put() never asks for deleting it.
+	std::lock_guard<std::mutex> lock(cache.arena->mutex);
+	for (std::size_t i = 0; i < SIZE_CLASS_COUNT; ++i) {
+		while (cache.freeLists[i].head) {
+			cache.arena->put(cache.freeLists[i].pop(), i);
+		}
+	}
+	cache.arena = nullptr;
+}
+
+/**
+* @brief Returns free nodes of an exiting thread to their arena.
+*/
+struct LocalCacheFlusher {
+	~LocalCacheFlusher() {
+		flush(localCache);
+		localCache.flushed = true;
+	}
+};
+
+/**
+* @brief Returns free nodes of the current thread, or the null pointer if the
+*        thread is exiting.
+*/
+LocalCache *getLocalCache() {
+	thread_local LocalCacheFlusher flusher;
+	return localCache.flushed ? nullptr : &localCache;
+}
+
+/**
+* @brief Returns @a node of the given size class to @a arena.
+*/
+void putToArena(NodeArena::State *arena, FreeNode *node,
+		std::size_t sizeClass) {
+	bool lastNode = false;
+	{
+		std::lock_guard<std::mutex> lock(arena->mutex);
+		lastNode = arena->put(node, sizeClass);
+	}
+	if (lastNode) {
+		delete arena;
+	}
+}
+
+} // anonymous namespace
+
+/**
+* @brief Makes @a arena current in the calling thread.
+*
+* @param[in] arena Arena to be made current. If it is the null pointer, the
+*                  default arena is made current.
+*/
+NodeArena::Scope::Scope(NodeArena *arena): prevArena(currentArena) {
+	if (LocalCache *cache = getLocalCache()) {
+		flush(*cache);
+	}
+	currentArena = arena;
+}
+
+/**
+* @brief Makes the previous arena current in the calling thread.
+*/
+NodeArena::Scope::~Scope() {
+	if (LocalCache *cache = getLocalCache()) {
+		flush(*cache);
+	}
+	currentArena = prevArena;
+}
+
+/**
+* @brief Constructs a new arena.
+*/
+NodeArena::NodeArena(): state(new State()) {}
+
+/**
+* @brief Destroys the arena.
+*
+* Chunks with no used nodes are freed, the other ones are freed once their
+* nodes are freed.
+*/
+NodeArena::~NodeArena() {
+	if (state->destroy()) {
+		delete state;
+	}
+}
+
+/**
+* @brief Returns the number of bytes reserved for nodes of the arena.
+*
+* It includes both used and free nodes.
+*/
+std::size_t NodeArena::getReservedBytes() const {
+	std::lock_guard<std::mutex> lock(state->mutex);
+	return state->chunks.size() * NodeAllocator::chunkSize;
+}
+
+/**
+* @brief Returns the state of the current arena of the calling thread.
+*/
+NodeArena::State *NodeArena::getCurrentState() {
+	return currentArena ? currentArena->state : getDefaultState();
+}
+
+/**
+* @brief Returns the current arena of the calling thread, or the null pointer
+*        if the default arena is current.
+*/
+NodeArena *NodeArena::getCurrent() {
+	return currentArena;
+}
+
+/**
+* @brief Allocates memory for a node of the given size from the current arena.
+*
+* The memory is aligned for any type the global operator new would align it
+* for. If there is not enough memory, @c std::bad_alloc is thrown.
+*/
+void *NodeAllocator::allocate(std::size_t size) {
+	if (size > maxPooledSize) {
+		return ::operator new(size);
+	}
+
+	const std::size_t sizeClass = getSizeClass(size);
+	NodeArena::State *arena = NodeArena::getCurrentState();
+	LocalCache *cache = getLocalCache();
+	if (!cache) {
+		std::lock_guard<std::mutex> lock(arena->mutex);
+		return arena->take(sizeClass);
+	}
+
+	if (cache->arena != arena) {
+		flush(*cache);
+		cache->arena = arena;
+	}
+	FreeList &list = cache->freeLists[sizeClass];
+	if (!list.head) {
+		arena->refill(sizeClass, list);
+	}
+	return list.pop();
+}
+
+/**
+* @brief Frees memory of a node allocated by allocate().
+*
+* @param[in] ptr Pointer returned by allocate().
+* @param[in] size Size passed to allocate().
+*
+* The memory may be freed by a different thread than the one which allocated
+* it, even after its arena has been destroyed.
+*/
+void NodeAllocator::deallocate(void *ptr, std::size_t size) noexcept {
+	if (!ptr) {
+		return;
+	}
+
+	if (size > maxPooledSize) {
+		::operator delete(ptr);
+		return;
+	}
+
+	const std::size_t sizeClass = getSizeClass(size);
+	auto node = static_cast<FreeNode *>(ptr);
+	NodeArena::State *arena = getChunk(ptr)->arena;
+	LocalCache *cache = getLocalCache();
+	if (!cache || cache->arena != arena) {
+		putToArena(arena, node, sizeClass);
+		return;
+	}
+
+	FreeList &list = cache->freeLists[sizeClass];
+	list.push(node);
+	if (list.length > 2 * BATCH_SIZE) {
+		// Let other threads reuse the nodes this thread has freed.
+		std::lock_guard<std::mutex> lock(arena->mutex);
+		for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+			arena->put(list.pop(), sizeClass);
+		}
+	}
+}
+
+/**
+* @brief Returns the number of bytes reserved for nodes of the current arena
+*        of the calling thread.
+*
+* It includes both used and free nodes.
+*/
+std::size_t NodeAllocator::getReservedBytes() {
+	NodeArena::State *state = NodeArena::getCurrentState();
+	std::lock_guard<std::mutex> lock(state->mutex);
+	return state->chunks.size() * chunkSize;
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
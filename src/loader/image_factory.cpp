@@ -64,18 +64,50 @@ std::unique_ptr<Image> createImageImpl(const std::shared_ptr<retdec::fileformat:
  *
  * @param filePath Path to input file.
  * @param isRaw Is the input a raw binary file format?
+ * @param loadFlags Load flags of the file format.
  *
  * @return Pointer to instance of Image class or @c nullptr if any error
  */
-std::unique_ptr<Image> createImage(const std::string& filePath, bool isRaw)
+std::unique_ptr<Image> createImage(
+		const std::string& filePath,
+		bool isRaw,
+		retdec::fileformat::LoadFlags loadFlags)
 {
 	std::unique_ptr<retdec::fileformat::FileFormat> fileFormat = retdec::fileformat::createFileFormat(
 			filePath,
-			isRaw);
+			isRaw,
+			loadFlags);
 	std::shared_ptr<retdec::fileformat::FileFormat> fileFormatShared(std::move(fileFormat)); // Obtain ownership.
 	return createImageImpl(fileFormatShared);
 }
 
+/**
+ * Create instance of Image class from file content in memory.
+ * If the input cannot be loaded, function will return @c nullptr.
+ * Loaded image becomes owner of the created @c FileFormat, but the memory
+ * pointed to by @a data is not copied and must outlive the image.
+ *
+ * @param data Input file content.
+ * @param size Size of @a data.
+ * @param isRaw Is the input a raw binary file format?
+ * @param loadFlags Load flags of the file format.
+ *
+ * @return Pointer to instance of Image class or @c nullptr if any error
+ */
+std::unique_ptr<Image> createImage(
+		const std::uint8_t* data,
+		std::size_t size,
+		bool isRaw,
+		retdec::fileformat::LoadFlags loadFlags)
+{
+	std::shared_ptr<retdec::fileformat::FileFormat> fileFormat = retdec::fileformat::createFileFormat(
+			data,
+			size,
+			isRaw,
+			loadFlags);
+	return createImageImpl(fileFormat);
+}
+
 /**
  * Create instance of Image class from existing file format instance.
  * If the input file cannot be loaded, function will return @c nullptr,
@@ -562,6 +562,8 @@ void ElfImage::fixBssSegments()
 			bssSegment->resize(nextSegment->getAddress() - bssSegment->getAddress());
 		}
 	}
+
+	invalidateSegmentIndex();
 }
 
 void ElfImage::applyRelocations()
@@ -18,7 +18,7 @@ namespace retdec {
 namespace loader {
 
 Image::Image(const std::shared_ptr<retdec::fileformat::FileFormat>& fileFormat) : _fileFormat(fileFormat), _segments(),
-	_baseAddress(0), _namelessSegNameGen("seg", '0', 4), _statusMessage()
+	_segmentIndex(), _segmentIndexValid(false), _segmentIndexMutex(), _baseAddress(0), _namelessSegNameGen("seg", '0', 4), _statusMessage()
 {
 }
 
@@ -331,18 +331,34 @@ std::pair<const std::uint8_t*, std::uint64_t> Image::getRawSegmentData(std::uint
 bool Image::getXByte(std::uint64_t address, std::uint64_t x, std::uint64_t& res, Endianness e/* = UNKNOWN*/) const
 {
 	const auto *seg = getSegmentFromAddress(address);
-	if (!seg || x * getByteLength() > sizeof(res) * CHAR_BIT)
+	if (!seg || x == 0 || x * getByteLength() > sizeof(res) * CHAR_BIT)
 	{
 		return false;
 	}
 
-	std::vector<std::uint8_t> data;
-	if (!seg->getBytes(data, address - seg->getAddress(), x) || data.size() != x)
+	if (e == Endianness::UNKNOWN)
+	{
+		e = getEndianness();
+	}
+	if (e != Endianness::LITTLE && e != Endianness::BIG)
 	{
 		return false;
 	}
 
-	return createValueFromBytes(data, res, e);
+	std::uint8_t data[sizeof(res)];
+	if (!seg->readBytes(address - seg->getAddress(), x, data))
+	{
+		return false;
+	}
+
+	res = 0;
+	for (std::uint64_t i = 0; i < x; ++i)
+	{
+		res |= static_cast<std::uint64_t>(data[i])
+				<< (getByteLength() * (e == Endianness::LITTLE ? i : x - i - 1));
+	}
+
+	return true;
 }
 
 /**
@@ -362,30 +378,41 @@ bool Image::getXBytes(std::uint64_t address, std::uint64_t x, std::vector<std::u
 		return false;
 	}
 
-	res.clear();
-	if (!seg->getBytes(res, address - seg->getAddress(), x) || res.size() != x)
+	// Check the range first so that the result is not resized needlessly.
+	auto offset = address - seg->getAddress();
+	if (x > seg->getSize() - offset)
 	{
 		return false;
 	}
 
-	return true;
+	res.resize(x);
+	return seg->readBytes(offset, x, res.data());
 }
 
 bool Image::setXByte(std::uint64_t address, std::uint64_t x, std::uint64_t val, retdec::utils::Endianness e/* = retdec::utils::Endianness::UNKNOWN*/)
 {
-	const auto *seg = getSegmentFromAddress(address);
+	auto *seg = getSegmentFromAddress(address);
 	if (!seg || x * getByteLength() > sizeof(val) * CHAR_BIT)
 	{
 		return false;
 	}
 
-	std::vector<std::uint8_t> data;
-	if (!createBytesFromValue(val, x, data, e))
+	if (e == Endianness::UNKNOWN)
+	{
+		e = getEndianness();
+	}
+	if (e != Endianness::LITTLE && e != Endianness::BIG)
 	{
 		return false;
 	}
 
-	return setXBytes(address, data);
+	std::uint8_t data[sizeof(val)];
+	for (std::uint64_t i = 0; i < x; ++i)
+	{
+		data[i] = (val >> (getByteLength() * (e == Endianness::LITTLE ? i : x - i - 1))) & 0xFF;
+	}
+
+	return seg->setBytes(data, x, address - seg->getAddress());
 }
 
 bool Image::setXBytes(std::uint64_t address, const std::vector<std::uint8_t>& val)
@@ -443,6 +470,7 @@ Segment* Image::insertSegment(std::unique_ptr<Segment> segment)
 	// Now give segment name
 	Segment* retSegment = _segments.back().get();
 	nameSegment(retSegment);
+	invalidateSegmentIndex();
 	return retSegment;
 }
 
@@ -453,6 +481,7 @@ void Image::removeSegment(Segment* segment)
 		if (itr->get() == segment)
 		{
 			_segments.erase(itr);
+			invalidateSegmentIndex();
 			return;
 		}
 	}
@@ -472,6 +501,17 @@ void Image::sortSegments()
 			{
 				return seg1->getAddress() < seg2->getAddress();
 			});
+	invalidateSegmentIndex();
+}
+
+/**
+ * Marks index of segments as outdated. Must be called whenever the address
+ * range of some segment is changed. Insertion, removal and sorting of segments
+ * invalidate the index automatically.
+ */
+void Image::invalidateSegmentIndex()
+{
+	_segmentIndexValid = false;
 }
 
 const Segment* Image::_getSegment(std::size_t index) const
@@ -506,13 +546,31 @@ const Segment* Image::_getSegmentWithIndex(std::size_t index) const
 
 const Segment* Image::_getSegmentFromAddress(std::uint64_t address) const
 {
-	for (const auto& segment : getSegments())
+	_updateSegmentIndex();
+	return _segmentIndex.find(address);
+}
+
+/**
+ * Builds index of segments by their address ranges if it is outdated. If more
+ * segments contain the same address, the first one is found.
+ */
+void Image::_updateSegmentIndex() const
+{
+	if (_segmentIndexValid)
+		return;
+
+	std::lock_guard<std::mutex> lock(_segmentIndexMutex);
+	if (_segmentIndexValid)
+		return;
+
+	_segmentIndex.clear();
+	for (const auto& segment : _segments)
 	{
-		if (segment->containsAddress(address))
-			return segment.get();
+		if (segment->getEndAddress() > segment->getAddress())
+			_segmentIndex.add(segment->getAddress(), segment->getEndAddress() - 1, segment.get());
 	}
-
-	return nullptr;
+	_segmentIndex.build();
+	_segmentIndexValid = true;
 }
 
 } // namespace loader
@@ -9,7 +9,6 @@
 #include <sstream>
 #include <vector>
 
-#include "retdec/utils/file_io.h"
 #include "retdec/fileformat/fileformat.h"
 #include "retdec/loader/loader/pe/pe_image.h"
 #include "retdec/loader/utils/overlap_resolver.h"
@@ -61,10 +60,8 @@ bool PeImage::load()
 	// If no sections found, map the whole file into one big segment.
 	if (sections.empty())
 	{
-		std::vector<std::uint8_t> bytes;
-		if (!readFile(peFormat->getPathToFile(), bytes))
-			return false;
-
+		// Use already loaded content, input may not be backed by a file.
+		std::vector<std::uint8_t> bytes = peFormat->getBytes().vec();
 		if (addSingleSegment(imageBase, bytes) == nullptr)
 			return false;
 	}
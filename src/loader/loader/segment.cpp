@@ -207,6 +207,34 @@ bool Segment::getBytes(std::vector<unsigned char>& result, std::uint64_t address
 	return true;
 }
 
+/**
+ * Get content of segment as bytes without any allocation. Unlike getBytes(), the whole
+ * requested range must lie in the segment. Bytes beyond the physical data of the segment
+ * are filled with zeroes.
+ *
+ * @param addressOffset First byte of the segment to be read (0 means first byte of segment).
+ * @param size Number of bytes for read.
+ * @param result Buffer for at least @p size bytes.
+ *
+ * @return True if read was successful, otherwise false.
+ */
+bool Segment::readBytes(std::uint64_t addressOffset, std::uint64_t size, std::uint8_t* result) const
+{
+	if (addressOffset >= getSize() || size > getSize() - addressOffset)
+		return false;
+
+	auto rawData = getRawData();
+	auto available = rawData.first && addressOffset < rawData.second
+		? std::min(size, rawData.second - addressOffset)
+		: 0;
+	if (available)
+		std::memcpy(result, rawData.first + addressOffset, available);
+	if (available < size)
+		std::memset(result + available, 0, size - available);
+
+	return true;
+}
+
 /**
  * Get content of segment as bits in string representation.
  *
@@ -239,11 +267,16 @@ bool Segment::getBits(std::string& result, std::uint64_t addressOffset, std::uin
 }
 
 bool Segment::setBytes(const std::vector<unsigned char>& value, std::uint64_t addressOffset)
+{
+	return setBytes(value.data(), value.size(), addressOffset);
+}
+
+bool Segment::setBytes(const std::uint8_t* value, std::uint64_t size, std::uint64_t addressOffset)
 {
 	if (addressOffset >= getSize())
 		return false;
 
-	std::size_t size = addressOffset + value.size() > getSize() ? getSize() - addressOffset : value.size();
+	size = addressOffset + size > getSize() ? getSize() - addressOffset : size;
 	if (_dataSource != nullptr)
 		_dataSource->saveData(addressOffset, size, value);
 
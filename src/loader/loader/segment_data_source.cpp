@@ -5,7 +5,6 @@
  */
 
 #include <algorithm>
-#include <iterator>
 
 #include "retdec/loader/loader/segment_data_source.h"
 
@@ -78,11 +77,16 @@ bool SegmentDataSource::loadData(std::uint64_t loadOffset, std::uint64_t loadSiz
 		return false;
 
 	loadSize = loadOffset + loadSize >= getDataSize() ? getDataSize() - loadOffset : loadSize;
-	std::copy(_data.data() + loadOffset, _data.data() + loadOffset + loadSize, std::back_inserter(data));
+	data.assign(_data.bytes_begin() + loadOffset, _data.bytes_begin() + loadOffset + loadSize);
 	return true;
 }
 
 bool SegmentDataSource::saveData(std::uint64_t saveOffset, std::uint64_t saveSize, const std::vector<std::uint8_t>& data)
+{
+	return saveData(saveOffset, std::min<std::uint64_t>(saveSize, data.size()), data.data());
+}
+
+bool SegmentDataSource::saveData(std::uint64_t saveOffset, std::uint64_t saveSize, const std::uint8_t* data)
 {
 	if (!isDataSet())
 		return false;
@@ -91,7 +95,7 @@ bool SegmentDataSource::saveData(std::uint64_t saveOffset, std::uint64_t saveSiz
 		return false;
 
 	saveSize = saveOffset + saveSize > getDataSize() ? getDataSize() - saveOffset : saveSize;
-	std::copy(data.data(), data.data() + saveSize, const_cast<char*>(_data.data()) + saveOffset);
+	std::copy(data, data + saveSize, const_cast<char*>(_data.data()) + saveOffset);
 	return true;
 }
 
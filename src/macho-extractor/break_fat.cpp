@@ -97,6 +97,33 @@ namespace macho_extractor {
 BreakMachOUniversal::BreakMachOUniversal(
 		const std::string &filePath)
 	: path(filePath), buffer(MemoryBuffer::getFile(Twine(filePath)))
+{
+	init();
+}
+
+/**
+ * BreakMachOUniversal constructor
+ * @param data input file content
+ * @param size size of @p data
+ *
+ * Input is not copied, @p data must outlive the created object.
+ * Verify success with isValid() function.
+ */
+BreakMachOUniversal::BreakMachOUniversal(
+		const std::uint8_t *data,
+		std::size_t size)
+	: buffer(MemoryBuffer::getMemBuffer(
+			StringRef(reinterpret_cast<const char*>(data), size),
+			"",
+			false))
+{
+	init();
+}
+
+/**
+ * Parse Mach-O Universal Binary from loaded buffer
+ */
+void BreakMachOUniversal::init()
 {
 	if(buffer && !buffer.getError())
 	{
@@ -196,6 +223,154 @@ bool BreakMachOUniversal::extract(
 	return false;
 }
 
+/**
+ * Extract object by iterator into memory
+ * @param it object iterator
+ * @param result extracted object content
+ * @return @c true if object was extracted successfully, @c false otherwise
+ */
+bool BreakMachOUniversal::extract(
+		llvm::object::MachOUniversalBinary::object_iterator &it,
+		std::vector<std::uint8_t> &result)
+{
+	auto *start = reinterpret_cast<const std::uint8_t*>(
+			getFileBufferStart() + it->getOffset());
+	result.assign(start, start + it->getSize());
+	return true;
+}
+
+/**
+ * Get archive with best architecture for decompilation
+ * @param res reference for storing result
+ * @return @c true if archive was found, @c false otherwise
+ */
+bool BreakMachOUniversal::getBestArchive(
+		llvm::object::MachOUniversalBinary::object_iterator &res)
+{
+	if(!file || !file->getNumberOfObjects())
+	{
+		return false;
+	}
+
+	res = file->begin_objects();
+	if(getByArchFamily(CPU_TYPE_X86, res)
+			|| getByArchFamily(CPU_TYPE_ARM, res)
+			|| getByArchFamily(CPU_TYPE_POWERPC, res))
+	{
+		return true;
+	}
+
+	// If none of above, just pick first.
+	return true;
+}
+
+/**
+ * Get archive with selected index
+ * @param index index of archive
+ * @param res reference for storing result
+ * @return @c true if archive was found, @c false otherwise
+ */
+bool BreakMachOUniversal::getArchiveWithIndex(
+		unsigned index,
+		llvm::object::MachOUniversalBinary::object_iterator &res)
+{
+	if(!file || index >= file->getNumberOfObjects())
+	{
+		return false;
+	}
+
+	unsigned idx = 0;
+	for(auto i = file->begin_objects(), e = file->end_objects(); i != e; ++i)
+	{
+		if(index == idx++)
+		{
+			res = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Get archive by architecture family
+ * @param familyName family name
+ * @param res reference for storing result
+ * @return @c true if archive was found, @c false otherwise
+ */
+bool BreakMachOUniversal::getArchiveForFamily(
+		const std::string &familyName,
+		llvm::object::MachOUniversalBinary::object_iterator &res)
+{
+	if(!file)
+	{
+		return false;
+	}
+
+	if(familyName == "x86")
+	{
+		return getByArchFamily(CPU_TYPE_X86, res);
+	}
+	else if(familyName == "arm" || familyName == "thumb")
+	{
+		// Same family
+		return getByArchFamily(CPU_TYPE_ARM, res);
+	}
+	else if(familyName == "powerpc")
+	{
+		return getByArchFamily(CPU_TYPE_POWERPC, res);
+	}
+	else if(familyName == "x86-64")
+	{
+		return getByArchFamily(CPU_TYPE_X86_64, res);
+	}
+	else if(familyName == "arm64")
+	{
+		return getByArchFamily(CPU_TYPE_ARM64, res);
+	}
+	else if(familyName == "powerpc64")
+	{
+		return getByArchFamily(CPU_TYPE_POWERPC64, res);
+	}
+	else if(familyName == "sparc")
+	{
+		return getByArchFamily(CPU_TYPE_SPARC, res);
+	}
+	else if(familyName == "mc98000")
+	{
+		return getByArchFamily(CPU_TYPE_MC98000, res);
+	}
+
+	return false;
+}
+
+/**
+ * Get archive by architecture
+ * @param machoArchName Mach-O specific architecture string
+ * @param res reference for storing result
+ * @return @c true if archive was found, @c false otherwise
+ */
+bool BreakMachOUniversal::getArchiveForArchitecture(
+		const std::string &machoArchName,
+		llvm::object::MachOUniversalBinary::object_iterator &res)
+{
+	if(!file)
+	{
+		return false;
+	}
+
+	for(auto i = file->begin_objects(), e = file->end_objects(); i != e; ++i)
+	{
+		if(machoArchName == getArchName(i))
+		{
+			res = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /**
  * Get file names of objects stored in archive
  * @param archOffset start of archive in Mach-O Universal Binary
@@ -468,15 +643,7 @@ bool BreakMachOUniversal::extractBestArchive(
 	}
 
 	auto obj = file->begin_objects();
-	if(getByArchFamily(CPU_TYPE_X86, obj)
-			|| getByArchFamily(CPU_TYPE_ARM, obj)
-			|| getByArchFamily(CPU_TYPE_POWERPC, obj))
-	{
-		return extract(obj, outPath);
-	}
-
-	// If none of above, just pick first.
-	return extract(obj, outPath);
+	return getBestArchive(obj) && extract(obj, outPath);
 }
 
 /**
@@ -489,21 +656,13 @@ bool BreakMachOUniversal::extractArchiveWithIndex(
 		unsigned index,
 		const std::string &outPath)
 {
-	if(!file || index >= file->getNumberOfObjects())
+	if(!file)
 	{
 		return false;
 	}
 
-	unsigned idx = 0;
-	for(auto i = file->begin_objects(), e = file->end_objects(); i != e; ++i)
-	{
-		if(index == idx++)
-		{
-			return extract(i, outPath);
-		}
-	}
-
-	return false;
+	auto obj = file->begin_objects();
+	return getArchiveWithIndex(index, obj) && extract(obj, outPath);
 }
 
 /**
@@ -522,91 +681,102 @@ bool BreakMachOUniversal::extractArchiveForFamily(
 	}
 
 	auto obj = file->begin_objects();
-	if(familyName == "x86")
-	{
-		if(getByArchFamily(CPU_TYPE_X86, obj))
-		{
-			return extract(obj, outPath);
-		}
-	}
-	else if(familyName == "arm" || familyName == "thumb")
-	{
-		// Same family
-		if(getByArchFamily(CPU_TYPE_ARM, obj))
-		{
-			return extract(obj, outPath);
-		}
-	}
-	else if(familyName == "powerpc")
-	{
-		if(getByArchFamily(CPU_TYPE_POWERPC, obj))
-		{
-			return extract(obj, outPath);
-		}
-	}
-	else if(familyName == "x86-64")
-	{
-		if(getByArchFamily(CPU_TYPE_X86_64, obj))
-		{
-			return extract(obj, outPath);
-		}
-	}
-	else if(familyName == "arm64")
+	return getArchiveForFamily(familyName, obj) && extract(obj, outPath);
+}
+
+/**
+ * Extract archive by architecture
+ * @param machoArchName Mach-O specific architecture string
+ * @param outPath path to output file
+ * @return @c true if extraction was successful, @c false otherwise
+ */
+bool BreakMachOUniversal::extractArchiveForArchitecture(
+		const std::string &machoArchName,
+		const std::string &outPath)
+{
+	if(!file)
 	{
-		if(getByArchFamily(CPU_TYPE_ARM64, obj))
-		{
-			return extract(obj, outPath);
-		}
+		return false;
 	}
-	else if(familyName == "powerpc64")
+
+	auto obj = file->begin_objects();
+	return getArchiveForArchitecture(machoArchName, obj)
+			&& extract(obj, outPath);
+}
+
+/**
+ * Extract archive with best architecture for decompilation into memory
+ * @param result extracted archive content
+ * @return @c true if extraction was successful, @c false otherwise
+ */
+bool BreakMachOUniversal::extractBestArchive(
+		std::vector<std::uint8_t> &result)
+{
+	if(!file)
 	{
-		if(getByArchFamily(CPU_TYPE_POWERPC64, obj))
-		{
-			return extract(obj, outPath);
-		}
+		return false;
 	}
-	else if(familyName == "sparc")
+
+	auto obj = file->begin_objects();
+	return getBestArchive(obj) && extract(obj, result);
+}
+
+/**
+ * Extract archive with selected index into memory
+ * @param index index of archive to extract
+ * @param result extracted archive content
+ * @return @c true if extraction was successful, @c false otherwise
+ */
+bool BreakMachOUniversal::extractArchiveWithIndex(
+		unsigned index,
+		std::vector<std::uint8_t> &result)
+{
+	if(!file)
 	{
-		if(getByArchFamily(CPU_TYPE_SPARC, obj))
-		{
-			return extract(obj, outPath);
-		}
+		return false;
 	}
-	else if(familyName == "mc98000")
+
+	auto obj = file->begin_objects();
+	return getArchiveWithIndex(index, obj) && extract(obj, result);
+}
+
+/**
+ * Extract archive by architecture family into memory
+ * @param familyName family name
+ * @param result extracted archive content
+ * @return @c true if extraction was successful, @c false otherwise
+ */
+bool BreakMachOUniversal::extractArchiveForFamily(
+		const std::string &familyName,
+		std::vector<std::uint8_t> &result)
+{
+	if(!file)
 	{
-		if(getByArchFamily(CPU_TYPE_MC98000, obj))
-		{
-			return extract(obj, outPath);
-		}
+		return false;
 	}
 
-	return false;
+	auto obj = file->begin_objects();
+	return getArchiveForFamily(familyName, obj) && extract(obj, result);
 }
 
 /**
- * Extract archive by architecture
+ * Extract archive by architecture into memory
  * @param machoArchName Mach-O specific architecture string
- * @param outPath path to output file
+ * @param result extracted archive content
  * @return @c true if extraction was successful, @c false otherwise
  */
 bool BreakMachOUniversal::extractArchiveForArchitecture(
 		const std::string &machoArchName,
-		const std::string &outPath)
+		std::vector<std::uint8_t> &result)
 {
 	if(!file)
 	{
 		return false;
 	}
 
-	for(auto i = file->begin_objects(), e = file->end_objects(); i != e; ++i)
-	{
-		if(machoArchName == getArchName(i))
-		{
-			return extract(i, outPath);
-		}
-	}
-
-	return false;
+	auto obj = file->begin_objects();
+	return getArchiveForArchitecture(machoArchName, obj)
+			&& extract(obj, result);
 }
 
 } // namespace macho_extractor
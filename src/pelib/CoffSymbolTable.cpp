@@ -71,7 +71,7 @@ namespace PeLib
 		numberOfStoredSymbols = (std::uint32_t)symbolTable.size();
 	}
 
-	int CoffSymbolTable::read(ByteBuffer & fileData, std::size_t uiOffset, std::size_t uiSize)
+	int CoffSymbolTable::read(const ByteView & fileData, std::size_t uiOffset, std::size_t uiSize)
 	{
 		// Check for overflow
 		if ((uiOffset + uiSize) < uiOffset)
@@ -227,17 +227,28 @@ uint32_t PeLib::ImageLoader::stringLength(
 					const PELIB_FILE_PAGE & page = pages[pageIndex];
 					const uint8_t * dataBegin;
 					const uint8_t * dataPtr;
+					uint32_t offsetInPage = rva & (PELIB_PAGE_SIZE - 1);
 					uint32_t rvaEndPage = (pageIndex + 1) * PELIB_PAGE_SIZE;
 
 					// If zero page, means this is a zeroed page. This is the end of the string.
-					if(page.buffer.empty())
+					// The same applies to the zero-padded part of a page after its valid data.
+					if(page.getData() == nullptr || offsetInPage >= page.getDataLength())
 						break;
-					dataBegin = dataPtr = page.buffer.data() + (rva & (PELIB_PAGE_SIZE - 1));
+					dataBegin = dataPtr = page.getData() + offsetInPage;
 
 					// Perhaps the last page loaded?
 					if(rvaEndPage > rvaEnd)
 						rvaEndPage = rvaEnd;
 
+					// If the page data end before, there is a zero right after them
+					if(rvaEndPage - rva > page.getDataLength() - offsetInPage)
+					{
+						dataPtr = (const uint8_t *)memchr(dataPtr, 0, page.getDataLength() - offsetInPage);
+						if(dataPtr == nullptr)
+							dataPtr = page.getData() + page.getDataLength();
+						return rva + (dataPtr - dataBegin) - rvaBegin;
+					}
+
 					// Try to find the zero byte on the page
 					dataPtr = (const uint8_t *)memchr(dataPtr, 0, (rvaEndPage - rva));
 					if(dataPtr != nullptr)
@@ -353,7 +364,7 @@ uint32_t PeLib::ImageLoader::readStringRc(
 }
 
 uint32_t PeLib::ImageLoader::readStringRaw(
-	ByteBuffer & fileData,
+	const ByteView & fileData,
 	std::string & str,
 	size_t offset,
 	size_t maxLength,
@@ -364,8 +375,8 @@ uint32_t PeLib::ImageLoader::readStringRaw(
 
 	if(offset < fileData.size())
 	{
-		uint8_t * stringBegin = fileData.data() + offset;
-		uint8_t * stringEnd;
+		const uint8_t * stringBegin = fileData.data() + offset;
+		const uint8_t * stringEnd;
 
 		// Make sure we won't read past the end of the buffer
 		if((offset + maxLength) > fileData.size())
@@ -413,15 +424,14 @@ uint32_t PeLib::ImageLoader::dumpImage(const char * fileName)
 
 	if(fs.is_open())
 	{
-		// Allocate one page filled with zeros
-		uint8_t zeroPage[PELIB_PAGE_SIZE] = {0};
-		char * dataToWrite;
+		// Allocate one page for the page content
+		uint8_t pageData[PELIB_PAGE_SIZE];
 
 		// Write each page to the file
 		for(auto & page : pages)
 		{
-			dataToWrite = (char *)(page.buffer.size() ? page.buffer.data() : zeroPage);
-			fs.write(dataToWrite, PELIB_PAGE_SIZE);
+			page.readFromPage(pageData, 0, PELIB_PAGE_SIZE);
+			fs.write((char *)pageData, PELIB_PAGE_SIZE);
 			bytesWritten += PELIB_PAGE_SIZE;
 		}
 	}
@@ -866,7 +876,7 @@ PeLib::LoaderError PeLib::ImageLoader::loaderError() const
 // Interface for loading files
 
 int PeLib::ImageLoader::Load(
-	ByteBuffer & fileData,
+	const ByteView & fileData,
 	bool loadHeadersOnly)
 {
 	int fileError;
@@ -984,8 +994,13 @@ int PeLib::ImageLoader::Load(
 		return ERROR_NOT_ENOUGH_SPACE;
 	}
 
+	// The mapped pages refer to the file data, so we need to keep them
+	if(loadHeadersOnly)
+		return Load(fileData, loadHeadersOnly);
+	streamFileData = std::make_shared<ByteBuffer>(std::move(fileData));
+
 	// Call the Load interface on char buffer
-	return Load(fileData, loadHeadersOnly);
+	return Load(*streamFileData, loadHeadersOnly);
 }
 
 int PeLib::ImageLoader::Load(
@@ -1076,15 +1091,8 @@ void PeLib::ImageLoader::readFromPage(
 	size_t offsetInPage,
 	size_t bytesInPage)
 {
-	// Is it a page with actual data?
-	if(page.buffer.size())
-	{
-		memcpy(buffer, page.buffer.data() + offsetInPage, bytesInPage);
-	}
-	else
-	{
-		memset(buffer, 0, bytesInPage);
-	}
+	// Read the data from the page. Pages without actual data read as zeros
+	page.readFromPage(buffer, offsetInPage, bytesInPage);
 }
 
 void PeLib::ImageLoader::writeToPage(
@@ -1549,10 +1557,10 @@ void PeLib::ImageLoader::writeNewImageBase(uint64_t newImageBase)
 	}
 }
 
-int PeLib::ImageLoader::captureDosHeader(ByteBuffer & fileData)
+int PeLib::ImageLoader::captureDosHeader(const ByteView & fileData)
 {
-	uint8_t * fileBegin = fileData.data();
-	uint8_t * fileEnd = fileBegin + fileData.size();
+	const uint8_t * fileBegin = fileData.data();
+	const uint8_t * fileEnd = fileBegin + fileData.size();
 
 	// Capture the DOS header
 	if((fileBegin + sizeof(PELIB_IMAGE_DOS_HEADER)) >= fileEnd)
@@ -1575,11 +1583,11 @@ int PeLib::ImageLoader::saveDosHeader(
 	return ERROR_NONE;
 }
 
-int PeLib::ImageLoader::captureNtHeaders(ByteBuffer & fileData)
+int PeLib::ImageLoader::captureNtHeaders(const ByteView & fileData)
 {
-	uint8_t * fileBegin = fileData.data();
-	uint8_t * filePtr = fileBegin + dosHeader.e_lfanew;
-	uint8_t * fileEnd = fileBegin + fileData.size();
+	const uint8_t * fileBegin = fileData.data();
+	const uint8_t * filePtr = fileBegin + dosHeader.e_lfanew;
+	const uint8_t * fileEnd = fileBegin + fileData.size();
 	size_t ntHeaderSize;
 	uint16_t optionalHeaderMagic = PELIB_IMAGE_NT_OPTIONAL_HDR32_MAGIC;
 
@@ -1819,7 +1827,7 @@ int PeLib::ImageLoader::saveNtHeaders(
 }
 
 int PeLib::ImageLoader::captureSectionName(
-	ByteBuffer & fileData,
+	const ByteView & fileData,
 	std::string & sectionName,
 	const uint8_t * Name)
 {
@@ -1855,11 +1863,11 @@ int PeLib::ImageLoader::captureSectionName(
 	return ERROR_NONE;
 }
 
-int PeLib::ImageLoader::captureSectionHeaders(ByteBuffer & fileData)
+int PeLib::ImageLoader::captureSectionHeaders(const ByteView & fileData)
 {
-	uint8_t * fileBegin = fileData.data();
-	uint8_t * filePtr;
-	uint8_t * fileEnd = fileBegin + fileData.size();
+	const uint8_t * fileBegin = fileData.data();
+	const uint8_t * filePtr;
+	const uint8_t * fileEnd = fileBegin + fileData.size();
 	bool bRawDataBeyondEOF = false;
 
 	// If there are no sections, then we're done
@@ -2055,7 +2063,7 @@ int PeLib::ImageLoader::saveSectionHeaders(
 	return ERROR_NONE;
 }
 
-int PeLib::ImageLoader::captureImageSections(ByteBuffer & fileData)
+int PeLib::ImageLoader::captureImageSections(const ByteView & fileData)
 {
 	uint32_t virtualAddress = 0;
 	uint32_t sizeOfHeaders = optionalHeader.SizeOfHeaders;
@@ -2172,19 +2180,19 @@ int PeLib::ImageLoader::verifyDosHeader(
 	return (ldrError == LDR_ERROR_E_LFANEW_OUT_OF_FILE) ? ERROR_INVALID_FILE : ERROR_NONE;
 }
 
-int PeLib::ImageLoader::loadImageAsIs(ByteBuffer & fileData)
+int PeLib::ImageLoader::loadImageAsIs(const ByteView & fileData)
 {
-	rawFileData = fileData;
+	rawFileData.assign(fileData.begin(), fileData.end());
 	return ERROR_NONE;
 }
 
 int PeLib::ImageLoader::captureOptionalHeader64(
-	uint8_t * fileBegin,
-	uint8_t * filePtr,
-	uint8_t * fileEnd)
+	const uint8_t * fileBegin,
+	const uint8_t * filePtr,
+	const uint8_t * fileEnd)
 {
 	PELIB_IMAGE_OPTIONAL_HEADER64 optionalHeader64{};
-	uint8_t * dataDirectoryPtr;
+	const uint8_t * dataDirectoryPtr;
 	uint32_t sizeOfOptionalHeader = sizeof(PELIB_IMAGE_OPTIONAL_HEADER64);
 	uint32_t numberOfRvaAndSizes;
 
@@ -2250,12 +2258,12 @@ int PeLib::ImageLoader::captureOptionalHeader64(
 }
 
 int PeLib::ImageLoader::captureOptionalHeader32(
-	uint8_t * fileBegin,
-	uint8_t * filePtr,
-	uint8_t * fileEnd)
+	const uint8_t * fileBegin,
+	const uint8_t * filePtr,
+	const uint8_t * fileEnd)
 {
 	PELIB_IMAGE_OPTIONAL_HEADER32 optionalHeader32{};
-	uint8_t * dataDirectoryPtr;
+	const uint8_t * dataDirectoryPtr;
 	uint32_t sizeOfOptionalHeader = sizeof(PELIB_IMAGE_OPTIONAL_HEADER32);
 	uint32_t numberOfRvaAndSizes;
 
@@ -2322,7 +2330,7 @@ int PeLib::ImageLoader::captureOptionalHeader32(
 }
 
 uint32_t PeLib::ImageLoader::captureImageSection(
-	ByteBuffer & fileData,
+	const ByteView & fileData,
 	uint32_t virtualAddress,
 	uint32_t virtualSize,
 	uint32_t pointerToRawData,
@@ -2330,10 +2338,10 @@ uint32_t PeLib::ImageLoader::captureImageSection(
 	uint32_t characteristics,
 	bool isImageHeader)
 {
-	uint8_t * fileBegin = fileData.data();
-	uint8_t * rawDataPtr;
-	uint8_t * rawDataEnd;
-	uint8_t * fileEnd = fileBegin + fileData.size();
+	const uint8_t * fileBegin = fileData.data();
+	const uint8_t * rawDataPtr;
+	const uint8_t * rawDataEnd;
+	const uint8_t * fileEnd = fileBegin + fileData.size();
 	uint32_t sizeOfInitializedPages;            // The part of section with initialized pages
 	uint32_t sizeOfValidPages;                  // The part of section with valid pages
 	uint32_t sizeOfSection;                     // Total virtual size of the section
@@ -2555,7 +2563,7 @@ bool PeLib::ImageLoader::isValidMachineForCodeIntegrifyCheck(uint32_t Bits)
 // there are some more checks implemented by CI!HashpParsePEHeader
 // (nt!SeValidateImageHeader -> CI!CiValidateImageHeader -> ... -> CI!HashpParsePEHeader in Win7)
 // This function does the same checks like CI!HashpParsePEHeader
-bool PeLib::ImageLoader::checkForBadCodeIntegrityImages(ByteBuffer & fileData)
+bool PeLib::ImageLoader::checkForBadCodeIntegrityImages(const ByteView & fileData)
 {
 	if(optionalHeader.DllCharacteristics & PELIB_IMAGE_DLLCHARACTERISTICS_FORCE_INTEGRITY)
 	{
@@ -2655,7 +2663,7 @@ bool PeLib::ImageLoader::checkForBadCodeIntegrityImages(ByteBuffer & fileData)
 		// just check for the most blatantly corrupt certificates
 		if(forceIntegrityCheckCertificate)
 		{
-			uint8_t * certPtr = fileData.data() + SecurityDir.VirtualAddress;
+			const uint8_t * certPtr = fileData.data() + SecurityDir.VirtualAddress;
 			if(SecurityDir.Size > 2 && certPtr[0] == 0 && certPtr[1] == 0)
 				return true;
 		}
@@ -6,8 +6,10 @@
 
 #include <fstream>
 #include <future>
+#include <memory>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 #include <llvm/ADT/Triple.h>
 #include <llvm/Analysis/LoopInfo.h>
@@ -48,6 +50,7 @@
 #include "retdec/utils/memory.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/version.h"
+#include "retdec/yaracpp/yara_rules_cache.h"
 
 using namespace retdec::utils::io;
 
@@ -75,6 +78,9 @@ class ProgramOptions
 		std::optional<uint64_t> arIdx;
 
 		bool cleanup = false;
+		bool profile = false;
+		std::string cacheDir;
+		std::string yaraCacheDir;
 		std::set<std::string> toClean;
 
 	public:
@@ -265,7 +271,8 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	else if (isParam(i, "-f", "--output-format"))
 	{
 		auto of = getParamOrDie(i);
-		if (!(of == "plain" || of == "json" || of == "json-human"))
+		if (!(of == "plain" || of == "json" || of == "json-human"
+				|| of == "json-compact"))
 		{
 			throw std::runtime_error(
 				"[-f|--output-format] unknown output format: " + of
@@ -442,6 +449,20 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	{
 		params.setIsBackendAggressiveOpts(true);
 	}
+	else if (isParam(i, "", "--backend-threads"))
+	{
+		auto t = getParamOrDie(i);
+		try
+		{
+			params.setBackendThreads(std::stoull(t));
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--backend-threads] invalid number of threads: " + t
+			);
+		}
+	}
 	else if (isParam(i, "", "--backend-keep-all-brackets"))
 	{
 		params.setIsBackendKeepAllBrackets(true);
@@ -505,6 +526,18 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 		auto file = checkFile(getParamOrDie(i), "[--static-code-sigfile]");
 		params.userStaticSignaturePaths.insert(file);
 	}
+	else if (isParam(i, "", "--profile"))
+	{
+		profile = true;
+	}
+	else if (isParam(i, "", "--cache-dir"))
+	{
+		cacheDir = getParamOrDie(i);
+	}
+	else if (isParam(i, "", "--yara-cache-dir"))
+	{
+		yaraCacheDir = getParamOrDie(i);
+	}
 	else if (isParam(i, "", "--timeout"))
 	{
 		auto t = getParamOrDie(i);
@@ -519,6 +552,39 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 			);
 		}
 	}
+	else if (isParam(i, "", "--fixed-point-pipeline"))
+	{
+		params.setIsFixedPointPipeline(true);
+	}
+	else if (isParam(i, "", "--pipeline-budget"))
+	{
+		auto b = getParamOrDie(i);
+		try
+		{
+			params.setPipelineBudget(std::stoull(b));
+			params.setIsFixedPointPipeline(true);
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--pipeline-budget] invalid budget value: " + b
+			);
+		}
+	}
+	else if (isParam(i, "", "--decoder-threads"))
+	{
+		auto t = getParamOrDie(i);
+		try
+		{
+			params.setDecoderThreads(std::stoull(t));
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--decoder-threads] invalid number of threads: " + t
+			);
+		}
+	}
 	else if (isParam(i, "-s", "--silent"))
 	{
 		params.setIsVerboseOutput(false);
@@ -558,6 +624,16 @@ void ProgramOptions::afterLoad()
 	}
 	if (params.getOutputUnpackedFile().empty())
 		params.setOutputUnpackedFile(in + "-unpacked");
+	if (profile && params.getOutputProfileFile().empty())
+	{
+		// Put the profile next to the output config.
+		std::string out = params.getOutputConfigFile();
+		if (retdec::utils::endsWith(out, ".config.json"))
+		{
+			out.erase(out.size() - std::string(".config.json").size());
+		}
+		params.setOutputProfileFile(out + ".profile.json");
+	}
 	if (arExtractPath.empty())
 		arExtractPath = in + "-extracted";
 
@@ -620,9 +696,9 @@ void ProgramOptions::printHelpAndDie()
 Mandatory arguments:
 	INPUT_FILE File to decompile.
 General arguments:
-	[-o|--output FILE] Output file (default: INPUT_FILE.c if OUTPUT_FORMAT is plain, INPUT_FILE.c.json if OUTPUT_FORMAT is json|json-human).
+	[-o|--output FILE] Output file (default: INPUT_FILE.c if OUTPUT_FORMAT is plain, INPUT_FILE.c.json if OUTPUT_FORMAT is json|json-human|json-compact).
 	[-s|--silent] Turns off informative output of the decompilation.
-	[-f|--output-format OUTPUT_FORMAT] Output format [plain|json|json-human] (default: plain).
+	[-f|--output-format OUTPUT_FORMAT] Output format [plain|json|json-human|json-compact] (default: plain).
 	[-m|--mode MODE] Force the type of decompilation mode [bin|raw] (default: bin).
 	[-p|--pdb FILE] File with PDB debug information.
 	[-k|--keep-unreachable-funcs] Keep functions that are unreachable from the main function.
@@ -655,6 +731,7 @@ Backend arguments:
 	[--backend-emit-cfg] Emits a CFG for each function in the backend IR (in the .dot format).
 	[--backend-emit-cg] Emits a CG for the decompiled module in the backend IR (in the .dot format).
 	[--backend-aggressive-opts] Enables aggressive optimizations.
+	[--backend-threads N] Runs optimizations which optimize each function separately in N threads (Default: 1).
 	[--backend-keep-all-brackets] Keeps all brackets in the generated code.
 	[--backend-keep-library-funcs] Keep functions from standard libraries.
 	[--backend-no-time-varying-info] Do not emit time-varying information, like dates.
@@ -665,6 +742,12 @@ Decompilation process arguments:
 	[--timeout SECONDS]
 	[--max-memory MAX_MEMORY] Limits the maximal memory used by the given number of bytes.
 	[--no-memory-limit] Disables the default memory limit (half of system RAM).
+	[--fixed-point-pipeline] Skips repetitions of LLVM pass sequences once they stop changing the module.
+	[--pipeline-budget SECONDS] Skips repetitions of LLVM pass sequences after the given time, even if they would improve the output. Implies --fixed-point-pipeline.
+	[--decoder-threads N] Decodes in N threads, N-1 of them disassemble jump targets ahead of decoding (Default: 0 = number of hardware threads).
+	[--cache-dir DIR] Reuses the output of an earlier decompilation of the same input with the same arguments stored in DIR, stores the output there otherwise. Other outputs are not produced when the stored output is reused. Not used for objects extracted from archives and fat Mach-O binaries.
+	[--yara-cache-dir DIR] Stores compiled YARA rules (signatures of compilers, crypto patterns and static code) in DIR and reuses them in later runs. DIR is created if it does not exist, it must be accessible only by the current user.
+	[--profile] Writes time, memory and LLVM IR size of each pass into JSON file next to the output config (INPUT_FILE.profile.json by default).
 LLVM IR debug arguments:
 	[--print-after-all] Dump LLVM IR to stderr after every LLVM pass.
 	[--print-before-all] Dump LLVM IR to stderr before every LLVM pass.
@@ -795,10 +878,34 @@ void setLogsFrom(const retdec::config::Parameters& params)
 	}
 }
 
+/**
+ * Write extracted input \p data into \p path so that tools that work only
+ * with files (i.e. unpacker plugins) can process it.
+ */
+void materializeInput(
+		const std::vector<std::uint8_t>& data,
+		const std::string& path,
+		ProgramOptions& po)
+{
+	std::ofstream out(path, std::ios::binary);
+	if (!out.write(reinterpret_cast<const char*>(data.data()), data.size()))
+	{
+		throw std::runtime_error("failed to write extracted input: " + path);
+	}
+	po.toClean.insert(path);
+}
+
 int decompile(retdec::config::Config& config, ProgramOptions& po)
 {
 	setLogsFrom(config.parameters);
 
+	// Objects extracted from fat Mach-O binaries and archives are kept in
+	// memory and passed to the decompiler directly. They are written to disk
+	// only if they need to be unpacked.
+	//
+	std::vector<std::uint8_t> inputData;
+	bool inputInMemory = false;
+
 	// Macho-O extraction.
 	//
 	retdec::macho_extractor::BreakMachOUniversal fat(
@@ -808,13 +915,11 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 	{
 		Log::phase("Mach-O extraction");
 
-		auto extractedFile = po.arExtractPath + "_m";
-
 		if (config.architecture.isKnown())
 		{
 			if (!fat.extractArchiveForFamily(
 					config.architecture.getName(),
-					extractedFile))
+					inputData))
 			{
 				std::stringstream ss;
 				ss << "Invalid --arch option '"
@@ -827,7 +932,7 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 		}
 		else
 		{
-			if (!fat.extractBestArchive(extractedFile))
+			if (!fat.extractBestArchive(inputData))
 			{
 				throw std::runtime_error(
 						"Mach-O extraction: extractBestArchive() failed."
@@ -836,24 +941,28 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 			}
 		}
 
-		config.parameters.setInputFile(extractedFile);
-		po.toClean.insert(extractedFile);
+		inputInMemory = true;
 	}
 
 	// Archive extraction.
 	//
+	bool ok = true;
+	std::string errMsg;
+	auto arw = inputInMemory
+			? std::make_unique<retdec::ar_extractor::ArchiveWrapper>(
+					inputData.data(),
+					inputData.size(),
+					ok,
+					errMsg)
+			: std::make_unique<retdec::ar_extractor::ArchiveWrapper>(
+					config.parameters.getInputFile(),
+					ok,
+					errMsg);
+
 	if (po.arIdx || !po.arName.empty())
 	{
 		Log::phase("Archive extraction");
 
-		bool ok = true;
-		std::string errMsg;
-		retdec::ar_extractor::ArchiveWrapper arw(
-				config.parameters.getInputFile(),
-				ok,
-				errMsg
-		);
-
 		if (!ok)
 		{
 			throw std::runtime_error(
@@ -861,9 +970,10 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 			);
 		}
 
+		std::vector<std::uint8_t> object;
 		if (po.arIdx)
 		{
-			if (!arw.extractByIndex(po.arIdx.value(), errMsg, po.arExtractPath))
+			if (!arw->extractByIndex(po.arIdx.value(), object, errMsg))
 			{
 				throw std::runtime_error(
 						"failed to extract archive: " + errMsg + "\n"
@@ -871,14 +981,14 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 						+ std::to_string(po.arIdx.value())
 						+ "' was not found in the input archive."
 						  " Valid indexes are 0-"
-						+ std::to_string(arw.getNumberOfObjects()-1)
+						+ std::to_string(arw->getNumberOfObjects()-1)
 						+ ".\n"
 				);
 			}
 		}
 		else if (!po.arName.empty())
 		{
-			if (!arw.extractByName(po.arName, errMsg, po.arExtractPath))
+			if (!arw->extractByName(po.arName, object, errMsg))
 			{
 				throw std::runtime_error(
 						"failed to extract archive: " + errMsg + "\n"
@@ -888,25 +998,20 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 			}
 		}
 
-		config.parameters.setInputFile(po.arExtractPath);
-		po.toClean.insert(po.arExtractPath);
+		// The wrapper may reference the replaced data.
+		arw.reset();
+		inputData = std::move(object);
+		inputInMemory = true;
 	}
 	else
 	{
-		bool ok = true;
-		std::string errMsg;
-		retdec::ar_extractor::ArchiveWrapper arw(
-				config.parameters.getInputFile(),
-				ok,
-				errMsg
-		);
-		if (ok && arw.isThinArchive())
+		if (ok && arw->isThinArchive())
 		{
 			Log::error() << "This file is an archive!" << std::endl;
 			Log::error() << "Error: File is a thin archive and cannot be decompiled." << std::endl;
 			return EXIT_FAILURE;
 		}
-		else if (ok && arw.isEmptyArchive())
+		else if (ok && arw->isEmptyArchive())
 		{
 			Log::error() << "This file is an archive!" << std::endl;
 			Log::error() << "Error: The input archive is empty." << std::endl;
@@ -917,48 +1022,61 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 			Log::error() << "This file is an archive!" << std::endl;
 
 			std::string result;
-			if (arw.getPlainTextList(result, errMsg, false, true))
+			if (arw->getPlainTextList(result, errMsg, false, true))
 			{
 				Log::error() << result << std::endl;
 			}
 			return EXIT_FAILURE;
 		}
 
-		if (!ok && retdec::ar_extractor::isArchive(config.parameters.getInputFile()))
+		if (!ok && !inputInMemory
+				&& retdec::ar_extractor::isArchive(config.parameters.getInputFile()))
 		{
 			Log::error() << "This file is an archive!" << std::endl;
 			Log::error() << "Error: The input archive has invalid format." << std::endl;
 			return EXIT_FAILURE;
 		}
 	}
+	arw.reset();
 
 	// Unpacking
 	//
 
 	Log::phase("Unpacking");
-	std::vector<std::string> unpackArgs;
-	unpackArgs.push_back("whatever_program_name");
-	unpackArgs.push_back(config.parameters.getInputFile());
-	unpackArgs.push_back("--output");
-	unpackArgs.push_back(config.parameters.getOutputUnpackedFile());
-	char* uargv[4] = {
-			unpackArgs[0].data(),
-			unpackArgs[1].data(),
-			unpackArgs[2].data(),
-			unpackArgs[3].data()
-	};
-	auto unpackCode = retdec::unpackertool::_main(4, uargv);
-	if (unpackCode == 0) // EXIT_CODE_OK
-	{
-		config.parameters.setInputFile(
+	if (inputInMemory
+			&& retdec::unpackertool::isUnpackable(
+					inputData.data(),
+					inputData.size()))
+	{
+		// Unpacker plugins work only with files.
+		materializeInput(inputData, po.arExtractPath, po);
+		config.parameters.setInputFile(po.arExtractPath);
+		inputInMemory = false;
+	}
+	if (!inputInMemory)
+	{
+		auto unpackCode = retdec::unpackertool::unpack(
+				config.parameters.getInputFile(),
 				config.parameters.getOutputUnpackedFile()
 		);
-		po.toClean.insert(config.parameters.getOutputUnpackedFile());
+		if (unpackCode == 0) // EXIT_CODE_OK
+		{
+			config.parameters.setInputFile(
+					config.parameters.getOutputUnpackedFile()
+			);
+			po.toClean.insert(config.parameters.getOutputUnpackedFile());
+		}
 	}
 
 	// Decompilation.
 	//
-	return retdec::decompile(config);
+	if (inputInMemory)
+	{
+		return retdec::decompile(config, inputData);
+	}
+	return po.cacheDir.empty()
+			? retdec::decompile(config)
+			: retdec::decompileCached(config, po.cacheDir);
 }
 
 //
@@ -1026,6 +1144,13 @@ int main(int argc, char **argv)
 	//
 	limitMaximalMemoryIfRequested(config.parameters);
 
+	// Store compiled YARA rules for later runs.
+	//
+	if (!po.yaraCacheDir.empty())
+	{
+		retdec::yaracpp::YaraRulesCache::get().setDirectory(po.yaraCacheDir);
+	}
+
 
 	// Decompile.
 	//
@@ -0,0 +1,232 @@
+/**
+ * @file src/retdec/decompilation_cache.cpp
+ * @brief On-disk cache of decompilation results.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "retdec/retdec/decompilation_cache.h"
+#include "retdec/utils/filesystem.h"
+
+namespace retdec {
+
+namespace {
+
+const std::string JSON_configHash = "configHash";
+const std::string JSON_output     = "output";
+
+/**
+ * Hash of data given in one or more parts.
+ *
+ * Two 64-bit FNV-1a hashes with different bases are combined so that
+ * collisions are not a practical concern. Unlike @c std::hash, the result is
+ * the same in all builds, so it can be stored on disk.
+ */
+class Hasher
+{
+	public:
+		void update(const char* data, std::size_t size)
+		{
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				auto c = static_cast<unsigned char>(data[i]);
+				_hash1 = (_hash1 ^ c) * 0x100000001b3ULL;
+				_hash2 = (_hash2 ^ c) * 0x100000001b3ULL;
+			}
+		}
+
+		/// Hash of all the data as a hexadecimal string.
+		std::string str() const
+		{
+			std::ostringstream ret;
+			ret << std::hex << std::setfill('0')
+					<< std::setw(16) << _hash1
+					<< std::setw(16) << _hash2;
+			return ret.str();
+		}
+
+	private:
+		std::uint64_t _hash1 = 0xcbf29ce484222325ULL;
+		std::uint64_t _hash2 = 0x84222325cbf29ce4ULL;
+};
+
+/**
+ * Hash of @a data as a hexadecimal string.
+ */
+std::string hash(const std::string& data)
+{
+	Hasher hasher;
+	hasher.update(data.data(), data.size());
+	return hasher.str();
+}
+
+} // anonymous namespace
+
+/**
+ * @param directory Directory where entries are stored. If empty, nothing is
+ *        cached.
+ */
+DecompilationCache::DecompilationCache(const std::string& directory) :
+		_directory(directory)
+{
+
+}
+
+/**
+ * Load the entry with the given key.
+ * @return @c True if the entry was loaded, @c false if there is no such
+ *         entry or it could not be read.
+ */
+bool DecompilationCache::load(const std::string& key, Entry& entry) const
+{
+	auto path = getCachePath(key);
+	if (path.empty())
+	{
+		return false;
+	}
+
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+	{
+		return false;
+	}
+	std::string json(
+			(std::istreambuf_iterator<char>(in)),
+			std::istreambuf_iterator<char>()
+	);
+
+	rapidjson::Document root;
+	root.Parse(json.c_str(), json.size());
+	if (root.HasParseError()
+			|| !root.IsObject()
+			|| !root.HasMember(JSON_configHash)
+			|| !root[JSON_configHash].IsString()
+			|| !root.HasMember(JSON_output)
+			|| !root[JSON_output].IsString())
+	{
+		return false;
+	}
+
+	entry = Entry();
+	entry.configHash = root[JSON_configHash].GetString();
+	entry.output = std::string(
+			root[JSON_output].GetString(),
+			root[JSON_output].GetStringLength()
+	);
+
+	return true;
+}
+
+/**
+ * Save the entry under the given key.
+ *
+ * The entry is written into a temporary file which is then renamed.
+ * Therefore, other processes never load partially written entries. Errors
+ * are ignored, the entry just is not cached.
+ */
+void DecompilationCache::save(const std::string& key, const Entry& entry) const
+{
+	auto path = getCachePath(key);
+	if (path.empty())
+	{
+		return;
+	}
+
+	std::error_code ec;
+	fs::create_directories(fs::path(path).parent_path(), ec);
+	if (ec)
+	{
+		return;
+	}
+
+	rapidjson::StringBuffer sb;
+	rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+	writer.StartObject();
+	writer.String(JSON_configHash);
+	writer.String(entry.configHash);
+	writer.String(JSON_output);
+	writer.String(entry.output);
+	writer.EndObject();
+
+	std::ostringstream tmpPath;
+	tmpPath << path << ".tmp"
+			<< std::hash<std::thread::id>()(std::this_thread::get_id())
+			<< "." << std::random_device()();
+	{
+		std::ofstream out(tmpPath.str(), std::ios::binary);
+		if (!out.write(sb.GetString(), sb.GetSize()))
+		{
+			out.close();
+			fs::remove(tmpPath.str(), ec);
+			return;
+		}
+	}
+
+	fs::rename(tmpPath.str(), path, ec);
+	if (ec)
+	{
+		fs::remove(tmpPath.str(), ec);
+	}
+}
+
+/**
+ * Compute the cache key of the given input file from its content.
+ * @return Key or empty string if the file could not be read.
+ */
+std::string DecompilationCache::computeKey(const std::string& inputFile)
+{
+	std::ifstream in(inputFile, std::ios::binary);
+	if (!in)
+	{
+		return std::string();
+	}
+
+	// Inputs may be big, so they are hashed by chunks.
+	Hasher hasher;
+	std::vector<char> buffer(64 * 1024);
+	while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0)
+	{
+		hasher.update(buffer.data(), in.gcount());
+	}
+	return in.bad() ? std::string() : hasher.str();
+}
+
+/**
+ * Compute hash of the whole @a config. It has to be the config given to the
+ * decompilation, not the one the decompilation produced.
+ */
+std::string DecompilationCache::computeConfigHash(const config::Config& config)
+{
+	return hash(config.generateJsonString());
+}
+
+/**
+ * Get path to the cache file with the given key.
+ * @return Path or empty string if the cache is disabled or the key is empty.
+ */
+std::string DecompilationCache::getCachePath(const std::string& key) const
+{
+	if (_directory.empty() || key.empty())
+	{
+		return std::string();
+	}
+
+	return (fs::path(_directory) / (key + ".json")).string();
+}
+
+} // namespace retdec
@@ -0,0 +1,97 @@
+/**
+ * @file src/retdec/pass_groups.cpp
+ * @brief Groups of repeated passes of the decompilation pipeline.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+
+#include "retdec/retdec/pass_groups.h"
+
+namespace retdec {
+
+std::vector<PassGroup> splitPasses(
+		const std::vector<std::string>& passes,
+		bool fixedPoint)
+{
+	if (!fixedPoint)
+	{
+		return {PassGroup{0, passes.size(), 1}};
+	}
+
+	std::vector<PassGroup> groups;
+	std::size_t onceBegin = 0;
+	std::size_t i = 0;
+	while (i < passes.size())
+	{
+		auto seqBegin = passes.begin() + i;
+		std::size_t len = (passes.size() - i) / 2;
+		for (; len > 0; --len)
+		{
+			if (std::equal(seqBegin, seqBegin + len, seqBegin + len))
+			{
+				break;
+			}
+		}
+		if (len == 0)
+		{
+			++i;
+			continue;
+		}
+
+		std::size_t repeats = 2;
+		while (i + (repeats + 1) * len <= passes.size()
+				&& std::equal(seqBegin, seqBegin + len, seqBegin + repeats * len))
+		{
+			++repeats;
+		}
+
+		if (onceBegin < i)
+		{
+			groups.push_back(PassGroup{onceBegin, i, 1});
+		}
+		groups.push_back(PassGroup{i, i + len, repeats});
+		i += repeats * len;
+		onceBegin = i;
+	}
+	if (onceBegin < passes.size())
+	{
+		groups.push_back(PassGroup{onceBegin, passes.size(), 1});
+	}
+
+	return groups;
+}
+
+bool runPassGroups(
+		const std::vector<PassGroup>& groups,
+		const std::function<bool(const PassGroup&, bool)>& run,
+		const std::function<bool()>& isOverBudget)
+{
+	bool budgetExhausted = false;
+
+	for (auto& g : groups)
+	{
+		for (std::size_t r = 0; r < g.repeats; ++r)
+		{
+			// The first run of each group is needed, the rest only improves
+			// the output.
+			if (r > 0 && isOverBudget())
+			{
+				budgetExhausted = true;
+				break;
+			}
+
+			// If the group did not change the module, its next run would
+			// not change it either.
+			bool last = r + 1 == g.repeats;
+			if (!run(g, last) && !last)
+			{
+				break;
+			}
+		}
+	}
+
+	return budgetExhausted;
+}
+
+} // namespace retdec
@@ -6,6 +6,7 @@ if(NOT TARGET retdec::retdec)
             bin2llvmir
             llvmir2hll
             config
+            utils
             common
             capstone
             llvm
@@ -4,6 +4,16 @@
  * @copyright (c) 2019 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <thread>
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
 #include <llvm/ADT/Triple.h>
 #include <llvm/Analysis/CallGraph.h>
 #include <llvm/Analysis/CallGraphSCCPass.h>
@@ -44,12 +54,17 @@
 #include "retdec/bin2llvmir/optimizations/provider_init/provider_init.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/providers/config.h"
+#include "retdec/bin2llvmir/providers/provider_context.h"
 
 #include "retdec/llvmir2hll/llvmir2hll.h"
 
 #include "retdec/config/config.h"
+#include "retdec/retdec/decompilation_cache.h"
+#include "retdec/retdec/pass_groups.h"
 #include "retdec/retdec/retdec.h"
 #include "retdec/utils/memory.h"
+#include "retdec/utils/scope_exit.h"
+#include "retdec/utils/time.h"
 #include "retdec/utils/io/log.h"
 
 using namespace retdec::utils::io;
@@ -92,6 +107,17 @@ std::unique_ptr<llvm::Module> createLlvmModule(llvm::LLVMContext& Context)
 
 namespace retdec {
 
+LlvmModuleContextPair::~LlvmModuleContextPair()
+{
+	// Order matters: providers use module, module destructor uses context.
+	if (module)
+	{
+		bin2llvmir::ProviderContext::release(module.get());
+	}
+	module.reset();
+	context.reset();
+}
+
 common::BasicBlock fillBasicBlock(
 		bin2llvmir::Config* config,
 		llvm::BasicBlock& bb,
@@ -357,7 +383,7 @@ class ModulePassPrinter : public ModulePass
 		std::string PhaseArg;
 		std::string PassName;
 
-		static std::string LastPhase;
+		static thread_local std::string LastPhase;
 		inline static const std::string LlvmAggregatePhaseName = "LLVM";
 
 	public:
@@ -406,21 +432,238 @@ class ModulePassPrinter : public ModulePass
 		}
 };
 char ModulePassPrinter::ID = 0;
-std::string ModulePassPrinter::LastPhase;
+thread_local std::string ModulePassPrinter::LastPhase;
+
+/**
+ * Profile of passes run on one module: time, memory and IR size of each pass.
+ *
+ * CPU time is the time of the thread running the passes. Peak memory is the
+ * peak resident set size of the whole process, which is shared by all
+ * modules decompiled at once.
+ */
+class PassProfiler
+{
+	public:
+		/**
+		 * State of the module and the process at one point.
+		 */
+		struct Snapshot
+		{
+			std::chrono::steady_clock::time_point wallTime;
+			double cpuTime = 0.0;
+			std::size_t peakMemory = 0;
+			std::size_t functions = 0;
+			std::size_t basicBlocks = 0;
+			std::size_t instructions = 0;
+		};
+		/**
+		 * Snapshots taken right before and after one pass.
+		 */
+		struct Record
+		{
+			std::string name;
+			std::string argument;
+			Snapshot before;
+			Snapshot after;
+		};
+
+	public:
+		void start(
+				const std::string& name,
+				const std::string& argument,
+				llvm::Module& m)
+		{
+			Record r;
+			r.name = name;
+			r.argument = argument;
+			r.before = snapshot(m);
+			_records.push_back(std::move(r));
+		}
+
+		void stop(llvm::Module& m)
+		{
+			if (!_records.empty())
+			{
+				_records.back().after = snapshot(m);
+			}
+		}
+
+		void write(const std::string& path) const
+		{
+			rapidjson::StringBuffer sb;
+			rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(sb);
+
+			writer.StartObject();
+			writer.String("passes");
+			writer.StartArray();
+			for (auto& r : _records)
+			{
+				writer.StartObject();
+				writer.String("name");
+				writer.String(r.name.c_str());
+				writer.String("argument");
+				writer.String(r.argument.c_str());
+				writer.String("wallTime");
+				writer.Double(std::chrono::duration<double>(
+						r.after.wallTime - r.before.wallTime).count());
+				writer.String("cpuTime");
+				writer.Double(r.after.cpuTime - r.before.cpuTime);
+				writer.String("peakMemoryDelta");
+				writer.Uint64(r.after.peakMemory > r.before.peakMemory
+						? r.after.peakMemory - r.before.peakMemory
+						: 0);
+				writer.String("before");
+				writeIrSize(writer, r.before);
+				writer.String("after");
+				writeIrSize(writer, r.after);
+				writer.EndObject();
+			}
+			writer.EndArray();
+			if (!_records.empty())
+			{
+				auto& first = _records.front().before;
+				auto& last = _records.back().after;
+				writer.String("wallTime");
+				writer.Double(std::chrono::duration<double>(
+						last.wallTime - first.wallTime).count());
+				writer.String("cpuTime");
+				writer.Double(last.cpuTime - first.cpuTime);
+				writer.String("peakMemory");
+				writer.Uint64(last.peakMemory);
+			}
+			writer.EndObject();
+
+			std::ofstream out(path);
+			if (!(out << sb.GetString() << std::endl))
+			{
+				throw std::runtime_error("failed to write profile: " + path);
+			}
+		}
+
+	private:
+		static Snapshot snapshot(llvm::Module& m)
+		{
+			Snapshot s;
+			for (auto& f : m)
+			{
+				if (f.isDeclaration())
+				{
+					continue;
+				}
+				++s.functions;
+				for (auto& bb : f)
+				{
+					++s.basicBlocks;
+					s.instructions += bb.size();
+				}
+			}
+			// Take the time last, counting is not part of the pass.
+			s.peakMemory = utils::getPeakMemoryUsage();
+			s.cpuTime = utils::getThreadCpuTime();
+			s.wallTime = std::chrono::steady_clock::now();
+			return s;
+		}
+
+		template <typename Writer>
+		static void writeIrSize(Writer& writer, const Snapshot& s)
+		{
+			writer.StartObject();
+			writer.String("functions");
+			writer.Uint64(s.functions);
+			writer.String("basicBlocks");
+			writer.Uint64(s.basicBlocks);
+			writer.String("instructions");
+			writer.Uint64(s.instructions);
+			writer.EndObject();
+		}
+
+	private:
+		std::vector<Record> _records;
+};
+
+/**
+ * This pass marks the start or the end of another pass in the profile.
+ * It should be placed right before (start) or right after (end) the pass.
+ */
+class ModulePassProfiler : public ModulePass
+{
+	public:
+		static char ID;
+		PassProfiler& Profiler;
+		bool Start;
+		std::string PhaseName;
+		std::string PhaseArg;
+		std::string PassName;
+
+	public:
+		ModulePassProfiler(
+				PassProfiler& profiler,
+				bool start,
+				const std::string& phaseName = std::string(),
+				const std::string& phaseArg = std::string())
+				: ModulePass(ID)
+				, Profiler(profiler)
+				, Start(start)
+				, PhaseName(phaseName)
+				, PhaseArg(phaseArg)
+				, PassName("ModulePass Profiler: " + PhaseName)
+		{
+
+		}
+
+		bool runOnModule(Module &M) override
+		{
+			if (Start)
+			{
+				Profiler.start(PhaseName, PhaseArg, M);
+			}
+			else
+			{
+				Profiler.stop(M);
+			}
+			return false;
+		}
+
+		llvm::StringRef getPassName() const override
+		{
+			return PassName.c_str();
+		}
+
+		void getAnalysisUsage(AnalysisUsage &AU) const override
+		{
+			AU.setPreservesAll();
+		}
+};
+char ModulePassProfiler::ID = 0;
 
 /**
  * Add the pass to the pass manager - no verification.
+ * If @a profiler is set, the pass is profiled.
  */
 static inline void addPass(
 		legacy::PassManagerBase& PM,
 		Pass* P,
-		const PassInfo* PI)
+		const PassInfo* PI,
+		PassProfiler* profiler = nullptr)
 {
 	PM.add(new ModulePassPrinter(
 			PI->getPassName().str(),
 			PI->getPassArgument().str()
 	));
+	if (profiler)
+	{
+		PM.add(new ModulePassProfiler(
+				*profiler,
+				true,
+				PI->getPassName().str(),
+				PI->getPassArgument().str()
+		));
+	}
 	PM.add(P);
+	if (profiler)
+	{
+		PM.add(new ModulePassProfiler(*profiler, false));
+	}
 
 // if (!PI->isAnalysis())
 // PM.add(P->createPrinterPass(
@@ -431,6 +674,17 @@ static inline void addPass(
 }
 
 
+/**
+ * Hash of the textual form of the module.
+ */
+std::size_t hashModule(const llvm::Module& module)
+{
+	std::string str;
+	llvm::raw_string_ostream os(str);
+	module.print(os, nullptr);
+	return std::hash<std::string>()(os.str());
+}
+
 /**
  * TODO: this function has exact copy located in retdec-decompiler.cpp.
  * The reason for this is that right now creation of correct interface that
@@ -460,22 +714,24 @@ void setLogsFrom(const retdec::config::Parameters& params)
 	}
 }
 
-bool decompile(retdec::config::Config& config, std::string* outString)
+/**
+ * Decompile according to \p config. Logs and LLVM passes must already be
+ * initialized.
+ */
+bool decompileModule(
+		llvm::PassRegistry& passRegistry,
+		retdec::config::Config& config,
+		std::string* outString,
+		const std::vector<std::uint8_t>* inputData = nullptr)
 {
-	setLogsFrom(config.parameters);
-
-	Log::phase("Initialization");
-	auto& passRegistry = initializeLlvmPasses();
-
-	// limitMaximalMemoryIfRequested(params);
-	// PrintAfterAll = true;
-
 	auto context = std::make_unique<llvm::LLVMContext>();
 	auto module = createLlvmModule(*context);
 
-	// Create a PassManager to hold and optimize the collection of passes we
-	// are about to build.
-	llvm::legacy::PassManager pm;
+	// Providers' data are bound to the module, they must be released before
+	// the module is destroyed.
+	SCOPE_EXIT {
+		bin2llvmir::ProviderContext::release(module.get());
+	};
 
 	// Without this LLVM does more opts than we would like it to.
 	// e.g. printf() call -> puts() call
@@ -485,19 +741,61 @@ bool decompile(retdec::config::Config& config, std::string* outString)
 	TargetLibraryInfoImpl TLII(ModuleTriple);
 	// The -disable-simplify-libcalls flag actually disables all builtin optzns.
 	TLII.disableAllFunctions();
-	pm.add(new TargetLibraryInfoWrapperPass(TLII));
 
-	for (auto& p : config.parameters.llvmPasses)
+	std::unique_ptr<PassProfiler> profiler;
+	if (!config.parameters.getOutputProfileFile().empty())
+	{
+		profiler = std::make_unique<PassProfiler>();
+	}
+
+	auto& passes = config.parameters.llvmPasses;
+	for (auto& p : passes)
+	{
+		if (passRegistry.getPassInfo(p) == nullptr)
+		{
+			throw std::runtime_error("cannot create pass: " + p);
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	auto budget = std::chrono::seconds(config.parameters.getPipelineBudget());
+	bool budgetExhausted = false;
+
+	auto isOverBudget = [&]()
 	{
-		if (auto* info = passRegistry.getPassInfo(p))
+		if (!budgetExhausted
+				&& config.parameters.isPipelineBudget()
+				&& std::chrono::steady_clock::now() - start > budget)
 		{
+			Log::error() << Log::Warning << "pipeline budget of "
+					<< config.parameters.getPipelineBudget()
+					<< " seconds exhausted, repeated passes are skipped"
+					<< std::endl;
+			budgetExhausted = true;
+		}
+		return budgetExhausted;
+	};
+
+	auto runGroup = [&](const PassGroup& g, bool last)
+	{
+		// Create a PassManager to hold and optimize the collection of
+		// passes we are about to build.
+		llvm::legacy::PassManager pm;
+		pm.add(new TargetLibraryInfoWrapperPass(TLII));
+		for (auto i = g.begin; i < g.end; ++i)
+		{
+			auto* info = passRegistry.getPassInfo(passes[i]);
 			auto* pass = info->createPass();
-			addPass(pm, pass, info);
+			addPass(pm, pass, info, profiler.get());
 
 			if (info->getTypeInfo() == &bin2llvmir::ProviderInitialization::ID)
 			{
 				auto* p = static_cast<bin2llvmir::ProviderInitialization*>(pass);
 				p->setConfig(&config);
+				if (inputData)
+				{
+					p->setInputData(inputData->data(), inputData->size());
+				}
 			}
 			if (info->getTypeInfo() == &llvmir2hll::LlvmIr2Hll::ID)
 			{
@@ -506,16 +804,192 @@ bool decompile(retdec::config::Config& config, std::string* outString)
 				p->setOutputString(outString);
 			}
 		}
-		else
+
+		// Now that we have all of the passes ready, run them.
+		// Passes may report changes they did not make, so the module is
+		// also compared. It is not needed after the last repetition.
+		auto hash = last ? 0 : hashModule(*module);
+		bool changed = pm.run(*module);
+		return !last && changed && hashModule(*module) != hash;
+	};
+
+	runPassGroups(
+			splitPasses(passes, config.parameters.isFixedPointPipeline()),
+			runGroup,
+			isOverBudget
+	);
+
+	if (profiler)
+	{
+		profiler->write(config.parameters.getOutputProfileFile());
+	}
+
+	return EXIT_SUCCESS;
+}
+
+bool decompile(retdec::config::Config& config, std::string* outString)
+{
+	setLogsFrom(config.parameters);
+
+	Log::phase("Initialization");
+	auto& passRegistry = initializeLlvmPasses();
+
+	// limitMaximalMemoryIfRequested(params);
+	// PrintAfterAll = true;
+
+	return decompileModule(passRegistry, config, outString);
+}
+
+bool decompile(
+		retdec::config::Config& config,
+		const std::vector<std::uint8_t>& inputData,
+		std::string* outString)
+{
+	setLogsFrom(config.parameters);
+
+	Log::phase("Initialization");
+	auto& passRegistry = initializeLlvmPasses();
+
+	return decompileModule(passRegistry, config, outString, &inputData);
+}
+
+bool decompileCached(
+		retdec::config::Config& config,
+		const std::string& cacheDir,
+		std::string* outString)
+{
+	setLogsFrom(config.parameters);
+
+	Log::phase("Initialization");
+	auto& passRegistry = initializeLlvmPasses();
+
+	// The decompilation changes the config, so the hash of the config given
+	// by the user has to be computed first.
+	DecompilationCache cache(cacheDir);
+	auto key = DecompilationCache::computeKey(
+			config.parameters.getInputFile()
+	);
+	auto configHash = DecompilationCache::computeConfigHash(config);
+
+	DecompilationCache::Entry entry;
+	std::string output;
+	int ret = EXIT_SUCCESS;
+	if (cache.load(key, entry) && entry.configHash == configHash)
+	{
+		Log::phase("Using cached decompilation");
+		output = std::move(entry.output);
+	}
+	else
+	{
+		ret = decompileModule(passRegistry, config, &output);
+		if (ret == EXIT_SUCCESS)
 		{
-			throw std::runtime_error("cannot create pass: " + p);
+			entry.configHash = configHash;
+			entry.output = output;
+			cache.save(key, entry);
 		}
 	}
 
-	// Now that we have all of the passes ready, run them.
-	pm.run(*module);
+	if (outString)
+	{
+		*outString = std::move(output);
+	}
+	else
+	{
+		std::ofstream out(config.parameters.getOutputFile());
+		if (!(out << output))
+		{
+			throw std::runtime_error("failed to write output: "
+					+ config.parameters.getOutputFile());
+		}
+	}
 
-	return EXIT_SUCCESS;
+	return ret;
+}
+
+std::vector<int> decompile(
+		std::vector<retdec::config::Config>& configs,
+		std::size_t threads,
+		std::vector<std::string>* outStrings)
+{
+	std::vector<int> ret(configs.size(), EXIT_FAILURE);
+	if (configs.empty())
+	{
+		return ret;
+	}
+	if (outStrings)
+	{
+		outStrings->assign(configs.size(), std::string());
+	}
+
+	setLogsFrom(configs.front().parameters);
+
+	Log::phase("Initialization");
+	auto& passRegistry = initializeLlvmPasses();
+
+	const std::size_t hwThreads = std::max(1u, std::thread::hardware_concurrency());
+	if (threads == 0)
+	{
+		threads = hwThreads;
+	}
+	threads = std::min(threads, configs.size());
+
+	// Decoders of concurrent decompilations share the hardware threads
+	// instead of each of them starting workers for all of them.
+	if (threads > 1)
+	{
+		for (auto& c : configs)
+		{
+			if (c.parameters.getDecoderThreads() == 0)
+			{
+				c.parameters.setDecoderThreads(
+						std::max<std::size_t>(1, hwThreads / threads));
+			}
+		}
+	}
+
+	// Workers take jobs one by one, results are stored by job index.
+	// Therefore, they do not depend on the scheduling.
+	std::atomic<std::size_t> nextJob = 0;
+	auto worker = [&]()
+	{
+		for (auto i = nextJob++; i < configs.size(); i = nextJob++)
+		{
+			try
+			{
+				ret[i] = decompileModule(
+						passRegistry,
+						configs[i],
+						outStrings ? &(*outStrings)[i] : nullptr
+				) == EXIT_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+			}
+			catch (const std::exception& e)
+			{
+				Log::error() << Log::Error << configs[i].parameters.getInputFile()
+						<< ": " << e.what() << std::endl;
+				ret[i] = EXIT_FAILURE;
+			}
+			catch (...)
+			{
+				Log::error() << Log::Error << configs[i].parameters.getInputFile()
+						<< ": unknown exception" << std::endl;
+				ret[i] = EXIT_FAILURE;
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (std::size_t t = 1; t < threads; ++t)
+	{
+		pool.emplace_back(worker);
+	}
+	worker();
+	for (auto& t : pool)
+	{
+		t.join();
+	}
+
+	return ret;
 }
 
 } // namespace retdec
@@ -20,6 +20,34 @@ using namespace retdec::common;
 using namespace retdec::utils;
 using namespace retdec::rtti_finder;
 
+namespace {
+
+/**
+ * Read word on the given address directly from the image data.
+ */
+bool readWord(const retdec::loader::Image* img, Address addr, std::uint64_t& val)
+{
+	switch (img->getBytesPerWord())
+	{
+		case 4:
+		{
+			std::uint32_t word = 0;
+			if (!img->read(addr, word))
+			{
+				return false;
+			}
+			val = word;
+			return true;
+		}
+		case 8:
+			return img->read(addr, val);
+		default:
+			return img->getWord(addr, val);
+	}
+}
+
+} // anonymous namespace
+
 void findPossibleVtables(
 		const retdec::loader::Image* img,
 		std::set<retdec::common::Address>& possibleVtables,
@@ -39,7 +67,7 @@ void findPossibleVtables(
 		while (addr + wordSz < end)
 		{
 			std::uint64_t val = 0;
-			if (!img->getWord(addr, val))
+			if (!readWord(img, addr, val))
 			{
 				addr += wordSz;
 				continue;
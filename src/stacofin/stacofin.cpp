@@ -12,7 +12,7 @@
 #include "retdec/stacofin/stacofin.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/filesystem.h"
-#include "retdec/yaracpp/yara_detector.h"
+#include "retdec/yaracpp/yara_scan_coordinator.h"
 
 /**
  * Set \c debug_enabled to \c true to enable this LOG macro.
@@ -695,6 +695,22 @@ const DetectedFunctionsPtrMap& Finder::getConfirmedDetections() const
 void Finder::search(
 	const Image& image,
 	const std::string& yaraFile)
+{
+	search(image, std::set<std::string>{yaraFile});
+}
+
+/**
+ * Search for static code in input file.
+ *
+ * All signature files are scanned at once, matches are then processed
+ * for each file separately.
+ *
+ * @param image input file image
+ * @param yaraFiles static code signature files
+ */
+void Finder::search(
+	const retdec::loader::Image& image,
+	const std::set<std::string>& yaraFiles)
 {
 	// Get FileFormat instance.
 	const auto* fileFormat = image.getFileFormat();
@@ -703,38 +719,63 @@ void Finder::search(
 		return;
 	}
 
-	// Start Yara detector.
-	YaraDetector detector;
-	detector.addRuleFile(yaraFile);
-	auto inputBytes = fileFormat->getLoadedBytes();
-	detector.analyze(inputBytes);
-	if (!detector.isInValidState())
+	// Each file is a separate consumer of the scan -- detections must know
+	// their signature file. Text files are scanned together by one rule set,
+	// precompiled files in parallel. Loaded bytes are scanned in place.
+	// A broken file has no detections, but the other files are used.
+	YaraScanCoordinator scan;
+	scan.setScanThreads(0);
+	for (const auto& f : yaraFiles)
 	{
-		return;
+		scan.addRuleFile(f, f);
 	}
+	scan.scan(
+			fileFormat->getLoadedBytesData(),
+			fileFormat->getLoadedBytes().size());
+
+	for (const auto& f : yaraFiles)
+	{
+		addDetections(image, f, scan.getDetectedRules(f));
+	}
+}
+
+/**
+ * Add detections of static code based on matched signatures.
+ *
+ * @param image input file image
+ * @param yaraFile static code signature file
+ * @param detectedRules rules from @a yaraFile detected in input file
+ */
+void Finder::addDetections(
+	const retdec::loader::Image& image,
+	const std::string& yaraFile,
+	const std::vector<yaracpp::YaraRule>& detectedRules)
+{
+	const auto* fileFormat = image.getFileFormat();
 
 	// Iterate over detected rules.
-	for (const YaraRule &detectedRule : detector.getDetectedRules())
+	for (const YaraRule &detectedRule : detectedRules)
 	{
 		DetectedFunction detectedFunction;
 		detectedFunction.signaturePath = yaraFile;
 
 		for (const YaraMeta &ruleMeta : detectedRule.getMetas())
 		{
-			if (ruleMeta.getId() == "name")
+			const auto &id = ruleMeta.getId();
+			if (id == "name")
 			{
 				detectedFunction.names.push_back(ruleMeta.getStringValue());
 			}
-			if (ruleMeta.getId() == "size")
+			else if (id == "size")
 			{
 				detectedFunction.size = ruleMeta.getIntValue();
 			}
-			if (ruleMeta.getId() == "refs")
+			else if (id == "refs")
 			{
 				const auto &refs = ruleMeta.getStringValue();
 				detectedFunction.setReferences(refs);
 			}
-			if (ruleMeta.getId() == "altNames")
+			else if (id == "altNames")
 			{
 				std::string name;
 				const auto &altNames = ruleMeta.getStringValue();
@@ -770,22 +811,6 @@ void Finder::search(
 	}
 }
 
-/**
- * Search for static code in input file.
- *
- * @param image input file image
- * @param yaraFiles static code signature files
- */
-void Finder::search(
-	const retdec::loader::Image& image,
-	const std::set<std::string>& yaraFiles)
-{
-	for (const auto& f : yaraFiles)
-	{
-		search(image, f);
-	}
-}
-
 /**
  * Search for static code in input file based on information in config file.
  *
@@ -864,6 +889,18 @@ void Finder::searchAndConfirm(
 
 	cs_free(_ceInsn, 1);
 	cs_close(&_ce);
+	_disassembly = nullptr;
+	_ownDisassembly.reset();
+}
+
+/**
+ * Share disassembled instructions with other consumers of the same image.
+ * @param store Store to use, it must outlive searches. If it is @c nullptr,
+ *              or its architecture differs, the finder uses its own store.
+ */
+void Finder::setDisassemblyStore(common::DisassemblyStore* store)
+{
+	_sharedDisassembly = store;
 }
 
 /**
@@ -907,10 +944,35 @@ bool Finder::initDisassembler()
 		return true;
 	}
 	_ceInsn = cs_malloc(_ce);
+	_ceCurrentMode = _ceMode;
+
+	_disassembly = _sharedDisassembly;
+	if (_disassembly == nullptr || _disassembly->getArchitecture() != arch)
+	{
+		_ownDisassembly = std::make_unique<common::DisassemblyStore>(
+				arch,
+				_ceMode,
+				_config->parameters.getDisassemblyCacheSize());
+		_disassembly = _ownDisassembly.get();
+	}
 
 	return false;
 }
 
+/**
+ * Disassemble one instruction into @c _ceInsn, the same way as
+ * @c cs_disasm_iter() with @c _ce.
+ */
+bool Finder::disasm(ByteData& bytes, std::uint64_t& addr)
+{
+	return _disassembly->disassemble(
+			_ceCurrentMode,
+			&bytes.first,
+			&bytes.second,
+			&addr,
+			_ceInsn);
+}
+
 void Finder::solveReferences()
 {
 	for (auto& p : _allDetections)
@@ -925,6 +987,7 @@ void Finder::solveReferences()
 				assert(false);
 				return;
 			}
+			_ceCurrentMode = CS_MODE_THUMB;
 			modeSwitch = true;
 		}
 
@@ -941,6 +1004,7 @@ void Finder::solveReferences()
 				assert(false);
 				return;
 			}
+			_ceCurrentMode = _ceMode;
 		}
 	}
 }
@@ -1089,7 +1153,7 @@ common::Address Finder::getAddressFromRef_mips(common::Address ref)
 {
 	uint64_t addr = ref;
 	ByteData data = _image->getRawSegmentData(ref);
-	if (!cs_disasm_iter(_ce, &data.first, &data.second, &addr, _ceInsn))
+	if (!disasm(data, addr))
 	{
 		return Address();
 	}
@@ -1116,7 +1180,7 @@ common::Address Finder::getAddressFromRef_mips(common::Address ref)
 		unsigned s = _config->architecture.getBitSize() / 2;
 		uint64_t upper = uint64_t(mips.operands[1].imm) << s;
 
-		if (!cs_disasm_iter(_ce, &data.first, &data.second, &addr, _ceInsn))
+		if (!disasm(data, addr))
 		{
 			return Address();
 		}
@@ -1129,7 +1193,7 @@ common::Address Finder::getAddressFromRef_mips(common::Address ref)
 		if (!isLoadStoreInsn_mips(_ce, _ceInsn)
 				&& !isAddInsn_mips(_ce, _ceInsn))
 		{
-			if (!cs_disasm_iter(_ce, &data.first, &data.second, &addr, _ceInsn))
+			if (!disasm(data, addr))
 			{
 				return Address();
 			}
@@ -1206,7 +1270,7 @@ common::Address Finder::getAddressFromRef_arm(common::Address ref)
 	//
 	uint64_t addr = ref;
 	ByteData data = _image->getRawSegmentData(ref);
-	if (cs_disasm_iter(_ce, &data.first, &data.second, &addr, _ceInsn))
+	if (disasm(data, addr))
 	{
 		auto& arm = _ceInsn->detail->arm;
 
@@ -1279,7 +1343,7 @@ common::Address Finder::getAddressFromRef_ppc(common::Address ref)
 	//
 	uint64_t addr = ref;
 	ByteData data = _image->getRawSegmentData(ref);
-	if (cs_disasm_iter(_ce, &data.first, &data.second, &addr, _ceInsn))
+	if (disasm(data, addr))
 	{
 		auto& ppc = _ceInsn->detail->ppc;
 
@@ -1437,7 +1501,7 @@ void Finder::checkRef_x86(Reference& ref)
 
 	uint64_t addr = ref.target;
 	ByteData bytes = _image->getRawSegmentData(ref.target);
-	if (cs_disasm_iter(_ce, &bytes.first, &bytes.second, &addr, _ceInsn))
+	if (disasm(bytes, addr))
 	{
 		auto& x86 = _ceInsn->detail->x86;
 
@@ -155,7 +155,7 @@ int doActions(
 	}
 
 	// Load image.
-	auto image = createImage(binaryPath);
+	auto image = createImage(binaryPath, false, retdec::fileformat::LoadFlags::LAZY_LOADING);
 	if (!image) {
 		return printError("could not load binary file");
 	}
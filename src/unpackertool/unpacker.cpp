@@ -39,14 +39,23 @@ enum ExitCode
 	EXIT_CODE_MEMORY_LIMIT_ERROR ///< There was an error when setting the memory limit.
 };
 
-bool detectPackers(const std::string& inputFile, std::vector<retdec::cpdetect::DetectResult>& detectedPackers)
+void detectPackers(retdec::fileformat::FileFormat& fileParser, std::vector<retdec::cpdetect::DetectResult>& detectedPackers)
 {
 	using namespace retdec::cpdetect;
-	using namespace retdec::fileformat;
 
 	DetectParams detectionParams(SearchType::MOST_SIMILAR, true, false);
 
 	ToolInformation toolInfo;
+	CompilerDetector compilerDetector(fileParser, detectionParams, toolInfo);
+	compilerDetector.getAllInformation();
+
+	detectedPackers = toolInfo.detectedTools;
+}
+
+bool detectPackers(const std::string& inputFile, std::vector<retdec::cpdetect::DetectResult>& detectedPackers)
+{
+	using namespace retdec::fileformat;
+
 	switch (detectFileFormat(inputFile))
 	{
 		case Format::UNDETECTABLE:
@@ -64,24 +73,10 @@ bool detectPackers(const std::string& inputFile, std::vector<retdec::cpdetect::D
 				return false;
 			}
 
-			auto compilerDetector = std::make_unique<CompilerDetector>(
-					*(fileParser.get()),
-					detectionParams,
-					toolInfo
-			);
-			if (!compilerDetector)
-			{
-				Log::error() << "No compiler detector was found! Please, report this." << std::endl;
-				return false;
-			}
-
-			compilerDetector->getAllInformation();
-			break;
+			detectPackers(*fileParser, detectedPackers);
+			return true;
 		}
 	}
-
-	detectedPackers = toolInfo.detectedTools;
-	return true;
 }
 
 ExitCode unpackFile(const std::string& inputFile, const std::string& outputFile, bool brute, const std::vector<retdec::cpdetect::DetectResult>& detectedPackers)
@@ -204,6 +199,53 @@ ExitCode processArgs(ArgHandler& handler, char argc, char** argv)
 	return EXIT_CODE_OK;
 }
 
+/**
+ * Check whether there is a plugin that may unpack the given file.
+ * The file content is inspected in memory. It is not written anywhere, so
+ * the caller may skip materializing files that do not need unpacking.
+ *
+ * @param data Input file content.
+ * @param size Size of @a data.
+ *
+ * @return @c true if some detected packer has a matching plugin.
+ */
+bool isUnpackable(const std::uint8_t* data, std::size_t size)
+{
+	using namespace retdec::fileformat;
+
+	auto fileParser = createFileFormat(data, size);
+	if (!fileParser)
+		return false;
+
+	std::vector<retdec::cpdetect::DetectResult> detectedPackers;
+	detectPackers(*fileParser, detectedPackers);
+	for (const auto& detectedPacker : detectedPackers)
+	{
+		if (!PluginMgr::matchingPlugins(detectedPacker.name, detectedPacker.versionInfo).empty())
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Unpack the given file without going through the command line interface.
+ *
+ * @param inputFile Path to packed file.
+ * @param outputFile Path to unpacked output file.
+ * @param brute Run plugins in the brute mode.
+ *
+ * @return Exit code of the unpacker, @c 0 if the file was unpacked.
+ */
+int unpack(const std::string& inputFile, const std::string& outputFile, bool brute)
+{
+	std::vector<retdec::cpdetect::DetectResult> detectedPackers;
+	if (!detectPackers(inputFile, detectedPackers))
+		return EXIT_CODE_PREPROCESSING_ERROR;
+
+	return unpackFile(inputFile, outputFile, brute, detectedPackers);
+}
+
 int _main(int argc, char** argv)
 {
 	ArgHandler handler("unpacker options [PACKED_FILE] [optional]");
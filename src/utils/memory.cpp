@@ -11,6 +11,7 @@
 
 #ifdef OS_WINDOWS
 	#include <windows.h>
+	#include <psapi.h>
 #elif defined(OS_MACOS) || defined(OS_BSD)
 	#include <sys/types.h>
 	#include <sys/sysctl.h>
@@ -222,5 +223,34 @@ bool limitSystemMemoryToHalfOfTotalSystemMemory() {
 	return limitSystemMemory(totalSize / 2);
 }
 
+/**
+* @brief Returns the peak resident set size of the process (in bytes).
+*
+* When the size cannot be obtained, it returns @c 0.
+*/
+std::size_t getPeakMemoryUsage() {
+#ifdef OS_WINDOWS
+	PROCESS_MEMORY_COUNTERS counters;
+	auto succeeded = K32GetProcessMemoryInfo(
+		GetCurrentProcess(),
+		&counters,
+		sizeof(counters)
+	);
+	return succeeded ? counters.PeakWorkingSetSize : 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+	#ifdef OS_MACOS
+		// Bytes on macOS.
+		return static_cast<std::size_t>(usage.ru_maxrss);
+	#else
+		// Kilobytes elsewhere.
+		return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+	#endif
+#endif
+}
+
 } // namespace utils
 } // namespace retdec
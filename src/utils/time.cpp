@@ -4,6 +4,7 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <cstdint>
 #include <iomanip>
 #include <limits>
 #include <sstream>
@@ -12,6 +13,10 @@
 #include "retdec/utils/os.h"
 #include "retdec/utils/time.h"
 
+#ifdef OS_WINDOWS
+	#include <windows.h>
+#endif
+
 namespace retdec {
 namespace utils {
 
@@ -118,5 +123,34 @@ double getElapsedTime() {
 	return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
 }
 
+/**
+* @brief Returns how much CPU time the calling thread has consumed so far
+*        (in seconds).
+*
+* Unlike getElapsedTime(), time consumed by other threads of the program is
+* not included. When the time cannot be obtained, it returns @c 0.
+*/
+double getThreadCpuTime() {
+#ifdef OS_WINDOWS
+	FILETIME creation, exit, kernel, user;
+	if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+		return 0.0;
+	}
+	// FILETIME is in 100-nanosecond intervals.
+	auto toTicks = [](const FILETIME& ft) {
+		return (static_cast<std::uint64_t>(ft.dwHighDateTime) << 32)
+			| ft.dwLowDateTime;
+	};
+	return static_cast<double>(toTicks(kernel) + toTicks(user)) / 1e7;
+#else
+	struct timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+		return 0.0;
+	}
+	return static_cast<double>(ts.tv_sec)
+		+ static_cast<double>(ts.tv_nsec) / 1e9;
+#endif
+}
+
 } // namespace utils
 } // namespace retdec
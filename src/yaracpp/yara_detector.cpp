@@ -4,6 +4,13 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
 #include <yara.h>
 #include <yara/compiler.h>
 #include <yara/types.h>
@@ -15,6 +22,15 @@ namespace yaracpp {
 
 namespace {
 
+/**
+ * Non-owning view of scanned memory.
+ */
+struct ByteView
+{
+	const std::uint8_t* data;
+	std::size_t size;
+};
+
 /**
  * Interface for YARA scanning interface. Uses template specialization
  * to decide whether to scan file or memory buffer.
@@ -48,18 +64,18 @@ struct Scanner<std::string>
  * Specialization for scanning memory buffers.
  */
 template <>
-struct Scanner<std::vector<std::uint8_t>>
+struct Scanner<ByteView>
 {
 	static bool scan(
 			YR_RULES* rules,
 			YR_CALLBACK_FUNC callback,
 			YaraDetector::CallbackSettings& settings,
-			const std::vector<std::uint8_t>& buffer)
+			const ByteView& buffer)
 	{
 		return yr_rules_scan_mem(
 				rules,
-				const_cast<uint8_t*>(buffer.data()),
-				buffer.size(),
+				const_cast<uint8_t*>(buffer.data),
+				buffer.size,
 				0,
 				callback,
 				&settings, 0
@@ -86,6 +102,38 @@ bool scan(
 	);
 }
 
+/**
+ * Check that the given sources can be compiled together
+ * @param sources Text sources of rules
+ * @return @c true if there are no errors in the sources
+ *
+ * Rules are only parsed, no compiled rules are created.
+ */
+bool compiles(const std::vector<const YaraRulesCache::Source*> &sources)
+{
+	YR_COMPILER *compiler = nullptr;
+	if (yr_compiler_create(&compiler) != ERROR_SUCCESS)
+	{
+		return false;
+	}
+
+	bool ok = true;
+	for (const auto *source : sources)
+	{
+		const char* ns = source->nameSpace.empty()
+				? nullptr
+				: source->nameSpace.c_str();
+		if (yr_compiler_add_string(compiler, source->content.c_str(), ns) != 0)
+		{
+			ok = false;
+			break;
+		}
+	}
+
+	yr_compiler_destroy(compiler);
+	return ok;
+}
+
 } // anonymous namespace
 
 /**
@@ -93,8 +141,7 @@ bool scan(
  */
 YaraDetector::YaraDetector()
 {
-	stateIsValid = ((yr_initialize() == ERROR_SUCCESS)
-			&& (yr_compiler_create(&compiler) == ERROR_SUCCESS));
+	stateIsValid = yr_initialize() == ERROR_SUCCESS;
 	std::uint32_t max_match_data = 65536;
 	yr_set_configuration(YR_CONFIG_MAX_MATCH_DATA, &max_match_data);
 }
@@ -104,29 +151,12 @@ YaraDetector::YaraDetector()
  */
 YaraDetector::~YaraDetector()
 {
-	for (auto* file : files)
-	{
-		if (file)
-			fclose(file);
-	}
-
-	files.clear();
 	detectedRules.clear();
 	undetectedRules.clear();
 
-	if (compiler)
-	{
-		yr_compiler_destroy(compiler);
-	}
-
-	if (textFilesRules)
-		yr_rules_destroy(textFilesRules);
-
-	for (auto* rules : precompiledRules)
-	{
-		if (rules)
-			yr_rules_destroy(rules);
-	}
+	// Rules may be shared, they are destroyed by their last user.
+	textFilesRules.reset();
+	precompiledRules.clear();
 
 	yr_finalize();
 }
@@ -176,6 +206,25 @@ bool YaraDetector::CallbackSettings::storeAllRules() const
 	return storeAll;
 }
 
+/**
+ * Get namespace which is reported for all rules instead of their own
+ * @return Forced namespace or @c nullptr if rules keep their own namespaces
+ */
+const std::string* YaraDetector::CallbackSettings::getForcedNamespace() const
+{
+	return forcedNamespace;
+}
+
+/**
+ * Set namespace which is reported for all rules instead of their own
+ * @param nameSpace Forced namespace or @c nullptr to use rules' namespaces
+ */
+void YaraDetector::CallbackSettings::setForcedNamespace(
+		const std::string *nameSpace)
+{
+	forcedNamespace = nameSpace;
+}
+
 /**
  * Callback function for scanning of input file
  * @param context YARA context
@@ -226,6 +275,14 @@ int YaraDetector::yaraCallback(
 
 	YaraRule actual;
 	actual.setName(actRule->identifier);
+	if(settings->getForcedNamespace())
+	{
+		actual.setNamespace(*settings->getForcedNamespace());
+	}
+	else if(actRule->ns && actRule->ns->name)
+	{
+		actual.setNamespace(actRule->ns->name);
+	}
 	YR_META *meta;
 	yr_rule_metas_foreach(actRule, meta)
 	{
@@ -278,56 +335,97 @@ int YaraDetector::yaraCallback(
 }
 
 /**
- * Add text rules to compiler
+ * Add text rules
  * @param string YARA rules to add
+ * @return @c true if the rules were added, @c false if they could not be
+ *    compiled (the detector keeps its previous rules)
+ *
+ * Rules are compiled together with all other text rules before the first
+ * analysis (or taken from cache) -- see @c YaraRulesCache.
  */
 bool YaraDetector::addRules(const char *string)
 {
-	const auto result = yr_compiler_add_string(compiler, string, nullptr);
+	if (!string)
+		return false;
 
-	needsRecompilation = (result == 0);
-	return needsRecompilation;
+	return addTextSource({std::string(), string});
 }
 
 /**
  * Add external file with text rules
  * @param pathToFile Path to rule file
- * @param nameSpace Namespace to use for the given rule file. If the file is
- *                  already compiled, this has no effect. If it is a text file,
- *                  this allows to have multiple rules with the same ID across
- *                  multiple rule files.
+ * @param nameSpace Namespace to use for the given rule file. If it is a text
+ *                  file, this allows to have multiple rules with the same ID
+ *                  across multiple rule files. If the file is already
+ *                  compiled, its rules keep their namespaces, but they are
+ *                  reported with this one (if not empty).
+ *
+ * @return @c true if the file was added, @c false if it could not be read or
+ *    compiled (the detector keeps its previous rules)
+ *
+ * All text files of this detector are compiled together before the first
+ * analysis and the result is cached -- see @c YaraRulesCache.
  */
 bool YaraDetector::addRuleFile(
 		const std::string &pathToFile,
 		const std::string &nameSpace)
 {
 	// AT first, try to load the files as precompiled file
-	YR_RULES* rules = nullptr;
-	if (yr_rules_load(pathToFile.c_str(), &rules) == ERROR_SUCCESS)
+	if (auto rules = YaraRulesCache::get().getPrecompiledRules(pathToFile))
 	{
 		precompiledRules.push_back(rules);
+		precompiledNamespaces.push_back(nameSpace);
 	}
 	// If we didn't succeeded consider it as text file
 	else
 	{
-		auto file = fopen(pathToFile.c_str(), "r");
+		std::ifstream file(pathToFile, std::ios::binary);
 		if (!file)
 			return false;
 
-		const char* ns = nameSpace.empty() ? nullptr : nameSpace.c_str();
-		if (yr_compiler_add_file(compiler, file, ns, nullptr) != 0)
-		{
-			fclose(file);
+		std::ostringstream content;
+		content << file.rdbuf();
+		if (!file)
 			return false;
-		}
 
-		files.push_back(file);
-		needsRecompilation = true;
+		return addTextSource({nameSpace, content.str()});
 	}
 
 	return true;
 }
 
+/**
+ * Add already compiled rules
+ * @param rules Compiled rules, e.g. rules of another detector obtained by
+ *              @c shareCompiledRules()
+ * @param nameSpace Namespace to report for the rules (if not empty)
+ *
+ * The rules are not copied, they are shared by all their users. It is safe
+ * to scan with the same rules from several threads at once.
+ */
+bool YaraDetector::addCompiledRules(
+		const std::shared_ptr<YR_RULES> &rules,
+		const std::string &nameSpace)
+{
+	if (!rules)
+		return false;
+
+	precompiledRules.push_back(rules);
+	precompiledNamespaces.push_back(nameSpace);
+	return true;
+}
+
+/**
+ * Get rules compiled from text rules of this detector
+ * @return Compiled rules that can be added to other detectors or @c nullptr
+ *    if there are no text rules or they could not be compiled
+ */
+std::shared_ptr<YR_RULES> YaraDetector::shareCompiledRules()
+{
+	compileTextRules();
+	return textFilesRules;
+}
+
 /**
  * Getter for state of instance
  * @return @c true if all is OK, @c false otherwise
@@ -358,9 +456,38 @@ bool YaraDetector::analyze(
  *                      store all rules (not only detected)
  * @return @c true if analysis completed without any error, otherwise @c false.
  */
-bool YaraDetector::analyze(std::vector<std::uint8_t> &bytes, bool storeAllRules)
+bool YaraDetector::analyze(const std::vector<std::uint8_t> &bytes, bool storeAllRules)
+{
+	return analyzeWithScan(ByteView{bytes.data(), bytes.size()}, storeAllRules);
+}
+
+/**
+ * Analyze input bytes without copying them
+ * @param bytes Pointer to input bytes
+ * @param size Number of input bytes
+ * @param storeAllRules If this parameter is set to @c true,
+ *                      store all rules (not only detected)
+ * @return @c true if analysis completed without any error, otherwise @c false.
+ */
+bool YaraDetector::analyze(
+		const std::uint8_t *bytes,
+		std::size_t size,
+		bool storeAllRules)
 {
-	return analyzeWithScan(bytes, storeAllRules);
+	return analyzeWithScan(ByteView{bytes, size}, storeAllRules);
+}
+
+/**
+ * Set number of threads used to scan with independent rule sets (text rules
+ * and each precompiled file) at once
+ * @param threads Number of threads, @c 0 means as many as the hardware
+ *    supports. Default is @c 1 -- rule sets are scanned one after another.
+ */
+void YaraDetector::setScanThreads(std::size_t threads)
+{
+	scanThreads = threads
+			? threads
+			: std::max(1u, std::thread::hardware_concurrency());
 }
 
 /**
@@ -391,53 +518,123 @@ const std::vector<YaraRule>& YaraDetector::getUndetectedRules() const
 template <typename T>
 bool YaraDetector::analyzeWithScan(T&& value, bool storeAllRules)
 {
-	auto settings = CallbackSettings(
-			storeAllRules,
-			detectedRules,
-			undetectedRules
-	);
-
-	auto rules = getCompiledRules();
-	if (!(rules))
+	if (!compileTextRules())
+	{
 		return false;
+	}
 
-	if (!scan(rules, yaraCallback, settings, std::forward<T>(value)))
-		return false;
+	// Rule sets to scan with and namespaces to report for them.
+	std::vector<std::pair<YR_RULES*, const std::string*>> ruleSets;
+	if (textFilesRules)
+	{
+		ruleSets.emplace_back(textFilesRules.get(), nullptr);
+	}
+	for (std::size_t i = 0; i < precompiledRules.size(); ++i)
+	{
+		const auto& ns = precompiledNamespaces[i];
+		ruleSets.emplace_back(
+				precompiledRules[i].get(),
+				ns.empty() ? nullptr : &ns
+		);
+	}
 
-	for (auto* rules : precompiledRules)
+	// Each rule set has its own results, they are merged in the order of
+	// rule sets. Therefore, results do not depend on the scheduling.
+	std::vector<std::vector<YaraRule>> detected(ruleSets.size());
+	std::vector<std::vector<YaraRule>> undetected(ruleSets.size());
+	std::vector<char> succeeded(ruleSets.size(), false);
+	std::atomic<std::size_t> next{0};
+	auto worker = [&]()
 	{
-		if (!scan(rules, yaraCallback, settings, std::forward<T>(value)))
-			return false;
+		for (auto i = next++; i < ruleSets.size(); i = next++)
+		{
+			auto settings = CallbackSettings(
+					storeAllRules,
+					detected[i],
+					undetected[i]
+			);
+			settings.setForcedNamespace(ruleSets[i].second);
+			succeeded[i] = scan(ruleSets[i].first, yaraCallback, settings, value);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (std::size_t t = 1; t < std::min(scanThreads, ruleSets.size()); ++t)
+	{
+		threads.emplace_back(worker);
+	}
+	worker();
+	for (auto& t : threads)
+	{
+		t.join();
 	}
 
-	return true;
+	for (std::size_t i = 0; i < ruleSets.size(); ++i)
+	{
+		std::move(
+				detected[i].begin(),
+				detected[i].end(),
+				std::back_inserter(detectedRules)
+		);
+		std::move(
+				undetected[i].begin(),
+				undetected[i].end(),
+				std::back_inserter(undetectedRules)
+		);
+	}
+
+	return std::all_of(succeeded.begin(), succeeded.end(), [](char s)
+	{
+		return s;
+	});
 }
 
 /**
- * Returns the compiled rules from text files.
- * @return Compiled rules.
+ * Add text source
+ * @param source Source to add
+ * @return @c true if the source was added, @c false if it could not be
+ *    compiled. In that case, the source is not added.
+ *
+ * The source is only checked here, together with the previous sources of
+ * its namespace (its rules may use their rules). All text sources are
+ * compiled into single YR_RULES structure by @c compileTextRules().
  */
-YR_RULES* YaraDetector::getCompiledRules()
+bool YaraDetector::addTextSource(YaraRulesCache::Source &&source)
 {
-	// File is text file and needs to be compiled first
-	// All text files are compiled into single YR_RULES structure and
-	// we shouldn't compile it twice if it's not needed
-	// analyze() called for the first time or the file was added since the
-	// last analyze() call
-	if (needsRecompilation)
+	std::vector<const YaraRulesCache::Source*> sameNamespace;
+	for (const auto &s : textSources)
 	{
-		YR_RULES* rules = nullptr;
-		if (yr_compiler_get_rules(compiler, &rules) != ERROR_SUCCESS)
-			return nullptr;
+		if (s.nameSpace == source.nameSpace)
+		{
+			sameNamespace.push_back(&s);
+		}
+	}
+	sameNamespace.push_back(&source);
+	if (!compiles(sameNamespace))
+		return false;
 
-		if (textFilesRules)
-			yr_rules_destroy(textFilesRules);
+	textSources.push_back(std::move(source));
+	textFilesRules.reset();
+	return true;
+}
 
-		textFilesRules = rules;
-		needsRecompilation = false;
+/**
+ * Compile all text sources unless they are already compiled
+ * @return @c true if the rules are compiled (or there are no text sources),
+ *    @c false otherwise
+ *
+ * Compiled rules are cached, so this is cheap if the same sources were
+ * compiled before.
+ */
+bool YaraDetector::compileTextRules()
+{
+	if (textFilesRules || textSources.empty())
+	{
+		return true;
 	}
 
-	return textFilesRules;
+	textFilesRules = YaraRulesCache::get().getCompiledRules(textSources);
+	return textFilesRules != nullptr;
 }
 
 } // namespace yaracpp
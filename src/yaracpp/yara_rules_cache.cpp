@@ -0,0 +1,405 @@
+/**
+ * @file src/yaracpp/yara_rules_cache.cpp
+ * @brief Cache of compiled YARA rules.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <system_error>
+#include <thread>
+
+#include <openssl/evp.h>
+#include <yara.h>
+#include <yara/compiler.h>
+#include <yara/types.h>
+
+#include "retdec/utils/filesystem.h"
+#include "retdec/utils/os.h"
+#include "retdec/yaracpp/yara_rules_cache.h"
+
+#ifdef OS_POSIX
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace retdec {
+namespace yaracpp {
+
+namespace {
+
+/**
+ * Add the given part of sources into SHA-256 digest
+ *
+ * Every part is preceded by its size, so that consecutive parts are
+ * separated, "ab" + "c" != "a" + "bc".
+ */
+bool updateDigest(EVP_MD_CTX *ctx, const std::string &data)
+{
+	const std::uint64_t size = data.size();
+	unsigned char sizeBytes[sizeof(size)];
+	for (std::size_t i = 0; i < sizeof(size); ++i)
+	{
+		sizeBytes[i] = static_cast<unsigned char>(size >> (8 * i));
+	}
+	return EVP_DigestUpdate(ctx, sizeBytes, sizeof(sizeBytes)) == 1
+			&& EVP_DigestUpdate(ctx, data.data(), data.size()) == 1;
+}
+
+/**
+ * Compute cache key of the given sources
+ * @return SHA-256 of the sources as a hexadecimal string or empty string
+ *    if it could not be computed
+ *
+ * YARA version is part of the key because the format of compiled rules
+ * depends on it.
+ */
+std::string computeKey(const std::vector<YaraRulesCache::Source> &sources)
+{
+	std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(
+			EVP_MD_CTX_new(),
+			&EVP_MD_CTX_free
+	);
+	if (!ctx || EVP_DigestInit_ex(ctx.get(), EVP_sha256(), nullptr) != 1)
+	{
+		return std::string();
+	}
+
+	bool ok = updateDigest(ctx.get(), YR_VERSION);
+	for (const auto &source : sources)
+	{
+		ok = ok
+				&& updateDigest(ctx.get(), source.nameSpace)
+				&& updateDigest(ctx.get(), source.content);
+	}
+
+	unsigned char digest[EVP_MAX_MD_SIZE];
+	unsigned int digestSize = 0;
+	if (!ok || EVP_DigestFinal_ex(ctx.get(), digest, &digestSize) != 1)
+	{
+		return std::string();
+	}
+
+	std::ostringstream key;
+	key << std::hex << std::setfill('0');
+	for (unsigned int i = 0; i < digestSize; ++i)
+	{
+		key << std::setw(2) << static_cast<unsigned>(digest[i]);
+	}
+	return key.str();
+}
+
+/**
+ * Check that only the current user can access the given directory
+ *
+ * Compiled rules are deserialized into the process, so the cache directory
+ * must not be writable by anybody else.
+ */
+bool isPrivateDirectory(const std::string &dir)
+{
+#ifdef OS_POSIX
+	struct stat st;
+	return lstat(dir.c_str(), &st) == 0
+			&& S_ISDIR(st.st_mode)
+			&& st.st_uid == geteuid()
+			&& (st.st_mode & (S_IRWXG | S_IRWXO)) == 0;
+#else
+	std::error_code ec;
+	return fs::is_directory(dir, ec);
+#endif
+}
+
+/**
+ * Wrap rules into shared pointer which destroys them
+ */
+std::shared_ptr<YR_RULES> makeShared(YR_RULES *rules)
+{
+	return std::shared_ptr<YR_RULES>(rules, [](YR_RULES *r)
+	{
+		if (r)
+			yr_rules_destroy(r);
+	});
+}
+
+} // anonymous namespace
+
+/**
+ * Constructor
+ *
+ * Compiled rules are not stored on disk by default -- see @c setDirectory().
+ */
+YaraRulesCache::YaraRulesCache()
+{
+	// Cached rules may outlive all detectors, keep the library initialized.
+	yr_initialize();
+}
+
+/**
+ * Destructor
+ */
+YaraRulesCache::~YaraRulesCache()
+{
+	rules.clear();
+	yr_finalize();
+}
+
+/**
+ * Get the process-wide cache
+ */
+YaraRulesCache& YaraRulesCache::get()
+{
+	static YaraRulesCache cache;
+	return cache;
+}
+
+/**
+ * Set directory where compiled rules are stored
+ * @param dir Path to directory. If empty, compiled rules are not stored
+ *    on disk, they are only shared inside the process.
+ *
+ * The directory is created if it does not exist. Only the current user may
+ * have access to it, otherwise it is not used (other users could plant
+ * their own compiled rules there). Therefore, do not use shared directories
+ * like the system temporary directory.
+ */
+void YaraRulesCache::setDirectory(const std::string &dir)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	directory = dir;
+}
+
+/**
+ * Get directory where compiled rules are stored
+ * @return Path to directory or empty string if disk cache is disabled
+ */
+std::string YaraRulesCache::getDirectory() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return directory;
+}
+
+/**
+ * Get rules compiled from the given text sources
+ * @param sources Text sources of rules
+ * @return Compiled rules or @c nullptr if they could not be compiled
+ *
+ * Rules are compiled only if the same sources are neither in memory nor
+ * in the cache directory.
+ */
+std::shared_ptr<YR_RULES> YaraRulesCache::getCompiledRules(
+		const std::vector<Source> &sources)
+{
+	const auto key = computeKey(sources);
+	if (key.empty())
+	{
+		return compile(sources);
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = rules.find(key);
+		if (it != rules.end())
+		{
+			return it->second;
+		}
+	}
+
+	// Load or compile without holding the lock -- other sources may be
+	// processed meanwhile. If the same sources are processed by more
+	// threads at once, the first one to finish wins.
+	const auto path = getCachePath(key);
+	auto result = path.empty() || !fs::exists(path) ? nullptr : load(path);
+	if (!result)
+	{
+		result = compile(sources);
+		if (!result)
+		{
+			return nullptr;
+		}
+		save(result.get(), key);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	return rules.emplace(key, result).first->second;
+}
+
+/**
+ * Get rules from the given precompiled file
+ * @param pathToFile Path to precompiled rules
+ * @return Loaded rules or @c nullptr if the file does not contain
+ *    precompiled rules
+ *
+ * The file is loaded again only if it was changed since the last load.
+ */
+std::shared_ptr<YR_RULES> YaraRulesCache::getPrecompiledRules(
+		const std::string &pathToFile)
+{
+	std::error_code ec;
+	auto size = fs::file_size(pathToFile, ec);
+	if (ec)
+	{
+		return nullptr;
+	}
+	auto time = fs::last_write_time(pathToFile, ec);
+	if (ec)
+	{
+		return nullptr;
+	}
+	auto canonical = fs::canonical(pathToFile, ec);
+	const auto key = "file:" + (ec ? pathToFile : canonical.string())
+			+ ":" + std::to_string(size)
+			+ ":" + std::to_string(time.time_since_epoch().count());
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = rules.find(key);
+		if (it != rules.end())
+		{
+			return it->second;
+		}
+	}
+
+	auto result = load(pathToFile);
+	if (!result)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	return rules.emplace(key, result).first->second;
+}
+
+/**
+ * Drop all rules kept in memory
+ *
+ * Rules which are still used by some detectors are destroyed when the last
+ * detector stops using them. Files in the cache directory are kept.
+ */
+void YaraRulesCache::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	rules.clear();
+}
+
+/**
+ * Compile rules from the given sources
+ * @param sources Text sources of rules
+ * @return Compiled rules or @c nullptr if there were errors
+ */
+std::shared_ptr<YR_RULES> YaraRulesCache::compile(
+		const std::vector<Source> &sources) const
+{
+	YR_COMPILER *compiler = nullptr;
+	if (yr_compiler_create(&compiler) != ERROR_SUCCESS)
+	{
+		return nullptr;
+	}
+
+	YR_RULES *result = nullptr;
+	bool ok = true;
+	for (const auto &source : sources)
+	{
+		const char* ns = source.nameSpace.empty()
+				? nullptr
+				: source.nameSpace.c_str();
+		if (yr_compiler_add_string(compiler, source.content.c_str(), ns) != 0)
+		{
+			ok = false;
+			break;
+		}
+	}
+	if (ok && yr_compiler_get_rules(compiler, &result) != ERROR_SUCCESS)
+	{
+		result = nullptr;
+	}
+
+	yr_compiler_destroy(compiler);
+	return result ? makeShared(result) : nullptr;
+}
+
+/**
+ * Load precompiled rules from the given file
+ * @param pathToFile Path to precompiled rules
+ * @return Loaded rules or @c nullptr if they could not be loaded
+ */
+std::shared_ptr<YR_RULES> YaraRulesCache::load(
+		const std::string &pathToFile) const
+{
+	YR_RULES *result = nullptr;
+	if (yr_rules_load(pathToFile.c_str(), &result) != ERROR_SUCCESS)
+	{
+		return nullptr;
+	}
+
+	return makeShared(result);
+}
+
+/**
+ * Save compiled rules into the cache directory (if enabled)
+ * @param compiled Rules to save
+ * @param key Cache key of rules
+ *
+ * Rules are written into temporary file which is then renamed. Therefore,
+ * other processes never load partially written rules. Errors are ignored,
+ * the rules just are not cached.
+ */
+void YaraRulesCache::save(YR_RULES *compiled, const std::string &key) const
+{
+	const auto path = getCachePath(key);
+	if (path.empty())
+	{
+		return;
+	}
+
+	std::error_code ec;
+	std::ostringstream tmpPath;
+	tmpPath << path << ".tmp"
+			<< std::hash<std::thread::id>()(std::this_thread::get_id())
+			<< "." << std::random_device()();
+	if (yr_rules_save(compiled, tmpPath.str().c_str()) != ERROR_SUCCESS)
+	{
+		fs::remove(tmpPath.str(), ec);
+		return;
+	}
+
+	fs::rename(tmpPath.str(), path, ec);
+	if (ec)
+	{
+		fs::remove(tmpPath.str(), ec);
+	}
+}
+
+/**
+ * Get path to the cache file with the given key
+ * @param key Cache key of rules
+ * @return Path or empty string if disk cache is disabled or its directory
+ *    cannot be used
+ *
+ * The directory is created (accessible only by the current user) if it does
+ * not exist.
+ */
+std::string YaraRulesCache::getCachePath(const std::string &key) const
+{
+	auto dir = getDirectory();
+	if (dir.empty())
+	{
+		return std::string();
+	}
+
+	std::error_code ec;
+	if (fs::create_directories(dir, ec))
+	{
+		fs::permissions(dir, fs::perms::owner_all, ec);
+	}
+	if (ec || !isPrivateDirectory(dir))
+	{
+		return std::string();
+	}
+
+	return (fs::path(dir) / (key + ".yarac")).string();
+}
+
+} // namespace yaracpp
+} // namespace retdec
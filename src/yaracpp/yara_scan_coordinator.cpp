@@ -0,0 +1,194 @@
+/**
+ * @file src/yaracpp/yara_scan_coordinator.cpp
+ * @brief Shared YARA scanning of one input for several consumers.
+ * @copyright (c) 2020 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include "retdec/yaracpp/yara_detector.h"
+#include "retdec/yaracpp/yara_scan_coordinator.h"
+
+namespace retdec {
+namespace yaracpp {
+
+namespace {
+
+const std::vector<YaraRule> emptyRules;
+
+} // anonymous namespace
+
+/**
+ * Constructor
+ */
+YaraScanCoordinator::YaraScanCoordinator()
+{
+
+}
+
+/**
+ * Destructor
+ */
+YaraScanCoordinator::~YaraScanCoordinator()
+{
+
+}
+
+/**
+ * Register rule file of the given consumer
+ * @param consumer Name of consumer which wants to get matches of the rules
+ * @param pathToFile Path to text or precompiled rule file
+ * @param storeAllRules If this parameter is set to @c true, store all
+ *    rules of the consumer (not only detected)
+ * @return @c true if the file was added, @c false otherwise (e.g. if its
+ *    rules could not be compiled -- the other registered files are kept)
+ */
+bool YaraScanCoordinator::addRuleFile(
+		const std::string &consumer,
+		const std::string &pathToFile,
+		bool storeAllRules)
+{
+	if (!pendingDetector)
+	{
+		pendingDetector = std::make_unique<YaraDetector>();
+	}
+
+	// Every file has its own namespace -- rules with the same names may be
+	// in several files. The detector checks the file on its own, so a broken
+	// file is not added at all.
+	const auto nameSpace = "ns_" + std::to_string(namespaces.size());
+	if (!pendingDetector->addRuleFile(pathToFile, nameSpace))
+	{
+		return false;
+	}
+
+	namespaces[nameSpace] = consumer;
+	auto &c = consumers[consumer];
+	c.storeAllRules |= storeAllRules;
+	c.pending = true;
+	return true;
+}
+
+/**
+ * Scan input with all the rule files registered since the last scan
+ * @param bytes Content of input file
+ * @return @c true if analysis completed without any error, otherwise @c false.
+ */
+bool YaraScanCoordinator::scan(const std::vector<std::uint8_t> &bytes)
+{
+	return scan(bytes.data(), bytes.size());
+}
+
+/**
+ * Scan input with all the rule files registered since the last scan
+ * @param bytes Pointer to content of input file (it is not copied)
+ * @param size Size of input file
+ * @return @c true if analysis completed without any error, otherwise @c false.
+ *
+ * Text rules of all consumers are compiled into one rule set, so the input
+ * is scanned by them only once. Precompiled files cannot be merged with other
+ * rules, they are scanned by their own rule sets (in parallel if more threads
+ * are allowed).
+ */
+bool YaraScanCoordinator::scan(const std::uint8_t *bytes, std::size_t size)
+{
+	if (!pendingDetector)
+	{
+		return true;
+	}
+
+	auto storeAllRules = false;
+	for (const auto &c : consumers)
+	{
+		storeAllRules |= c.second.pending && c.second.storeAllRules;
+	}
+
+	auto detector = std::move(pendingDetector);
+	detector->setScanThreads(scanThreads);
+	const auto result = detector->analyze(bytes, size, storeAllRules)
+			&& detector->isInValidState();
+
+	for (const auto &rule : detector->getDetectedRules())
+	{
+		auto ns = namespaces.find(rule.getNamespace());
+		if (ns != namespaces.end())
+		{
+			consumers[ns->second].detected.push_back(rule);
+		}
+	}
+	for (const auto &rule : detector->getUndetectedRules())
+	{
+		auto ns = namespaces.find(rule.getNamespace());
+		if (ns != namespaces.end())
+		{
+			auto &c = consumers[ns->second];
+			if (c.storeAllRules)
+			{
+				c.undetected.push_back(rule);
+			}
+		}
+	}
+
+	for (auto &c : consumers)
+	{
+		if (c.second.pending)
+		{
+			c.second.pending = false;
+			c.second.scanned = true;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * Set number of threads used by scans
+ * @param threads Number of threads, @c 0 means as many as the hardware
+ *    supports. See @c YaraDetector::setScanThreads().
+ */
+void YaraScanCoordinator::setScanThreads(std::size_t threads)
+{
+	scanThreads = threads
+			? threads
+			: std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Check if all rule files of the given consumer were scanned
+ * @param consumer Name of consumer
+ * @return @c true if consumer's rules were scanned, @c false otherwise
+ */
+bool YaraScanCoordinator::isScanned(const std::string &consumer) const
+{
+	auto c = consumers.find(consumer);
+	return c != consumers.end() && c->second.scanned && !c->second.pending;
+}
+
+/**
+ * Get detected rules of the given consumer
+ * @param consumer Name of consumer
+ * @return Detected rules from the consumer's rule files
+ */
+const std::vector<YaraRule>& YaraScanCoordinator::getDetectedRules(
+		const std::string &consumer) const
+{
+	auto c = consumers.find(consumer);
+	return c != consumers.end() ? c->second.detected : emptyRules;
+}
+
+/**
+ * Get undetected rules of the given consumer
+ * @param consumer Name of consumer
+ * @return Undetected rules from the consumer's rule files (only if the
+ *    consumer wanted to store all rules)
+ */
+const std::vector<YaraRule>& YaraScanCoordinator::getUndetectedRules(
+		const std::string &consumer) const
+{
+	auto c = consumers.find(consumer);
+	return c != consumers.end() ? c->second.undetected : emptyRules;
+}
+
+} // namespace yaracpp
+} // namespace retdec
@@ -23,6 +23,27 @@ namespace tests {
  */
 class ReachingDefinitionsTests: public LlvmIrTests
 {
+	protected:
+		std::set<llvm::Instruction*> defsOf(const std::string& use)
+		{
+			std::set<llvm::Instruction*> ret;
+			for (auto* d : RDA.defsFromUse(getInstructionByName(use)))
+			{
+				ret.insert(d->def);
+			}
+			return ret;
+		}
+
+		std::set<llvm::Instruction*> usesOf(llvm::Instruction* def)
+		{
+			std::set<llvm::Instruction*> ret;
+			for (auto* u : RDA.usesFromDef(def))
+			{
+				ret.insert(u->use);
+			}
+			return ret;
+		}
+
 	protected:
 		ReachingDefinitionsAnalysis RDA;
 };
@@ -44,6 +65,102 @@ DummyTest)
 	EXPECT_EQ( nullptr, module->getGlobalVariable("glob1") );
 }
 
+TEST_F(ReachingDefinitionsTests,
+definitionsFromBothBranchesReachUse)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1(i1 %c) {
+			store i32 1, i32* @glob0
+			br i1 %c, label %left, label %right
+		left:
+			store i32 2, i32* @glob0
+			br label %join
+		right:
+			br label %join
+		join:
+			%x = load i32, i32* @glob0
+			ret void
+		}
+	)");
+	auto* s1 = getNthInstruction<StoreInst>(0);
+	auto* s2 = getNthInstruction<StoreInst>(1);
+	auto* x = getInstructionByName("x");
+
+	RDA.runOnModule(*module);
+
+	std::set<llvm::Instruction*> expectedDefs = {s1, s2};
+	std::set<llvm::Instruction*> expectedUses = {x};
+	EXPECT_EQ(expectedDefs, defsOf("x"));
+	EXPECT_EQ(expectedUses, usesOf(s1));
+	EXPECT_EQ(expectedUses, usesOf(s2));
+}
+
+TEST_F(ReachingDefinitionsTests,
+definitionsReachUseThroughLoop)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1(i1 %c) {
+			store i32 1, i32* @glob0
+			br label %loop
+		loop:
+			%x = load i32, i32* @glob0
+			store i32 2, i32* @glob0
+			%y = load i32, i32* @glob0
+			br i1 %c, label %loop, label %exit
+		exit:
+			%z = load i32, i32* @glob0
+			ret void
+		}
+	)");
+	auto* s1 = getNthInstruction<StoreInst>(0);
+	auto* s2 = getNthInstruction<StoreInst>(1);
+
+	RDA.runOnModule(*module);
+
+	std::set<llvm::Instruction*> expectedX = {s1, s2};
+	std::set<llvm::Instruction*> expectedY = {s2};
+	std::set<llvm::Instruction*> expectedZ = {s2};
+	EXPECT_EQ(expectedX, defsOf("x"));
+	EXPECT_EQ(expectedY, defsOf("y"));
+	EXPECT_EQ(expectedZ, defsOf("z"));
+}
+
+TEST_F(ReachingDefinitionsTests,
+allFunctionsAreAnalysed)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1() {
+			store i32 1, i32* @glob0
+			%x = load i32, i32* @glob0
+			ret void
+		}
+		define void @func2() {
+			store i32 2, i32* @glob0
+			br label %next
+		next:
+			%y = load i32, i32* @glob0
+			ret void
+		}
+		define void @func3() {
+			%z = load i32, i32* @glob0
+			ret void
+		}
+	)");
+	auto* s1 = getNthInstruction<StoreInst>(0);
+	auto* s2 = getNthInstruction<StoreInst>(1);
+
+	RDA.runOnModule(*module);
+
+	std::set<llvm::Instruction*> expectedX = {s1};
+	std::set<llvm::Instruction*> expectedY = {s2};
+	EXPECT_EQ(expectedX, defsOf("x"));
+	EXPECT_EQ(expectedY, defsOf("y"));
+	EXPECT_TRUE(defsOf("z").empty());
+}
+
 } // namespace tests
 } // namespace bin2llvmir
 } // namespace retdec
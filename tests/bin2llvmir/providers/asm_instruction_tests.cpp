@@ -357,6 +357,92 @@ TEST_F(AsmInstructionTests, AsmInstructionCtorAddressConstructsValidForGoodAddre
 	EXPECT_EQ(ref, a.getLlvmToAsmInstruction());
 }
 
+//
+// Index of ASM instructions
+//
+
+TEST_F(AsmInstructionTests, indexedInstructionFollowsErasedMapInstruction)
+{
+	parseInput(R"(
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm
+			%a = add i32 1, 2
+			store volatile i64 5678, i64* @llvm2asm
+			%b = mul i32 %a, 3
+			ret void
+		}
+		@llvm2asm = global i64 0
+	)");
+	auto* mapGv = getGlobalByName("llvm2asm");
+	AsmInstruction::setLlvmToAsmGlobalVariable(module.get(), mapGv);
+	auto* ref1 = getNthInstruction<StoreInst>(0);
+	auto* ref2 = getNthInstruction<StoreInst>(1);
+	auto* b = getInstructionByName("b");
+
+	EXPECT_EQ(ref2, AsmInstruction(b).getLlvmToAsmInstruction());
+	EXPECT_EQ(ref2, AsmInstruction(module.get(), 5678).getLlvmToAsmInstruction());
+
+	ref2->eraseFromParent();
+
+	EXPECT_EQ(ref1, AsmInstruction(b).getLlvmToAsmInstruction());
+	EXPECT_TRUE(AsmInstruction(module.get(), 5678).isInvalid());
+}
+
+TEST_F(AsmInstructionTests, addedMapInstructionInvalidatesIndexedInstructions)
+{
+	parseInput(R"(
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm
+			%a = add i32 1, 2
+			%b = mul i32 %a, 3
+			ret void
+		}
+		@llvm2asm = global i64 0
+	)");
+	auto* mapGv = getGlobalByName("llvm2asm");
+	AsmInstruction::setLlvmToAsmGlobalVariable(module.get(), mapGv);
+	auto* ref1 = getNthInstruction<StoreInst>(0);
+	auto* b = getInstructionByName("b");
+
+	EXPECT_EQ(ref1, AsmInstruction(b).getLlvmToAsmInstruction());
+
+	IRBuilder<> irb(b);
+	auto* ref2 = irb.CreateStore(
+			ConstantInt::get(Type::getInt64Ty(context), 5678),
+			mapGv,
+			true);
+	AsmInstruction::addLlvmToAsmInstruction(ref2, nullptr);
+
+	EXPECT_EQ(ref2, AsmInstruction(b).getLlvmToAsmInstruction());
+	EXPECT_EQ(ref2, AsmInstruction(module.get(), 5678).getLlvmToAsmInstruction());
+}
+
+TEST_F(AsmInstructionTests, indexedInstructionMovedToAnotherBasicBlockIsFoundAgain)
+{
+	parseInput(R"(
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm
+			%a = add i32 1, 2
+			br label %lab_0
+		lab_0:
+			store volatile i64 5678, i64* @llvm2asm
+			ret void
+		}
+		@llvm2asm = global i64 0
+	)");
+	auto* mapGv = getGlobalByName("llvm2asm");
+	AsmInstruction::setLlvmToAsmGlobalVariable(module.get(), mapGv);
+	auto* ref2 = getNthInstruction<StoreInst>(1);
+	auto* a = getInstructionByName("a");
+	auto* ret = getNthInstruction<ReturnInst>();
+
+	ASSERT_TRUE(AsmInstruction(a).isValid());
+
+	a->moveBefore(ret);
+
+	EXPECT_EQ(ref2, AsmInstruction(a).getLlvmToAsmInstruction());
+}
+
 //
 // AsmInstruction(llvm::Function*)
 //
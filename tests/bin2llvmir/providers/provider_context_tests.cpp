@@ -0,0 +1,123 @@
+/**
+* @file tests/bin2llvmir/providers/provider_context_tests.cpp
+* @brief Tests for the @c ProviderContext.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <thread>
+
+#include "retdec/bin2llvmir/providers/provider_context.h"
+#include "bin2llvmir/utils/llvmir_tests.h"
+
+using namespace ::testing;
+using namespace llvm;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+/**
+ * @brief Tests for the @c ProviderContext.
+ */
+class ProviderContextTests: public LlvmIrTests
+{
+	protected:
+		virtual void TearDown() override
+		{
+			ProviderContext::release(module.get());
+			LlvmIrTests::TearDown();
+		}
+};
+
+TEST_F(ProviderContextTests, getReturnsNullptrForUnknownModule)
+{
+	EXPECT_EQ(nullptr, ProviderContext::get(module.get()));
+}
+
+TEST_F(ProviderContextTests, getOrCreateCreatesContextOnlyOnce)
+{
+	auto& ctx1 = ProviderContext::getOrCreate(module.get());
+	auto& ctx2 = ProviderContext::getOrCreate(module.get());
+
+	EXPECT_EQ(&ctx1, &ctx2);
+	EXPECT_EQ(&ctx1, ProviderContext::get(module.get()));
+}
+
+TEST_F(ProviderContextTests, releaseDestroysContextAndProviderData)
+{
+	retdec::config::Config c;
+	auto* config = ConfigProvider::addConfig(module.get(), c);
+	ASSERT_NE(nullptr, config);
+	EXPECT_EQ(config, ConfigProvider::getConfig(module.get()));
+
+	ProviderContext::release(module.get());
+
+	EXPECT_EQ(nullptr, ProviderContext::get(module.get()));
+	EXPECT_EQ(nullptr, ConfigProvider::getConfig(module.get()));
+}
+
+TEST_F(ProviderContextTests, modulesHaveIndependentContexts)
+{
+	LLVMContext otherContext;
+	auto other = std::make_unique<Module>("other", otherContext);
+
+	retdec::config::Config c1;
+	retdec::config::Config c2;
+	auto* config1 = ConfigProvider::addConfig(module.get(), c1);
+	auto* config2 = ConfigProvider::addConfig(other.get(), c2);
+
+	EXPECT_NE(config1, config2);
+	EXPECT_EQ(config1, ConfigProvider::getConfig(module.get()));
+	EXPECT_EQ(config2, ConfigProvider::getConfig(other.get()));
+
+	ProviderContext::release(other.get());
+
+	EXPECT_EQ(config1, ConfigProvider::getConfig(module.get()));
+	EXPECT_EQ(nullptr, ConfigProvider::getConfig(other.get()));
+}
+
+TEST_F(ProviderContextTests, contextsCanBeUsedFromMultipleThreads)
+{
+	const unsigned threadsCount = 4;
+	const unsigned iterations = 100;
+
+	std::vector<std::thread> threads;
+	std::vector<char> results(threadsCount, true);
+	for (unsigned t = 0; t < threadsCount; ++t)
+	{
+		threads.emplace_back([&results, t]()
+		{
+			LLVMContext ctx;
+			for (unsigned i = 0; i < iterations; ++i)
+			{
+				auto m = std::make_unique<Module>("m", ctx);
+				retdec::config::Config c;
+				auto* config = ConfigProvider::addConfig(m.get(), c);
+				if (config == nullptr
+						|| ConfigProvider::getConfig(m.get()) != config
+						|| &config->getConfig() != &c)
+				{
+					results[t] = false;
+				}
+				ProviderContext::release(m.get());
+				if (ConfigProvider::getConfig(m.get()) != nullptr)
+				{
+					results[t] = false;
+				}
+			}
+		});
+	}
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+
+	for (unsigned t = 0; t < threadsCount; ++t)
+	{
+		EXPECT_TRUE(results[t]) << "thread #" << t;
+	}
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
@@ -21,6 +21,7 @@
 #include <llvm/Support/raw_ostream.h>
 
 #include "retdec/bin2llvmir/analyses/symbolic_tree.h"
+#include "retdec/bin2llvmir/optimizations/value_protect/value_protect.h"
 #include "retdec/bin2llvmir/utils/llvm.h"
 #include "retdec/fileformat/file_format/raw_data/raw_data_format.h"
 #include "retdec/loader/loader.h"
@@ -69,6 +70,7 @@ class LlvmIrTests : public ::testing::Test
 			NamesProvider::clear();
 			SymbolicTree::clear();
 			CallingConventionProvider::clear();
+			ValueProtect::clear();
 		}
 
 		/**
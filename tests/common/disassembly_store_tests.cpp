@@ -0,0 +1,175 @@
+/**
+* @file tests/common/disassembly_store_tests.cpp
+* @brief Tests for the @c disassembly_store module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/common/disassembly_store.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace common {
+namespace tests {
+
+/**
+ * @brief Tests for the @c DisassemblyStore class.
+ */
+class DisassemblyStoreTests: public Test
+{
+	public:
+		DisassemblyStoreTests()
+		{
+			cs_open(CS_ARCH_X86, CS_MODE_32, &handle);
+			cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+			insn = cs_malloc(handle);
+		}
+
+		~DisassemblyStoreTests()
+		{
+			cs_free(insn, 1);
+			cs_close(&handle);
+		}
+
+	protected:
+		// push ebp; mov ebp, esp; ret
+		const std::uint8_t code[4] = {0x55, 0x89, 0xe5, 0xc3};
+		csh handle = 0;
+		cs_insn* insn = nullptr;
+};
+
+TEST_F(DisassemblyStoreTests,
+DisassembleWorksTheSameWayAsCapstone)
+{
+	DisassemblyStore store(CS_ARCH_X86, CS_MODE_32);
+	const std::uint8_t* bytes = code;
+	std::size_t size = sizeof(code);
+	std::uint64_t addr = 0x1000;
+
+	ASSERT_TRUE(store.disassemble(CS_MODE_32, &bytes, &size, &addr, insn));
+	EXPECT_EQ(X86_INS_PUSH, insn->id);
+	EXPECT_EQ(0x1000, insn->address);
+	EXPECT_EQ(code + 1, bytes);
+	EXPECT_EQ(3, size);
+	EXPECT_EQ(0x1001, addr);
+
+	ASSERT_TRUE(store.disassemble(CS_MODE_32, &bytes, &size, &addr, insn));
+	EXPECT_EQ(X86_INS_MOV, insn->id);
+	EXPECT_EQ(2, insn->detail->x86.op_count);
+	EXPECT_EQ(X86_REG_EBP, insn->detail->x86.operands[0].reg);
+
+	ASSERT_TRUE(store.disassemble(CS_MODE_32, &bytes, &size, &addr, insn));
+	EXPECT_EQ(X86_INS_RET, insn->id);
+	EXPECT_EQ(0, size);
+	EXPECT_EQ(0x1004, addr);
+
+	EXPECT_FALSE(store.disassemble(CS_MODE_32, &bytes, &size, &addr, insn));
+	EXPECT_EQ(3, store.getInstructionCount());
+}
+
+TEST_F(DisassemblyStoreTests,
+FindReturnsCopyOfCachedInstruction)
+{
+	DisassemblyStore store(CS_ARCH_X86, CS_MODE_32);
+	const std::uint8_t* bytes = code + 1;
+	std::size_t size = sizeof(code) - 1;
+	std::uint64_t addr = 0x1001;
+	ASSERT_TRUE(store.disassemble(CS_MODE_32, &bytes, &size, &addr, insn));
+
+	auto* other = cs_malloc(handle);
+	ASSERT_TRUE(store.find(CS_MODE_32, 0x1001, 3, other));
+	EXPECT_EQ(X86_INS_MOV, other->id);
+	EXPECT_EQ(2, other->size);
+	EXPECT_NE(insn->detail, other->detail);
+	EXPECT_EQ(X86_REG_ESP, other->detail->x86.operands[1].reg);
+	cs_free(other, 1);
+}
+
+TEST_F(DisassemblyStoreTests,
+FindFailsIfBytesDifferFromCachedOnes)
+{
+	DisassemblyStore store(CS_ARCH_X86, CS_MODE_32);
+	const std::uint8_t* bytes = code + 1;
+	std::size_t size = sizeof(code) - 1;
+	std::uint64_t addr = 0x1001;
+	ASSERT_TRUE(store.disassemble(CS_MODE_32, &bytes, &size, &addr, insn));
+
+	// Capstone would see fewer bytes than when it disassembled the cached
+	// instruction.
+	EXPECT_FALSE(store.find(CS_MODE_32, 0x1001, 2, insn));
+	EXPECT_FALSE(store.find(CS_MODE_32, 0x1001, 1, insn));
+	EXPECT_TRUE(store.find(CS_MODE_32, 0x1001, 3, insn));
+}
+
+TEST_F(DisassemblyStoreTests,
+InstructionsAreCachedSeparatelyForEachMode)
+{
+	DisassemblyStore store(CS_ARCH_X86, CS_MODE_32);
+	const std::uint8_t* bytes = code;
+	std::size_t size = sizeof(code);
+	std::uint64_t addr = 0x1000;
+	ASSERT_TRUE(store.disassemble(CS_MODE_32, &bytes, &size, &addr, insn));
+
+	EXPECT_TRUE(store.contains(CS_MODE_32, 0x1000));
+	EXPECT_FALSE(store.contains(CS_MODE_64, 0x1000));
+	EXPECT_FALSE(store.find(CS_MODE_64, 0x1000, sizeof(code), insn));
+
+	bytes = code;
+	size = sizeof(code);
+	addr = 0x1000;
+	ASSERT_TRUE(store.disassemble(CS_MODE_64, &bytes, &size, &addr, insn));
+	EXPECT_TRUE(store.contains(CS_MODE_64, 0x1000));
+	EXPECT_EQ(2, store.getInstructionCount());
+}
+
+TEST_F(DisassemblyStoreTests,
+InsertedInstructionIsFound)
+{
+	DisassemblyStore store(CS_ARCH_X86, CS_MODE_32);
+	const std::uint8_t* bytes = code;
+	std::size_t size = sizeof(code);
+	std::uint64_t addr = 0x1000;
+	ASSERT_TRUE(cs_disasm_iter(handle, &bytes, &size, &addr, insn));
+
+	store.insert(CS_MODE_32, *insn, sizeof(code));
+
+	insn->id = X86_INS_INVALID;
+	ASSERT_TRUE(store.find(CS_MODE_32, 0x1000, sizeof(code), insn));
+	EXPECT_EQ(X86_INS_PUSH, insn->id);
+}
+
+TEST_F(DisassemblyStoreTests,
+NumberOfCachedInstructionsIsBoundedByBudget)
+{
+	DisassemblyStore store(CS_ARCH_X86, CS_MODE_32, 64 * 1024);
+	ASSERT_LT(0, store.getCapacity());
+
+	std::vector<std::uint8_t> nops(10 * store.getCapacity(), 0x90);
+	const std::uint8_t* bytes = nops.data();
+	std::size_t size = nops.size();
+	std::uint64_t addr = 0x1000;
+	while (store.disassemble(CS_MODE_32, &bytes, &size, &addr, insn))
+	{
+		EXPECT_LE(store.getInstructionCount(), store.getCapacity());
+	}
+	EXPECT_EQ(0, size);
+}
+
+TEST_F(DisassemblyStoreTests,
+ZeroBudgetDisablesCaching)
+{
+	DisassemblyStore store(CS_ARCH_X86, CS_MODE_32, 0);
+	const std::uint8_t* bytes = code;
+	std::size_t size = sizeof(code);
+	std::uint64_t addr = 0x1000;
+
+	EXPECT_TRUE(store.disassemble(CS_MODE_32, &bytes, &size, &addr, insn));
+	EXPECT_EQ(X86_INS_PUSH, insn->id);
+	EXPECT_EQ(0, store.getInstructionCount());
+}
+
+} // namespace tests
+} // namespace common
+} // namespace retdec
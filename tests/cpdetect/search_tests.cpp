@@ -0,0 +1,588 @@
+/**
+* @file tests/cpdetect/search_tests.cpp
+* @brief Tests for the @c search module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/cpdetect/search.h"
+#include "retdec/fileformat/file_format/raw_data/raw_data_format.h"
+#include "retdec/utils/conversion.h"
+#include "retdec/utils/equality.h"
+
+using namespace ::testing;
+using namespace retdec::fileformat;
+using namespace retdec::utils;
+
+namespace retdec {
+namespace cpdetect {
+namespace tests {
+
+namespace
+{
+
+/**
+ * Matcher working on hexadecimal string representation of file as the
+ * signature search did before it was rewritten to work on bytes. It is used
+ * as a reference for results of @c Search on x86 little endian files.
+ */
+class ReferenceSearch
+{
+	private:
+		const FileFormat &parser;
+		std::string nibbles;
+		std::vector<Search::RelativeJump> jumps;
+		std::size_t averageSlashLen = 2;
+
+		const Search::RelativeJump* getRelativeJump(
+				std::size_t fileOffset,
+				std::size_t shift,
+				std::int64_t &moveSize) const
+		{
+			const auto nibbleOffset = parser.nibblesFromBytes(fileOffset) + shift;
+			moveSize = 0;
+
+			for (const auto &jump : jumps)
+			{
+				const auto nibblesAfter = parser.nibblesFromBytes(
+						jump.getBytesAfter());
+				if (!hasSubstringOnPosition(jump.getSlash(), nibbleOffset)
+						|| (nibbleOffset + jump.getSlashNibbleSize()
+								+ nibblesAfter - 1 >= nibbles.length()))
+				{
+					continue;
+				}
+
+				std::uint64_t jumpedBytes = 0;
+				if (!parser.getXByteOffset(
+						fileOffset + parser.bytesFromNibbles(
+								jump.getSlashNibbleSize()),
+						jump.getBytesAfter(),
+						jumpedBytes,
+						Endianness::LITTLE))
+				{
+					continue;
+				}
+
+				moveSize = jump.getBytesAfter() == 1
+						? static_cast<std::int8_t>(jumpedBytes)
+						: static_cast<std::int32_t>(jumpedBytes);
+				moveSize = parser.nibblesFromBytes(moveSize);
+				return &jump;
+			}
+
+			return nullptr;
+		}
+
+		bool hasSubstringOnPosition(
+				const std::string &str,
+				std::size_t position) const
+		{
+			return position < nibbles.length()
+					&& nibbles.length() - position >= str.length()
+					&& nibbles.compare(position, str.length(), str) == 0;
+		}
+
+	public:
+		explicit ReferenceSearch(const FileFormat &fileParser)
+				: parser(fileParser)
+		{
+			const auto &bytes = parser.getLoadedBytes();
+			bytesToHexString(bytes.data(), bytes.size(), nibbles);
+			jumps = {
+				Search::RelativeJump("EB", 1),
+				Search::RelativeJump("E9", 4)
+			};
+		}
+
+		unsigned long long countImpNibbles(const std::string &signPattern) const
+		{
+			unsigned long long count = 0;
+			for (const auto &c : signPattern)
+			{
+				if (c == '/')
+				{
+					count += averageSlashLen;
+				}
+				else if (c != '-' && c != '?' && c != ';')
+				{
+					++count;
+				}
+			}
+			return count;
+		}
+
+		unsigned long long findUnslashedSignature(
+				const std::string &signPattern,
+				std::size_t startOffset,
+				std::size_t stopOffset) const
+		{
+			if (startOffset > stopOffset)
+			{
+				return 0;
+			}
+
+			const auto startIterator = nibbles.begin()
+					+ parser.nibblesFromBytes(startOffset);
+			const auto stopIndex = parser.nibblesFromBytes(stopOffset) + 1;
+			const auto stopIterator = stopIndex < nibbles.size()
+					? nibbles.begin() + stopIndex
+					: nibbles.end();
+			const auto it = std::search(
+					startIterator,
+					stopIterator,
+					signPattern.begin(),
+					signPattern.end(),
+					[] (const char fileNibble, const char signatureNibble)
+					{
+						return fileNibble == signatureNibble
+								|| signatureNibble == '-'
+								|| signatureNibble == '?'
+								|| signatureNibble == ';';
+					}
+			);
+
+			return (it != stopIterator) ? countImpNibbles(signPattern) : 0;
+		}
+
+		unsigned long long exactComparison(
+				const std::string &signPattern,
+				std::size_t fileOffset,
+				std::size_t shift = 0) const
+		{
+			for (std::size_t sigIndex = 0,
+					fileIndex = parser.nibblesFromBytes(fileOffset) + shift,
+					fileLen = nibbles.length();
+					fileIndex < fileLen;
+					++sigIndex, ++fileIndex)
+			{
+				if (sigIndex == signPattern.length()
+						|| signPattern[sigIndex] == ';')
+				{
+					return countImpNibbles(signPattern);
+				}
+				else if (signPattern[sigIndex] == '/')
+				{
+					std::int64_t moveSize = 0;
+					const auto *jump = getRelativeJump(
+							parser.bytesFromNibbles(fileIndex),
+							fileIndex % 2,
+							moveSize);
+					if (!jump)
+					{
+						return 0;
+					}
+					fileIndex += jump->getSlashNibbleSize()
+							+ parser.nibblesFromBytes(jump->getBytesAfter())
+							+ moveSize
+							- 1;
+				}
+				else if (signPattern[sigIndex] != nibbles[fileIndex]
+						&& signPattern[sigIndex] != '-'
+						&& signPattern[sigIndex] != '?')
+				{
+					return 0;
+				}
+			}
+
+			return 0;
+		}
+
+		unsigned long long findSlashedSignature(
+				const std::string &signPattern,
+				std::size_t startOffset,
+				std::size_t stopOffset) const
+		{
+			if (startOffset > stopOffset)
+			{
+				return 0;
+			}
+
+			const auto areaSize = parser.nibblesFromBytes(
+					stopOffset - startOffset + 1);
+			const auto signSize = signPattern.length()
+					- std::count(signPattern.begin(), signPattern.end(), ';');
+			if (areaSize < signSize)
+			{
+				return 0;
+			}
+			const auto iters = startOffset == stopOffset
+					? 1
+					: areaSize - signSize + 1;
+
+			for (std::size_t i = 0; i < iters; ++i)
+			{
+				if (const auto result = exactComparison(
+						signPattern, startOffset, i))
+				{
+					return result;
+				}
+			}
+
+			return 0;
+		}
+
+		bool countSimilarity(
+				const std::string &signPattern,
+				Similarity &sim,
+				std::size_t fileOffset,
+				std::size_t shift = 0) const
+		{
+			Similarity result;
+
+			for (std::size_t sigIndex = 0,
+					fileIndex = parser.nibblesFromBytes(fileOffset) + shift,
+					fileLen = nibbles.length();
+					fileIndex < fileLen;
+					++sigIndex, ++fileIndex)
+			{
+				if (sigIndex == signPattern.length()
+						|| signPattern[sigIndex] == ';')
+				{
+					sim.same = result.same;
+					sim.total = result.total;
+					sim.ratio = static_cast<double>(result.same) / result.total;
+					return countImpNibbles(signPattern);
+				}
+				else if (signPattern[sigIndex] == '-'
+						|| signPattern[sigIndex] == '?')
+				{
+					continue;
+				}
+				else if (signPattern[sigIndex] == '/')
+				{
+					std::int64_t moveSize = 0;
+					const auto *jump = getRelativeJump(
+							parser.bytesFromNibbles(fileIndex),
+							fileIndex % 2,
+							moveSize);
+					if (!jump)
+					{
+						result.total += averageSlashLen;
+					}
+					else
+					{
+						result.total += jump->getSlashNibbleSize();
+						result.same += jump->getSlashNibbleSize();
+						fileIndex += jump->getSlashNibbleSize()
+								+ parser.nibblesFromBytes(
+										jump->getBytesAfter())
+								+ moveSize - 1;
+					}
+					continue;
+				}
+				else if (signPattern[sigIndex] == nibbles[fileIndex])
+				{
+					++result.same;
+				}
+
+				++result.total;
+			}
+
+			return false;
+		}
+
+		bool areaSimilarity(
+				const std::string &signPattern,
+				Similarity &sim,
+				std::size_t startOffset,
+				std::size_t stopOffset) const
+		{
+			if (startOffset > stopOffset)
+			{
+				return false;
+			}
+
+			const auto areaSize = parser.nibblesFromBytes(
+					stopOffset - startOffset + 1);
+			const auto signSize = signPattern.length()
+					- std::count(signPattern.begin(), signPattern.end(), ';');
+			if (areaSize < signSize)
+			{
+				return false;
+			}
+			const auto iters = startOffset == stopOffset
+					? 1
+					: areaSize - signSize + 1;
+			auto result = false;
+			Similarity act, max;
+
+			for (std::size_t i = 0; i < iters; ++i)
+			{
+				if (countSimilarity(signPattern, act, startOffset, i)
+						&& (act.ratio > max.ratio
+								|| (areEqual(act.ratio, max.ratio)
+										&& act.total > max.total)))
+				{
+					max = act;
+					result = true;
+				}
+			}
+
+			if (result)
+			{
+				sim = max;
+			}
+
+			return result;
+		}
+
+		const std::string& getNibbles() const
+		{
+			return nibbles;
+		}
+};
+
+} // anonymous namespace
+
+/**
+ * Tests for the @c search module.
+ */
+class SearchTests : public Test
+{
+	protected:
+		std::vector<std::uint8_t> content;
+		std::unique_ptr<RawDataFormat> parser;
+		std::unique_ptr<Search> search;
+		std::unique_ptr<ReferenceSearch> reference;
+
+		void load(
+				const std::vector<std::uint8_t> &bytes,
+				Endianness endianness = Endianness::LITTLE,
+				std::size_t bytesLength = 8)
+		{
+			search.reset();
+			reference.reset();
+			content = bytes;
+			parser = std::make_unique<RawDataFormat>(
+					content.data(),
+					content.size()
+			);
+			parser->setTargetArchitecture(Architecture::X86);
+			parser->setEndianness(endianness);
+			parser->setBytesPerWord(4);
+			parser->setBytesLength(bytesLength);
+			search = std::make_unique<Search>(*parser);
+			reference = std::make_unique<ReferenceSearch>(*parser);
+		}
+
+		/// Random content with many bytes of relative jumps.
+		std::vector<std::uint8_t> randomBytes(
+				std::mt19937 &gen,
+				std::size_t size) const
+		{
+			const std::uint8_t common[] = {0x00, 0x55, 0x8B, 0xE9, 0xEB, 0xFF};
+			std::vector<std::uint8_t> bytes(size);
+			for (auto &b : bytes)
+			{
+				b = gen() % 3
+						? common[gen() % sizeof(common)]
+						: static_cast<std::uint8_t>(gen());
+			}
+			return bytes;
+		}
+
+		/// Random pattern made of a part of file content with some nibbles
+		/// replaced by wildcards or changed.
+		std::string randomPattern(std::mt19937 &gen, bool slashes) const
+		{
+			const auto &nibbles = reference->getNibbles();
+			const auto len = 1 + gen() % 12;
+			const auto start = gen() % (nibbles.length() - len);
+			auto pattern = nibbles.substr(start, len);
+			for (auto &c : pattern)
+			{
+				switch (gen() % 12)
+				{
+					case 0: c = '-'; break;
+					case 1: c = '?'; break;
+					case 2: c = "0123456789ABCDEF"[gen() % 16]; break;
+					case 3: c = slashes ? '/' : ';'; break;
+					default: break;
+				}
+			}
+			if (slashes && gen() % 4 == 0)
+			{
+				pattern += ";";
+			}
+			return pattern;
+		}
+};
+
+TEST_F(SearchTests,
+FileWithTwoNibblesInByteIsSupported)
+{
+	load({0x55, 0x8B, 0xEC});
+
+	EXPECT_TRUE(search->isFileLoaded());
+	EXPECT_TRUE(search->isFileSupported());
+}
+
+TEST_F(SearchTests,
+FileWithOtherNumberOfNibblesInByteIsNotSupported)
+{
+	load({0x55, 0x8B, 0xEC, 0x00}, Endianness::LITTLE, 16);
+
+	EXPECT_FALSE(search->isFileSupported());
+}
+
+TEST_F(SearchTests,
+FileWithUnknownEndiannessIsNotSupported)
+{
+	load({0x55, 0x8B, 0xEC, 0x00}, Endianness::UNKNOWN);
+
+	EXPECT_FALSE(search->isFileSupported());
+}
+
+TEST_F(SearchTests,
+BigEndianFileIsSearchedInLittleEndianWords)
+{
+	load({0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88}, Endianness::BIG);
+
+	EXPECT_TRUE(search->isFileSupported());
+	EXPECT_EQ(8, search->findUnslashedSignature("33221188", 0, 7));
+	EXPECT_EQ(0, search->findUnslashedSignature("11223344", 0, 7));
+}
+
+TEST_F(SearchTests,
+UnslashedSignatureIsFoundOnOddNibble)
+{
+	load({0x01, 0x23, 0x45, 0x67, 0x89});
+
+	EXPECT_EQ(4, search->findUnslashedSignature("1234", 0, 4));
+	EXPECT_EQ(4, search->findUnslashedSignature("3456", 0, 4));
+	EXPECT_EQ(0, search->findUnslashedSignature("1234", 1, 4));
+	EXPECT_EQ(0, search->findUnslashedSignature("4321", 0, 4));
+}
+
+TEST_F(SearchTests,
+UnslashedSignatureWithNibbleWildcardsIsFound)
+{
+	load({0x55, 0x8B, 0xEC, 0x83, 0xEC, 0x10});
+
+	EXPECT_EQ(3, search->findUnslashedSignature("8?E-8", 0, 5));
+	EXPECT_EQ(3, search->findUnslashedSignature("-B;C8", 0, 5));
+	EXPECT_EQ(2, search->findUnslashedSignature("E?-?E", 0, 5));
+	EXPECT_EQ(0, search->findUnslashedSignature("E?-?2", 0, 5));
+}
+
+TEST_F(SearchTests,
+UnslashedSignatureMustEndBeforeLowerNibbleOfStopOffset)
+{
+	load({0x55, 0x8B, 0xEC, 0x83, 0xEC, 0x10});
+
+	EXPECT_EQ(0, search->findUnslashedSignature("8BEC", 0, 2));
+	EXPECT_EQ(4, search->findUnslashedSignature("8BEC", 0, 3));
+	EXPECT_EQ(0, search->findUnslashedSignature("BEC83", 0, 3));
+	EXPECT_EQ(5, search->findUnslashedSignature("BEC83", 0, 4));
+	EXPECT_EQ(0, search->findUnslashedSignature("10", 5, 5));
+	EXPECT_EQ(2, search->findUnslashedSignature("10", 5, 100));
+}
+
+TEST_F(SearchTests,
+SlashedSignatureFollowsRelativeJumps)
+{
+	// EB 02 skips two bytes, E9 with zero offset jumps to the next byte.
+	load({0x90, 0xEB, 0x02, 0xCC, 0xCC, 0x55, 0xE9, 0x00, 0x00, 0x00, 0x00,
+			0x8B, 0xEC, 0x90});
+
+	EXPECT_EQ(6, search->exactComparison("90/55", 0));
+	EXPECT_EQ(12, search->exactComparison("90/55/8BEC", 0));
+	EXPECT_EQ(11, search->exactComparison("90/-5/8B;EC", 0));
+	EXPECT_EQ(0, search->exactComparison("90/CC", 0));
+	EXPECT_EQ(4, search->findSlashedSignature("/55", 0, 13));
+	EXPECT_EQ(0, search->findSlashedSignature("/55", 2, 13));
+}
+
+TEST_F(SearchTests,
+SignatureEndingAtEndOfFileIsNotMatchedAsBefore)
+{
+	load({0x55, 0x8B, 0xEC});
+
+	EXPECT_EQ(0, search->exactComparison("558BEC", 0));
+	EXPECT_EQ(0, reference->exactComparison("558BEC", 0));
+	EXPECT_EQ(5, search->exactComparison("558BE;", 0));
+}
+
+TEST_F(SearchTests,
+UnslashedSearchGivesSameResultsAsHexStringMatcher)
+{
+	std::mt19937 gen(0x5eed);
+	for (std::size_t round = 0; round < 50; ++round)
+	{
+		load(randomBytes(gen, 16 + gen() % 64));
+		const auto size = parser->getLoadedBytes().size();
+		for (std::size_t i = 0; i < 100; ++i)
+		{
+			const auto pattern = randomPattern(gen, false);
+			const auto start = gen() % size;
+			const auto stop = start + gen() % (size - start + 4);
+			EXPECT_EQ(
+					reference->findUnslashedSignature(pattern, start, stop),
+					search->findUnslashedSignature(pattern, start, stop)
+			) << pattern << " in <" << start << ", " << stop << ">";
+		}
+	}
+}
+
+TEST_F(SearchTests,
+SlashedSearchGivesSameResultsAsHexStringMatcher)
+{
+	std::mt19937 gen(0xc0ffee);
+	for (std::size_t round = 0; round < 50; ++round)
+	{
+		load(randomBytes(gen, 16 + gen() % 64));
+		const auto size = parser->getLoadedBytes().size();
+		for (std::size_t i = 0; i < 100; ++i)
+		{
+			const auto pattern = randomPattern(gen, true);
+			const auto start = gen() % size;
+			const auto stop = start + gen() % (size - start);
+			const auto shift = gen() % 4;
+			EXPECT_EQ(
+					reference->exactComparison(pattern, start, shift),
+					search->exactComparison(pattern, start, shift)
+			) << pattern << " at " << start << " + " << shift;
+			EXPECT_EQ(
+					reference->findSlashedSignature(pattern, start, stop),
+					search->findSlashedSignature(pattern, start, stop)
+			) << pattern << " in <" << start << ", " << stop << ">";
+		}
+	}
+}
+
+TEST_F(SearchTests,
+SimilarityIsSameAsOfHexStringMatcher)
+{
+	std::mt19937 gen(0xabcdef);
+	for (std::size_t round = 0; round < 50; ++round)
+	{
+		load(randomBytes(gen, 16 + gen() % 64));
+		const auto size = parser->getLoadedBytes().size();
+		for (std::size_t i = 0; i < 50; ++i)
+		{
+			const auto pattern = randomPattern(gen, true);
+			const auto start = gen() % size;
+			const auto stop = start + gen() % (size - start);
+			Similarity expected, actual;
+			EXPECT_EQ(
+					reference->areaSimilarity(pattern, expected, start, stop),
+					search->areaSimilarity(pattern, actual, start, stop)
+			) << pattern << " in <" << start << ", " << stop << ">";
+			EXPECT_EQ(expected.same, actual.same) << pattern;
+			EXPECT_EQ(expected.total, actual.total) << pattern;
+			EXPECT_TRUE(areEqual(expected.ratio, actual.ratio)) << pattern;
+		}
+	}
+}
+
+} // namespace tests
+} // namespace cpdetect
+} // namespace retdec
@@ -0,0 +1,71 @@
+/**
+* @file tests/fileformat/crypto_tests.cpp
+* @brief Tests for the @c crypto module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/fileformat/utils/crypto.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace fileformat {
+namespace tests {
+
+/**
+ * Tests for the @c crypto module.
+ */
+class CryptoTests : public Test
+{
+	protected:
+		static std::vector<unsigned char> createData(std::size_t size)
+		{
+			std::vector<unsigned char> data(size);
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				data[i] = static_cast<unsigned char>(i * 7 + 3);
+			}
+			return data;
+		}
+
+		static void checkComputeHashes(const std::vector<unsigned char> &data)
+		{
+			std::string crc32, md5, sha256;
+			computeHashes(data.data(), data.size(), crc32, md5, sha256);
+			EXPECT_EQ(getCrc32(data.data(), data.size()), crc32);
+			EXPECT_EQ(getMd5(data.data(), data.size()), md5);
+			EXPECT_EQ(getSha256(data.data(), data.size()), sha256);
+		}
+};
+
+TEST_F(CryptoTests, ComputeHashesOfKnownData)
+{
+	const std::string data = "abc";
+	std::string crc32, md5, sha256;
+	computeHashes(reinterpret_cast<const unsigned char*>(data.data()),
+			data.size(), crc32, md5, sha256);
+	EXPECT_EQ("352441c2", crc32);
+	EXPECT_EQ("900150983cd24fb0d6963f7d28e17f72", md5);
+	EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", sha256);
+}
+
+TEST_F(CryptoTests, ComputeHashesOfEmptyData)
+{
+	checkComputeHashes({});
+}
+
+TEST_F(CryptoTests, ComputeHashesOfDataLongerThanOneChunk)
+{
+	checkComputeHashes(createData(100 * 1024 + 17));
+}
+
+TEST_F(CryptoTests, ComputeHashesOfLongData)
+{
+	checkComputeHashes(createData(5 * 1024 * 1024 + 3));
+}
+
+} // namespace tests
+} // namespace fileformat
+} // namespace retdec
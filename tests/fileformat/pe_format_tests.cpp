@@ -204,6 +204,98 @@ TEST_F(PeFormatTests_data, DataInterpretationDefault)
 	EXPECT_EQ(0x105d0040103805c7, res);
 }
 
+/**
+ * Tests for the @c pe_format module - using data constructor without copying
+ * the input.
+ */
+class PeFormatTests_noCopy : public Test
+{
+	protected:
+		std::unique_ptr<PeFormat> parser;
+	public:
+		PeFormatTests_noCopy()
+		{
+			parser = std::make_unique<PeFormat>(
+					peBytes.data(),
+					peBytes.size(),
+					LoadFlags::NO_INPUT_COPY);
+		}
+};
+
+TEST_F(PeFormatTests_noCopy, InputIsNotCopied)
+{
+	EXPECT_EQ(peBytes.data(), parser->getBytesData());
+	EXPECT_EQ(peBytes.data(), parser->getLoadedBytesData());
+	EXPECT_EQ(peBytes.size(), parser->getFileLength());
+	EXPECT_EQ(peBytes.size(), parser->getBytes().size());
+}
+
+TEST_F(PeFormatTests_noCopy, CorrectParsing)
+{
+	EXPECT_EQ(true, parser->isInValidState());
+	EXPECT_EQ(0, parser->getNumberOfSegments());
+	ASSERT_EQ(1, parser->getNumberOfSections());
+	EXPECT_EQ(0x401000, parser->getSection(0)->getAddress());
+	EXPECT_EQ(0x200, parser->getSection(0)->getOffset());
+	unsigned long long memsize = 0;
+	EXPECT_EQ(true, parser->getSection(0)->getSizeInMemory(memsize));
+	EXPECT_EQ(0x1000, memsize);
+}
+
+TEST_F(PeFormatTests_noCopy, DataInterpretationDefault)
+{
+	std::uint64_t res;
+	EXPECT_EQ(true, parser->get4Byte(0x401000, res));
+	EXPECT_EQ(0x103805c7, res);
+	EXPECT_EQ(true, parser->get8Byte(0x401000, res));
+	EXPECT_EQ(0x105d0040103805c7, res);
+}
+
+/**
+ * Tests for the @c pe_format module - using lazy loading.
+ */
+class PeFormatTests_lazy : public Test
+{
+	protected:
+		std::unique_ptr<PeFormat> parser;
+		std::unique_ptr<PeFormat> eagerParser;
+	public:
+		PeFormatTests_lazy()
+		{
+			parser = std::make_unique<PeFormat>(
+					peBytes.data(),
+					peBytes.size(),
+					LoadFlags::LAZY_LOADING);
+			eagerParser = std::make_unique<PeFormat>(
+					peBytes.data(),
+					peBytes.size());
+		}
+};
+
+TEST_F(PeFormatTests_lazy, CorrectParsing)
+{
+	EXPECT_EQ(true, parser->isInValidState());
+	ASSERT_EQ(1, parser->getNumberOfSections());
+	EXPECT_EQ(0x401000, parser->getSection(0)->getAddress());
+	EXPECT_EQ(0x200, parser->getSection(0)->getOffset());
+}
+
+TEST_F(PeFormatTests_lazy, LazyPartsAreSameAsEagerlyLoaded)
+{
+	EXPECT_EQ(
+			eagerParser->getLoaderErrorInfo().loaderErrorCode,
+			parser->getLoaderErrorInfo().loaderErrorCode);
+	EXPECT_EQ(eagerParser->getAnomalies(), parser->getAnomalies());
+	EXPECT_EQ(eagerParser->isDotNet(), parser->isDotNet());
+	EXPECT_EQ(eagerParser->isSignaturePresent(), parser->isSignaturePresent());
+	EXPECT_EQ(
+			eagerParser->getResourceTable() == nullptr,
+			parser->getResourceTable() == nullptr);
+	EXPECT_EQ(
+			eagerParser->getNonDecodableAddressRanges().size(),
+			parser->getNonDecodableAddressRanges().size());
+}
+
 } // namespace tests
 } // namespace fileformat
 } // namespace retdec
@@ -0,0 +1,117 @@
+/**
+* @file tests/fileformat/string_scanner_tests.cpp
+* @brief Tests for the @c string_scanner module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/fileformat/types/strings/string_scanner.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace fileformat {
+namespace tests {
+
+/**
+ * Tests for the @c string_scanner module.
+ */
+class StringScannerTests : public Test
+{
+	protected:
+		using FoundString = std::tuple<StringType, std::size_t, std::string>;
+
+		std::vector<FoundString> scan(
+				const std::string &data,
+				CharacterEndianness endian = CharacterEndianness::Little,
+				std::size_t maxCount = 100)
+		{
+			std::vector<FoundString> result;
+			scanStrings(
+					reinterpret_cast<const unsigned char*>(data.data()),
+					data.size(),
+					endian,
+					4,
+					maxCount,
+					[&](StringType type, std::size_t offset, std::string&& content)
+					{
+						result.emplace_back(type, offset, std::move(content));
+					});
+			std::sort(result.begin(), result.end());
+			return result;
+		}
+};
+
+TEST_F(StringScannerTests, FindsAsciiStrings)
+{
+	const std::string data("\x01\x02hello\xff" "abc\x00world, long enough\x7f", 34);
+
+	EXPECT_EQ(
+		std::vector<FoundString>({
+			FoundString(StringType::Ascii, 2, "hello"),
+			FoundString(StringType::Ascii, 12, "world, long enough")
+		}),
+		scan(data)
+	);
+}
+
+TEST_F(StringScannerTests, FindsWideStringsAtEvenAndOddOffsets)
+{
+	const std::string data("t\0e\0s\0t\0\xff\xff\xff" "a\0b\0c\0d\0e\0\xff", 22);
+
+	EXPECT_EQ(
+		std::vector<FoundString>({
+			FoundString(StringType::Wide, 0, "test"),
+			FoundString(StringType::Wide, 11, "abcde")
+		}),
+		scan(data)
+	);
+}
+
+TEST_F(StringScannerTests, FindsBigEndianWideStrings)
+{
+	const std::string data("\xff\0t\0e\0s\0t\xff", 10);
+
+	EXPECT_EQ(
+		std::vector<FoundString>({
+			FoundString(StringType::Wide, 1, "test")
+		}),
+		scan(data, CharacterEndianness::Big)
+	);
+}
+
+TEST_F(StringScannerTests, WideCharacterAtEndOfDataIsNotComplete)
+{
+	const std::string data("a\0b\0c\0d", 7);
+
+	EXPECT_TRUE(scan(data).empty());
+}
+
+TEST_F(StringScannerTests, FindsStringsCrossingWordBoundaries)
+{
+	const std::string data =
+			std::string(13, '\xff') + std::string(40, 'x') + std::string(11, '\0');
+
+	EXPECT_EQ(
+		std::vector<FoundString>({
+			FoundString(StringType::Ascii, 13, std::string(40, 'x'))
+		}),
+		scan(data)
+	);
+}
+
+TEST_F(StringScannerTests, StopsWhenMaxCountIsReached)
+{
+	const std::string data("aaaa\xff" "bbbb\xff" "cccc\xff", 15);
+
+	EXPECT_EQ(2, scan(data, CharacterEndianness::Little, 2).size());
+}
+
+} // namespace tests
+} // namespace fileformat
+} // namespace retdec
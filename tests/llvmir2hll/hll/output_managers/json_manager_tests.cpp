@@ -247,6 +247,72 @@ TEST_F(JsonOutputManagerTests, address_push_and_pop_do_nothing)
 		emitSingleToken());
 }
 
+//
+// streaming
+//
+
+TEST_F(JsonOutputManagerTests, long_output_is_streamed_before_finalize)
+{
+	for (std::size_t i = 0; i < 10000; ++i)
+	{
+		manager->localVariableId("v" + std::to_string(i));
+		manager->newLine();
+	}
+	std::string streamed = codeStream.str();
+	std::string all = emitCode();
+
+	EXPECT_FALSE(streamed.empty());
+	EXPECT_TRUE(retdec::utils::startsWith(all, streamed));
+	EXPECT_TRUE(contains(all, R"({"kind":"i_lvar","val":"v0"},)"));
+	EXPECT_TRUE(contains(all, R"({"kind":"i_lvar","val":"v9999"},)"));
+	EXPECT_TRUE(retdec::utils::endsWith(all, R"(],"language":"C"})"));
+}
+
+//
+// compact format
+//
+
+class JsonCompactOutputManagerTests: public OutputManagerTests
+{
+	protected:
+		virtual void SetUp() override;
+};
+
+void JsonCompactOutputManagerTests::SetUp()
+{
+	OutputManagerTests::SetUp();
+	manager = UPtr<OutputManager>(new JsonOutputManagerPlain(codeStream, true));
+	manager->setCommentPrefix("//");
+	manager->setOutputLanguage("C");
+}
+
+TEST_F(JsonCompactOutputManagerTests, tokens_are_pairs_of_kind_index_and_value)
+{
+	manager->localVariableId("v");
+	manager->newLine();
+
+	std::string all = emitCode();
+
+	EXPECT_TRUE(retdec::utils::startsWith(all,
+		R"({"format":"compact","kinds":["nl","ws","punc","op","i_gvar","i_lvar",)"));
+	EXPECT_TRUE(retdec::utils::endsWith(all,
+		R"("tokens":[21,null,5,"v",0,"\n"],"language":"C"})"));
+}
+
+TEST_F(JsonCompactOutputManagerTests, addresses_are_delta_encoded)
+{
+	manager->addressPush(0x1000);
+	manager->localVariableId("v1");
+	manager->addressPush(0x1010);
+	manager->functionId("f");
+	manager->addressPop();
+	manager->localVariableId("v2");
+	manager->addressPop();
+
+	EXPECT_TRUE(retdec::utils::endsWith(emitCode(),
+		R"("tokens":[21,null,21,4096,5,"v1",21,16,8,"f",21,-16,5,"v2"],"language":"C"})"));
+}
+
 } // namespace tests
 } // namespace llvmir2hll
 } // namespace retdec
\ No newline at end of file
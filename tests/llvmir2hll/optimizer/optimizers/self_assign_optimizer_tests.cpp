@@ -16,6 +16,7 @@
 #include "retdec/llvmir2hll/ir/return_stmt.h"
 #include "llvmir2hll/ir/tests_with_module.h"
 #include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/optimizer/func_optimizer.h"
 #include "retdec/llvmir2hll/optimizer/optimizers/self_assign_optimizer.h"
 
 using namespace ::testing;
@@ -204,6 +205,43 @@ FuncWithJustSelfAssignIsOptimizedToEmptyBody) {
 		testFunc->getBody()->getSuccessor();
 }
 
+TEST_F(SelfAssignOptimizerTests,
+OptimizerIsFunctionLocal) {
+	ShPtr<SelfAssignOptimizer> optimizer(new SelfAssignOptimizer(module));
+
+	EXPECT_TRUE(optimizer->isFunctionLocal());
+}
+
+TEST_F(SelfAssignOptimizerTests,
+SelfAssignsOfGlobalVariableAreRemovedInAllFunctionsWhenRunInParallel) {
+	// Add several functions with the following body:
+	//
+	//   g = g
+	//   return
+	//
+	// where g is a global variable shared by all the functions.
+	ShPtr<Variable> varG(Variable::create("g", IntType::create(16)));
+	module->addGlobalVar(varG);
+	FuncVector funcs{testFunc};
+	for (int i = 0; i < 16; ++i) {
+		funcs.push_back(addFuncDef("f" + std::to_string(i)));
+	}
+	for (const auto &func : funcs) {
+		func->setBody(AssignStmt::create(varG, varG, ReturnStmt::create()));
+	}
+
+	// Optimize the module.
+	FuncOptimizer::optimizeInParallel<SelfAssignOptimizer>(4, module);
+
+	// Check that the output is correct.
+	for (const auto &func : funcs) {
+		ASSERT_TRUE(isa<ReturnStmt>(func->getBody())) <<
+			"expected ReturnStmt, got " << func->getBody();
+		EXPECT_TRUE(!func->getBody()->hasSuccessor()) <<
+			"expected no successor, got " << func->getBody()->getSuccessor();
+	}
+}
+
 } // namespace tests
 } // namespace llvmir2hll
 } // namespace retdec
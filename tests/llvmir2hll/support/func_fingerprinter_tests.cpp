@@ -0,0 +1,159 @@
+/**
+* @file tests/llvmir2hll/support/func_fingerprinter_tests.cpp
+* @brief Tests for the @c func_fingerprinter module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/ir/address_op_expr.h"
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/const_int.h"
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "retdec/llvmir2hll/ir/pointer_type.h"
+#include "retdec/llvmir2hll/ir/return_stmt.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/support/func_fingerprinter.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c func_fingerprinter module.
+*/
+class FuncFingerprinterTests: public TestsWithModule {};
+
+TEST_F(FuncFingerprinterTests,
+FingerprintOfUnchangedFunctionIsSame) {
+	// Add a body to the testing function:
+	//
+	//   a = 1
+	//   return
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	testFunc->addLocalVar(varA);
+	testFunc->setBody(AssignStmt::create(varA,
+		ConstInt::create(1, 32), ReturnStmt::create()));
+
+	EXPECT_EQ(FuncFingerprinter::getFingerprint(testFunc),
+		FuncFingerprinter::getFingerprint(testFunc));
+}
+
+TEST_F(FuncFingerprinterTests,
+FingerprintChangesWhenStatementIsModified) {
+	// Add a body to the testing function:
+	//
+	//   a = 1
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	testFunc->addLocalVar(varA);
+	ShPtr<AssignStmt> assignStmt(AssignStmt::create(varA,
+		ConstInt::create(1, 32)));
+	testFunc->setBody(assignStmt);
+	auto fingerprint = FuncFingerprinter::getFingerprint(testFunc);
+
+	// a = 2
+	assignStmt->setRhs(ConstInt::create(2, 32));
+
+	EXPECT_NE(fingerprint, FuncFingerprinter::getFingerprint(testFunc));
+}
+
+TEST_F(FuncFingerprinterTests,
+FingerprintChangesWhenStatementIsRemoved) {
+	// Add a body to the testing function:
+	//
+	//   a = 1
+	//   return
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	testFunc->addLocalVar(varA);
+	ShPtr<ReturnStmt> returnStmt(ReturnStmt::create());
+	testFunc->setBody(AssignStmt::create(varA,
+		ConstInt::create(1, 32), returnStmt));
+	auto fingerprint = FuncFingerprinter::getFingerprint(testFunc);
+
+	// return
+	testFunc->setBody(returnStmt);
+
+	EXPECT_NE(fingerprint, FuncFingerprinter::getFingerprint(testFunc));
+}
+
+TEST_F(FuncFingerprinterTests,
+AddressedVarsAreCollected) {
+	// Add a body to the testing function:
+	//
+	//   p = &a
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	ShPtr<Variable> varP(Variable::create("p",
+		PointerType::create(IntType::create(32))));
+	testFunc->addLocalVar(varA);
+	testFunc->addLocalVar(varP);
+	testFunc->setBody(AssignStmt::create(varP, AddressOpExpr::create(varA)));
+
+	VarSet addressedVars;
+	FuncFingerprinter::getFingerprint(testFunc, &addressedVars);
+
+	EXPECT_EQ(VarSet({varA}), addressedVars);
+}
+
+TEST_F(FuncFingerprinterTests,
+ModuleFingerprintChangesWhenAddressOfVariableIsNoLongerTaken) {
+	// Add a body to the testing function:
+	//
+	//   p = &g
+	//
+	// where g is a global variable.
+	ShPtr<Variable> varG(Variable::create("g", IntType::create(32)));
+	ShPtr<Variable> varP(Variable::create("p",
+		PointerType::create(IntType::create(32))));
+	module->addGlobalVar(varG);
+	testFunc->addLocalVar(varP);
+	ShPtr<AssignStmt> assignStmt(AssignStmt::create(varP,
+		AddressOpExpr::create(varG)));
+	testFunc->setBody(assignStmt);
+	auto fingerprint = FuncFingerprinter::getModuleFingerprint(module);
+
+	// p = 0
+	assignStmt->setRhs(ConstInt::create(0, 32));
+
+	EXPECT_NE(fingerprint, FuncFingerprinter::getModuleFingerprint(module));
+}
+
+TEST_F(FuncFingerprinterTests,
+ModuleFingerprintChangesWhenFunctionBecomesDeclaration) {
+	// Add a body to the testing function:
+	//
+	//   return
+	//
+	testFunc->setBody(ReturnStmt::create());
+	auto fingerprint = FuncFingerprinter::getModuleFingerprint(module);
+
+	testFunc->convertToDeclaration();
+
+	EXPECT_NE(fingerprint, FuncFingerprinter::getModuleFingerprint(module));
+}
+
+TEST_F(FuncFingerprinterTests,
+ModuleFingerprintProvidesFingerprintsOfDefinedFunctions) {
+	// Add a body to the testing function:
+	//
+	//   return
+	//
+	testFunc->setBody(ReturnStmt::create());
+
+	FuncFingerprinter::FuncFingerprints funcFingerprints;
+	FuncFingerprinter::getModuleFingerprint(module, &funcFingerprints);
+
+	ASSERT_EQ(1, funcFingerprints.size());
+	EXPECT_EQ(FuncFingerprinter::getFingerprint(testFunc),
+		funcFingerprints[testFunc]);
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
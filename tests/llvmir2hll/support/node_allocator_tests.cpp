@@ -0,0 +1,161 @@
+/**
+* @file tests/llvmir2hll/support/node_allocator_tests.cpp
+* @brief Tests for the @c node_allocator module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/support/node_allocator.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c node_allocator module.
+*/
+class NodeAllocatorTests: public Test {};
+
+TEST_F(NodeAllocatorTests,
+FreedNodeIsReusedForNodeOfSameSize) {
+	void *ptr = NodeAllocator::allocate(40);
+	NodeAllocator::deallocate(ptr, 40);
+
+	EXPECT_EQ(ptr, NodeAllocator::allocate(40));
+	NodeAllocator::deallocate(ptr, 40);
+}
+
+TEST_F(NodeAllocatorTests,
+NodesAreDistinctAndAligned) {
+	std::vector<void *> nodes;
+	for (std::size_t size = 1; size <= NodeAllocator::maxPooledSize; ++size) {
+		void *ptr = NodeAllocator::allocate(size);
+		EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(ptr) %
+			alignof(std::max_align_t));
+		nodes.push_back(ptr);
+		// Nodes allocated earlier must not be overwritten.
+		std::fill_n(static_cast<unsigned char *>(ptr), size, size % 256);
+	}
+
+	for (std::size_t size = 1; size <= NodeAllocator::maxPooledSize; ++size) {
+		auto bytes = static_cast<unsigned char *>(nodes[size - 1]);
+		EXPECT_EQ(std::size_t(0), std::count_if(bytes, bytes + size,
+			[&](unsigned char b) { return b != size % 256; }));
+		NodeAllocator::deallocate(bytes, size);
+	}
+}
+
+TEST_F(NodeAllocatorTests,
+BigNodesAreNotPooled) {
+	const std::size_t reservedBytes = NodeAllocator::getReservedBytes();
+
+	void *ptr = NodeAllocator::allocate(NodeAllocator::chunkSize);
+	EXPECT_EQ(reservedBytes, NodeAllocator::getReservedBytes());
+	NodeAllocator::deallocate(ptr, NodeAllocator::chunkSize);
+}
+
+TEST_F(NodeAllocatorTests,
+NodesFreedByOtherThreadsAreReused) {
+	std::vector<void *> nodes(10000);
+	for (auto &ptr : nodes) {
+		ptr = NodeAllocator::allocate(100);
+	}
+	std::thread([&]() {
+		for (auto ptr : nodes) {
+			NodeAllocator::deallocate(ptr, 100);
+		}
+	}).join();
+	const std::size_t reservedBytes = NodeAllocator::getReservedBytes();
+
+	for (auto &ptr : nodes) {
+		ptr = NodeAllocator::allocate(100);
+	}
+	EXPECT_EQ(reservedBytes, NodeAllocator::getReservedBytes());
+	for (auto ptr : nodes) {
+		NodeAllocator::deallocate(ptr, 100);
+	}
+}
+
+TEST_F(NodeAllocatorTests,
+NodesAreAllocatedFromCurrentArena) {
+	const std::size_t defaultReservedBytes = NodeAllocator::getReservedBytes();
+	NodeArena arena;
+	std::vector<void *> nodes(10000);
+	{
+		NodeArena::Scope scope(&arena);
+		EXPECT_EQ(&arena, NodeArena::getCurrent());
+		for (auto &ptr : nodes) {
+			ptr = NodeAllocator::allocate(100);
+		}
+		EXPECT_EQ(arena.getReservedBytes(), NodeAllocator::getReservedBytes());
+	}
+
+	EXPECT_EQ(nullptr, NodeArena::getCurrent());
+	EXPECT_LE(nodes.size() * 100, arena.getReservedBytes());
+	EXPECT_EQ(defaultReservedBytes, NodeAllocator::getReservedBytes());
+	for (auto ptr : nodes) {
+		NodeAllocator::deallocate(ptr, 100);
+	}
+}
+
+TEST_F(NodeAllocatorTests,
+NodesFreedIntoArenaAreReusedByItsOtherThreads) {
+	NodeArena arena;
+	std::vector<void *> nodes(10000);
+	{
+		NodeArena::Scope scope(&arena);
+		for (auto &ptr : nodes) {
+			ptr = NodeAllocator::allocate(100);
+		}
+		for (auto ptr : nodes) {
+			NodeAllocator::deallocate(ptr, 100);
+		}
+	}
+	const std::size_t reservedBytes = arena.getReservedBytes();
+
+	std::thread([&]() {
+		NodeArena::Scope scope(&arena);
+		for (auto &ptr : nodes) {
+			ptr = NodeAllocator::allocate(100);
+		}
+		for (auto ptr : nodes) {
+			NodeAllocator::deallocate(ptr, 100);
+		}
+	}).join();
+	EXPECT_EQ(reservedBytes, arena.getReservedBytes());
+}
+
+TEST_F(NodeAllocatorTests,
+NodesMayBeFreedAfterTheirArenaIsDestroyed) {
+	std::vector<void *> nodes(10000);
+	{
+		NodeArena arena;
+		NodeArena::Scope scope(&arena);
+		for (auto &ptr : nodes) {
+			ptr = NodeAllocator::allocate(64);
+		}
+		// Free every other node before the arena is destroyed.
+		for (std::size_t i = 0; i < nodes.size(); i += 2) {
+			NodeAllocator::deallocate(nodes[i], 64);
+		}
+	}
+
+	for (std::size_t i = 1; i < nodes.size(); i += 2) {
+		// The remaining nodes are still usable.
+		std::fill_n(static_cast<unsigned char *>(nodes[i]), 64, 0xAB);
+		NodeAllocator::deallocate(nodes[i], 64);
+	}
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -403,6 +403,93 @@ GetRawDataWithNoDataSegmentWorks) {
 	EXPECT_EQ(0, rawData.second);
 }
 
+TEST_F(SegmentTests,
+ReadBytesWorks) {
+	std::vector<std::uint8_t> mockFileData = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 };
+
+	Segment seg(nullptr, 0x1000, 0x100, makeDataSource(mockFileData));
+
+	std::uint8_t loaded[4] = {};
+
+	EXPECT_TRUE(seg.readBytes(2, 4, loaded));
+	EXPECT_EQ(0x12, loaded[0]);
+	EXPECT_EQ(0x13, loaded[1]);
+	EXPECT_EQ(0x14, loaded[2]);
+	EXPECT_EQ(0x15, loaded[3]);
+}
+
+TEST_F(SegmentTests,
+ReadBytesBeyondPhysicalDataReadsZeroes) {
+	std::vector<std::uint8_t> mockFileData = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 };
+
+	Segment seg(nullptr, 0x1000, 0x100, makeDataSource(mockFileData));
+
+	std::uint8_t loaded[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+	EXPECT_TRUE(seg.readBytes(5, 4, loaded));
+	EXPECT_EQ(0x15, loaded[0]);
+	EXPECT_EQ(0x16, loaded[1]);
+	EXPECT_EQ(0x00, loaded[2]);
+	EXPECT_EQ(0x00, loaded[3]);
+}
+
+TEST_F(SegmentTests,
+ReadBytesBeyondSegmentEndFails) {
+	std::vector<std::uint8_t> mockFileData = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 };
+
+	Segment seg(nullptr, 0x1000, mockFileData.size(), makeDataSource(mockFileData));
+
+	std::uint8_t loaded[4] = {};
+
+	EXPECT_FALSE(seg.readBytes(4, 4, loaded));
+	EXPECT_FALSE(seg.readBytes(7, 1, loaded));
+}
+
+TEST_F(SegmentTests,
+ReadWorks) {
+	std::vector<std::uint8_t> mockFileData = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 };
+
+	Segment seg(nullptr, 0x1000, 0x100, makeDataSource(mockFileData));
+
+	std::uint32_t little = 0;
+	std::uint32_t big = 0;
+	std::uint16_t halfWithZeroes = 0;
+	std::uint8_t byte = 0;
+
+	EXPECT_TRUE(seg.read(1, little, retdec::utils::Endianness::LITTLE));
+	EXPECT_TRUE(seg.read(1, big, retdec::utils::Endianness::BIG));
+	EXPECT_TRUE(seg.read(6, halfWithZeroes, retdec::utils::Endianness::BIG));
+	EXPECT_TRUE(seg.read(3, byte, retdec::utils::Endianness::LITTLE));
+	EXPECT_EQ(0x14131211, little);
+	EXPECT_EQ(0x11121314, big);
+	EXPECT_EQ(0x1600, halfWithZeroes);
+	EXPECT_EQ(0x13, byte);
+}
+
+TEST_F(SegmentTests,
+ReadWithUnknownEndiannessFails) {
+	std::vector<std::uint8_t> mockFileData = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 };
+
+	Segment seg(nullptr, 0x1000, 0x100, makeDataSource(mockFileData));
+
+	std::uint32_t value = 0;
+
+	EXPECT_FALSE(seg.read(0, value, retdec::utils::Endianness::UNKNOWN));
+}
+
+TEST_F(SegmentTests,
+SetBytesFromPointerWorks) {
+	std::vector<std::uint8_t> mockFileData = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 };
+
+	Segment seg(nullptr, 0x1000, mockFileData.size(), makeDataSource(mockFileData));
+
+	std::uint8_t value[] = { 0x20, 0x21, 0x22 };
+	std::vector<std::uint8_t> expected = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x20, 0x21 };
+
+	EXPECT_TRUE(seg.setBytes(value, 3, 5));
+	EXPECT_EQ(expected, mockFileData);
+}
+
 } // namespace loader
 } // namespace retdec
 } // namespace tests
@@ -0,0 +1,280 @@
+/**
+* @file tests/pelib/image_loader_tests.cpp
+* @brief Tests for the @c ImageLoader module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <cstring>
+#include <memory>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "retdec/pelib/ImageLoader.h"
+
+using namespace ::testing;
+
+namespace PeLib {
+namespace tests {
+
+/**
+ * Tests for the @c PELIB_FILE_PAGE structure.
+ */
+class FilePageTests : public Test
+{
+	protected:
+		/// Page content read by the page.
+		ByteBuffer read(const PELIB_FILE_PAGE & page)
+		{
+			ByteBuffer ret(PELIB_PAGE_SIZE, 0xCC);
+			page.readFromPage(ret.data(), 0, ret.size());
+			return ret;
+		}
+};
+
+TEST_F(FilePageTests,
+PartialPageIsPaddedWithZeros)
+{
+	ByteBuffer data(100, 0xAB);
+	PELIB_FILE_PAGE page;
+
+	page.setValidPage(data.data(), data.size());
+
+	auto content = read(page);
+	EXPECT_EQ(ByteBuffer(content.begin(), content.begin() + 100), data);
+	EXPECT_EQ(
+		ByteBuffer(content.begin() + 100, content.end()),
+		ByteBuffer(PELIB_PAGE_SIZE - 100, 0)
+	);
+}
+
+TEST_F(FilePageTests,
+ReadAcrossEndOfValidDataIsPaddedWithZeros)
+{
+	ByteBuffer data = {1, 2, 3, 4};
+	PELIB_FILE_PAGE page;
+	page.setValidPage(data.data(), data.size());
+	std::uint8_t buffer[4] = {0xCC, 0xCC, 0xCC, 0xCC};
+
+	page.readFromPage(buffer, 2, sizeof(buffer));
+
+	EXPECT_EQ(ByteBuffer(buffer, buffer + 4), ByteBuffer({3, 4, 0, 0}));
+}
+
+TEST_F(FilePageTests,
+WriteMakesPrivateCopyOfSharedData)
+{
+	ByteBuffer data(100, 0xAB);
+	PELIB_FILE_PAGE page;
+	page.setValidPage(data.data(), data.size());
+	std::uint8_t value = 0x11;
+
+	page.writeToPage(&value, 10, 1);
+
+	EXPECT_EQ(data, ByteBuffer(100, 0xAB));
+	EXPECT_NE(page.getData(), data.data());
+	auto content = read(page);
+	EXPECT_EQ(content[9], 0xAB);
+	EXPECT_EQ(content[10], 0x11);
+	EXPECT_EQ(content[100], 0);
+}
+
+TEST_F(FilePageTests,
+WriteIntoZeroPageKeepsRestOfPageZero)
+{
+	PELIB_FILE_PAGE page;
+	page.setZeroPage();
+	std::uint8_t value = 0x11;
+
+	page.writeToPage(&value, 10, 1);
+
+	auto content = read(page);
+	EXPECT_EQ(content[10], 0x11);
+	content[10] = 0;
+	EXPECT_EQ(content, ByteBuffer(PELIB_PAGE_SIZE, 0));
+}
+
+/**
+ * Tests for the @c ImageLoader class on a minimal 32-bit image.
+ *
+ * The image has one section at RVA @c 0x1000 with two pages. Only the first
+ * @c 0x200 bytes of the section are in the file, the rest of its first page
+ * is padded with zeros and its second page is a zero page.
+ */
+class ImageLoaderTests : public Test
+{
+	protected:
+		static constexpr std::uint32_t IMAGE_BASE = 0x400000;
+		static constexpr std::uint32_t SECTION_RVA = 0x1000;
+		static constexpr std::uint32_t SECTION_OFFSET = 0x200;
+		static constexpr std::uint32_t SECTION_RAW_SIZE = 0x200;
+		/// RVA of a pointer fixed up by the relocations.
+		static constexpr std::uint32_t POINTER_RVA = SECTION_RVA + 0x10;
+		/// RVA of the relocations.
+		static constexpr std::uint32_t RELOCS_RVA = SECTION_RVA + 0x100;
+		/// RVA of a string which ends exactly at the end of the file data.
+		static constexpr std::uint32_t STRING_RVA = SECTION_RVA + 0x1F0;
+
+		ImageLoaderTests() : file(SECTION_OFFSET + SECTION_RAW_SIZE, 0)
+		{
+			// DOS header
+			put16(0x00, 0x5A4D);                  // e_magic
+			put32(0x3C, 0x40);                    // e_lfanew
+
+			// NT headers
+			put32(0x40, 0x00004550);              // Signature
+			put16(0x44, 0x014C);                  // Machine (i386)
+			put16(0x46, 1);                       // NumberOfSections
+			put16(0x54, 0xE0);                    // SizeOfOptionalHeader
+			put16(0x56, 0x0102);                  // Characteristics
+			put16(0x58, 0x010B);                  // Magic (PE32)
+			put32(0x68, SECTION_RVA);             // AddressOfEntryPoint
+			put32(0x74, IMAGE_BASE);              // ImageBase
+			put32(0x78, 0x1000);                  // SectionAlignment
+			put32(0x7C, 0x200);                   // FileAlignment
+			put16(0x80, 4);                       // MajorOperatingSystemVersion
+			put16(0x88, 4);                       // MajorSubsystemVersion
+			put32(0x90, 0x3000);                  // SizeOfImage
+			put32(0x94, 0x200);                   // SizeOfHeaders
+			put16(0x9C, 2);                       // Subsystem (GUI)
+			put32(0xA0, 0x100000);                // SizeOfStackReserve
+			put32(0xA4, 0x1000);                  // SizeOfStackCommit
+			put32(0xA8, 0x100000);                // SizeOfHeapReserve
+			put32(0xAC, 0x1000);                  // SizeOfHeapCommit
+			put32(0xB4, 16);                      // NumberOfRvaAndSizes
+			put32(0xB8 + 5 * 8, RELOCS_RVA);      // Base relocations
+			put32(0xBC + 5 * 8, 12);
+
+			// Section header
+			std::memcpy(file.data() + 0x138, ".text", 5);
+			put32(0x140, 0x2000);                 // VirtualSize
+			put32(0x144, SECTION_RVA);            // VirtualAddress
+			put32(0x148, SECTION_RAW_SIZE);       // SizeOfRawData
+			put32(0x14C, SECTION_OFFSET);         // PointerToRawData
+			put32(0x15C, 0xE0000020);             // Characteristics
+
+			// Section data
+			toFile(POINTER_RVA, [&](std::size_t o) {
+				put32(o, IMAGE_BASE + 0x1020);
+			});
+			toFile(RELOCS_RVA, [&](std::size_t o) {
+				put32(o, SECTION_RVA);            // VirtualAddress of the block
+				put32(o + 4, 12);                 // SizeOfBlock
+				put16(o + 8, (3 << 12) | (POINTER_RVA - SECTION_RVA));
+				put16(o + 10, 0);                 // Padding
+			});
+			toFile(STRING_RVA, [&](std::size_t o) {
+				std::memset(file.data() + o, 'a', SECTION_RAW_SIZE - (STRING_RVA - SECTION_RVA));
+			});
+		}
+
+		void put16(std::size_t offset, std::uint16_t value)
+		{
+			file[offset] = value & 0xFF;
+			file[offset + 1] = value >> 8;
+		}
+
+		void put32(std::size_t offset, std::uint32_t value)
+		{
+			put16(offset, value & 0xFFFF);
+			put16(offset + 2, value >> 16);
+		}
+
+		template <typename Writer>
+		void toFile(std::uint32_t rva, Writer write)
+		{
+			write(rva - SECTION_RVA + SECTION_OFFSET);
+		}
+
+		std::uint32_t read32(ImageLoader & loader, std::uint32_t rva)
+		{
+			std::uint8_t bytes[4] = {};
+			EXPECT_EQ(loader.readImage(bytes, rva, sizeof(bytes)), sizeof(bytes));
+			return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24);
+		}
+
+		/// Content of the input file.
+		ByteBuffer file;
+};
+
+TEST_F(ImageLoaderTests,
+ImageIsLoaded)
+{
+	ImageLoader loader;
+
+	ASSERT_EQ(loader.Load(file), ERROR_NONE);
+	EXPECT_EQ(loader.getSizeOfImage(), 0x3000);
+	EXPECT_EQ(loader.getNumberOfSections(), 1);
+	EXPECT_EQ(read32(loader, POINTER_RVA), IMAGE_BASE + 0x1020);
+}
+
+TEST_F(ImageLoaderTests,
+PartialLastPageOfSectionIsReadAsZeroPadded)
+{
+	ImageLoader loader;
+	ASSERT_EQ(loader.Load(file), ERROR_NONE);
+	ByteBuffer content(0x20, 0xCC);
+
+	ASSERT_EQ(loader.readImage(content.data(), STRING_RVA, content.size()), content.size());
+
+	EXPECT_EQ(ByteBuffer(content.begin(), content.begin() + 0x10), ByteBuffer(0x10, 'a'));
+	EXPECT_EQ(ByteBuffer(content.begin() + 0x10, content.end()), ByteBuffer(0x10, 0));
+}
+
+TEST_F(ImageLoaderTests,
+StringEndsAtEndOfValidDataOfPage)
+{
+	ImageLoader loader;
+	ASSERT_EQ(loader.Load(file), ERROR_NONE);
+
+	EXPECT_EQ(loader.stringLength(STRING_RVA), 0x10);
+	EXPECT_EQ(loader.stringLength(STRING_RVA, 8), 8);
+	EXPECT_EQ(loader.stringLength(SECTION_RVA + SECTION_RAW_SIZE), 0);
+	EXPECT_EQ(loader.stringLength(SECTION_RVA + 0x1000), 0);
+}
+
+TEST_F(ImageLoaderTests,
+RelocationMakesPrivateCopyOfPageAndKeepsInputUnchanged)
+{
+	const ByteBuffer original = file;
+	ImageLoader loader;
+	ASSERT_EQ(loader.Load(file), ERROR_NONE);
+
+	ASSERT_TRUE(loader.relocateImage(0x500000));
+
+	EXPECT_EQ(read32(loader, 0x74), 0x500000);                 // ImageBase in the mapped header
+	EXPECT_EQ(read32(loader, POINTER_RVA), 0x500000 + 0x1020);
+	EXPECT_EQ(file, original);
+}
+
+TEST_F(ImageLoaderTests,
+WriteIntoZeroPageIsReadBack)
+{
+	ImageLoader loader;
+	ASSERT_EQ(loader.Load(file), ERROR_NONE);
+	std::uint8_t value[4] = {1, 2, 3, 4};
+
+	ASSERT_EQ(loader.writeImage(value, SECTION_RVA + 0x1010, sizeof(value)), sizeof(value));
+
+	EXPECT_EQ(read32(loader, SECTION_RVA + 0x1010), 0x04030201);
+	EXPECT_EQ(read32(loader, SECTION_RVA + 0x100C), 0);
+	EXPECT_EQ(read32(loader, SECTION_RVA + 0x1014), 0);
+}
+
+TEST_F(ImageLoaderTests,
+CopyOfStreamLoadedImageStaysValid)
+{
+	std::unique_ptr<ImageLoader> copy;
+	{
+		std::istringstream stream(std::string(file.begin(), file.end()));
+		ImageLoader loader;
+		ASSERT_EQ(loader.Load(stream), ERROR_NONE);
+		copy = std::make_unique<ImageLoader>(loader);
+	}
+
+	EXPECT_EQ(read32(*copy, POINTER_RVA), IMAGE_BASE + 0x1020);
+	EXPECT_EQ(copy->stringLength(STRING_RVA), 0x10);
+}
+
+} // namespace tests
+} // namespace PeLib
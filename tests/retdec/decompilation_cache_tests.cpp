@@ -0,0 +1,250 @@
+/**
+* @file tests/retdec/decompilation_cache_tests.cpp
+* @brief Tests for the @c decompilation_cache module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <fstream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "retdec/retdec/decompilation_cache.h"
+#include "retdec/utils/filesystem.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace tests {
+
+/**
+ * Tests for the @c decompilation_cache module.
+ */
+class DecompilationCacheTests : public Test
+{
+	protected:
+		void SetUp() override
+		{
+			dir = fs::temp_directory_path()
+					/ ("retdec-decompilation-cache-tests-"
+						+ std::to_string(std::random_device()()));
+			fs::create_directories(dir);
+		}
+
+		void TearDown() override
+		{
+			std::error_code ec;
+			fs::remove_all(dir, ec);
+		}
+
+		/// Writes @a content into the file @a name in @c dir.
+		std::string writeFile(
+				const std::string& name,
+				const std::string& content)
+		{
+			auto path = (dir / name).string();
+			std::ofstream out(path, std::ios::binary);
+			out << content;
+			return path;
+		}
+
+		DecompilationCache::Entry createEntry()
+		{
+			DecompilationCache::Entry entry;
+			entry.configHash = "config";
+			entry.output = "int f(void) {\n\treturn \"\\\"\";\n}\n";
+			return entry;
+		}
+
+		/// Directory with files of a test.
+		fs::path dir;
+};
+
+//
+// load(), save()
+//
+
+TEST_F(DecompilationCacheTests,
+SavedEntryIsLoaded)
+{
+	DecompilationCache cache((dir / "cache").string());
+	auto saved = createEntry();
+
+	cache.save("key", saved);
+	DecompilationCache::Entry loaded;
+
+	ASSERT_TRUE(cache.load("key", loaded));
+	EXPECT_EQ(saved.configHash, loaded.configHash);
+	EXPECT_EQ(saved.output, loaded.output);
+}
+
+TEST_F(DecompilationCacheTests,
+SavedEntryReplacesPreviousEntryWithSameKey)
+{
+	DecompilationCache cache(dir.string());
+	auto first = createEntry();
+	auto second = createEntry();
+	second.configHash = "other config";
+	second.output = "int g(void) {}\n";
+
+	cache.save("key", first);
+	cache.save("key", second);
+	DecompilationCache::Entry loaded;
+
+	ASSERT_TRUE(cache.load("key", loaded));
+	EXPECT_EQ(second.configHash, loaded.configHash);
+	EXPECT_EQ(second.output, loaded.output);
+}
+
+TEST_F(DecompilationCacheTests,
+LoadOfMissingEntryFails)
+{
+	DecompilationCache cache(dir.string());
+	cache.save("key", createEntry());
+	DecompilationCache::Entry loaded;
+
+	EXPECT_FALSE(cache.load("other-key", loaded));
+}
+
+TEST_F(DecompilationCacheTests,
+LoadOfCorruptedEntryFails)
+{
+	DecompilationCache cache(dir.string());
+	writeFile("key.json", "{\"configHash\": \"config\", \"output\": ");
+	DecompilationCache::Entry loaded;
+
+	EXPECT_FALSE(cache.load("key", loaded));
+}
+
+TEST_F(DecompilationCacheTests,
+NothingIsCachedWithoutDirectoryOrKey)
+{
+	DecompilationCache disabled("");
+	DecompilationCache cache(dir.string());
+	DecompilationCache::Entry loaded;
+
+	disabled.save("key", createEntry());
+	cache.save("", createEntry());
+
+	EXPECT_FALSE(disabled.load("key", loaded));
+	EXPECT_FALSE(cache.load("", loaded));
+	EXPECT_TRUE(fs::is_empty(dir));
+}
+
+//
+// computeKey()
+//
+
+TEST_F(DecompilationCacheTests,
+KeyDependsOnlyOnContentOfInput)
+{
+	auto a = writeFile("a", "content");
+	auto b = writeFile("b", "content");
+	auto c = writeFile("c", "Content");
+
+	EXPECT_EQ(
+		DecompilationCache::computeKey(a),
+		DecompilationCache::computeKey(b)
+	);
+	EXPECT_NE(
+		DecompilationCache::computeKey(a),
+		DecompilationCache::computeKey(c)
+	);
+}
+
+TEST_F(DecompilationCacheTests,
+KeyOfInputBiggerThanReadChunkDependsOnAllItsBytes)
+{
+	std::string content(200 * 1024, 'x');
+	auto a = writeFile("a", content);
+	auto b = writeFile("b", content);
+	content.back() = 'y';
+	auto c = writeFile("c", content);
+
+	EXPECT_EQ(
+		DecompilationCache::computeKey(a),
+		DecompilationCache::computeKey(b)
+	);
+	EXPECT_NE(
+		DecompilationCache::computeKey(a),
+		DecompilationCache::computeKey(c)
+	);
+}
+
+TEST_F(DecompilationCacheTests,
+KeyIsSameInAllBuilds)
+{
+	// Both FNV-1a bases, nothing hashed into them.
+	EXPECT_EQ(
+		"cbf29ce48422232584222325cbf29ce4",
+		DecompilationCache::computeKey(writeFile("empty", ""))
+	);
+}
+
+TEST_F(DecompilationCacheTests,
+KeyOfMissingInputIsEmpty)
+{
+	EXPECT_EQ("", DecompilationCache::computeKey((dir / "none").string()));
+}
+
+//
+// computeConfigHash()
+//
+
+TEST_F(DecompilationCacheTests,
+ConfigHashOfSameConfigsIsSame)
+{
+	config::Config c1;
+	c1.functions.insert(common::Function("f"));
+	config::Config c2 = c1;
+
+	EXPECT_EQ(
+		DecompilationCache::computeConfigHash(c1),
+		DecompilationCache::computeConfigHash(c2)
+	);
+}
+
+TEST_F(DecompilationCacheTests,
+ConfigHashDependsOnParameters)
+{
+	config::Config c1;
+	config::Config c2;
+	c2.parameters.setOutputFormat("json");
+
+	EXPECT_NE(
+		DecompilationCache::computeConfigHash(c1),
+		DecompilationCache::computeConfigHash(c2)
+	);
+}
+
+TEST_F(DecompilationCacheTests,
+ConfigHashDependsOnFunctions)
+{
+	config::Config c1;
+	c1.functions.insert(common::Function("f"));
+	config::Config c2;
+	common::Function f("f");
+	f.setComment("changed");
+	c2.functions.insert(f);
+
+	EXPECT_NE(
+		DecompilationCache::computeConfigHash(c1),
+		DecompilationCache::computeConfigHash(c2)
+	);
+}
+
+TEST_F(DecompilationCacheTests,
+ConfigHashDependsOnSelections)
+{
+	config::Config c1;
+	config::Config c2;
+	c2.parameters.selectedFunctions.insert("f");
+
+	EXPECT_NE(
+		DecompilationCache::computeConfigHash(c1),
+		DecompilationCache::computeConfigHash(c2)
+	);
+}
+
+} // namespace tests
+} // namespace retdec
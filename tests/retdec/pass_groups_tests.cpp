@@ -0,0 +1,202 @@
+/**
+* @file tests/retdec/pass_groups_tests.cpp
+* @brief Tests for the @c pass_groups module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/retdec/pass_groups.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace tests {
+
+/**
+ * Tests for the @c pass_groups module.
+ */
+class PassGroupsTests : public Test
+{
+	protected:
+		/// Groups as (begin, end, repeats) triples.
+		std::vector<std::vector<std::size_t>> split(
+				const std::vector<std::string>& passes,
+				bool fixedPoint = true)
+		{
+			std::vector<std::vector<std::size_t>> ret;
+			for (auto& g : splitPasses(passes, fixedPoint))
+			{
+				ret.push_back({g.begin, g.end, g.repeats});
+			}
+			return ret;
+		}
+
+		/// Runs of groups made by runPassGroups(), by indexes of groups.
+		std::vector<std::size_t> runs;
+		/// Last flags of the runs.
+		std::vector<bool> lasts;
+
+		/**
+		 * Run @a groups whose i-th group changes the module in its first
+		 * @c changes[i] runs.
+		 */
+		bool run(
+				const std::vector<PassGroup>& groups,
+				const std::vector<std::size_t>& changes,
+				const std::function<bool()>& isOverBudget = [](){ return false; })
+		{
+			std::vector<std::size_t> counts(groups.size(), 0);
+			return runPassGroups(
+					groups,
+					[&](const PassGroup& g, bool last)
+					{
+						auto i = static_cast<std::size_t>(&g - groups.data());
+						runs.push_back(i);
+						lasts.push_back(last);
+						return counts[i]++ < changes[i];
+					},
+					isOverBudget
+			);
+		}
+};
+
+//
+// splitPasses()
+//
+
+TEST_F(PassGroupsTests,
+AllPassesAreInOneGroupWithoutFixedPoint)
+{
+	EXPECT_EQ(
+			(std::vector<std::vector<std::size_t>>{{0, 4, 1}}),
+			split({"a", "b", "a", "b"}, false)
+	);
+}
+
+TEST_F(PassGroupsTests,
+PassesWithoutRepetitionsAreInOneGroupRunOnce)
+{
+	EXPECT_EQ(
+			(std::vector<std::vector<std::size_t>>{{0, 3, 1}}),
+			split({"a", "b", "c"})
+	);
+}
+
+TEST_F(PassGroupsTests,
+EmptyPipelineHasNoGroupsWithFixedPoint)
+{
+	EXPECT_TRUE(split({}).empty());
+}
+
+TEST_F(PassGroupsTests,
+RepeatedSequenceIsGroupWithNumberOfItsRepetitions)
+{
+	EXPECT_EQ(
+			(std::vector<std::vector<std::size_t>>{
+					{0, 1, 1},
+					{1, 3, 3},
+					{7, 8, 1}}),
+			split({"x", "a", "b", "a", "b", "a", "b", "y"})
+	);
+}
+
+TEST_F(PassGroupsTests,
+RepeatedPassIsGroupOfOnePass)
+{
+	EXPECT_EQ(
+			(std::vector<std::vector<std::size_t>>{
+					{0, 1, 3},
+					{3, 4, 1},
+					{4, 5, 2}}),
+			split({"a", "a", "a", "b", "c", "c"})
+	);
+}
+
+TEST_F(PassGroupsTests,
+LongestRepeatedSequenceWins)
+{
+	EXPECT_EQ(
+			(std::vector<std::vector<std::size_t>>{{0, 2, 2}}),
+			split({"a", "a", "a", "a"})
+	);
+}
+
+//
+// runPassGroups()
+//
+
+TEST_F(PassGroupsTests,
+GroupRunOnceIsRunOnceAsLastRun)
+{
+	std::vector<PassGroup> groups = {{0, 3, 1}};
+
+	EXPECT_FALSE(run(groups, {1}));
+
+	EXPECT_EQ(std::vector<std::size_t>({0}), runs);
+	EXPECT_EQ(std::vector<bool>({true}), lasts);
+}
+
+TEST_F(PassGroupsTests,
+UnchangedGroupIsNotRepeated)
+{
+	std::vector<PassGroup> groups = {{0, 2, 5}, {2, 3, 1}};
+
+	run(groups, {0, 0});
+
+	EXPECT_EQ(std::vector<std::size_t>({0, 1}), runs);
+}
+
+TEST_F(PassGroupsTests,
+ChangedGroupIsRepeatedUntilItDoesNotChangeModule)
+{
+	std::vector<PassGroup> groups = {{0, 2, 5}, {2, 3, 4}};
+
+	run(groups, {2, 1});
+
+	EXPECT_EQ(std::vector<std::size_t>({0, 0, 0, 1, 1}), runs);
+	EXPECT_EQ(std::vector<bool>({false, false, false, false, false}), lasts);
+}
+
+TEST_F(PassGroupsTests,
+AlwaysChangedGroupIsRunNumberOfItsRepetitions)
+{
+	std::vector<PassGroup> groups = {{0, 2, 3}};
+
+	run(groups, {100});
+
+	EXPECT_EQ(std::vector<std::size_t>({0, 0, 0}), runs);
+	EXPECT_EQ(std::vector<bool>({false, false, true}), lasts);
+}
+
+TEST_F(PassGroupsTests,
+RepetitionsAreSkippedOverBudgetButFirstRunsAreDone)
+{
+	std::vector<PassGroup> groups = {{0, 1, 3}, {1, 2, 1}, {2, 3, 3}};
+	std::size_t budgetChecks = 0;
+
+	EXPECT_TRUE(run(groups, {100, 100, 100}, [&]()
+	{
+		// Only the first repetition fits into the budget.
+		return ++budgetChecks > 1;
+	}));
+
+	EXPECT_EQ(std::vector<std::size_t>({0, 0, 1, 2}), runs);
+}
+
+TEST_F(PassGroupsTests,
+BudgetIsNotCheckedWithoutRepetitions)
+{
+	std::vector<PassGroup> groups = {{0, 1, 3}, {1, 2, 1}};
+
+	EXPECT_FALSE(run(groups, {0, 0}, []()
+	{
+		ADD_FAILURE() << "budget checked";
+		return true;
+	}));
+
+	EXPECT_EQ(std::vector<std::size_t>({0, 1}), runs);
+}
+
+} // namespace tests
+} // namespace retdec
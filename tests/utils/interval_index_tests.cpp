@@ -0,0 +1,171 @@
+/**
+* @file tests/utils/interval_index_tests.cpp
+* @brief Tests for the @c interval_index module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <limits>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/interval_index.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace tests {
+
+/**
+* @brief Tests for the @c interval_index module.
+*/
+class IntervalIndexTests: public Test {};
+
+TEST_F(IntervalIndexTests,
+EmptyIndexFindsNothing) {
+	IntervalIndex<int> index;
+	index.build();
+
+	EXPECT_TRUE(index.isBuilt());
+	EXPECT_EQ(0, index.find(0));
+	EXPECT_EQ(0, index.find(100));
+}
+
+TEST_F(IntervalIndexTests,
+IndexIsNotBuiltUntilBuildIsCalled) {
+	IntervalIndex<int> index;
+	index.add(0, 10, 1);
+
+	EXPECT_FALSE(index.isBuilt());
+	EXPECT_EQ(0, index.find(5));
+}
+
+TEST_F(IntervalIndexTests,
+FindReturnsValueOfIntervalContainingKey) {
+	IntervalIndex<int> index;
+	index.add(10, 19, 1);
+	index.add(30, 39, 2);
+	index.build();
+
+	EXPECT_EQ(0, index.find(9));
+	EXPECT_EQ(1, index.find(10));
+	EXPECT_EQ(1, index.find(19));
+	EXPECT_EQ(0, index.find(20));
+	EXPECT_EQ(0, index.find(29));
+	EXPECT_EQ(2, index.find(30));
+	EXPECT_EQ(2, index.find(39));
+	EXPECT_EQ(0, index.find(40));
+}
+
+TEST_F(IntervalIndexTests,
+FirstAddedIntervalWinsWhenIntervalsOverlap) {
+	IntervalIndex<int> index;
+	index.add(20, 29, 1);
+	index.add(0, 100, 2);
+	index.add(25, 50, 3);
+	index.build();
+
+	EXPECT_EQ(2, index.find(0));
+	EXPECT_EQ(2, index.find(19));
+	EXPECT_EQ(1, index.find(20));
+	EXPECT_EQ(1, index.find(29));
+	EXPECT_EQ(2, index.find(30));
+	EXPECT_EQ(2, index.find(100));
+	EXPECT_EQ(0, index.find(101));
+}
+
+TEST_F(IntervalIndexTests,
+IntervalMayEndOnMaximalKey) {
+	const auto max = std::numeric_limits<IntervalIndex<int>::Key>::max();
+	IntervalIndex<int> index;
+	index.add(max - 1, max, 1);
+	index.build();
+
+	EXPECT_EQ(0, index.find(max - 2));
+	EXPECT_EQ(1, index.find(max - 1));
+	EXPECT_EQ(1, index.find(max));
+}
+
+TEST_F(IntervalIndexTests,
+InvalidIntervalIsIgnored) {
+	IntervalIndex<int> index;
+	index.add(10, 5, 1);
+	index.build();
+
+	EXPECT_EQ(0, index.find(5));
+	EXPECT_EQ(0, index.find(10));
+}
+
+TEST_F(IntervalIndexTests,
+RepeatedQueriesReturnSameResults) {
+	IntervalIndex<int> index;
+	index.add(0, 9, 1);
+	index.add(10, 19, 2);
+	index.build();
+
+	EXPECT_EQ(2, index.find(15));
+	EXPECT_EQ(2, index.find(15));
+	EXPECT_EQ(1, index.find(5));
+	EXPECT_EQ(1, index.find(5));
+	EXPECT_EQ(0, index.find(20));
+	EXPECT_EQ(2, index.find(10));
+}
+
+TEST_F(IntervalIndexTests,
+ClearRemovesAllIntervals) {
+	IntervalIndex<int> index;
+	index.add(0, 9, 1);
+	index.build();
+	index.clear();
+
+	EXPECT_FALSE(index.isBuilt());
+
+	index.build();
+	EXPECT_EQ(0, index.find(5));
+}
+
+TEST_F(IntervalIndexTests,
+CopyHasSameIntervals) {
+	IntervalIndex<int> index;
+	index.add(0, 9, 1);
+	index.build();
+
+	IntervalIndex<int> copy(index);
+	EXPECT_TRUE(copy.isBuilt());
+	EXPECT_EQ(1, copy.find(5));
+}
+
+TEST_F(IntervalIndexTests,
+IndexCanBeQueriedFromMultipleThreads) {
+	const unsigned threadsCount = 4;
+	IntervalIndex<unsigned> index;
+	for (unsigned i = 0; i < 100; ++i) {
+		index.add(i * 10, i * 10 + 9, i + 1);
+	}
+	index.build();
+
+	std::vector<std::thread> threads;
+	std::vector<char> results(threadsCount, true);
+	for (unsigned t = 0; t < threadsCount; ++t) {
+		threads.emplace_back([&index, &results, t]() {
+			for (unsigned i = 0; i < 1000; ++i) {
+				const auto key = (i * 7 + t * 13) % 1000;
+				if (index.find(key) != key / 10 + 1) {
+					results[t] = false;
+				}
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+
+	for (unsigned t = 0; t < threadsCount; ++t) {
+		EXPECT_TRUE(results[t]) << "thread #" << t;
+	}
+}
+
+} // namespace tests
+} // namespace utils
+} // namespace retdec
@@ -4,6 +4,8 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "retdec/utils/memory.h"
@@ -73,6 +75,20 @@ LimitSystemMemoryToHalfOfTotalSystemMemoryReturnsTrue) {
 	ASSERT_TRUE(limitSystemMemoryToHalfOfTotalSystemMemory());
 }
 
+TEST_F(MemoryTests,
+GetPeakMemoryUsageReturnsNonZeroSize) {
+	ASSERT_GT(getPeakMemoryUsage(), 0);
+}
+
+TEST_F(MemoryTests,
+PeakMemoryUsageDoesNotDecrease) {
+	auto before = getPeakMemoryUsage();
+
+	std::vector<char> data(16 * 1024 * 1024, 1);
+
+	ASSERT_GE(getPeakMemoryUsage(), before);
+}
+
 } // namespace tests
 } // namespace utils
 } // namespace retdec
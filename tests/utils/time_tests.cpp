@@ -4,6 +4,7 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <cstdint>
 #include <cstdlib>
 #include <ctime>
 #include <regex>
@@ -87,6 +88,22 @@ CorrectTimestampToDateConversion) {
 			std::regex("2015-08-05T14:25:19[-+][0-9]{4}")));
 }
 
+//
+// getThreadCpuTime()
+//
+
+TEST_F(TimeTests,
+ThreadCpuTimeIncreasesWhenThreadComputes) {
+	auto before = getThreadCpuTime();
+
+	volatile std::uint64_t sum = 0;
+	for (std::uint64_t i = 0; i < 50000000; ++i) {
+		sum = sum + i;
+	}
+
+	EXPECT_GT(getThreadCpuTime(), before);
+}
+
 } // namespace tests
 } // namespace utils
 } // namespace retdec
@@ -0,0 +1,140 @@
+/**
+* @file tests/yaracpp/yara_detector_tests.cpp
+* @brief Tests for the @c yara_detector module.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/yaracpp/yara_detector.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace yaracpp {
+namespace tests {
+
+/**
+ * Tests for the @c yara_detector module.
+ */
+class YaraDetectorTests : public Test
+{
+	protected:
+		const std::vector<std::uint8_t> input = createInput(
+				"first: abc, second: def, third: ghi"
+		);
+
+		static std::vector<std::uint8_t> createInput(const std::string &str)
+		{
+			return std::vector<std::uint8_t>(str.begin(), str.end());
+		}
+
+		/**
+		 * Compile rules which match strings with the given prefix. Rules
+		 * of the set with index @a i are named after it.
+		 */
+		static std::shared_ptr<YR_RULES> compileRuleSet(std::size_t i)
+		{
+			std::string rules;
+			for (const auto *str : {"abc", "def", "xyz"})
+			{
+				rules += "rule set" + std::to_string(i) + "_" + str
+						+ " { strings: $s = \"" + str + "\" condition: $s }\n";
+			}
+
+			YaraDetector detector;
+			EXPECT_TRUE(detector.addRules(rules.c_str()));
+			return detector.shareCompiledRules();
+		}
+
+		/**
+		 * Scan the input with rule sets by the given number of threads and
+		 * get names and namespaces of detected and undetected rules.
+		 */
+		std::pair<std::vector<std::string>, std::vector<std::string>> scan(
+				std::size_t threads)
+		{
+			YaraDetector detector;
+			EXPECT_TRUE(detector.addRules(
+					"rule text { strings: $s = \"ghi\" condition: $s }"
+			));
+			for (std::size_t i = 0; i < 8; ++i)
+			{
+				EXPECT_TRUE(detector.addCompiledRules(
+						compileRuleSet(i),
+						"ns" + std::to_string(i)
+				));
+			}
+
+			detector.setScanThreads(threads);
+			EXPECT_TRUE(detector.analyze(input, true));
+
+			std::pair<std::vector<std::string>, std::vector<std::string>> ret;
+			for (const auto &rule : detector.getDetectedRules())
+			{
+				ret.first.push_back(rule.getNamespace() + ":" + rule.getName());
+			}
+			for (const auto &rule : detector.getUndetectedRules())
+			{
+				ret.second.push_back(rule.getNamespace() + ":" + rule.getName());
+			}
+			return ret;
+		}
+};
+
+TEST_F(YaraDetectorTests,
+SingleThreadedScanDetectsRulesOfAllRuleSetsInTheirOrder)
+{
+	auto result = scan(1);
+
+	ASSERT_EQ(17, result.first.size());
+	EXPECT_EQ("default:text", result.first[0]);
+	EXPECT_EQ("ns0:set0_abc", result.first[1]);
+	EXPECT_EQ("ns0:set0_def", result.first[2]);
+	EXPECT_EQ("ns7:set7_def", result.first[16]);
+	ASSERT_EQ(8, result.second.size());
+	EXPECT_EQ("ns0:set0_xyz", result.second[0]);
+	EXPECT_EQ("ns7:set7_xyz", result.second[7]);
+}
+
+TEST_F(YaraDetectorTests,
+MultiThreadedScanGivesSameResultsAsSingleThreadedScan)
+{
+	auto expected = scan(1);
+
+	for (std::size_t threads : {2, 4, 16, 0})
+	{
+		// Repeat to give different schedules a chance.
+		for (int i = 0; i < 5; ++i)
+		{
+			EXPECT_EQ(expected, scan(threads)) << "threads: " << threads;
+		}
+	}
+}
+
+TEST_F(YaraDetectorTests,
+BrokenRulesAreRejectedAndOtherRulesAreScanned)
+{
+	YaraDetector detector;
+
+	EXPECT_TRUE(detector.addRules(
+			"rule first { strings: $s = \"abc\" condition: $s }"
+	));
+	EXPECT_FALSE(detector.addRules("rule broken { condition: "));
+	EXPECT_TRUE(detector.addRules(
+			"rule second { condition: first }"
+	));
+
+	ASSERT_TRUE(detector.analyze(input));
+	ASSERT_EQ(2, detector.getDetectedRules().size());
+	EXPECT_EQ("first", detector.getDetectedRules()[0].getName());
+	EXPECT_EQ("second", detector.getDetectedRules()[1].getName());
+}
+
+} // namespace tests
+} // namespace yaracpp
+} // namespace retdec